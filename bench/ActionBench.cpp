@@ -0,0 +1,95 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "Bench.h"
+
+using namespace easy2d;
+using namespace easy2d::bench;
+
+namespace
+{
+	const int kTargetCount = 10000;
+	const int kFrames = 60;
+	const float kFrameTime = 1.f / 60;
+	const Duration kFrameStep(kFrameTime);
+
+	// 可以手动更新子节点的根节点
+	class ClockRoot
+		: public Node
+	{
+	public:
+		using Node::UpdateChildren;
+	};
+
+	// 在 10k 个节点上执行 make 返回的动作，输出每个执行占用的内存池字节数和每帧更新时间
+	// 内存池统计所有引用计数对象和执行状态，动作程序内部数组的堆内存不在其中
+	template <typename MakeAction>
+	void Run(const char * label, MakeAction make)
+	{
+		ClockRoot * root = new ClockRoot();
+		root->Retain();
+		for (int i = 0; i < kTargetCount; ++i)
+		{
+			root->AddChild(new Node());
+		}
+
+		const size_t before = MemoryPool::GetLiveBytes();
+		for (auto child : root->GetAllChildren())
+		{
+			child->RunAction(make());
+		}
+		const size_t after = MemoryPool::GetLiveBytes();
+
+		auto frame = [&]()
+		{
+			root->UpdateChildren(kFrameTime, kFrameStep);
+			ActionManager::GetInstance()->Update(nullptr);
+			TweenManager::GetInstance()->Update(nullptr);
+		};
+
+		frame();
+		const double ms = Measure(kFrames, frame);
+
+		Report(label, static_cast<double>(after - before) / kTargetCount, "bytes/run");
+		Report("  update", ms, "ms/frame");
+
+		root->Release();
+		ActionManager::GetInstance()->Update(nullptr);
+	}
+}
+
+// 同一个动作在 10k 个节点上执行：每个节点克隆一份定义，与所有节点共享一份定义对比
+E2D_BENCH(ActionShare10k)
+{
+	Sequence * sequence = new Sequence({ new MoveBy(1000, Point(100, 100)), new RotateBy(1000, 90) });
+	sequence->Retain();
+
+	Run("Sequence(MoveBy, RotateBy), cloned per target", [=]() -> Action*
+	{
+		return sequence->Clone();
+	});
+
+	Run("Sequence(MoveBy, RotateBy), shared definition", [=]() -> Action*
+	{
+		return sequence;
+	});
+
+	sequence->Release();
+}
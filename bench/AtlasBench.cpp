@@ -0,0 +1,99 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "Bench.h"
+
+using namespace easy2d;
+using namespace easy2d::bench;
+
+namespace
+{
+	const int kImageCount = 500;
+	const int kPageSize = 2048;
+	const int kRounds = 10;
+
+	struct ImageSize
+	{
+		UINT width;
+		UINT height;
+	};
+
+	// 固定种子的线性同余随机数，保证每次运行的图片尺寸相同
+	std::vector<ImageSize> MakeSizes()
+	{
+		std::vector<ImageSize> sizes(kImageCount);
+		unsigned int seed = 12345;
+		for (auto& size : sizes)
+		{
+			seed = seed * 1103515245 + 12345;
+			size.width = 8 + (seed >> 16) % 121;
+			seed = seed * 1103515245 + 12345;
+			size.height = 8 + (seed >> 16) % 121;
+		}
+		return sizes;
+	}
+
+	ImageAtlas * Pack(const std::vector<ImageSize>& sizes)
+	{
+		ImageAtlas * atlas = new ImageAtlas(kPageSize, kPageSize);
+		atlas->Retain();
+		for (size_t i = 0; i < sizes.size(); ++i)
+		{
+			const auto& size = sizes[i];
+			std::vector<BYTE> pixels(static_cast<size_t>(size.width) * size.height * 4, 255);
+			atlas->Add(String(L"image") + String::Parse(static_cast<int>(i)), size.width, size.height, pixels);
+		}
+		atlas->Build();
+		return atlas;
+	}
+}
+
+// 500 张 8~128 像素的随机尺寸图片：打包时间，以及和逐张加载相比的位图数量与显存占用
+// 页面只保留实际用到的区域，这里同时给出按固定 2048x2048 页面分配时的占用
+E2D_BENCH(AtlasPack500)
+{
+	const auto sizes = MakeSizes();
+
+	const double ms = Measure(kRounds, [&]()
+	{
+		Pack(sizes)->Release();
+	});
+	Report("pack 500 images (add + build)", ms, "ms");
+
+	ImageAtlas * atlas = Pack(sizes);
+
+	double image_bytes = 0;
+	for (const auto& size : sizes)
+	{
+		image_bytes += static_cast<double>(size.width) * size.height * 4;
+	}
+	const double page_bytes = image_bytes / atlas->GetOccupancy();
+	const double fixed_bytes = static_cast<double>(atlas->GetPageCount()) * kPageSize * kPageSize * 4;
+	const double mb = 1024.0 * 1024.0;
+
+	Report("separate images, bitmaps", static_cast<double>(sizes.size()), "");
+	Report("separate images, pixel memory", image_bytes / mb, "MB");
+	Report("atlas, bitmaps", static_cast<double>(atlas->GetPageCount()), "");
+	Report("atlas, trimmed pages", page_bytes / mb, "MB");
+	Report("atlas, fixed 2048x2048 pages", fixed_bytes / mb, "MB");
+	Report("atlas, occupancy", atlas->GetOccupancy() * 100.0, "%");
+
+	atlas->Release();
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "../core/easy2d.h"
+#include <chrono>
+#include <cstdio>
+
+namespace easy2d
+{
+	namespace bench
+	{
+		typedef void(*BenchFunc)();
+
+		struct BenchCase
+		{
+			const char *	name;
+			BenchFunc		func;
+		};
+
+		// 所有已注册的性能测试
+		inline std::vector<BenchCase>& GetBenches()
+		{
+			static std::vector<BenchCase> benches;
+			return benches;
+		}
+
+		// 在静态初始化时注册性能测试
+		struct Registrar
+		{
+			Registrar(const char * name, BenchFunc func)
+			{
+				BenchCase bench = { name, func };
+				GetBenches().push_back(bench);
+			}
+		};
+
+		// 重复执行函数，返回每次执行的平均毫秒数
+		template <typename Func>
+		double Measure(int iterations, Func func)
+		{
+			auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < iterations; ++i)
+			{
+				func();
+			}
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+			return elapsed.count() / iterations;
+		}
+
+		// 输出一项测量结果
+		inline void Report(const char * label, double value, const char * unit)
+		{
+			std::printf("  %-48s %12.3f %s\n", label, value, unit);
+		}
+	}
+}
+
+// 定义一个性能测试
+#define E2D_BENCH(NAME) \
+	static void NAME(); \
+	static ::easy2d::bench::Registrar NAME##_registrar(#NAME, NAME); \
+	static void NAME()
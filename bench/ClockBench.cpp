@@ -0,0 +1,70 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "Bench.h"
+
+using namespace easy2d;
+using namespace easy2d::bench;
+
+namespace
+{
+	const int kNodeCount = 100000;
+	const int kFrames = 120;
+	const float kFrameTime = 1.f / 60;
+	const Duration kFrameStep(kFrameTime);
+
+	// 可以手动更新子节点的根节点
+	class ClockRoot
+		: public Node
+	{
+	public:
+		using Node::UpdateChildren;
+	};
+
+	// 测量每帧推进 100k 个节点时钟的时间，time_scale 设置在根节点上
+	void Run(const char * label, float time_scale)
+	{
+		ClockRoot * root = new ClockRoot();
+		root->Retain();
+		root->SetTimeScale(time_scale);
+		for (int i = 0; i < kNodeCount; ++i)
+		{
+			root->AddChild(new Node());
+		}
+
+		auto frame = [&]()
+		{
+			root->UpdateChildren(kFrameTime, kFrameStep);
+		};
+
+		frame();
+		const double ms = Measure(kFrames, frame);
+		Report(label, ms, "ms/frame");
+
+		root->Release();
+	}
+}
+
+// 没有动作和任务的节点，只有时钟推进和子节点遍历的开销
+E2D_BENCH(Clock100k)
+{
+	Run("100k nodes, time scale 1", 1.f);
+	Run("100k nodes, time scale 0.5", 0.5f);
+}
@@ -0,0 +1,374 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "Bench.h"
+
+using namespace easy2d;
+using namespace easy2d::bench;
+
+namespace
+{
+	const int kImageCount = 64;
+	const UINT kImageSize = 256;
+	const int kRounds = 5;
+
+	const UINT kLengthBase[29] = {
+		3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+		35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+	};
+	const UINT kDistBase[30] = {
+		1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+		257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+	};
+
+	// 低位在前写入数据流
+	class BitWriter
+	{
+	public:
+		explicit BitWriter(std::vector<BYTE>& out) : out_(out), bits_(0), count_(0) {}
+
+		void Put(UINT value, int n)
+		{
+			bits_ |= value << count_;
+			count_ += n;
+			while (count_ >= 8)
+			{
+				out_.push_back(static_cast<BYTE>(bits_));
+				bits_ >>= 8;
+				count_ -= 8;
+			}
+		}
+
+		// Huffman 编码高位在前
+		void PutCode(UINT code, int n)
+		{
+			UINT reversed = 0;
+			for (int i = 0; i < n; ++i)
+			{
+				reversed |= ((code >> i) & 1) << (n - 1 - i);
+			}
+			Put(reversed, n);
+		}
+
+		void Flush()
+		{
+			if (count_ > 0)
+			{
+				out_.push_back(static_cast<BYTE>(bits_));
+			}
+			bits_ = 0;
+			count_ = 0;
+		}
+
+	private:
+		std::vector<BYTE>&	out_;
+		UINT				bits_;
+		int					count_;
+	};
+
+	void PutLiteral(BitWriter& writer, UINT symbol)
+	{
+		if (symbol < 144)
+			writer.PutCode(0x30 + symbol, 8);
+		else if (symbol < 256)
+			writer.PutCode(0x190 + symbol - 144, 9);
+		else if (symbol < 280)
+			writer.PutCode(symbol - 256, 7);
+		else
+			writer.PutCode(0xC0 + symbol - 280, 8);
+	}
+
+	void PutMatch(BitWriter& writer, UINT length, UINT distance)
+	{
+		int index = 28;
+		while (kLengthBase[index] > length)
+			--index;
+		PutLiteral(writer, 257 + index);
+		static const int length_extra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+		writer.Put(length - kLengthBase[index], length_extra[index]);
+
+		index = 29;
+		while (kDistBase[index] > distance)
+			--index;
+		writer.PutCode(index, 5);
+		writer.Put(distance - kDistBase[index], index < 4 ? 0 : index / 2 - 1);
+	}
+
+	// 使用固定 Huffman 编码和单候选哈希匹配压缩，压缩率接近常见的快速压缩级别
+	std::vector<BYTE> Deflate(const std::vector<BYTE>& data)
+	{
+		std::vector<BYTE> out;
+		out.push_back(0x78);
+		out.push_back(0x01);
+
+		BitWriter writer(out);
+		writer.Put(1, 1);
+		writer.Put(1, 2);
+
+		std::vector<int> head(1 << 15, -1);
+		const size_t size = data.size();
+		size_t pos = 0;
+		while (pos < size)
+		{
+			UINT best = 0;
+			if (pos + 3 <= size)
+			{
+				const UINT hash = ((data[pos] << 10) ^ (data[pos + 1] << 5) ^ data[pos + 2]) & 0x7FFF;
+				const int candidate = head[hash];
+				head[hash] = static_cast<int>(pos);
+				if (candidate >= 0 && pos - candidate <= 32768)
+				{
+					const size_t limit = std::min<size_t>(258, size - pos);
+					while (best < limit && data[candidate + best] == data[pos + best])
+						++best;
+					if (best >= 3)
+					{
+						PutMatch(writer, best, static_cast<UINT>(pos - candidate));
+						pos += best;
+						continue;
+					}
+				}
+			}
+			PutLiteral(writer, data[pos]);
+			++pos;
+		}
+		PutLiteral(writer, 256);
+		writer.Flush();
+
+		UINT a = 1, b = 0;
+		for (size_t i = 0; i < size; ++i)
+		{
+			a = (a + data[i]) % 65521;
+			b = (b + a) % 65521;
+		}
+		const UINT adler = (b << 16) | a;
+		for (int i = 3; i >= 0; --i)
+		{
+			out.push_back(static_cast<BYTE>(adler >> (i * 8)));
+		}
+		return out;
+	}
+
+	UINT Crc32(const BYTE * data, size_t size)
+	{
+		UINT crc = 0xFFFFFFFF;
+		for (size_t i = 0; i < size; ++i)
+		{
+			crc ^= data[i];
+			for (int k = 0; k < 8; ++k)
+			{
+				crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+			}
+		}
+		return ~crc;
+	}
+
+	void PutBE32(std::vector<BYTE>& out, UINT value)
+	{
+		for (int i = 3; i >= 0; --i)
+		{
+			out.push_back(static_cast<BYTE>(value >> (i * 8)));
+		}
+	}
+
+	void PutChunk(std::vector<BYTE>& out, const char * type, const std::vector<BYTE>& data)
+	{
+		PutBE32(out, static_cast<UINT>(data.size()));
+		const size_t start = out.size();
+		out.insert(out.end(), type, type + 4);
+		out.insert(out.end(), data.begin(), data.end());
+		PutBE32(out, Crc32(&out[start], out.size() - start));
+	}
+
+	int Paeth(int a, int b, int c)
+	{
+		const int p = a + b - c;
+		const int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+		return (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+	}
+
+	// 编码 RGBA PNG，每行选择绝对值之和最小的过滤方式
+	std::vector<BYTE> EncodePng(UINT width, UINT height, const std::vector<BYTE>& rgba)
+	{
+		const size_t row_size = width * 4;
+		std::vector<BYTE> raw;
+		std::vector<BYTE> zero(row_size, 0), candidate(row_size);
+		for (UINT y = 0; y < height; ++y)
+		{
+			const BYTE * row = &rgba[y * row_size];
+			const BYTE * prev = y ? row - row_size : &zero[0];
+
+			int best_filter = 0;
+			long best_sum = -1;
+			std::vector<BYTE> best_row;
+			for (int filter = 0; filter < 5; ++filter)
+			{
+				long sum = 0;
+				for (size_t i = 0; i < row_size; ++i)
+				{
+					const int a = i >= 4 ? row[i - 4] : 0;
+					const int b = prev[i];
+					const int c = i >= 4 ? prev[i - 4] : 0;
+					const int predict[5] = { 0, a, b, (a + b) / 2, Paeth(a, b, c) };
+					candidate[i] = static_cast<BYTE>(row[i] - predict[filter]);
+					sum += std::abs(static_cast<signed char>(candidate[i]));
+				}
+				if (best_sum < 0 || sum < best_sum)
+				{
+					best_sum = sum;
+					best_filter = filter;
+					best_row = candidate;
+				}
+			}
+			raw.push_back(static_cast<BYTE>(best_filter));
+			raw.insert(raw.end(), best_row.begin(), best_row.end());
+		}
+
+		static const BYTE signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		std::vector<BYTE> png(signature, signature + 8);
+
+		std::vector<BYTE> header;
+		PutBE32(header, width);
+		PutBE32(header, height);
+		const BYTE rest[5] = { 8, 6, 0, 0, 0 };
+		header.insert(header.end(), rest, rest + 5);
+		PutChunk(png, "IHDR", header);
+		PutChunk(png, "IDAT", Deflate(raw));
+		PutChunk(png, "IEND", std::vector<BYTE>());
+		return png;
+	}
+
+	// 编码自上而下存放的 32 位 BMP
+	std::vector<BYTE> EncodeBmp(UINT width, UINT height, const std::vector<BYTE>& rgba)
+	{
+		std::vector<BYTE> bmp(54, 0);
+		auto put32 = [&](size_t pos, UINT value)
+		{
+			for (int i = 0; i < 4; ++i)
+			{
+				bmp[pos + i] = static_cast<BYTE>(value >> (i * 8));
+			}
+		};
+		bmp[0] = 'B';
+		bmp[1] = 'M';
+		put32(2, static_cast<UINT>(54 + rgba.size()));
+		put32(10, 54);
+		put32(14, 40);
+		put32(18, width);
+		put32(22, static_cast<UINT>(-static_cast<int>(height)));
+		bmp[26] = 1;
+		bmp[28] = 32;
+		for (size_t i = 0; i < rgba.size(); i += 4)
+		{
+			const BYTE bgra[4] = { rgba[i + 2], rgba[i + 1], rgba[i], rgba[i + 3] };
+			bmp.insert(bmp.end(), bgra, bgra + 4);
+		}
+		return bmp;
+	}
+
+	// 生成类似游戏精灵的图片：渐变填充的圆形，边缘透明，带少量噪声
+	std::vector<BYTE> MakeSprite(UINT size, UINT seed)
+	{
+		std::vector<BYTE> rgba(size * size * 4);
+		const float center = size * 0.5f;
+		const float radius = size * 0.45f;
+		for (UINT y = 0; y < size; ++y)
+		{
+			for (UINT x = 0; x < size; ++x)
+			{
+				seed = seed * 1664525u + 1013904223u;
+				const float dx = x - center, dy = y - center;
+				const float distance = std::sqrt(dx * dx + dy * dy);
+				const float coverage = std::min(std::max(radius - distance, 0.f), 1.f);
+
+				BYTE * p = &rgba[(y * size + x) * 4];
+				const UINT noise = (seed >> 28) & 3;
+				p[0] = static_cast<BYTE>(std::min(255u, x * 255 / size + noise));
+				p[1] = static_cast<BYTE>(std::min(255u, y * 255 / size + noise));
+				p[2] = static_cast<BYTE>(std::min(255u, static_cast<UINT>(distance) + noise));
+				p[3] = static_cast<BYTE>(coverage * 255);
+			}
+		}
+		return rgba;
+	}
+
+	// 解码所有图片 rounds 遍，返回每秒解码的像素字节数 (MB/s)
+	double MeasureDecode(const std::vector<std::vector<BYTE>>& files, ThreadPool * pool)
+	{
+		PortableImageDecoder decoder;
+		std::atomic<size_t> decoded_bytes(0);
+		std::atomic<int> failures(0);
+
+		auto decode = [&](size_t index)
+		{
+			UINT width = 0, height = 0;
+			std::vector<BYTE> pixels;
+			if (decoder.Decode(&files[index][0], files[index].size(), &width, &height, pixels))
+				decoded_bytes += pixels.size();
+			else
+				++failures;
+		};
+
+		const double ms = Measure(kRounds, [&]()
+		{
+			for (size_t i = 0; i < files.size(); ++i)
+			{
+				if (pool)
+					pool->Submit([&decode, i]() { decode(i); });
+				else
+					decode(i);
+			}
+			if (pool)
+				pool->Wait();
+		});
+
+		if (failures)
+		{
+			std::printf("  decode failed: %d\n", failures.load());
+		}
+		const double bytes_per_round = static_cast<double>(decoded_bytes.load()) / kRounds;
+		return bytes_per_round / (1024.0 * 1024.0) / (ms / 1000.0);
+	}
+}
+
+// 图片解码吞吐量：单线程与线程池解码同一组 PNG 和 BMP
+E2D_BENCH(ImageDecodeThroughput)
+{
+	std::vector<std::vector<BYTE>> png_files, bmp_files;
+	size_t png_bytes = 0;
+	for (int i = 0; i < kImageCount; ++i)
+	{
+		const std::vector<BYTE> rgba = MakeSprite(kImageSize, static_cast<UINT>(i));
+		png_files.push_back(EncodePng(kImageSize, kImageSize, rgba));
+		bmp_files.push_back(EncodeBmp(kImageSize, kImageSize, rgba));
+		png_bytes += png_files.back().size();
+	}
+
+	const double raw_bytes = static_cast<double>(kImageCount) * kImageSize * kImageSize * 4;
+	Report("PNG compressed size / pixel size", png_bytes / raw_bytes * 100, "%");
+
+	ThreadPool pool;
+	Report("PNG decode, 1 thread", MeasureDecode(png_files, nullptr), "MB/s");
+	Report("PNG decode, thread pool", MeasureDecode(png_files, &pool), "MB/s");
+	Report("BMP decode, 1 thread", MeasureDecode(bmp_files, nullptr), "MB/s");
+	Report("BMP decode, thread pool", MeasureDecode(bmp_files, &pool), "MB/s");
+	Report("thread pool workers", static_cast<double>(pool.GetThreadCount()), "threads");
+}
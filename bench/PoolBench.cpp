@@ -0,0 +1,96 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "Bench.h"
+
+using namespace easy2d;
+using namespace easy2d::bench;
+
+namespace
+{
+	const int kObjectCount = 10000;
+	const int kFrames = 200;
+
+	// 每帧按节点、动作、任务的大小分配一批内存，再打乱顺序全部释放
+	template <typename Alloc, typename Free>
+	void Churn(const char * label, Alloc alloc, Free free)
+	{
+		const size_t sizes[] = { sizeof(Sprite), sizeof(MoveBy), sizeof(Sequence), sizeof(Task) };
+		std::vector<std::pair<void*, size_t>> blocks(kObjectCount);
+
+		const double ms = Measure(kFrames, [&]()
+		{
+			for (int i = 0; i < kObjectCount; ++i)
+			{
+				const size_t size = sizes[i % 4];
+				blocks[i] = std::make_pair(alloc(size), size);
+			}
+
+			// 以固定步长跳跃释放，模拟对象生命周期交错
+			for (int i = 0; i < kObjectCount; ++i)
+			{
+				const auto& block = blocks[(i * 7919) % kObjectCount];
+				free(block.first, block.second);
+			}
+		});
+
+		Report(label, ms * 1e6 / kObjectCount, "ns/object");
+	}
+}
+
+// 10k 个对象的分配和释放：系统堆与内存池对比，并输出内存池的计数器
+E2D_BENCH(PoolChurn)
+{
+	Churn("operator new/delete", [](size_t size)
+	{
+		return ::operator new(size);
+	}, [](void * p, size_t)
+	{
+		::operator delete(p);
+	});
+
+	Churn("MemoryPool", [](size_t size)
+	{
+		return MemoryPool::Allocate(size);
+	}, [](void * p, size_t size)
+	{
+		MemoryPool::Free(p, size);
+	});
+
+	// 通过 Ref 的 operator new 创建真实的引擎对象
+	std::vector<Action*> actions(kObjectCount);
+	const double ms = Measure(kFrames, [&]()
+	{
+		for (int i = 0; i < kObjectCount; ++i)
+		{
+			actions[i] = new MoveBy(1, Point(10, 0));
+			actions[i]->Retain();
+		}
+		for (int i = 0; i < kObjectCount; ++i)
+		{
+			actions[(i * 7919) % kObjectCount]->Release();
+		}
+	});
+	Report("create/release MoveBy through Ref", ms * 1e6 / kObjectCount, "ns/object");
+
+	Report("  live objects", static_cast<double>(MemoryPool::GetLiveCount()), "");
+	Report("  peak objects", static_cast<double>(MemoryPool::GetPeakCount()), "");
+	Report("  reserved bytes", static_cast<double>(MemoryPool::GetReservedBytes()), "bytes");
+}
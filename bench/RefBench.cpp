@@ -0,0 +1,81 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "Bench.h"
+
+using namespace easy2d;
+using namespace easy2d::bench;
+
+namespace
+{
+	const int kPairCount = 10000000;
+	const int kNodeCount = 10000;
+	const int kFrames = 100;
+
+#if E2D_ATOMIC_REF_COUNT
+	const char * const kPairLabel = "Retain/Release pair (atomic)";
+#else
+	const char * const kPairLabel = "Retain/Release pair (plain)";
+#endif
+
+	// 每帧创建一批节点再全部移除，deferred 决定是否延迟到帧末删除
+	void Churn(const char * label, bool deferred)
+	{
+		Node * root = new Node();
+		root->Retain();
+
+		AutoreleasePool::SetDeferred(deferred);
+		const double ms = Measure(kFrames, [&]()
+		{
+			for (int i = 0; i < kNodeCount; ++i)
+			{
+				root->AddChild(new Node());
+			}
+			root->RemoveAllChildren();
+			AutoreleasePool::Drain();
+		});
+		AutoreleasePool::SetDeferred(false);
+
+		Report(label, ms, "ms/frame");
+		root->Release();
+	}
+}
+
+E2D_BENCH(RefCount)
+{
+	Node * node = new Node();
+	node->Retain();
+
+	// 单线程中的原子操作仍然比普通加减慢，定义 E2D_ATOMIC_REF_COUNT=0 重新编译后对比
+	const double ms = Measure(1, [&]()
+	{
+		for (int i = 0; i < kPairCount; ++i)
+		{
+			node->Retain();
+			node->Release();
+		}
+	});
+	Report(kPairLabel, ms * 1e6 / kPairCount, "ns");
+
+	node->Release();
+
+	Churn("10k nodes added and removed, deleted at once", false);
+	Churn("10k nodes added and removed, autorelease pool", true);
+}
@@ -0,0 +1,158 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "Bench.h"
+
+using namespace easy2d;
+using namespace easy2d::bench;
+
+namespace
+{
+	const int kSpriteCount = 100000;
+	const int kFrames = 30;
+	const float kViewWidth = 1920.f;
+	const float kViewHeight = 1080.f;
+	const D2D1_RECT_F kSpriteRect = D2D1::RectF(0, 0, 16, 16);
+
+	// 和 Sprite 一样每个节点生成一次位图绘制，录制命令不需要真实的位图
+	class BitmapNode
+		: public Node
+	{
+	public:
+		virtual void Record(RenderCommandList& commands) const override
+		{
+			commands.DrawBitmap(nullptr, kSpriteRect, kSpriteRect, display_opacity_);
+		}
+	};
+
+	// 和 SpriteBatch 一样把所有精灵保存在连续数组中，作为一个命令提交
+	class BatchNode
+		: public Node
+	{
+	public:
+		BatchNode()
+			: dests(kSpriteCount, kSpriteRect)
+			, srcs(kSpriteCount, kSpriteRect)
+			, transforms(kSpriteCount)
+			, colors(kSpriteCount, D2D1::ColorF(D2D1::ColorF::White))
+			, opacities(kSpriteCount, 1.f)
+		{
+			for (int i = 0; i < kSpriteCount; ++i)
+			{
+				transforms[i] = D2D1::Matrix3x2F::Translation(
+					static_cast<float>(i % 1900),
+					static_cast<float>(i / 1900 % 1060)
+				);
+			}
+		}
+
+		virtual void Record(RenderCommandList& commands) const override
+		{
+			commands.DrawSprites(
+				nullptr,
+				&dests[0],
+				&srcs[0],
+				&transforms[0],
+				&colors[0],
+				&opacities[0],
+				static_cast<UINT32>(kSpriteCount),
+				display_opacity_
+			);
+		}
+
+		std::vector<D2D1_RECT_F>		dests;
+		std::vector<D2D1_RECT_F>		srcs;
+		std::vector<D2D1_MATRIX_3X2_F>	transforms;
+		std::vector<D2D1_COLOR_F>		colors;
+		std::vector<float>				opacities;
+	};
+
+	// 测量每帧执行 move、遍历场景、录制并回放命令的时间
+	template <typename Move>
+	void Run(const char * label, Node * root, Move move)
+	{
+		Scene * scene = new Scene(root);
+		scene->Retain();
+
+		RenderCommandList commands;
+		RenderRecorder recorder;
+		auto frame = [&]()
+		{
+			move();
+			commands.Clear();
+			recorder.Clear();
+			scene->Draw(commands, Size(kViewWidth, kViewHeight));
+			recorder.Replay(commands);
+		};
+
+		frame();
+		const double ms = Measure(kFrames, frame);
+
+		Report(label, ms, "ms/frame");
+		Report("  draw calls", static_cast<double>(recorder.GetDrawCallCount()), "");
+		Report("  state changes", static_cast<double>(recorder.GetStateChangeCount()), "");
+
+		scene->Release();
+	}
+
+	void Nothing()
+	{
+	}
+}
+
+// 100k 个精灵：每个精灵一个节点，与同样数量的精灵放在一个批次中
+// 只测量 CPU 端的遍历、录制和回放，GPU 提交的差异需要在 Windows 上测量
+E2D_BENCH(SpriteBatch100k)
+{
+	Node * nodes = new Node();
+	for (int i = 0; i < kSpriteCount; ++i)
+	{
+		Node * node = new BitmapNode();
+		node->SetPivot(0, 0);
+		node->SetSize(16, 16);
+		node->SetPosition(static_cast<float>(i % 1900), static_cast<float>(i / 1900 % 1060));
+		nodes->AddChild(node);
+	}
+	nodes->Retain();
+	Run("100k sprite nodes, static", nodes, Nothing);
+	Run("100k sprite nodes, all moving", nodes, [=]()
+	{
+		for (auto child : nodes->GetAllChildren())
+		{
+			child->MoveBy(0.01f, 0);
+		}
+	});
+	nodes->Release();
+
+	Node * batch = new Node();
+	BatchNode * sprites = new BatchNode();
+	batch->AddChild(sprites);
+	batch->Retain();
+	Run("100k sprites in one batch, static", batch, Nothing);
+	Run("100k sprites in one batch, all moving", batch, [=]()
+	{
+		for (auto& transform : sprites->transforms)
+		{
+			transform._31 += 0.01f;
+		}
+	});
+	batch->Release();
+}
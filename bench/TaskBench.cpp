@@ -0,0 +1,81 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "Bench.h"
+
+using namespace easy2d;
+using namespace easy2d::bench;
+
+namespace
+{
+	const int kNodeCount = 10000;
+	const int kFrames = 300;
+	const float kFrameTime = 1.f / 60;
+	const Duration kFrameStep(kFrameTime);
+
+	// 可以手动更新子节点的根节点
+	class ClockRoot
+		: public Node
+	{
+	public:
+		using Node::UpdateChildren;
+	};
+
+	// 每个节点添加 tasks 个间隔为 interval 的任务，测量每帧更新节点和任务的时间
+	void Run(const char * label, int tasks, float interval)
+	{
+		ClockRoot * root = new ClockRoot();
+		root->Retain();
+
+		int counter = 0;
+		for (int i = 0; i < kNodeCount; ++i)
+		{
+			Node * node = new Node();
+			for (int t = 0; t < tasks; ++t)
+			{
+				node->AddTask(new Task([&counter]() { ++counter; }, interval));
+			}
+			root->AddChild(node);
+		}
+
+		auto frame = [&]()
+		{
+			root->UpdateChildren(kFrameTime, kFrameStep);
+		};
+
+		frame();
+		counter = 0;
+		const double ms = Measure(kFrames, frame);
+
+		Report(label, ms, "ms/frame");
+		Report("  task runs per frame", static_cast<double>(counter) / kFrames, "");
+
+		root->Release();
+	}
+}
+
+// 10k 个节点上的任务：每帧都到期的任务，以及大多数帧都不到期的任务
+E2D_BENCH(Task10k)
+{
+	Run("10k nodes, no task", 0, 0);
+	Run("10k nodes, 1 task every frame", 1, 0);
+	Run("10k nodes, 4 tasks every frame", 4, 0);
+	Run("10k nodes, 4 tasks every 0.5s", 4, 0.5f);
+}
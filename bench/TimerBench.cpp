@@ -0,0 +1,96 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "Bench.h"
+
+using namespace easy2d;
+using namespace easy2d::bench;
+
+namespace
+{
+	const long long kHourNanoseconds = 3600LL * 1000000000LL;
+
+	// 可以手动更新子节点的根节点
+	class ClockRoot
+		: public Node
+	{
+	public:
+		using Node::UpdateChildren;
+	};
+
+	// 模拟以 hz 帧率运行一小时，系统时钟的差值按 resolution 微秒截断
+	// keep_remainder 为 false 时上一帧时间直接设为当前时间，截断的部分被丢弃
+	// 输出节点时钟的误差和每秒执行一次的任务的执行次数
+	void Run(const char * label, int hz, long long resolution, bool keep_remainder)
+	{
+		ClockRoot * root = new ClockRoot();
+		root->Retain();
+
+		int runs = 0;
+		Node * node = new Node();
+		node->AddTask(new Task([&runs]() { ++runs; }, 1.f));
+		root->AddChild(node);
+
+		const long long frame_ns = 1000000000LL / hz;
+		const long long frames = (kHourNanoseconds + frame_ns - 1) / frame_ns;
+		long long last_ns = 0;
+		long long clock_us = 0;
+		float carry = 0.f;
+
+		const double ms = Measure(1, [&]()
+		{
+			for (long long i = 1; i <= frames; ++i)
+			{
+				// 与 Game::Run 相同，每帧读取一次时钟差值
+				const long long now_ns = i * frame_ns;
+				const long long dur_us = (now_ns - last_ns) / 1000 / resolution * resolution;
+				const Duration dur = Duration::FromMicroseconds(dur_us);
+				const float dt = dur.Seconds();
+				last_ns = keep_remainder ? last_ns + dur_us * 1000 : now_ns;
+
+				// 与 Game::UpdateScene 相同，不足精度的部分留到下一帧
+				const Duration step(dt + carry);
+				carry = dt + carry - step.Seconds();
+				clock_us += step.Microseconds();
+
+				root->UpdateChildren(dt, step);
+			}
+		});
+
+		const double error = static_cast<double>(frames * frame_ns / 1000 - clock_us) / 1000000.0;
+
+		Report(label, error, "s behind");
+		Report("  task runs (3600 expected)", static_cast<double>(runs), "");
+		Report("  simulation time", ms, "ms");
+
+		root->Release();
+	}
+}
+
+// 一小时内的时钟误差：旧的毫秒精度、只提高到微秒精度、以及保留截断余量的当前实现
+E2D_BENCH(Timer1h)
+{
+	Run("60 Hz, milliseconds, remainder dropped", 60, 1000, false);
+	Run("60 Hz, microseconds, remainder dropped", 60, 1, false);
+	Run("60 Hz, microseconds, remainder kept", 60, 1, true);
+	Run("144 Hz, milliseconds, remainder dropped", 144, 1000, false);
+	Run("144 Hz, microseconds, remainder dropped", 144, 1, false);
+	Run("144 Hz, microseconds, remainder kept", 144, 1, true);
+}
@@ -0,0 +1,112 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "Bench.h"
+
+using namespace easy2d;
+using namespace easy2d::bench;
+
+namespace
+{
+	const int kGroupCount = 1000;
+	const int kLeafCount = 100;
+	const int kFrames = 200;
+
+	// 每帧执行 change 后更新变换缓存，测量每帧的时间
+	template <typename Change>
+	void Run(const char * label, Change change)
+	{
+		Node * root = new Node();
+		Scene * scene = new Scene(root);
+		scene->Retain();
+
+		std::vector<Node*> groups;
+		for (int i = 0; i < kGroupCount; ++i)
+		{
+			Node * group = new Node();
+			group->SetPosition(static_cast<float>(i % 40) * 20, static_cast<float>(i / 40) * 20);
+			root->AddChild(group);
+			groups.push_back(group);
+
+			for (int j = 0; j < kLeafCount; ++j)
+			{
+				Node * leaf = new Node();
+				leaf->SetPosition(static_cast<float>(j), static_cast<float>(j));
+				leaf->SetSize(8, 8);
+				group->AddChild(leaf);
+			}
+		}
+		scene->UpdateTransform();
+
+		int frame = 0;
+		const double ms = Measure(kFrames, [&]()
+		{
+			change(root, groups, frame++);
+			scene->UpdateTransform();
+		});
+		Report(label, ms, "ms/frame");
+
+		scene->Release();
+	}
+}
+
+E2D_BENCH(TransformStore100k)
+{
+	// 没有结构变化，作为其他结果的基准
+	Run("100k nodes, one leaf moved", [](Node *, std::vector<Node*>& groups, int frame)
+	{
+		Node * leaf = groups[frame % kGroupCount]->GetAllChildren().front();
+		leaf->SetPosition(static_cast<float>(frame % 7), 0);
+	});
+
+	Run("100k nodes, leaf added and removed", [](Node *, std::vector<Node*>& groups, int frame)
+	{
+		Node * group = groups[frame % kGroupCount];
+		if (frame % 2 == 0)
+		{
+			Node * leaf = new Node();
+			leaf->SetSize(8, 8);
+			group->AddChild(leaf);
+		}
+		else
+		{
+			group->RemoveChild(group->GetAllChildren().back());
+		}
+	});
+
+	Run("100k nodes, leaf reordered", [](Node *, std::vector<Node*>& groups, int frame)
+	{
+		Node * group = groups[frame % kGroupCount];
+		group->GetAllChildren().front()->SetOrder(frame % 2);
+	});
+
+	// 根节点的子节点变化时需要拼接整棵树，未变化的子树按块复制
+	Run("100k nodes, group added and removed", [](Node * root, std::vector<Node*>&, int frame)
+	{
+		if (frame % 2 == 0)
+		{
+			root->AddChild(new Node());
+		}
+		else
+		{
+			root->RemoveChild(root->GetAllChildren().back());
+		}
+	});
+}
@@ -0,0 +1,122 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "Bench.h"
+
+using namespace easy2d;
+using namespace easy2d::bench;
+
+namespace
+{
+	const int kNodeCount = 100000;
+	const int kFrames = 60;
+	const float kFrameTime = 1.f / 60;
+	const Duration kFrameStep(kFrameTime);
+
+	// 可以手动更新子节点的根节点
+	class ClockRoot
+		: public Node
+	{
+	public:
+		using Node::UpdateChildren;
+	};
+
+	// 重写了属性设置函数的节点，补间结果只能通过虚函数写回
+	class VirtualNode
+		: public Node
+	{
+	public:
+		virtual void SetPosition(float x, float y) override
+		{
+			Node::SetPosition(x, y);
+		}
+	};
+
+	// 在每个节点上执行 make 创建的动作，测量每帧更新节点和所有动作的时间
+	template <typename NodeType, typename MakeAction>
+	void Run(const char * label, MakeAction make)
+	{
+		ClockRoot * root = new ClockRoot();
+		root->Retain();
+		for (int i = 0; i < kNodeCount; ++i)
+		{
+			Node * node = new NodeType();
+			root->AddChild(node);
+
+			if (Action * action = make())
+			{
+				node->RunAction(action);
+			}
+		}
+
+		auto frame = [&]()
+		{
+			root->UpdateChildren(kFrameTime, kFrameStep);
+			ActionManager::GetInstance()->Update(nullptr);
+			TweenManager::GetInstance()->Update(nullptr);
+		};
+
+		// 第一帧开始执行动作，之后补间步骤转交给补间管理器
+		frame();
+		const size_t tweens = TweenManager::GetInstance()->GetCount();
+		const double ms = Measure(kFrames, frame);
+
+		Report(label, ms, "ms/frame");
+		Report("  tweens in lanes", static_cast<double>(tweens), "");
+
+		root->Release();
+		ActionManager::GetInstance()->Update(nullptr);
+	}
+}
+
+E2D_BENCH(Tween100k)
+{
+	// 只更新节点，作为其他结果的基准
+	Run<Node>("100k nodes, no action", []() -> Action*
+	{
+		return nullptr;
+	});
+
+	Run<Node>("100k MoveBy", []() -> Action*
+	{
+		return new MoveBy(1000, Point(100, 100));
+	});
+
+	Run<VirtualNode>("100k MoveBy, overridden SetPosition", []() -> Action*
+	{
+		return new MoveBy(1000, Point(100, 100));
+	});
+
+	Run<Node>("100k Sequence(MoveBy, RotateBy)", []() -> Action*
+	{
+		return new Sequence({ new MoveBy(1000, Point(100, 100)), new RotateBy(1000, 90) });
+	});
+
+	Run<Node>("100k Spawn(MoveBy, ScaleBy, OpacityBy)", []() -> Action*
+	{
+		return new Spawn({ new MoveBy(1000, Point(100, 100)), new ScaleBy(1000, 2), new OpacityBy(1000, -1) });
+	});
+
+	// 跳跃步骤不能转交，作为逐个执行的对照
+	Run<Node>("100k JumpBy (not lowered)", []() -> Action*
+	{
+		return new JumpBy(1000, Point(100, 0), 20, 10);
+	});
+}
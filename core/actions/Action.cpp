@@ -18,18 +18,27 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2daction.h"
+#include "../e2daction.h"
 
 easy2d::Action::Action() 
-	: running_(false)
+	: tag_(0)
+	, manager_index_(-1)
+	, tween_property_(-1)
+	, tween_index_(-1)
+	, running_(false)
 	, done_(false)
 	, initialized_(false)
 	, target_(nullptr)
+	, version_(0)
+	, program_(nullptr)
+	, runs_(nullptr)
 {
 }
 
 easy2d::Action::~Action()
 {
+	TweenManager::GetInstance()->Remove(this);
+	SafeRelease(program_);
 }
 
 bool easy2d::Action::IsRunning()
@@ -40,16 +49,31 @@ bool easy2d::Action::IsRunning()
 void easy2d::Action::Resume()
 {
 	running_ = true;
+
+	for (auto run = runs_; run; run = run->next_run_)
+	{
+		run->Resume();
+	}
 }
 
 void easy2d::Action::Pause()
 {
 	running_ = false;
+
+	for (auto run = runs_; run; run = run->next_run_)
+	{
+		run->Pause();
+	}
 }
 
 void easy2d::Action::Stop()
 {
 	done_ = true;
+
+	for (auto run = runs_; run; run = run->next_run_)
+	{
+		run->Stop();
+	}
 }
 
 const easy2d::String& easy2d::Action::GetName() const
@@ -60,6 +84,26 @@ const easy2d::String& easy2d::Action::GetName() const
 void easy2d::Action::SetName(const String& name)
 {
 	name_ = name;
+
+	for (auto run = runs_; run; run = run->next_run_)
+	{
+		run->SetName(name);
+	}
+}
+
+int easy2d::Action::GetTag() const
+{
+	return tag_;
+}
+
+void easy2d::Action::SetTag(int tag)
+{
+	tag_ = tag;
+
+	for (auto run = runs_; run; run = run->next_run_)
+	{
+		run->SetTag(tag);
+	}
 }
 
 easy2d::Node * easy2d::Action::GetTarget()
@@ -71,7 +115,7 @@ void easy2d::Action::Reset()
 {
 	initialized_ = false;
 	done_ = false;
-	started_ = Time::Now();
+	started_ = GetTime();
 }
 
 bool easy2d::Action::IsDone() const
@@ -79,6 +123,32 @@ bool easy2d::Action::IsDone() const
 	return done_;
 }
 
+easy2d::ActionProgram * easy2d::Action::GetProgram() const
+{
+	// 子动作的修改不会通知父动作，获取时比较子动作的版本号
+	if (program_ && program_->IsOutdated())
+	{
+		SafeRelease(program_);
+	}
+
+	if (!program_)
+	{
+		program_ = new ActionProgram(this);
+		program_->Retain();
+	}
+	return program_;
+}
+
+void easy2d::Action::InvalidateProgram()
+{
+	++version_;
+	SafeRelease(program_);
+}
+
+void easy2d::Action::UpdateTween(float progress, float eased)
+{
+}
+
 void easy2d::Action::StartWithTarget(Node* target)
 {
 	target_ = target;
@@ -89,7 +159,7 @@ void easy2d::Action::StartWithTarget(Node* target)
 void easy2d::Action::Init()
 {
 	initialized_ = true;
-	started_ = Time::Now();
+	started_ = GetTime();
 }
 
 void easy2d::Action::Update()
@@ -103,3 +173,14 @@ void easy2d::Action::Update()
 void easy2d::Action::ResetTime()
 {
 }
+
+easy2d::Time easy2d::Action::GetTime() const
+{
+	// 动作跟随执行目标的时钟，受目标的时间缩放和暂停影响
+	return target_ ? target_->GetTime() : Time::Now();
+}
+
+void easy2d::Action::Compile(ActionProgram * program) const
+{
+	program->AddStep(ActionProgram::StepType::Action, 0.f, program->AddAction(this));
+}
@@ -0,0 +1,183 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "../e2daction.h"
+
+easy2d::ActionManager * easy2d::ActionManager::GetInstance()
+{
+	static ActionManager instance;
+	return &instance;
+}
+
+easy2d::ActionManager::ActionManager()
+{
+}
+
+void easy2d::ActionManager::Add(Action * action)
+{
+	if (action && action->manager_index_ < 0)
+	{
+		action->manager_index_ = static_cast<int>(actions_.size());
+		actions_.push_back(action);
+	}
+}
+
+void easy2d::ActionManager::Remove(Action * action)
+{
+	if (action && action->manager_index_ >= 0)
+	{
+		// 更新过程中可能移除动作，这里只清空位置，在更新结束时统一整理
+		actions_[action->manager_index_] = nullptr;
+		action->manager_index_ = -1;
+		TweenManager::GetInstance()->Remove(action);
+	}
+}
+
+void easy2d::ActionManager::Update(Scene * scene)
+{
+	// 动作更新时新添加的动作从下一帧开始更新
+	const size_t count = actions_.size();
+	for (size_t i = 0; i < count; ++i)
+	{
+		Action * action = actions_[i];
+		// 已转交给补间管理器的动作不在这里更新
+		if (action &&
+			action->tween_index_ < 0 &&
+			action->target_->GetParentScene() == scene &&
+			action->IsRunning() &&
+			!action->IsDone())
+		{
+			action->Update();
+		}
+	}
+
+	// 移除已完成的动作
+	for (size_t i = 0; i < actions_.size();)
+	{
+		Action * action = actions_[i];
+		if (!action)
+		{
+			SwapRemove(i);
+		}
+		else if (action->IsDone())
+		{
+			SwapRemove(i);
+			action->manager_index_ = -1;
+			TweenManager::GetInstance()->Remove(action);
+
+			Node * target = action->target_;
+			auto& actions = target->actions_;
+			auto iter = std::find(actions.begin(), actions.end(), action);
+			if (iter != actions.end())
+			{
+				actions.erase(iter);
+				action->Release();
+			}
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
+
+void easy2d::ActionManager::Resume(const String& name)
+{
+	for (auto action : actions_)
+	{
+		if (action && action->GetName() == name)
+		{
+			action->Resume();
+		}
+	}
+}
+
+void easy2d::ActionManager::Pause(const String& name)
+{
+	for (auto action : actions_)
+	{
+		if (action && action->GetName() == name)
+		{
+			action->Pause();
+		}
+	}
+}
+
+void easy2d::ActionManager::Stop(const String& name)
+{
+	for (auto action : actions_)
+	{
+		if (action && action->GetName() == name)
+		{
+			action->Stop();
+		}
+	}
+}
+
+void easy2d::ActionManager::Resume(int tag)
+{
+	for (auto action : actions_)
+	{
+		if (action && action->tag_ == tag)
+		{
+			action->Resume();
+		}
+	}
+}
+
+void easy2d::ActionManager::Pause(int tag)
+{
+	for (auto action : actions_)
+	{
+		if (action && action->tag_ == tag)
+		{
+			action->Pause();
+		}
+	}
+}
+
+void easy2d::ActionManager::Stop(int tag)
+{
+	for (auto action : actions_)
+	{
+		if (action && action->tag_ == tag)
+		{
+			action->Stop();
+		}
+	}
+}
+
+size_t easy2d::ActionManager::GetCount() const
+{
+	return actions_.size();
+}
+
+void easy2d::ActionManager::SwapRemove(size_t index)
+{
+	Action * last = actions_.back();
+	actions_[index] = last;
+	actions_.pop_back();
+
+	if (last && index < actions_.size())
+	{
+		last->manager_index_ = static_cast<int>(index);
+	}
+}
@@ -0,0 +1,478 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "../e2daction.h"
+#include "../e2dobject.h"
+
+namespace
+{
+	// 一帧内最多完成的循环次数，落后更多时跳过整数次循环，避免回调在同一帧内重复触发
+	const int kMaxLoopIterations = 4;
+}
+
+easy2d::ActionProgram::ActionProgram(const Action * action)
+	: steps_()
+	, callbacks_()
+	, actions_()
+	, borrowed_()
+	, tween_funcs_()
+	, sources_()
+	, versions_()
+{
+	E2D_WARNING_IF(action == nullptr, "ActionProgram NULL pointer exception!");
+
+	if (action)
+	{
+		action->Compile(this);
+	}
+}
+
+easy2d::ActionProgram::~ActionProgram()
+{
+	for (size_t i = 0; i < actions_.size(); ++i)
+	{
+		if (!borrowed_[i])
+		{
+			SafeRelease(actions_[i]);
+		}
+	}
+}
+
+size_t easy2d::ActionProgram::GetStepCount() const
+{
+	return steps_.size();
+}
+
+int easy2d::ActionProgram::AddStep(StepType type, float duration, int param, float x, float y, float z)
+{
+	Step step;
+	step.type = type;
+	step.end = static_cast<int>(steps_.size()) + 1;
+	step.param = param;
+	step.duration = std::max(duration, 0.f);
+	step.values[0] = x;
+	step.values[1] = y;
+	step.values[2] = z;
+	step.ease = Ease::Linear;
+	steps_.push_back(step);
+	return step.end - 1;
+}
+
+void easy2d::ActionProgram::SetEase(int index, Ease ease)
+{
+	steps_[index].ease = ease;
+}
+
+void easy2d::ActionProgram::EndStep(int index)
+{
+	steps_[index].end = static_cast<int>(steps_.size());
+}
+
+int easy2d::ActionProgram::AddCallback(const Function& func)
+{
+	callbacks_.push_back(func);
+	return static_cast<int>(callbacks_.size()) - 1;
+}
+
+int easy2d::ActionProgram::AddAction(const Action * action)
+{
+	// 保存拷贝，编译后原动作的改变不会影响程序
+	Action * copy = action->Clone();
+	if (copy && typeid(*copy) != typeid(*action))
+	{
+		// 派生的动作没有重写 Clone，拷贝会丢失重写的 Init 和 Update，只能直接执行原动作
+		// 原动作由父动作或 RunProgram 持有，程序不增加引用，避免与 Action::program_ 循环引用
+		delete copy;
+		actions_.push_back(const_cast<Action*>(action));
+		borrowed_.push_back(true);
+		tween_funcs_.push_back(nullptr);
+		return static_cast<int>(actions_.size()) - 1;
+	}
+
+	if (copy)
+	{
+		copy->Retain();
+	}
+	actions_.push_back(copy);
+	borrowed_.push_back(false);
+	tween_funcs_.push_back(nullptr);
+	return static_cast<int>(actions_.size()) - 1;
+}
+
+int easy2d::ActionProgram::AddTween(const Action * tween, TweenFunc func)
+{
+	// 补间的拷贝只保存属性值和设置器，所有执行目标共享
+	int index = AddAction(tween);
+	tween_funcs_[index] = func;
+	return index;
+}
+
+void easy2d::ActionProgram::Compile(const Action * action)
+{
+	sources_.push_back(action);
+	versions_.push_back(action->version_);
+	action->Compile(this);
+}
+
+bool easy2d::ActionProgram::IsOutdated() const
+{
+	for (size_t i = 0; i < sources_.size(); ++i)
+	{
+		if (sources_[i]->version_ != versions_[i])
+			return true;
+	}
+	return false;
+}
+
+easy2d::TweenManager::Property easy2d::ActionProgram::GetTweenProperty(StepType type)
+{
+	switch (type)
+	{
+	case StepType::MoveBy:
+	case StepType::MoveTo:
+		return TweenManager::Property::Position;
+	case StepType::ScaleBy:
+	case StepType::ScaleTo:
+		return TweenManager::Property::Scale;
+	case StepType::RotateBy:
+	case StepType::RotateTo:
+		return TweenManager::Property::Rotation;
+	case StepType::OpacityBy:
+	case StepType::OpacityTo:
+		return TweenManager::Property::Opacity;
+	default:
+		return TweenManager::Property::Count;
+	}
+}
+
+void easy2d::ActionProgram::Run(int index, float elapsed, State * states, Node * target, Action * owner) const
+{
+	const Step& step = steps_[index];
+	State& state = states[index];
+
+	if (state.finished)
+		return;
+
+	switch (step.type)
+	{
+	case StepType::Sequence:
+	{
+		// 子步骤结束时的实际时长决定下一个子步骤的开始时间，多出的时间不会丢失
+		float offset = 0;
+		for (int child = index + 1; child < step.end; child = steps_[child].end)
+		{
+			Run(child, elapsed - offset, states, target, owner);
+			if (!states[child].finished)
+				return;
+			offset += states[child].length;
+		}
+		state.finished = true;
+		state.length = offset;
+		break;
+	}
+
+	case StepType::Spawn:
+	{
+		bool finished = true;
+		float length = 0;
+		for (int child = index + 1; child < step.end; child = steps_[child].end)
+		{
+			Run(child, elapsed, states, target, owner);
+			if (states[child].finished)
+			{
+				length = std::max(length, states[child].length);
+			}
+			else
+			{
+				finished = false;
+			}
+		}
+
+		if (finished)
+		{
+			state.finished = true;
+			state.length = length;
+		}
+		break;
+	}
+
+	case StepType::Loop:
+	{
+		const int child = index + 1;
+		for (int completed = 0;; ++completed)
+		{
+			if (step.param >= 0 && state.iteration >= step.param)
+			{
+				state.finished = true;
+				state.length = state.offset;
+				break;
+			}
+
+			Run(child, elapsed - state.offset, states, target, owner);
+			if (!states[child].finished)
+				break;
+
+			const float length = states[child].length;
+			++state.iteration;
+			state.offset += length;
+			ResetStates(child, states);
+
+			// 时长为零的循环每帧只执行一次
+			if (length <= 0 && (step.param < 0 || state.iteration < step.param))
+				break;
+
+			if (completed + 1 >= kMaxLoopIterations && length > 0)
+			{
+				// 时间大幅跳跃后，跳过的循环不再执行其中的步骤，只保留不足一次的剩余时间
+				int skipped = static_cast<int>((elapsed - state.offset) / length);
+				if (step.param >= 0)
+				{
+					skipped = std::min(skipped, step.param - state.iteration);
+				}
+
+				if (skipped > 0)
+				{
+					state.iteration += skipped;
+					state.offset += length * skipped;
+				}
+
+				if (step.param >= 0 && state.iteration >= step.param)
+				{
+					state.finished = true;
+					state.length = state.offset;
+				}
+				else
+				{
+					// 剩余时间属于下一次循环，子步骤在下一帧结算
+					Run(child, elapsed - state.offset, states, target, owner);
+				}
+				break;
+			}
+		}
+		break;
+	}
+
+	case StepType::Delay:
+		if (elapsed >= step.duration)
+		{
+			state.finished = true;
+			state.length = step.duration;
+		}
+		break;
+
+	case StepType::Callback:
+		state.finished = true;
+		state.length = 0;
+		callbacks_[step.param]();
+		break;
+
+	case StepType::Tween:
+	{
+		float progress = step.duration > 0 ? std::min(elapsed / step.duration, 1.f) : 1.f;
+		tween_funcs_[step.param](actions_[step.param], target, TweenManager::Evaluate(step.ease, progress));
+
+		if (progress >= 1)
+		{
+			state.finished = true;
+			state.length = step.duration;
+		}
+		break;
+	}
+
+	case StepType::Action:
+	{
+		Action * prototype = actions_[step.param];
+		if (!state.action && prototype)
+		{
+			// 借用的动作同一时间只能在一个节点上执行
+			state.action = borrowed_[step.param] ? prototype : prototype->Clone();
+			state.action->Retain();
+			state.action->StartWithTarget(target);
+		}
+
+		if (state.action)
+		{
+			state.action->Update();
+		}
+
+		if (!state.action || state.action->IsDone())
+		{
+			state.finished = true;
+			state.length = elapsed;
+		}
+		break;
+	}
+
+	default:
+	{
+		if (!state.begun)
+		{
+			Begin(step, state, target);
+			state.begun = true;
+		}
+
+		float progress = step.duration > 0 ? std::min(elapsed / step.duration, 1.f) : 1.f;
+		const TweenManager::Property property = GetTweenProperty(step.type);
+
+		if (state.tween >= 0)
+		{
+			// 已转交的步骤只更新时间，由补间管理器在本帧批量计算并写回
+			if (progress < 1)
+			{
+				TweenManager::GetInstance()->SetElapsed(property, state.tween, elapsed);
+				break;
+			}
+
+			// 最后一帧在这里写回，之后的步骤开始时能读取到结束时的值
+			TweenManager::GetInstance()->Remove(property, &state.tween);
+		}
+
+		Apply(step, state, target, TweenManager::Evaluate(step.ease, progress));
+
+		if (progress >= 1)
+		{
+			state.finished = true;
+			state.length = step.duration;
+		}
+		else if (owner && owner->manager_index_ >= 0 && property != TweenManager::Property::Count)
+		{
+			TweenManager::GetInstance()->Add(owner, &state.tween, state.values, property, step.ease, step.duration, progress);
+		}
+		break;
+	}
+	}
+}
+
+void easy2d::ActionProgram::Begin(const Step& step, State& state, Node * target) const
+{
+	float * values = state.values;
+	switch (step.type)
+	{
+	case StepType::MoveBy:
+	case StepType::MoveTo:
+	case StepType::JumpBy:
+	case StepType::JumpTo:
+	{
+		Point pos = target->GetPosition();
+		values[0] = values[2] = pos.x;
+		values[1] = values[3] = pos.y;
+
+		const bool to = (step.type == StepType::MoveTo || step.type == StepType::JumpTo);
+		values[4] = to ? step.values[0] - pos.x : step.values[0];
+		values[5] = to ? step.values[1] - pos.y : step.values[1];
+		break;
+	}
+
+	case StepType::ScaleBy:
+	case StepType::ScaleTo:
+		values[0] = target->GetScaleX();
+		values[1] = target->GetScaleY();
+		values[4] = step.type == StepType::ScaleTo ? step.values[0] - values[0] : step.values[0];
+		values[5] = step.type == StepType::ScaleTo ? step.values[1] - values[1] : step.values[1];
+		break;
+
+	case StepType::OpacityBy:
+	case StepType::OpacityTo:
+		values[0] = target->GetOpacity();
+		values[4] = step.type == StepType::OpacityTo ? step.values[0] - values[0] : step.values[0];
+		break;
+
+	case StepType::RotateBy:
+	case StepType::RotateTo:
+		values[0] = target->GetRotation();
+		values[4] = step.type == StepType::RotateTo ? step.values[0] - values[0] : step.values[0];
+		break;
+
+	default:
+		break;
+	}
+}
+
+void easy2d::ActionProgram::Apply(const Step& step, State& state, Node * target, float progress) const
+{
+	float * values = state.values;
+	switch (step.type)
+	{
+	case StepType::MoveBy:
+	case StepType::MoveTo:
+	case StepType::JumpBy:
+	case StepType::JumpTo:
+	{
+		float x = values[4] * progress;
+		float y = values[5] * progress;
+		if (step.type == StepType::JumpBy || step.type == StepType::JumpTo)
+		{
+			float frac = fmod(progress * step.param, 1.f);
+			y += step.values[2] * 4 * frac * (1 - frac);
+		}
+
+		// 与 MoveBy 相同，叠加执行期间其他方式造成的位移
+		Point pos = target->GetPosition();
+		values[0] += pos.x - values[2];
+		values[1] += pos.y - values[3];
+
+		values[2] = values[0] + x;
+		values[3] = values[1] + y;
+		target->SetPosition(values[2], values[3]);
+		break;
+	}
+
+	case StepType::ScaleBy:
+	case StepType::ScaleTo:
+		target->SetScale(values[0] + values[4] * progress, values[1] + values[5] * progress);
+		break;
+
+	case StepType::OpacityBy:
+	case StepType::OpacityTo:
+		target->SetOpacity(values[0] + values[4] * progress);
+		break;
+
+	case StepType::RotateBy:
+	case StepType::RotateTo:
+		target->SetRotation(values[0] + values[4] * progress);
+		break;
+
+	default:
+		break;
+	}
+}
+
+void easy2d::ActionProgram::ResetStates(int index, State * states) const
+{
+	for (int i = index; i < steps_[index].end; ++i)
+	{
+		State& state = states[i];
+		if (state.tween >= 0)
+		{
+			TweenManager::GetInstance()->Remove(GetTweenProperty(steps_[i].type), &state.tween);
+		}
+
+		state.begun = false;
+		state.finished = false;
+		state.iteration = 0;
+		state.offset = 0;
+		state.length = 0;
+
+		if (state.action)
+		{
+			state.action->Reset();
+		}
+	}
+}
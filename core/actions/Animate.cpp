@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2daction.h"
-#include "..\e2dobject.h"
+#include "../e2daction.h"
+#include "../e2dobject.h"
 
 easy2d::Animate::Animate() 
 	: frame_index_(0)
@@ -55,6 +55,7 @@ void easy2d::Animate::SetAnimation(Animation * animation)
 		animation_ = animation;
 		animation_->Retain();
 		frame_index_ = 0;
+		InvalidateProgram();
 	}
 }
 
@@ -80,7 +81,8 @@ void easy2d::Animate::Update()
 		return;
 	}
 
-	while ((Time::Now() - started_).Seconds() >= animation_->GetInterval())
+	const Duration interval(animation_->GetInterval());
+	while (GetTime() - started_ >= interval)
 	{
 		auto& frames = animation_->GetFrames();
 		auto target = dynamic_cast<Sprite*>(target_);
@@ -90,7 +92,7 @@ void easy2d::Animate::Update()
 			target->Load(frames[frame_index_]);
 		}
 
-		started_ += Duration(animation_->GetInterval());
+		started_ += interval;
 		++frame_index_;
 
 		if (frame_index_ == frames.size())
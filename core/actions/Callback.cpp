@@ -18,7 +18,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2daction.h"
+#include "../e2daction.h"
 
 easy2d::Callback::Callback(const Function& func) :
 	callback_(func)
@@ -44,3 +44,15 @@ void easy2d::Callback::Update()
 	callback_();
 	this->Stop();
 }
+
+void easy2d::Callback::Compile(ActionProgram * program) const
+{
+	// 派生的动作可能重写了 Init 和 Update，只能按普通动作执行
+	if (typeid(*this) != typeid(Callback))
+	{
+		Action::Compile(program);
+		return;
+	}
+
+	program->AddStep(ActionProgram::StepType::Callback, 0.f, program->AddCallback(callback_));
+}
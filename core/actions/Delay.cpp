@@ -18,7 +18,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2daction.h"
+#include "../e2daction.h"
 
 easy2d::Delay::Delay(float duration)
 	: delta_(0)
@@ -51,7 +51,7 @@ void easy2d::Delay::Update()
 {
 	Action::Update();
 
-	delta_ = (Time::Now() - started_).Seconds();
+	delta_ = (GetTime() - started_).Seconds();
 
 	if (delta_ >= delay_)
 	{
@@ -62,5 +62,17 @@ void easy2d::Delay::Update()
 void easy2d::Delay::ResetTime()
 {
 	Action::ResetTime();
-	started_ = Time::Now() - Duration(delta_);
+	started_ = GetTime() - Duration(delta_);
+}
+
+void easy2d::Delay::Compile(ActionProgram * program) const
+{
+	// 派生的动作可能重写了 Init 和 Update，只能按普通动作执行
+	if (typeid(*this) != typeid(Delay))
+	{
+		Action::Compile(program);
+		return;
+	}
+
+	program->AddStep(ActionProgram::StepType::Delay, delay_);
 }
@@ -18,7 +18,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2daction.h"
+#include "../e2daction.h"
 
 easy2d::FadeIn::FadeIn(float duration)
 	: OpacityTo(duration, 1)
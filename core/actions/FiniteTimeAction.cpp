@@ -18,18 +18,37 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2daction.h"
+#include "../e2daction.h"
 
 easy2d::FiniteTimeAction::FiniteTimeAction(float duration)
 	: delta_(0)
+	, eased_(0)
+	, ease_(Ease::Linear)
 	, duration_(std::max(duration, 0.f))
 {
 }
 
+easy2d::FiniteTimeAction::~FiniteTimeAction()
+{
+}
+
+void easy2d::FiniteTimeAction::SetEase(Ease ease)
+{
+	ease_ = ease;
+	InvalidateProgram();
+}
+
+easy2d::Ease easy2d::FiniteTimeAction::GetEase() const
+{
+	return ease_;
+}
+
 void easy2d::FiniteTimeAction::Reset()
 {
+	TweenManager::GetInstance()->Remove(this);
 	Action::Reset();
 	delta_ = 0;
+	eased_ = 0;
 }
 
 void easy2d::FiniteTimeAction::Init()
@@ -48,17 +67,18 @@ void easy2d::FiniteTimeAction::Update()
 	}
 	else
 	{
-		delta_ = std::min((Time::Now() - started_).Seconds() / duration_, 1.f);
+		delta_ = std::min((GetTime() - started_).Seconds() / duration_, 1.f);
 
 		if (delta_ >= 1)
 		{
 			this->Stop();
 		}
 	}
+	eased_ = TweenManager::Evaluate(ease_, delta_);
 }
 
 void easy2d::FiniteTimeAction::ResetTime()
 {
 	Action::ResetTime();
-	started_ = Time::Now() - Duration(delta_ * duration_);
+	started_ = GetTime() - Duration(delta_ * duration_);
 }
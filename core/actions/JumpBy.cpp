@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2daction.h"
-#include "..\e2dobject.h"
+#include "../e2daction.h"
+#include "../e2dobject.h"
 
 easy2d::JumpBy::JumpBy(float duration, const Point & vec, float height, int jumps)
 	: FiniteTimeAction(duration)
@@ -31,12 +31,16 @@ easy2d::JumpBy::JumpBy(float duration, const Point & vec, float height, int jump
 
 easy2d::JumpBy * easy2d::JumpBy::Clone() const
 {
-	return new JumpBy(duration_, delta_pos_, height_, jumps_);
+	auto action = new JumpBy(duration_, delta_pos_, height_, jumps_);
+	action->SetEase(ease_);
+	return action;
 }
 
 easy2d::JumpBy * easy2d::JumpBy::Reverse() const
 {
-	return new JumpBy(duration_, -delta_pos_, height_, jumps_);
+	auto action = new JumpBy(duration_, -delta_pos_, height_, jumps_);
+	action->SetEase(ease_);
+	return action;
 }
 
 void easy2d::JumpBy::Init()
@@ -55,10 +59,10 @@ void easy2d::JumpBy::Update()
 
 	if (target_)
 	{
-		float frac = fmod(delta_ * jumps_, 1.f);
-		float x = delta_pos_.x * delta_;
+		float frac = fmod(eased_ * jumps_, 1.f);
+		float x = delta_pos_.x * eased_;
 		float y = height_ * 4 * frac * (1 - frac);
-		y += delta_pos_.y * delta_;
+		y += delta_pos_.y * eased_;
 
 		Point currentPos = target_->GetPosition();
 
@@ -71,3 +75,16 @@ void easy2d::JumpBy::Update()
 		prev_pos_ = newPos;
 	}
 }
+
+void easy2d::JumpBy::Compile(ActionProgram * program) const
+{
+	// 派生的动作可能重写了 Init 和 Update，只能按普通动作执行
+	if (typeid(*this) != typeid(JumpBy))
+	{
+		Action::Compile(program);
+		return;
+	}
+
+	int index = program->AddStep(ActionProgram::StepType::JumpBy, duration_, jumps_, delta_pos_.x, delta_pos_.y, height_);
+	program->SetEase(index, ease_);
+}
@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2daction.h"
-#include "..\e2dobject.h"
+#include "../e2daction.h"
+#include "../e2dobject.h"
 
 easy2d::JumpTo::JumpTo(float duration, const Point & pos, float height, int jumps)
 	: JumpBy(duration, Point(), height, jumps)
@@ -29,7 +29,9 @@ easy2d::JumpTo::JumpTo(float duration, const Point & pos, float height, int jump
 
 easy2d::JumpTo * easy2d::JumpTo::Clone() const
 {
-	return new JumpTo(duration_, end_pos_, height_, jumps_);
+	auto action = new JumpTo(duration_, end_pos_, height_, jumps_);
+	action->SetEase(ease_);
+	return action;
 }
 
 void easy2d::JumpTo::Init()
@@ -37,3 +39,16 @@ void easy2d::JumpTo::Init()
 	JumpBy::Init();
 	delta_pos_ = end_pos_ - start_pos_;
 }
+
+void easy2d::JumpTo::Compile(ActionProgram * program) const
+{
+	// 派生的动作可能重写了 Init 和 Update，只能按普通动作执行
+	if (typeid(*this) != typeid(JumpTo))
+	{
+		Action::Compile(program);
+		return;
+	}
+
+	int index = program->AddStep(ActionProgram::StepType::JumpTo, duration_, jumps_, end_pos_.x, end_pos_.y, height_);
+	program->SetEase(index, ease_);
+}
@@ -18,7 +18,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2daction.h"
+#include "../e2daction.h"
 
 easy2d::Loop::Loop(Action * action, int times /* = -1 */)
 	: action_(action)
@@ -43,7 +43,7 @@ easy2d::Loop * easy2d::Loop::Clone() const
 {
 	if (action_)
 	{
-		return new Loop(action_->Clone());
+		return new Loop(action_->Clone(), total_times_);
 	}
 	else
 	{
@@ -55,7 +55,7 @@ easy2d::Loop * easy2d::Loop::Reverse() const
 {
 	if (action_)
 	{
-		return new Loop(action_->Clone());
+		return new Loop(action_->Clone(), total_times_);
 	}
 	else
 	{
@@ -114,3 +114,25 @@ void easy2d::Loop::ResetTime()
 {
 	if (action_) action_->ResetTime();
 }
+
+void easy2d::Loop::Compile(ActionProgram * program) const
+{
+	// 派生的动作可能重写了 Init 和 Update，只能按普通动作执行
+	if (typeid(*this) != typeid(Loop))
+	{
+		Action::Compile(program);
+		return;
+	}
+
+	int index = program->AddStep(ActionProgram::StepType::Loop, 0.f, total_times_);
+	if (action_)
+	{
+		program->Compile(action_);
+	}
+	else
+	{
+		// 空循环立即结束
+		program->AddStep(ActionProgram::StepType::Delay, 0.f);
+	}
+	program->EndStep(index);
+}
@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2daction.h"
-#include "..\e2dobject.h"
+#include "../e2daction.h"
+#include "../e2dobject.h"
 
 
 easy2d::MoveBy::MoveBy(float duration, Point vector)
@@ -48,7 +48,7 @@ void easy2d::MoveBy::Update()
 		Point diff = currentPos - prev_pos_;
 		start_pos_ = start_pos_ + diff;
 
-		Point newPos = start_pos_ + (delta_pos_ * delta_);
+		Point newPos = start_pos_ + (delta_pos_ * eased_);
 		target_->SetPosition(newPos);
 
 		prev_pos_ = newPos;
@@ -57,10 +57,27 @@ void easy2d::MoveBy::Update()
 
 easy2d::MoveBy * easy2d::MoveBy::Clone() const
 {
-	return new MoveBy(duration_, delta_pos_);
+	auto action = new MoveBy(duration_, delta_pos_);
+	action->SetEase(ease_);
+	return action;
 }
 
 easy2d::MoveBy * easy2d::MoveBy::Reverse() const
 {
-	return new MoveBy(duration_, -delta_pos_);
-}
\ No newline at end of file
+	auto action = new MoveBy(duration_, -delta_pos_);
+	action->SetEase(ease_);
+	return action;
+}
+
+void easy2d::MoveBy::Compile(ActionProgram * program) const
+{
+	// 派生的动作可能重写了 Init 和 Update，只能按普通动作执行
+	if (typeid(*this) != typeid(MoveBy))
+	{
+		Action::Compile(program);
+		return;
+	}
+
+	int index = program->AddStep(ActionProgram::StepType::MoveBy, duration_, 0, delta_pos_.x, delta_pos_.y);
+	program->SetEase(index, ease_);
+}
@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2daction.h"
-#include "..\e2dobject.h"
+#include "../e2daction.h"
+#include "../e2dobject.h"
 
 easy2d::MoveTo::MoveTo(float duration, Point pos)
 	: MoveBy(duration, Point())
@@ -29,7 +29,9 @@ easy2d::MoveTo::MoveTo(float duration, Point pos)
 
 easy2d::MoveTo * easy2d::MoveTo::Clone() const
 {
-	return new MoveTo(duration_, end_pos_);
+	auto action = new MoveTo(duration_, end_pos_);
+	action->SetEase(ease_);
+	return action;
 }
 
 void easy2d::MoveTo::Init()
@@ -37,3 +39,16 @@ void easy2d::MoveTo::Init()
 	MoveBy::Init();
 	delta_pos_ = end_pos_ - start_pos_;
 }
+
+void easy2d::MoveTo::Compile(ActionProgram * program) const
+{
+	// 派生的动作可能重写了 Init 和 Update，只能按普通动作执行
+	if (typeid(*this) != typeid(MoveTo))
+	{
+		Action::Compile(program);
+		return;
+	}
+
+	int index = program->AddStep(ActionProgram::StepType::MoveTo, duration_, 0, end_pos_.x, end_pos_.y);
+	program->SetEase(index, ease_);
+}
@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2daction.h"
-#include "..\e2dobject.h"
+#include "../e2daction.h"
+#include "../e2dobject.h"
 
 
 easy2d::OpacityBy::OpacityBy(float duration, float opacity)
@@ -44,16 +44,33 @@ void easy2d::OpacityBy::Update()
 
 	if (target_)
 	{
-		target_->SetOpacity(start_val_ + delta_val_ * delta_);
+		target_->SetOpacity(start_val_ + delta_val_ * eased_);
 	}
 }
 
 easy2d::OpacityBy * easy2d::OpacityBy::Clone() const
 {
-	return new OpacityBy(duration_, delta_val_);
+	auto action = new OpacityBy(duration_, delta_val_);
+	action->SetEase(ease_);
+	return action;
 }
 
 easy2d::OpacityBy * easy2d::OpacityBy::Reverse() const
 {
-	return new OpacityBy(duration_, -delta_val_);
-}
\ No newline at end of file
+	auto action = new OpacityBy(duration_, -delta_val_);
+	action->SetEase(ease_);
+	return action;
+}
+
+void easy2d::OpacityBy::Compile(ActionProgram * program) const
+{
+	// 派生的动作可能重写了 Init 和 Update，只能按普通动作执行
+	if (typeid(*this) != typeid(OpacityBy))
+	{
+		Action::Compile(program);
+		return;
+	}
+
+	int index = program->AddStep(ActionProgram::StepType::OpacityBy, duration_, 0, delta_val_);
+	program->SetEase(index, ease_);
+}
@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2daction.h"
-#include "..\e2dobject.h"
+#include "../e2daction.h"
+#include "../e2dobject.h"
 
 
 easy2d::OpacityTo::OpacityTo(float duration, float opacity)
@@ -30,7 +30,9 @@ easy2d::OpacityTo::OpacityTo(float duration, float opacity)
 
 easy2d::OpacityTo * easy2d::OpacityTo::Clone() const
 {
-	return new OpacityTo(duration_, end_val_);
+	auto action = new OpacityTo(duration_, end_val_);
+	action->SetEase(ease_);
+	return action;
 }
 
 void easy2d::OpacityTo::Init()
@@ -38,3 +40,19 @@ void easy2d::OpacityTo::Init()
 	OpacityBy::Init();
 	delta_val_ = end_val_ - start_val_;
 }
+
+void easy2d::OpacityTo::Compile(ActionProgram * program) const
+{
+	// 派生的动作可能重写了 Init 和 Update，只能按普通动作执行
+	// FadeIn 和 FadeOut 只设置了目标透明度
+	if (typeid(*this) != typeid(OpacityTo) &&
+		typeid(*this) != typeid(FadeIn) &&
+		typeid(*this) != typeid(FadeOut))
+	{
+		Action::Compile(program);
+		return;
+	}
+
+	int index = program->AddStep(ActionProgram::StepType::OpacityTo, duration_, 0, end_val_);
+	program->SetEase(index, ease_);
+}
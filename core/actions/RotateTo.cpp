@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2daction.h"
-#include "..\e2dobject.h"
+#include "../e2daction.h"
+#include "../e2dobject.h"
 
 
 easy2d::RotateTo::RotateTo(float duration, float rotation)
@@ -30,7 +30,9 @@ easy2d::RotateTo::RotateTo(float duration, float rotation)
 
 easy2d::RotateTo * easy2d::RotateTo::Clone() const
 {
-	return new RotateTo(duration_, end_val_);
+	auto action = new RotateTo(duration_, end_val_);
+	action->SetEase(ease_);
+	return action;
 }
 
 void easy2d::RotateTo::Init()
@@ -38,3 +40,16 @@ void easy2d::RotateTo::Init()
 	RotateBy::Init();
 	delta_val_ = end_val_ - start_val_;
 }
+
+void easy2d::RotateTo::Compile(ActionProgram * program) const
+{
+	// 派生的动作可能重写了 Init 和 Update，只能按普通动作执行
+	if (typeid(*this) != typeid(RotateTo))
+	{
+		Action::Compile(program);
+		return;
+	}
+
+	int index = program->AddStep(ActionProgram::StepType::RotateTo, duration_, 0, end_val_);
+	program->SetEase(index, ease_);
+}
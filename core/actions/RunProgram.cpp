@@ -0,0 +1,227 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "../e2daction.h"
+
+easy2d::RunProgram::RunProgram(ActionProgram * program, Action * source)
+	: elapsed_(0)
+	, state_count_(0)
+	, states_(nullptr)
+	, source_(source)
+	, next_run_(nullptr)
+{
+	E2D_WARNING_IF(program == nullptr, "RunProgram NULL pointer exception!");
+
+	// 执行的程序即是该动作编译后的程序
+	if (program)
+	{
+		program_ = program;
+		program_->Retain();
+	}
+
+	// 名称和标签与定义相同，定义的控制操作转发给它的所有执行
+	if (source_)
+	{
+		source_->Retain();
+		name_ = source_->GetName();
+		tag_ = source_->GetTag();
+		next_run_ = source_->runs_;
+		source_->runs_ = this;
+	}
+}
+
+easy2d::RunProgram::~RunProgram()
+{
+	ClearStates();
+
+	if (source_)
+	{
+		RunProgram ** link = &source_->runs_;
+		while (*link != this)
+		{
+			link = &(*link)->next_run_;
+		}
+		*link = next_run_;
+
+		// 执行目标可能随执行一起销毁，不再作为定义的执行目标
+		if (source_->target_ == target_)
+		{
+			source_->target_ = source_->runs_ ? source_->runs_->target_ : nullptr;
+		}
+		UpdateSource();
+		SafeRelease(source_);
+	}
+}
+
+easy2d::RunProgram * easy2d::RunProgram::Clone() const
+{
+	return new RunProgram(program_, source_);
+}
+
+easy2d::ActionProgram * easy2d::RunProgram::GetProgram() const
+{
+	return program_;
+}
+
+easy2d::Action * easy2d::RunProgram::GetSource() const
+{
+	return source_;
+}
+
+void easy2d::RunProgram::Stop()
+{
+	Action::Stop();
+	UpdateSource();
+}
+
+void easy2d::RunProgram::StartWithTarget(Node * target)
+{
+	Action::StartWithTarget(target);
+
+	if (source_)
+	{
+		source_->target_ = target;
+		source_->running_ = true;
+		source_->done_ = false;
+	}
+}
+
+void easy2d::RunProgram::Reset()
+{
+	TweenManager::GetInstance()->Remove(this);
+	Action::Reset();
+	elapsed_ = 0;
+
+	if (states_)
+	{
+		program_->ResetStates(0, states_);
+	}
+}
+
+void easy2d::RunProgram::Init()
+{
+	Action::Init();
+
+	if (program_ && !states_ && program_->GetStepCount() > 0)
+	{
+		// 每次执行只从内存池中分配一块步骤状态
+		state_count_ = program_->GetStepCount();
+		states_ = static_cast<ActionProgram::State*>(MemoryPool::Allocate(sizeof(ActionProgram::State) * state_count_));
+
+		ActionProgram::State state = { false, false, 0, 0, 0, { 0 }, nullptr, -1 };
+		std::fill(states_, states_ + state_count_, state);
+	}
+}
+
+void easy2d::RunProgram::Update()
+{
+	Action::Update();
+
+	if (!states_ || !target_)
+	{
+		this->Stop();
+		return;
+	}
+
+	elapsed_ = (GetTime() - started_).Seconds();
+
+	// 只有单个步骤时整个动作转交给补间管理器，组合动作中的补间步骤逐个转交
+	program_->Run(0, elapsed_, states_, target_, state_count_ > 1 ? this : nullptr);
+
+	if (states_[0].finished)
+	{
+		this->Stop();
+	}
+	else
+	{
+		LowerToTween();
+	}
+}
+
+void easy2d::RunProgram::ResetTime()
+{
+	Action::ResetTime();
+	started_ = GetTime() - Duration(elapsed_);
+}
+
+void easy2d::RunProgram::UpdateTween(float progress, float eased)
+{
+	const float duration = program_->steps_[0].duration;
+	elapsed_ = progress * duration;
+
+	if (progress >= 1)
+	{
+		states_[0].finished = true;
+		states_[0].length = duration;
+	}
+}
+
+void easy2d::RunProgram::LowerToTween()
+{
+	// 组合动作中的补间步骤由程序逐个转交，添加到动作管理器之外的执行不能转交
+	if (manager_index_ < 0 || tween_index_ >= 0 || state_count_ != 1 || !states_[0].begun)
+		return;
+
+	const ActionProgram::Step& step = program_->steps_[0];
+	if (step.duration <= 0)
+		return;
+
+	const TweenManager::Property property = ActionProgram::GetTweenProperty(step.type);
+	if (property == TweenManager::Property::Count)
+		return;
+
+	// 起始值和变化量在步骤开始时已经确定，与程序中的补间步骤结果一致
+	const float * values = states_[0].values;
+	const float start[] = { values[0], values[1] };
+	const float delta[] = { values[4], values[5] };
+	const float progress = std::min(elapsed_ / step.duration, 1.f);
+	TweenManager::GetInstance()->Add(this, property, step.ease, step.duration, progress, start, delta);
+}
+
+void easy2d::RunProgram::UpdateSource()
+{
+	if (!source_)
+		return;
+
+	for (auto run = source_->runs_; run; run = run->next_run_)
+	{
+		if (!run->done_)
+			return;
+	}
+	source_->done_ = true;
+}
+
+void easy2d::RunProgram::ClearStates()
+{
+	if (states_)
+	{
+		for (size_t i = 0; i < state_count_; ++i)
+		{
+			if (states_[i].tween >= 0)
+			{
+				TweenManager::GetInstance()->Remove(ActionProgram::GetTweenProperty(program_->steps_[i].type), &states_[i].tween);
+			}
+			SafeRelease(states_[i].action);
+		}
+		MemoryPool::Free(states_, sizeof(ActionProgram::State) * state_count_);
+		states_ = nullptr;
+		state_count_ = 0;
+	}
+}
@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2daction.h"
-#include "..\e2dobject.h"
+#include "../e2daction.h"
+#include "../e2dobject.h"
 
 
 easy2d::ScaleBy::ScaleBy(float duration, float scale)
@@ -53,16 +53,33 @@ void easy2d::ScaleBy::Update()
 
 	if (target_)
 	{
-		target_->SetScale(start_scale_x_ + delta_x_ * delta_, start_scale_y_ + delta_y_ * delta_);
+		target_->SetScale(start_scale_x_ + delta_x_ * eased_, start_scale_y_ + delta_y_ * eased_);
 	}
 }
 
 easy2d::ScaleBy * easy2d::ScaleBy::Clone() const
 {
-	return new ScaleBy(duration_, delta_x_, delta_y_);
+	auto action = new ScaleBy(duration_, delta_x_, delta_y_);
+	action->SetEase(ease_);
+	return action;
 }
 
 easy2d::ScaleBy * easy2d::ScaleBy::Reverse() const
 {
-	return new ScaleBy(duration_, -delta_x_, -delta_y_);
-}
\ No newline at end of file
+	auto action = new ScaleBy(duration_, -delta_x_, -delta_y_);
+	action->SetEase(ease_);
+	return action;
+}
+
+void easy2d::ScaleBy::Compile(ActionProgram * program) const
+{
+	// 派生的动作可能重写了 Init 和 Update，只能按普通动作执行
+	if (typeid(*this) != typeid(ScaleBy))
+	{
+		Action::Compile(program);
+		return;
+	}
+
+	int index = program->AddStep(ActionProgram::StepType::ScaleBy, duration_, 0, delta_x_, delta_y_);
+	program->SetEase(index, ease_);
+}
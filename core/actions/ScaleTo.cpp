@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2daction.h"
-#include "..\e2dobject.h"
+#include "../e2daction.h"
+#include "../e2dobject.h"
 
 easy2d::ScaleTo::ScaleTo(float duration, float scale)
 	: ScaleBy(duration, 0, 0)
@@ -37,7 +37,9 @@ easy2d::ScaleTo::ScaleTo(float duration, float scale_x, float scale_y)
 
 easy2d::ScaleTo * easy2d::ScaleTo::Clone() const
 {
-	return new ScaleTo(duration_, end_scale_x_, end_scale_y_);
+	auto action = new ScaleTo(duration_, end_scale_x_, end_scale_y_);
+	action->SetEase(ease_);
+	return action;
 }
 
 void easy2d::ScaleTo::Init()
@@ -46,3 +48,16 @@ void easy2d::ScaleTo::Init()
 	delta_x_ = end_scale_x_ - start_scale_x_;
 	delta_y_ = end_scale_y_ - start_scale_y_;
 }
+
+void easy2d::ScaleTo::Compile(ActionProgram * program) const
+{
+	// 派生的动作可能重写了 Init 和 Update，只能按普通动作执行
+	if (typeid(*this) != typeid(ScaleTo))
+	{
+		Action::Compile(program);
+		return;
+	}
+
+	int index = program->AddStep(ActionProgram::StepType::ScaleTo, duration_, 0, end_scale_x_, end_scale_y_);
+	program->SetEase(index, ease_);
+}
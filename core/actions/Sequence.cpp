@@ -18,7 +18,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2daction.h"
+#include "../e2daction.h"
 
 easy2d::Sequence::Sequence()
 	: action_index_(0)
@@ -42,7 +42,7 @@ easy2d::Sequence::~Sequence()
 void easy2d::Sequence::Init()
 {
 	Action::Init();
-	// жĿ
+	// 将所有动作与目标绑定
 	if (target_)
 	{
 		for (const auto& action : actions_)
@@ -50,7 +50,7 @@ void easy2d::Sequence::Init()
 			action->target_ = target_;
 		}
 	}
-	// ʼһ
+	// 初始化第一个动作
 	actions_[0]->Init();
 }
 
@@ -99,6 +99,7 @@ void easy2d::Sequence::Add(Action * action)
 	{
 		actions_.push_back(action);
 		action->Retain();
+		InvalidateProgram();
 	}
 }
 
@@ -136,4 +137,21 @@ easy2d::Sequence * easy2d::Sequence::Reverse() const
 		sequence->Add(newActions);
 	}
 	return sequence;
-}
\ No newline at end of file
+}
+
+void easy2d::Sequence::Compile(ActionProgram * program) const
+{
+	// 派生的动作可能重写了 Init 和 Update，只能按普通动作执行
+	if (typeid(*this) != typeid(Sequence))
+	{
+		Action::Compile(program);
+		return;
+	}
+
+	int index = program->AddStep(ActionProgram::StepType::Sequence, 0.f);
+	for (const auto& action : actions_)
+	{
+		program->Compile(action);
+	}
+	program->EndStep(index);
+}
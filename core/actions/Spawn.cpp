@@ -18,7 +18,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2daction.h"
+#include "../e2daction.h"
 
 easy2d::Spawn::Spawn()
 {
@@ -97,6 +97,7 @@ void easy2d::Spawn::Add(Action * action)
 	{
 		actions_.push_back(action);
 		action->Retain();
+		InvalidateProgram();
 	}
 }
 
@@ -134,4 +135,21 @@ easy2d::Spawn * easy2d::Spawn::Reverse() const
 		spawn->Add(newActions);
 	}
 	return spawn;
-}
\ No newline at end of file
+}
+
+void easy2d::Spawn::Compile(ActionProgram * program) const
+{
+	// 派生的动作可能重写了 Init 和 Update，只能按普通动作执行
+	if (typeid(*this) != typeid(Spawn))
+	{
+		Action::Compile(program);
+		return;
+	}
+
+	int index = program->AddStep(ActionProgram::StepType::Spawn, 0.f);
+	for (const auto& action : actions_)
+	{
+		program->Compile(action);
+	}
+	program->EndStep(index);
+}
@@ -0,0 +1,537 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "../e2daction.h"
+#include "../e2dobject.h"
+
+#if E2D_SIMD
+#	include <emmintrin.h>
+#endif
+
+namespace
+{
+	const int kPosition = static_cast<int>(easy2d::TweenManager::Property::Position);
+	const int kCount = static_cast<int>(easy2d::TweenManager::Property::Count);
+
+#if E2D_SIMD
+	// 按掩码从两个向量中选取分量
+	inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+	{
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	}
+
+	inline __m128 EaseMask(__m128i ease, easy2d::Ease value)
+	{
+		return _mm_castsi128_ps(_mm_cmpeq_epi32(ease, _mm_set1_epi32(static_cast<int>(value))));
+	}
+#endif
+
+	// 根据经过时间计算进度和缓动值
+	void EvaluateLanes(
+		const float * elapsed,
+		const float * duration,
+		const int * ease,
+		float * progress,
+		float * eased,
+		size_t count
+	)
+	{
+		size_t i = 0;
+#if E2D_SIMD
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.f);
+		const __m128 two = _mm_set1_ps(2.f);
+		const __m128 half = _mm_set1_ps(0.5f);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 p = _mm_div_ps(_mm_loadu_ps(elapsed + i), _mm_loadu_ps(duration + i));
+			p = _mm_min_ps(_mm_max_ps(p, zero), one);
+
+			// 所有曲线都计算一遍，再按每个补间的曲线类型选取结果
+			__m128 q = _mm_sub_ps(one, p);
+			__m128 in = _mm_mul_ps(p, p);
+			__m128 out = _mm_sub_ps(one, _mm_mul_ps(q, q));
+			__m128 in_out = Select(
+				_mm_cmplt_ps(p, half),
+				_mm_mul_ps(two, in),
+				_mm_sub_ps(one, _mm_mul_ps(two, _mm_mul_ps(q, q)))
+			);
+
+			__m128i type = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ease + i));
+			__m128 result = p;
+			result = Select(EaseMask(type, easy2d::Ease::EaseIn), in, result);
+			result = Select(EaseMask(type, easy2d::Ease::EaseOut), out, result);
+			result = Select(EaseMask(type, easy2d::Ease::EaseInOut), in_out, result);
+
+			_mm_storeu_ps(progress + i, p);
+			_mm_storeu_ps(eased + i, result);
+		}
+#endif
+		for (; i < count; ++i)
+		{
+			float p = std::min(std::max(elapsed[i] / duration[i], 0.f), 1.f);
+			progress[i] = p;
+			eased[i] = easy2d::TweenManager::Evaluate(static_cast<easy2d::Ease>(ease[i]), p);
+		}
+	}
+
+	// 叠加执行期间其他方式造成的变化：start += current - previous
+	void FollowLanes(
+		float * start,
+		const float * current,
+		const float * previous,
+		size_t count
+	)
+	{
+		size_t i = 0;
+#if E2D_SIMD
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 diff = _mm_sub_ps(_mm_loadu_ps(current + i), _mm_loadu_ps(previous + i));
+			_mm_storeu_ps(start + i, _mm_add_ps(_mm_loadu_ps(start + i), diff));
+		}
+#endif
+		for (; i < count; ++i)
+		{
+			start[i] += current[i] - previous[i];
+		}
+	}
+
+	// 计算补间结果：value = start + delta * eased
+	void BlendLanes(
+		const float * start,
+		const float * delta,
+		const float * eased,
+		float * value,
+		size_t count
+	)
+	{
+		size_t i = 0;
+#if E2D_SIMD
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 offset = _mm_mul_ps(_mm_loadu_ps(delta + i), _mm_loadu_ps(eased + i));
+			_mm_storeu_ps(value + i, _mm_add_ps(_mm_loadu_ps(start + i), offset));
+		}
+#endif
+		for (; i < count; ++i)
+		{
+			value[i] = start[i] + delta[i] * eased[i];
+		}
+	}
+}
+
+easy2d::TweenManager * easy2d::TweenManager::GetInstance()
+{
+	static TweenManager instance;
+	return &instance;
+}
+
+float easy2d::TweenManager::Evaluate(Ease ease, float progress)
+{
+	const float q = 1.f - progress;
+	switch (ease)
+	{
+	case Ease::EaseIn:
+		return progress * progress;
+	case Ease::EaseOut:
+		return 1.f - q * q;
+	case Ease::EaseInOut:
+		return progress < 0.5f ? 2.f * progress * progress : 1.f - 2.f * q * q;
+	default:
+		return progress;
+	}
+}
+
+easy2d::TweenManager::TweenManager()
+	: updating_(false)
+{
+	for (int i = 0; i < kCount; ++i)
+	{
+		lanes_[i].components = (i <= static_cast<int>(Property::Scale)) ? 2 : 1;
+	}
+}
+
+void easy2d::TweenManager::Add(Action * action, Property property, Ease ease, float duration, float progress, const float * start, const float * delta)
+{
+	if (!action || action->tween_index_ >= 0)
+		return;
+
+	action->tween_property_ = static_cast<int>(property);
+	Insert(action, &action->tween_index_, nullptr, property, ease, duration, progress, start, delta, nullptr);
+}
+
+void easy2d::TweenManager::Add(Action * owner, int * slot, float * values, Property property, Ease ease, float duration, float progress)
+{
+	if (!owner || *slot >= 0)
+		return;
+
+	// 步骤状态中依次保存起始值、上一帧的值和变化量，只有位置步骤记录了上一帧的值
+	const float * previous = (property == Property::Position) ? values + 2 : nullptr;
+	Insert(owner, slot, values, property, ease, duration, progress, values, values + 4, previous);
+}
+
+size_t easy2d::TweenManager::Insert(
+	Action * owner,
+	int * slot,
+	float * state,
+	Property property,
+	Ease ease,
+	float duration,
+	float progress,
+	const float * start,
+	const float * delta,
+	const float * previous
+)
+{
+	Lanes& lanes = lanes_[static_cast<int>(property)];
+	const size_t index = lanes.owners.size();
+	*slot = static_cast<int>(index);
+
+	lanes.owners.push_back(owner);
+	lanes.targets.push_back(owner->target_);
+	lanes.slots.push_back(slot);
+	lanes.states.push_back(state);
+	lanes.direct.push_back(typeid(*owner->target_) == owner->target_->GetSetterType() ? 1 : 0);
+	lanes.active.push_back(0);
+	lanes.ease.push_back(static_cast<int>(ease));
+	lanes.elapsed.push_back(progress * duration);
+	lanes.duration.push_back(duration);
+	lanes.progress.push_back(progress);
+	lanes.eased.push_back(Evaluate(ease, progress));
+
+	for (int c = 0; c < lanes.components; ++c)
+	{
+		// 上一帧写入节点的值，用于计算执行期间其他方式造成的变化
+		const float value = previous ? previous[c] : start[c] + delta[c] * lanes.eased.back();
+		lanes.start[c].push_back(start[c]);
+		lanes.delta[c].push_back(delta[c]);
+		lanes.current[c].push_back(value);
+		lanes.value[c].push_back(value);
+	}
+	return index;
+}
+
+void easy2d::TweenManager::Remove(Action * action)
+{
+	if (action && action->tween_index_ >= 0)
+	{
+		Detach(lanes_[action->tween_property_], static_cast<size_t>(action->tween_index_));
+	}
+}
+
+void easy2d::TweenManager::Remove(Property property, int * slot)
+{
+	if (*slot >= 0)
+	{
+		Detach(lanes_[static_cast<int>(property)], static_cast<size_t>(*slot));
+	}
+}
+
+void easy2d::TweenManager::SetElapsed(Property property, int index, float elapsed)
+{
+	lanes_[static_cast<int>(property)].elapsed[index] = elapsed;
+}
+
+void easy2d::TweenManager::Update(Scene * scene)
+{
+	// 设置属性时用户代码可能停止或删除动作，更新期间的移除只做标记
+	updating_ = true;
+
+	for (int i = 0; i < kCount; ++i)
+	{
+		Lanes& lanes = lanes_[i];
+		const size_t count = lanes.owners.size();
+		if (count == 0)
+			continue;
+
+		const Property property = static_cast<Property>(i);
+		Gather(lanes, property, scene);
+
+		EvaluateLanes(&lanes.elapsed[0], &lanes.duration[0], &lanes.ease[0], &lanes.progress[0], &lanes.eased[0], count);
+		for (int c = 0; c < lanes.components; ++c)
+		{
+			if (i == kPosition)
+			{
+				FollowLanes(&lanes.start[c][0], &lanes.current[c][0], &lanes.value[c][0], count);
+			}
+			BlendLanes(&lanes.start[c][0], &lanes.delta[c][0], &lanes.eased[0], &lanes.value[c][0], count);
+		}
+
+		Scatter(lanes, property);
+	}
+
+	updating_ = false;
+
+	// 移除已完成或被停止的补间，动作本身由动作管理器移除
+	for (int i = 0; i < kCount; ++i)
+	{
+		Lanes& lanes = lanes_[i];
+		for (size_t j = lanes.owners.size(); j > 0; --j)
+		{
+			Action * owner = lanes.owners[j - 1];
+			if (!owner)
+			{
+				SwapRemove(lanes, j - 1);
+			}
+			else if (!lanes.states[j - 1] && owner->done_)
+			{
+				Detach(lanes, j - 1);
+			}
+		}
+	}
+}
+
+size_t easy2d::TweenManager::GetCount() const
+{
+	size_t count = 0;
+	for (int i = 0; i < kCount; ++i)
+	{
+		count += lanes_[i].owners.size();
+	}
+	return count;
+}
+
+void easy2d::TweenManager::Gather(Lanes& lanes, Property property, Scene * scene)
+{
+	const size_t count = lanes.owners.size();
+	for (size_t i = 0; i < count; ++i)
+	{
+		Action * action = lanes.owners[i];
+		Node * target = lanes.targets[i];
+
+		const bool active = action && action->running_ && !action->done_ && target->parent_scene_ == scene;
+		lanes.active[i] = active ? 1 : 0;
+
+		if (!active)
+		{
+			// 保持原有的时间和起始值，计算结果不会写回节点
+			for (int c = 0; c < lanes.components; ++c)
+			{
+				lanes.current[c][i] = lanes.value[c][i];
+			}
+			continue;
+		}
+
+		// 组合动作中的步骤时间已由动作程序设置
+		if (!lanes.states[i])
+		{
+			lanes.elapsed[i] = (target->time_ - action->started_).Seconds();
+		}
+
+		if (property == Property::Position)
+		{
+			lanes.current[0][i] = target->transform_.position.x;
+			lanes.current[1][i] = target->transform_.position.y;
+		}
+	}
+}
+
+void easy2d::TweenManager::Scatter(Lanes& lanes, Property property)
+{
+	// 内置节点直接写入属性，重写了属性设置函数的节点通过虚函数写回，也能收到每一帧的值
+	// 变换的重新计算由场景的变换缓存在下一次更新时统一完成
+	const size_t count = lanes.owners.size();
+	const std::vector<float>& x = lanes.value[0];
+	const std::vector<float>& y = lanes.value[1];
+
+	switch (property)
+	{
+	case Property::Position:
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (!lanes.active[i])
+				continue;
+
+			Node * target = lanes.targets[i];
+			if (!lanes.direct[i])
+			{
+				target->SetPosition(x[i], y[i]);
+			}
+			else if (target->transform_.position.x != x[i] || target->transform_.position.y != y[i])
+			{
+				target->transform_.position.x = x[i];
+				target->transform_.position.y = y[i];
+				target->MarkTransformDirty();
+			}
+		}
+		break;
+
+	case Property::Scale:
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (!lanes.active[i])
+				continue;
+
+			Node * target = lanes.targets[i];
+			if (!lanes.direct[i])
+			{
+				target->SetScale(x[i], y[i]);
+			}
+			else if (target->transform_.scale_x != x[i] || target->transform_.scale_y != y[i])
+			{
+				target->transform_.scale_x = x[i];
+				target->transform_.scale_y = y[i];
+				target->MarkTransformDirty();
+			}
+		}
+		break;
+
+	case Property::Rotation:
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (!lanes.active[i])
+				continue;
+
+			Node * target = lanes.targets[i];
+			if (!lanes.direct[i])
+			{
+				target->SetRotation(x[i]);
+			}
+			else if (target->transform_.rotation != x[i])
+			{
+				target->transform_.rotation = x[i];
+				target->MarkTransformDirty();
+			}
+		}
+		break;
+
+	case Property::Opacity:
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (!lanes.active[i])
+				continue;
+
+			if (!lanes.direct[i])
+			{
+				lanes.targets[i]->SetOpacity(x[i]);
+			}
+			else
+			{
+				lanes.targets[i]->real_opacity_ = std::min(std::max(x[i], 0.f), 1.f);
+			}
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	// 单独执行的动作记录进度，组合动作中的步骤由动作程序在下一帧结束
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (!lanes.active[i] || lanes.states[i])
+			continue;
+
+		Action * action = lanes.owners[i];
+		action->UpdateTween(lanes.progress[i], lanes.eased[i]);
+
+		if (lanes.progress[i] >= 1)
+		{
+			action->done_ = true;
+		}
+	}
+}
+
+void easy2d::TweenManager::Detach(Lanes& lanes, size_t index)
+{
+	Action * owner = lanes.owners[index];
+	if (!owner)
+		return;
+
+	// 组合动作中的步骤写回补间过程中叠加的起始值和上一帧的值
+	if (float * state = lanes.states[index])
+	{
+		for (int c = 0; c < lanes.components; ++c)
+		{
+			state[c] = lanes.start[c][index];
+			state[c + 2] = lanes.value[c][index];
+		}
+	}
+	else
+	{
+		owner->tween_property_ = -1;
+	}
+	*lanes.slots[index] = -1;
+
+	if (updating_)
+	{
+		lanes.owners[index] = nullptr;
+		lanes.slots[index] = nullptr;
+		lanes.states[index] = nullptr;
+		lanes.active[index] = 0;
+	}
+	else
+	{
+		SwapRemove(lanes, index);
+	}
+}
+
+void easy2d::TweenManager::SwapRemove(Lanes& lanes, size_t index)
+{
+	const size_t last = lanes.owners.size() - 1;
+
+	if (index != last)
+	{
+		lanes.owners[index] = lanes.owners[last];
+		lanes.targets[index] = lanes.targets[last];
+		lanes.slots[index] = lanes.slots[last];
+		lanes.states[index] = lanes.states[last];
+		lanes.direct[index] = lanes.direct[last];
+		lanes.active[index] = lanes.active[last];
+		lanes.ease[index] = lanes.ease[last];
+		lanes.elapsed[index] = lanes.elapsed[last];
+		lanes.duration[index] = lanes.duration[last];
+		lanes.progress[index] = lanes.progress[last];
+		lanes.eased[index] = lanes.eased[last];
+		for (int c = 0; c < lanes.components; ++c)
+		{
+			lanes.start[c][index] = lanes.start[c][last];
+			lanes.delta[c][index] = lanes.delta[c][last];
+			lanes.current[c][index] = lanes.current[c][last];
+			lanes.value[c][index] = lanes.value[c][last];
+		}
+
+		if (lanes.slots[index])
+		{
+			*lanes.slots[index] = static_cast<int>(index);
+		}
+	}
+
+	lanes.owners.pop_back();
+	lanes.targets.pop_back();
+	lanes.slots.pop_back();
+	lanes.states.pop_back();
+	lanes.direct.pop_back();
+	lanes.active.pop_back();
+	lanes.ease.pop_back();
+	lanes.elapsed.pop_back();
+	lanes.duration.pop_back();
+	lanes.progress.pop_back();
+	lanes.eased.pop_back();
+	for (int c = 0; c < lanes.components; ++c)
+	{
+		lanes.start[c].pop_back();
+		lanes.delta[c].pop_back();
+		lanes.current[c].pop_back();
+		lanes.value[c].pop_back();
+	}
+}
@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dcomponent.h"
-#include "..\e2dmodule.h"
+#include "../e2dcomponent.h"
+#include "../e2dmodule.h"
 
 #define SAFE_SET(pointer, func, ...) if (pointer) { pointer->##func(__VA_ARGS__); }
 
@@ -163,7 +163,12 @@ void easy2d::Button::SetPivot(float pivot_x, float pivot_y)
 	SAFE_SET(disabled_, SetPivot, pivot_x, pivot_y);
 }
 
-bool easy2d::Button::Dispatch(const MouseEvent & e, bool handled)
+bool easy2d::Button::IsMouseListener() const
+{
+	return true;
+}
+
+bool easy2d::Button::OnMouseEvent(const MouseEvent & e, bool handled)
 {
 	if (!handled && enabled_ && visible_ && normal_)
 	{
@@ -209,12 +214,12 @@ bool easy2d::Button::Dispatch(const MouseEvent & e, bool handled)
 		}
 	}
 
-	return Node::Dispatch(e, handled);
+	return Node::OnMouseEvent(e, handled);
 }
 
-void easy2d::Button::Visit()
+void easy2d::Button::Visit(RenderCommandList & commands)
 {
-	Node::Visit();
+	Node::Visit(commands);
 
 	if (visible_ &&
 		!enabled_ &&
@@ -18,7 +18,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dcomponent.h"
+#include "../e2dcomponent.h"
 
 easy2d::Menu::Menu()
 	: enabled_(true)
@@ -81,7 +81,7 @@ bool easy2d::Menu::RemoveButton(Button * button)
 		auto iter = std::find(buttons_.begin(), buttons_.end(), button);
 		if (iter != buttons_.end())
 		{
-			// Ƴťǰ
+			// 移除按钮前，将它启用
 			button->SetEnabled(true);
 			buttons_.erase(iter);
 			return true;
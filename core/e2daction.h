@@ -31,13 +31,29 @@ namespace easy2d
 	class Sequence;
 	class Spawn;
 	class ActionManager;
+	class ActionProgram;
+	class TweenManager;
+	class RunProgram;
 
 
-	// 
+	// 缓动曲线
+	enum class Ease : int
+	{
+		Linear,		/* 线性 */
+		EaseIn,		/* 由慢到快 */
+		EaseOut,	/* 由快到慢 */
+		EaseInOut	/* 由慢到快再到慢 */
+	};
+
+
+	// 基础动作
 	class Action
 		: public Ref
 	{
 		friend class ActionManager;
+		friend class ActionProgram;
+		friend class TweenManager;
+		friend class RunProgram;
 		friend class Loop;
 		friend class Sequence;
 		friend class Spawn;
@@ -47,122 +63,578 @@ namespace easy2d
 
 		virtual ~Action();
 
-		// ȡ״̬
+		// 获取动作运行状态
 		virtual bool IsRunning();
 
-		// 
+		// 继续动作，同时继续该动作在各个节点上的执行
 		virtual void Resume();
 
-		// ͣ
+		// 暂停动作，同时暂停该动作在各个节点上的执行
 		virtual void Pause();
 
-		// ֹͣ
+		// 停止动作，同时停止该动作在各个节点上的执行
 		virtual void Stop();
 
-		// ȡ
+		// 获取动作名称
 		virtual const String& GetName() const;
 
-		// ö
+		// 设置动作名称，执行中的动作同时改名
 		virtual void SetName(
 			const String& name
 		);
 
-		// ȡĿ
+		// 获取动作标签
+		int GetTag() const;
+
+		// 设置动作标签，执行中的动作同时修改标签
+		void SetTag(
+			int tag
+		);
+
+		// 获取动作的拷贝
 		virtual Action * Clone() const = 0;
 
-		// ȡĵת
+		// 获取动作的倒转
 		virtual Action * Reverse() const = 0;
 
-		// ö
+		// 重置动作
 		virtual void Reset();
 
-		// ȡöִĿ
+		// 获取该动作的执行目标，作为定义执行时为最近一次开始执行的节点
 		virtual Node * GetTarget();
 
-		// ʼ
+		// 开始动作
 		virtual void StartWithTarget(
 			Node* target
 		);
 
-		// ʼ
+		// 初始化动作
 		virtual void Init();
 
-		// ¶
+		// 更新动作
 		virtual void Update();
 
-		// öʱ
+		// 重置动作时间
 		virtual void ResetTime();
 
-		// ȡ״̬
+		// 获取动作结束状态，作为定义执行时在所有执行都结束后为真
 		virtual bool IsDone() const;
 
+		// 获取动作编译后的程序，程序在第一次获取时生成并缓存，动作或其子动作改变后重新生成
+		// 同一个动作可以通过程序同时在多个节点上执行，之后对动作的修改不会影响已生成的程序
+		virtual ActionProgram * GetProgram() const;
+
 	protected:
 		E2D_DISABLE_COPY(Action);
 
+		// 动作定义改变后丢弃缓存的程序，并增加版本号使包含该动作的组合动作重新编译
+		void InvalidateProgram();
+
+		// 补间管理器写回转交后的进度和缓动值
+		virtual void UpdateTween(
+			float progress,
+			float eased
+		);
+
+		// 获取执行目标的时钟时间
+		Time GetTime() const;
+
+		// 将动作编译为动作程序中的步骤，不支持编译的动作以拷贝的形式保存
+		virtual void Compile(
+			ActionProgram * program
+		) const;
+
 	protected:
 		String	name_;
+		int		tag_;
+		int		manager_index_;
+		int		tween_property_;
+		int		tween_index_;
 		bool	running_;
 		bool	done_;
 		bool	initialized_;
 		Node *	target_;
 		Time	started_;
+		unsigned int version_;
+		mutable ActionProgram * program_;
+		RunProgram * runs_;		/* 以该动作为定义的执行，通过 RunProgram::next_run_ 连接 */
 	};
 
 
-	// 
+	// 动作管理器，所有正在运行的动作保存在一个连续数组中统一更新
+	class ActionManager
+	{
+	public:
+		// 获取实例
+		static ActionManager * GetInstance();
+
+		// 添加动作，动作必须已有执行目标
+		void Add(
+			Action * action
+		);
+
+		// 移除动作，不会改变动作的引用计数
+		void Remove(
+			Action * action
+		);
+
+		// 更新执行目标位于指定场景中的动作，并移除已完成的动作
+		void Update(
+			Scene * scene
+		);
+
+		// 继续所有名称相同的动作
+		void Resume(
+			const String& name
+		);
+
+		// 暂停所有名称相同的动作
+		void Pause(
+			const String& name
+		);
+
+		// 停止所有名称相同的动作
+		void Stop(
+			const String& name
+		);
+
+		// 继续所有标签相同的动作
+		void Resume(
+			int tag
+		);
+
+		// 暂停所有标签相同的动作
+		void Pause(
+			int tag
+		);
+
+		// 停止所有标签相同的动作
+		void Stop(
+			int tag
+		);
+
+		// 获取正在运行的动作数量
+		size_t GetCount() const;
+
+	protected:
+		ActionManager();
+
+		E2D_DISABLE_COPY(ActionManager);
+
+		// 将数组末尾的动作移动到指定位置
+		void SwapRemove(
+			size_t index
+		);
+
+	protected:
+		std::vector<Action*> actions_;
+	};
+
+
+	// 补间管理器，同一属性的补间以结构数组的形式保存，每帧使用 SIMD 指令批量计算
+	// 节点上只包含单个位移、缩放、旋转或透明度步骤的动作程序会转交给补间管理器更新
+	class TweenManager
+	{
+	public:
+		// 补间属性
+		enum class Property : int
+		{
+			Position,
+			Scale,
+			Rotation,
+			Opacity,
+			Count
+		};
+
+		// 获取实例
+		static TweenManager * GetInstance();
+
+		// 计算缓动曲线在指定进度上的值
+		static float Evaluate(
+			Ease ease,
+			float progress
+		);
+
+		// 添加补间，start 和 delta 的分量数量由属性决定
+		void Add(
+			Action * action,
+			Property property,
+			Ease ease,
+			float duration,
+			float progress,
+			const float * start,
+			const float * delta
+		);
+
+		// 添加组合动作中的补间步骤，步骤的时间由动作程序每帧设置
+		// values 为步骤状态中的起始值、上一帧的值和变化量，移除时写回起始值和上一帧的值
+		void Add(
+			Action * owner,
+			int * slot,				/* 记录补间位置的变量 */
+			float * values,
+			Property property,
+			Ease ease,
+			float duration,
+			float progress
+		);
+
+		// 移除动作对应的补间
+		void Remove(
+			Action * action
+		);
+
+		// 移除组合动作中的补间步骤
+		void Remove(
+			Property property,
+			int * slot
+		);
+
+		// 设置组合动作中的补间步骤已经过的时间
+		void SetElapsed(
+			Property property,
+			int index,
+			float elapsed
+		);
+
+		// 更新执行目标位于指定场景中的补间，并移除已完成的补间
+		void Update(
+			Scene * scene
+		);
+
+		// 获取正在运行的补间数量
+		size_t GetCount() const;
+
+	protected:
+		TweenManager();
+
+		E2D_DISABLE_COPY(TweenManager);
+
+		// 同一属性的所有补间，每个数组保存所有补间的同一个字段
+		struct Lanes
+		{
+			int								components;
+			std::vector<Action*>			owners;
+			std::vector<Node*>				targets;
+			std::vector<int*>				slots;		/* 记录补间位置的变量，移动补间时更新 */
+			std::vector<float*>				states;		/* 组合动作中补间步骤的状态，单独执行的动作为空 */
+			std::vector<int>				direct;		/* 节点没有重写属性设置函数，可以直接写入 */
+			std::vector<int>				active;
+			std::vector<int>				ease;
+			std::vector<float>				elapsed;
+			std::vector<float>				duration;
+			std::vector<float>				progress;
+			std::vector<float>				eased;
+			std::vector<float>				start[2];
+			std::vector<float>				delta[2];
+			std::vector<float>				current[2];
+			std::vector<float>				value[2];
+		};
+
+		// 读取动作时间和节点属性
+		void Gather(
+			Lanes& lanes,
+			Property property,
+			Scene * scene
+		);
+
+		// 将计算结果写回节点
+		void Scatter(
+			Lanes& lanes,
+			Property property
+		);
+
+		// 添加补间并返回其位置
+		size_t Insert(
+			Action * owner,
+			int * slot,
+			float * state,
+			Property property,
+			Ease ease,
+			float duration,
+			float progress,
+			const float * start,
+			const float * delta,
+			const float * previous
+		);
+
+		// 移除补间，更新期间只标记，在更新结束后统一整理
+		void Detach(
+			Lanes& lanes,
+			size_t index
+		);
+
+		// 将数组末尾的补间移动到指定位置
+		void SwapRemove(
+			Lanes& lanes,
+			size_t index
+		);
+
+	protected:
+		bool updating_;
+		Lanes lanes_[static_cast<int>(Property::Count)];
+	};
+
+
+	// 持续动作
 	class FiniteTimeAction
 		: public Action
 	{
 	public:
-		// ضʱĳ
+		// 创建特定时长的持续动作
 		explicit FiniteTimeAction(
 			float duration
 		);
 
-		// ö
+		virtual ~FiniteTimeAction();
+
+		// 设置缓动曲线
+		void SetEase(
+			Ease ease
+		);
+
+		// 获取缓动曲线
+		Ease GetEase() const;
+
+		// 重置动作
 		virtual void Reset() override;
 
 	protected:
 		E2D_DISABLE_COPY(FiniteTimeAction);
 
-		// ʼ
+		// 初始化动作
 		virtual void Init() override;
 
-		// ¶
+		// 更新动作
 		virtual void Update() override;
 
-		// öʱ
+		// 重置动作时间
 		virtual void ResetTime() override;
 
 	protected:
 		float duration_;
 		float delta_;
+		float eased_;
+		Ease  ease_;
+	};
+
+
+	// 编译期确定的缓动曲线，可以作为 Tween 的缓动参数
+	template<Ease E>
+	struct EaseCurve
+	{
+		float operator() (float progress) const { return progress; }
 	};
 
+	template<>
+	struct EaseCurve<Ease::EaseIn>
+	{
+		float operator() (float progress) const { return progress * progress; }
+	};
+
+	template<>
+	struct EaseCurve<Ease::EaseOut>
+	{
+		float operator() (float progress) const { return 1.f - (1.f - progress) * (1.f - progress); }
+	};
+
+	template<>
+	struct EaseCurve<Ease::EaseInOut>
+	{
+		float operator() (float progress) const
+		{
+			const float q = 1.f - progress;
+			return progress < 0.5f ? 2.f * progress * progress : 1.f - 2.f * q * q;
+		}
+	};
+
+
+	// 补间插值，默认计算 from + (to - from) * t，其他类型可以特化此模板
+	template<typename T>
+	struct TweenLerp
+	{
+		T operator() (const T& from, const T& to, float t) const { return from + (to - from) * t; }
+	};
+
+	template<>
+	struct TweenLerp<Color>
+	{
+		Color operator() (const Color& from, const Color& to, float t) const
+		{
+			return Color(
+				from.r + (to.r - from.r) * t,
+				from.g + (to.g - from.g) * t,
+				from.b + (to.b - from.b) * t,
+				from.a + (to.a - from.a) * t
+			);
+		}
+	};
+
+
+	// 节点属性设置器，可以作为 Tween 的设置器参数
+	// 通过虚函数设置，节点重写的设置函数同样会被调用
+	struct PositionSetter
+	{
+		void operator() (Node * target, const Point& value) const { target->SetPosition(value.x, value.y); }
+	};
+
+	struct ScaleSetter
+	{
+		void operator() (Node * target, const Point& value) const { target->SetScale(value.x, value.y); }
+	};
+
+	struct SkewSetter
+	{
+		void operator() (Node * target, const Point& value) const { target->SetSkew(value.x, value.y); }
+	};
+
+	struct SizeSetter
+	{
+		void operator() (Node * target, const Size& value) const { target->SetSize(value.width, value.height); }
+	};
 
-	// λƶ
+	struct RotationSetter
+	{
+		void operator() (Node * target, float value) const { target->SetRotation(value); }
+	};
+
+	struct OpacitySetter
+	{
+		void operator() (Node * target, float value) const { target->SetOpacity(value); }
+	};
+
+
+	// 属性补间，设置器、缓动曲线和插值方式都由模板参数决定，每帧更新时不再经过虚函数
+	// Setter 是形如 void(Node*, const T&) 的函数对象，EaseFunc 是形如 float(float) 的函数对象
+	// EaseFunc 作用于 SetEase 设置的缓动结果之上，默认的线性曲线不改变 SetEase 的效果
+	template<
+		typename T,
+		typename Setter,
+		typename EaseFunc = EaseCurve<Ease::Linear>,
+		typename Lerp = TweenLerp<T>
+	>
+	class Tween
+		: public FiniteTimeAction
+	{
+	public:
+		explicit Tween(
+			float duration,					/* 持续时长 */
+			const T& from,					/* 起始值 */
+			const T& to,					/* 目标值 */
+			const Setter& setter = Setter(),
+			const EaseFunc& ease = EaseFunc()
+		)
+			: FiniteTimeAction(duration)
+			, from_(from)
+			, to_(to)
+			, setter_(setter)
+			, ease_func_(ease)
+		{
+		}
+
+		// 获取该动作的拷贝对象
+		virtual Tween * Clone() const override
+		{
+			auto action = new Tween(duration_, from_, to_, setter_, ease_func_);
+			action->SetEase(ease_);
+			return action;
+		}
+
+		// 获取该动作的倒转
+		virtual Tween * Reverse() const override
+		{
+			auto action = new Tween(duration_, to_, from_, setter_, ease_func_);
+			action->SetEase(ease_);
+			return action;
+		}
+
+	protected:
+		E2D_DISABLE_COPY(Tween);
+
+		// 编译动作，程序保存补间的拷贝，执行时不再为每个执行目标拷贝
+		virtual void Compile(
+			ActionProgram * program
+		) const override;
+
+		// 按缓动值设置执行目标的属性，由动作程序调用
+		static void Apply(
+			const Action * action,
+			Node * target,
+			float eased
+		);
+
+		// 更新动作
+		virtual void Update() override
+		{
+			FiniteTimeAction::Update();
+
+			if (target_)
+			{
+				setter_(target_, lerp_(from_, to_, ease_func_(eased_)));
+			}
+		}
+
+	protected:
+		T			from_;
+		T			to_;
+		Setter		setter_;
+		EaseFunc	ease_func_;
+		Lerp		lerp_;
+	};
+
+
+	// 创建属性补间，可以直接传入 lambda 作为设置器
+	template<typename T, typename Setter>
+	inline Tween<T, Setter> * CreateTween(
+		float duration,
+		const T& from,
+		const T& to,
+		const Setter& setter
+	)
+	{
+		return new Tween<T, Setter>(duration, from, to, setter);
+	}
+
+	// 创建使用指定缓动曲线的属性补间，例如 CreateTween<EaseCurve<Ease::EaseIn>>(...)
+	template<typename EaseFunc, typename T, typename Setter>
+	inline Tween<T, Setter, EaseFunc> * CreateTween(
+		float duration,
+		const T& from,
+		const T& to,
+		const Setter& setter
+	)
+	{
+		return new Tween<T, Setter, EaseFunc>(duration, from, to, setter);
+	}
+
+
+	// 相对位移动作
 	class MoveBy
 		: public FiniteTimeAction
 	{
 	public:
 		explicit MoveBy(
-			float duration,		/* ʱ */
-			Point vector		/* ƶ */
+			float duration,		/* 持续时长 */
+			Point vector		/* 移动距离 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		virtual MoveBy * Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual MoveBy * Reverse() const override;
 
 	protected:
 		E2D_DISABLE_COPY(MoveBy);
 
-		// ʼ
+		// 编译动作
+		virtual void Compile(
+			ActionProgram * program
+		) const override;
+
+		// 初始化动作
 		virtual void Init() override;
 
-		// ¶
+		// 更新动作
 		virtual void Update() override;
 
 	protected:
@@ -172,20 +644,20 @@ namespace easy2d
 	};
 
 
-	// λƶ
+	// 位移动作
 	class MoveTo
 		: public MoveBy
 	{
 	public:
 		explicit MoveTo(
-			float duration,		/* ʱ */
-			Point pos			/* Ŀ */
+			float duration,		/* 持续时长 */
+			Point pos			/* 目的坐标 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		virtual MoveTo * Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual MoveTo * Reverse() const override
 		{
 			E2D_WARNING("Reverse() not supported in MoveTo");
@@ -195,7 +667,12 @@ namespace easy2d
 	protected:
 		E2D_DISABLE_COPY(MoveTo);
 
-		// ʼ
+		// 编译动作
+		virtual void Compile(
+			ActionProgram * program
+		) const override;
+
+		// 初始化动作
 		virtual void Init() override;
 
 	protected:
@@ -203,31 +680,36 @@ namespace easy2d
 	};
 
 
-	// Ծ
+	// 相对跳跃动作
 	class JumpBy
 		: public FiniteTimeAction
 	{
 	public:
 		explicit JumpBy(
-			float duration,			/* ʱ */
-			const Point& vec,		/* Ծ */
-			float height,			/* Ծ߶ */
-			int jumps = 1			/* Ծ */
+			float duration,			/* 持续时长 */
+			const Point& vec,		/* 跳跃距离 */
+			float height,			/* 跳跃高度 */
+			int jumps = 1			/* 跳跃次数 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		virtual JumpBy * Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual JumpBy * Reverse() const override;
 
 	protected:
 		E2D_DISABLE_COPY(JumpBy);
 
-		// ʼ
+		// 编译动作
+		virtual void Compile(
+			ActionProgram * program
+		) const override;
+
+		// 初始化动作
 		virtual void Init() override;
 
-		// ¶
+		// 更新动作
 		virtual void Update() override;
 
 	protected:
@@ -239,22 +721,22 @@ namespace easy2d
 	};
 
 
-	// Ծ
+	// 跳跃动作
 	class JumpTo
 		: public JumpBy
 	{
 	public:
 		explicit JumpTo(
-			float duration,			/* ʱ */
-			const Point& pos,		/* Ŀ */
-			float height,			/* Ծ߶ */
-			int jumps = 1			/* Ծ */
+			float duration,			/* 持续时长 */
+			const Point& pos,		/* 目的坐标 */
+			float height,			/* 跳跃高度 */
+			int jumps = 1			/* 跳跃次数 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		virtual JumpTo * Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual JumpTo * Reverse() const override
 		{
 			E2D_WARNING("Reverse() not supported in JumpTo");
@@ -264,7 +746,12 @@ namespace easy2d
 	protected:
 		E2D_DISABLE_COPY(JumpTo);
 
-		// ʼ
+		// 编译动作
+		virtual void Compile(
+			ActionProgram * program
+		) const override;
+
+		// 初始化动作
 		virtual void Init() override;
 
 	protected:
@@ -272,35 +759,40 @@ namespace easy2d
 	};
 
 
-	// Ŷ
+	// 相对缩放动作
 	class ScaleBy
 		: public FiniteTimeAction
 	{
 	public:
 		explicit ScaleBy(
-			float duration,		/* ʱ */
-			float scale			/* Ա仯ֵ */
+			float duration,		/* 持续时长 */
+			float scale			/* 相对变化值 */
 		);
 
 		explicit ScaleBy(
-			float duration,		/* ʱ */
-			float scale_x,		/* Ա仯ֵ */
-			float scale_y		/* Ա仯ֵ */
+			float duration,		/* 持续时长 */
+			float scale_x,		/* 横向缩放相对变化值 */
+			float scale_y		/* 纵向缩放相对变化值 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		virtual ScaleBy * Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual ScaleBy * Reverse() const override;
 
 	protected:
 		E2D_DISABLE_COPY(ScaleBy);
 
-		// ʼ
+		// 编译动作
+		virtual void Compile(
+			ActionProgram * program
+		) const override;
+
+		// 初始化动作
 		virtual void Init() override;
 
-		// ¶
+		// 更新动作
 		virtual void Update() override;
 
 	protected:
@@ -311,26 +803,26 @@ namespace easy2d
 	};
 
 
-	// Ŷ
+	// 缩放动作
 	class ScaleTo
 		: public ScaleBy
 	{
 	public:
 		explicit ScaleTo(
-			float duration,		/* ʱ */
-			float scale			/* Ŀֵ */
+			float duration,		/* 持续时长 */
+			float scale			/* 目标值 */
 		);
 
 		explicit ScaleTo(
-			float duration,		/* ʱ */
-			float scale_x,		/* Ŀֵ */
-			float scale_y		/* Ŀֵ */
+			float duration,		/* 持续时长 */
+			float scale_x,		/* 横向缩放目标值 */
+			float scale_y		/* 纵向缩放目标值 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		virtual ScaleTo * Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual ScaleTo * Reverse() const override
 		{
 			E2D_WARNING("Reverse() not supported in ScaleTo");
@@ -340,7 +832,12 @@ namespace easy2d
 	protected:
 		E2D_DISABLE_COPY(ScaleTo);
 
-		// ʼ
+		// 编译动作
+		virtual void Compile(
+			ActionProgram * program
+		) const override;
+
+		// 初始化动作
 		virtual void Init() override;
 
 	protected:
@@ -349,29 +846,34 @@ namespace easy2d
 	};
 
 
-	// ͸Խ䶯
+	// 透明度相对渐变动作
 	class OpacityBy
 		: public FiniteTimeAction
 	{
 	public:
 		explicit OpacityBy(
-			float duration,		/* ʱ */
-			float opacity		/* Ա仯ֵ */
+			float duration,		/* 持续时长 */
+			float opacity		/* 相对变化值 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		virtual OpacityBy * Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual OpacityBy * Reverse() const override;
 
 	protected:
 		E2D_DISABLE_COPY(OpacityBy);
 
-		// ʼ
+		// 编译动作
+		virtual void Compile(
+			ActionProgram * program
+		) const override;
+
+		// 初始化动作
 		virtual void Init() override;
 
-		// ¶
+		// 更新动作
 		virtual void Update() override;
 
 	protected:
@@ -380,20 +882,20 @@ namespace easy2d
 	};
 
 
-	// ͸Ƚ䶯
+	// 透明度渐变动作
 	class OpacityTo
 		: public OpacityBy
 	{
 	public:
 		explicit OpacityTo(
-			float duration,		/* ʱ */
-			float opacity		/* Ŀֵ */
+			float duration,		/* 持续时长 */
+			float opacity		/* 目标值 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		virtual OpacityTo * Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual OpacityTo * Reverse() const override
 		{
 			E2D_WARNING("Reverse() not supported in OpacityTo");
@@ -403,7 +905,12 @@ namespace easy2d
 	protected:
 		E2D_DISABLE_COPY(OpacityTo);
 
-		// ʼ
+		// 编译动作
+		virtual void Compile(
+			ActionProgram * program
+		) const override;
+
+		// 初始化动作
 		virtual void Init() override;
 
 	protected:
@@ -411,14 +918,14 @@ namespace easy2d
 	};
 
 
-	// 붯
+	// 淡入动作
 	class FadeIn
 		: public OpacityTo
 	{
 	public:
-		// 붯
+		// 创建淡入动作
 		explicit FadeIn(
-			float duration		/* ʱ */
+			float duration		/* 持续时长 */
 		);
 
 	protected:
@@ -426,14 +933,14 @@ namespace easy2d
 	};
 
 
-	// 
+	// 淡出动作
 	class FadeOut
 		: public OpacityTo
 	{
 	public:
-		// 
+		// 创建淡出动作
 		explicit FadeOut(
-			float duration		/* ʱ */
+			float duration		/* 持续时长 */
 		);
 
 	protected:
@@ -441,29 +948,34 @@ namespace easy2d
 	};
 
 
-	// ת
+	// 相对旋转动作
 	class RotateBy
 		: public FiniteTimeAction
 	{
 	public:
 		explicit RotateBy(
-			float duration,		/* ʱ */
-			float rotation		/* Ա仯ֵ */
+			float duration,		/* 持续时长 */
+			float rotation		/* 相对变化值 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		virtual RotateBy * Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual RotateBy * Reverse() const override;
 
 	protected:
 		E2D_DISABLE_COPY(RotateBy);
 
-		// ʼ
+		// 编译动作
+		virtual void Compile(
+			ActionProgram * program
+		) const override;
+
+		// 初始化动作
 		virtual void Init() override;
 
-		// ¶
+		// 更新动作
 		virtual void Update() override;
 
 	protected:
@@ -472,20 +984,20 @@ namespace easy2d
 	};
 
 
-	// ת
+	// 旋转动作
 	class RotateTo
 		: public RotateBy
 	{
 	public:
 		explicit RotateTo(
-			float duration,		/* ʱ */
-			float rotation		/* Ŀֵ */
+			float duration,		/* 持续时长 */
+			float rotation		/* 目标值 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		virtual RotateTo * Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual RotateTo * Reverse() const override
 		{
 			E2D_WARNING("Reverse() not supported in RotateTo");
@@ -495,7 +1007,12 @@ namespace easy2d
 	protected:
 		E2D_DISABLE_COPY(RotateTo);
 
-		// ʼ
+		// 编译动作
+		virtual void Compile(
+			ActionProgram * program
+		) const override;
+
+		// 初始化动作
 		virtual void Init() override;
 
 	protected:
@@ -503,34 +1020,39 @@ namespace easy2d
 	};
 
 
-	// ʱ
+	// 延时动作
 	class Delay
 		: public Action
 	{
 	public:
 		explicit Delay(
-			float duration	/* ӳʱ룩 */
+			float duration	/* 延迟时长（秒） */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		virtual Delay * Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual Delay * Reverse() const override;
 
-		// ö
+		// 重置动作
 		virtual void Reset() override;
 
 	protected:
 		E2D_DISABLE_COPY(Delay);
 
-		// ʼ
+		// 编译动作
+		virtual void Compile(
+			ActionProgram * program
+		) const override;
+
+		// 初始化动作
 		virtual void Init() override;
 
-		// ¶
+		// 更新动作
 		virtual void Update() override;
 
-		// öʱ
+		// 重置动作时间
 		virtual void ResetTime() override;
 
 	protected:
@@ -539,37 +1061,42 @@ namespace easy2d
 	};
 
 
-	// ѭ
+	// 循环动作
 	class Loop
 		: public Action
 	{
 	public:
 		explicit Loop(
-			Action * action,	/* ִѭĶ */
-			int times = -1		/* ѭ */
+			Action * action,	/* 执行循环的动作 */
+			int times = -1		/* 循环次数 */
 		);
 
 		virtual ~Loop();
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		virtual Loop * Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual Loop * Reverse() const override;
 
-		// ö
+		// 重置动作
 		virtual void Reset() override;
 
 	protected:
 		E2D_DISABLE_COPY(Loop);
 
-		// ʼ
+		// 编译动作
+		virtual void Compile(
+			ActionProgram * program
+		) const override;
+
+		// 初始化动作
 		virtual void Init() override;
 
-		// ¶
+		// 更新动作
 		virtual void Update() override;
 
-		// öʱ
+		// 重置动作时间
 		virtual void ResetTime() override;
 
 	protected:
@@ -579,28 +1106,33 @@ namespace easy2d
 	};
 
 
-	// ص
+	// 回调动作
 	class Callback
 		: public Action
 	{
 	public:
 		explicit Callback(
-			const Function& func /*  */
+			const Function& func /* 函数对象 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		virtual Callback * Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual Callback * Reverse() const override;
 
 	protected:
 		E2D_DISABLE_COPY(Callback);
 
-		// ʼ
+		// 编译动作
+		virtual void Compile(
+			ActionProgram * program
+		) const override;
+
+		// 初始化动作
 		virtual void Init() override;
 
-		// ¶
+		// 更新动作
 		virtual void Update() override;
 
 	protected:
@@ -608,7 +1140,7 @@ namespace easy2d
 	};
 
 
-	// ˳
+	// 顺序动作
 	class Sequence
 		: public Action
 	{
@@ -618,40 +1150,45 @@ namespace easy2d
 		Sequence();
 
 		explicit Sequence(
-			const Actions& actions	/* б */
+			const Actions& actions	/* 动作列表 */
 		);
 
 		virtual ~Sequence();
 
-		// ڽβӶ
+		// 在结尾添加动作
 		void Add(
 			Action * action
 		);
 
-		// ڽβӶ
+		// 在结尾添加多个动作
 		void Add(
-			const Actions& actions	/* б */
+			const Actions& actions	/* 动作列表 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		virtual Sequence * Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual Sequence * Reverse() const;
 
-		// ö
+		// 重置动作
 		virtual void Reset() override;
 
 	protected:
 		E2D_DISABLE_COPY(Sequence);
 
-		// ʼ
+		// 编译动作
+		virtual void Compile(
+			ActionProgram * program
+		) const override;
+
+		// 初始化动作
 		virtual void Init() override;
 
-		// ¶
+		// 更新动作
 		virtual void Update() override;
 
-		// öʱ
+		// 重置动作时间
 		virtual void ResetTime() override;
 
 	protected:
@@ -660,7 +1197,7 @@ namespace easy2d
 	};
 
 
-	// ͬ
+	// 同步动作
 	class Spawn
 		: public Action
 	{
@@ -670,40 +1207,45 @@ namespace easy2d
 		Spawn();
 
 		explicit Spawn(
-			const Actions& actions	/* б */
+			const Actions& actions	/* 动作列表 */
 		);
 
 		virtual ~Spawn();
 
-		// ڽβӶ
+		// 在结尾添加动作
 		void Add(
 			Action * action
 		);
 
-		// ڽβӶ
+		// 在结尾添加多个动作
 		void Add(
-			const Actions& actions	/* б */
+			const Actions& actions	/* 动作列表 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		virtual Spawn * Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual Spawn * Reverse() const;
 
-		// ö
+		// 重置动作
 		virtual void Reset() override;
 
 	protected:
 		E2D_DISABLE_COPY(Spawn);
 
-		// ʼ
+		// 编译动作
+		virtual void Compile(
+			ActionProgram * program
+		) const override;
+
+		// 初始化动作
 		virtual void Init() override;
 
-		// ¶
+		// 更新动作
 		virtual void Update() override;
 
-		// öʱ
+		// 重置动作时间
 		virtual void ResetTime() override;
 
 	protected:
@@ -711,7 +1253,7 @@ namespace easy2d
 	};
 
 
-	// ֡
+	// 帧动画
 	class Animation
 		: public Ref
 	{
@@ -721,45 +1263,45 @@ namespace easy2d
 		Animation();
 
 		explicit Animation(
-			const Images& frames	/* ؼ֡ */
+			const Images& frames	/* 关键帧数组 */
 		);
 
 		explicit Animation(
-			float interval			/* ֡룩 */
+			float interval			/* 帧间隔（秒） */
 		);
 
 		explicit Animation(
-			float interval,			/* ֡룩 */
-			const Images& frames	/* ؼ֡ */
+			float interval,			/* 帧间隔（秒） */
+			const Images& frames	/* 关键帧数组 */
 		);
 
 		virtual ~Animation();
 
-		// ӹؼ֡
+		// 添加关键帧
 		void Add(
-			Image * frame			/* ؼ֡ */
+			Image * frame			/* 关键帧 */
 		);
 
-		// Ӷؼ֡
+		// 添加多个关键帧
 		void Add(
-			const Images& frames	/* ؼ֡ */
+			const Images& frames	/* 关键帧数组 */
 		);
 
-		// ȡ֡
+		// 获取帧间隔
 		float GetInterval() const;
 
-		// ȡؼ֡
+		// 获取关键帧
 		const Images& GetFrames() const;
 
-		// ÿһ֡ʱ
+		// 设置每一帧的时间间隔
 		void SetInterval(
-			float interval		/* ֡룩 */
+			float interval		/* 帧间隔（秒） */
 		);
 
-		// ȡ֡Ŀ
+		// 获取帧动画的拷贝对象
 		Animation * Clone() const;
 
-		// ȡ֡ĵת
+		// 获取帧动画的倒转
 		Animation * Reverse() const;
 
 	protected:
@@ -771,7 +1313,7 @@ namespace easy2d
 	};
 
 
-	// 鶯
+	// 精灵动作
 	class Animate
 		: public Action
 	{
@@ -784,33 +1326,33 @@ namespace easy2d
 
 		virtual ~Animate();
 
-		// ȡ
+		// 获取动画
 		virtual Animation * GetAnimation() const;
 
-		// ö
+		// 设置动画
 		virtual void SetAnimation(
 			Animation * animation
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		virtual Animate * Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual Animate * Reverse() const override;
 
-		// ö
+		// 重置动作
 		virtual void Reset() override;
 
 	protected:
 		E2D_DISABLE_COPY(Animate);
 
-		// ʼ
+		// 初始化动作
 		virtual void Init() override;
 
-		// ¶
+		// 更新动作
 		virtual void Update() override;
 
-		// öʱ
+		// 重置动作时间
 		virtual void ResetTime() override;
 
 	protected:
@@ -819,4 +1361,266 @@ namespace easy2d
 	};
 
 
+	// 动作程序，将动作树编译为扁平的步骤表
+	// 程序创建后不再改变，可以同时在多个节点上执行，每个节点只保存少量的步骤状态
+	class ActionProgram
+		: public Ref
+	{
+		friend class RunProgram;
+
+	public:
+		// 步骤类型
+		enum class StepType
+		{
+			MoveBy,
+			MoveTo,
+			JumpBy,
+			JumpTo,
+			ScaleBy,
+			ScaleTo,
+			OpacityBy,
+			OpacityTo,
+			RotateBy,
+			RotateTo,
+			Delay,
+			Callback,
+			Tween,		/* 属性补间，通过保存的函数设置属性 */
+			Action,		/* 无法编译的动作 */
+			Sequence,
+			Spawn,
+			Loop
+		};
+
+		// 步骤，组合步骤的子步骤紧跟在其后，end 为子步骤结束后的位置
+		struct Step
+		{
+			StepType	type;
+			int			end;
+			int			param;		/* 跳跃次数、循环次数、回调或动作的位置 */
+			float		duration;
+			float		values[3];
+			Ease		ease;
+		};
+
+		// 属性补间的设置函数，按缓动值设置执行目标的属性
+		typedef void(*TweenFunc)(const Action * tween, Node * target, float eased);
+
+		explicit ActionProgram(
+			const Action * action	/* 要编译的动作 */
+		);
+
+		virtual ~ActionProgram();
+
+		// 获取步骤数量
+		size_t GetStepCount() const;
+
+		// 添加步骤，返回步骤的位置，仅在编译动作时调用
+		int AddStep(
+			StepType type,
+			float duration,
+			int param = 0,
+			float x = 0,
+			float y = 0,
+			float z = 0
+		);
+
+		// 设置补间步骤的缓动曲线，仅在编译动作时调用
+		void SetEase(
+			int index,
+			Ease ease
+		);
+
+		// 结束组合步骤，之后添加的步骤不再属于该步骤，仅在编译动作时调用
+		void EndStep(
+			int index
+		);
+
+		// 保存回调函数，返回回调的位置，仅在编译动作时调用
+		int AddCallback(
+			const Function& func
+		);
+
+		// 保存动作的拷贝，返回动作的位置，仅在编译动作时调用
+		// 未重写 Clone 的派生动作无法拷贝，程序直接借用原动作，此时它同一时间只能在一个节点上执行
+		int AddAction(
+			const Action * action
+		);
+
+		// 保存属性补间的拷贝和设置函数，返回补间的位置，仅在编译动作时调用
+		int AddTween(
+			const Action * tween,
+			TweenFunc func
+		);
+
+		// 编译子动作并记录其版本号，仅在编译动作时调用
+		void Compile(
+			const Action * action
+		);
+
+		// 编译后是否有子动作被修改
+		bool IsOutdated() const;
+
+	protected:
+		E2D_DISABLE_COPY(ActionProgram);
+
+		// 每个执行目标上的步骤状态
+		struct State
+		{
+			bool		begun;
+			bool		finished;
+			int			iteration;
+			float		offset;		/* 已完成的循环时长 */
+			float		length;		/* 步骤结束时的实际时长 */
+			float		values[6];	/* 起始值、上一帧的值、变化量 */
+			Action *	action;		/* 无法编译的动作在执行时的拷贝 */
+			int			tween;		/* 转交给补间管理器后的位置 */
+		};
+
+		// 获取补间步骤对应的补间属性，不能转交的步骤返回 Property::Count
+		static TweenManager::Property GetTweenProperty(
+			StepType type
+		);
+
+		// 在执行目标上执行步骤，elapsed 为步骤开始后经过的时间
+		// owner 不为空时，补间步骤在第一帧之后转交给补间管理器批量计算
+		void Run(
+			int index,
+			float elapsed,
+			State * states,
+			Node * target,
+			Action * owner = nullptr
+		) const;
+
+		// 开始执行补间步骤，记录执行目标的起始值
+		void Begin(
+			const Step& step,
+			State& state,
+			Node * target
+		) const;
+
+		// 按进度设置执行目标的属性
+		void Apply(
+			const Step& step,
+			State& state,
+			Node * target,
+			float progress
+		) const;
+
+		// 重置步骤及其子步骤的状态
+		void ResetStates(
+			int index,
+			State * states
+		) const;
+
+	protected:
+		std::vector<Step>			steps_;
+		std::vector<Function>		callbacks_;
+		std::vector<Action*>		actions_;
+		std::vector<bool>			borrowed_;	/* 未重写 Clone 的派生动作，直接执行原动作 */
+		std::vector<TweenFunc>		tween_funcs_;	/* 与 actions_ 对应，属性补间的设置函数 */
+		std::vector<const Action*>	sources_;	/* 子动作由父动作持有，程序不增加引用 */
+		std::vector<unsigned int>	versions_;
+	};
+
+
+	// 执行动作程序
+	class RunProgram
+		: public Action
+	{
+		friend class Action;
+
+	public:
+		explicit RunProgram(
+			ActionProgram * program,
+			Action * source = nullptr	/* 生成程序的动作，执行期间保持引用，名称和标签与其相同 */
+		);
+
+		virtual ~RunProgram();
+
+		// 获取该动作的拷贝对象，拷贝与原动作共享同一个动作程序
+		virtual RunProgram * Clone() const override;
+
+		// 获取该动作的倒转
+		virtual RunProgram * Reverse() const override
+		{
+			E2D_WARNING("Reverse() not supported in RunProgram");
+			return nullptr;
+		}
+
+		// 重置动作
+		virtual void Reset() override;
+
+		// 停止动作
+		virtual void Stop() override;
+
+		// 开始动作，同时记录为定义的执行目标
+		virtual void StartWithTarget(
+			Node* target
+		) override;
+
+		// 获取执行的程序，执行中的程序不会重新生成
+		virtual ActionProgram * GetProgram() const override;
+
+		// 获取生成程序的动作
+		Action * GetSource() const;
+
+	protected:
+		E2D_DISABLE_COPY(RunProgram);
+
+		// 初始化动作
+		virtual void Init() override;
+
+		// 更新动作
+		virtual void Update() override;
+
+		// 重置动作时间
+		virtual void ResetTime() override;
+
+		// 补间管理器写回转交后的进度和缓动值
+		virtual void UpdateTween(
+			float progress,
+			float eased
+		) override;
+
+		// 只包含单个补间步骤的程序转交给补间管理器
+		void LowerToTween();
+
+		// 释放步骤状态及其中保存的动作
+		void ClearStates();
+
+		// 所有执行都结束后将定义标记为结束
+		void UpdateSource();
+
+	protected:
+		float	elapsed_;
+		size_t	state_count_;
+		ActionProgram::State * states_;
+		Action * source_;
+		RunProgram * next_run_;
+	};
+
+
+	// 动作程序在 Tween 之后定义，编译函数在这里实现
+	template<typename T, typename Setter, typename EaseFunc, typename Lerp>
+	void Tween<T, Setter, EaseFunc, Lerp>::Compile(ActionProgram * program) const
+	{
+		// 派生的补间可能重写了 Update，只能按普通动作执行
+		if (typeid(*this) != typeid(Tween))
+		{
+			FiniteTimeAction::Compile(program);
+			return;
+		}
+
+		int index = program->AddStep(ActionProgram::StepType::Tween, duration_, program->AddTween(this, &Tween::Apply));
+		program->SetEase(index, ease_);
+	}
+
+	template<typename T, typename Setter, typename EaseFunc, typename Lerp>
+	void Tween<T, Setter, EaseFunc, Lerp>::Apply(const Action * action, Node * target, float eased)
+	{
+		auto tween = static_cast<const Tween*>(action);
+		tween->setter_(target, tween->lerp_(tween->from_, tween->to_, tween->ease_func_(eased)));
+	}
+
+
 }
\ No newline at end of file
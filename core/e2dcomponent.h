@@ -32,66 +32,66 @@ namespace easy2d
 		Button();
 
 		explicit Button(
-			Node * normal,					/* ͨ״̬ */
-			const Function& func = nullptr	/* ťĻص */
+			Node * normal,					/* 普通状态 */
+			const Function& func = nullptr	/* 按钮点击后的回调函数 */
 		);
 
 		explicit Button(
-			Node * normal,					/* ͨ״̬ */
-			Node * selected,				/* 갴״̬ */
-			const Function& func = nullptr	/* ťĻص */
+			Node * normal,					/* 普通状态 */
+			Node * selected,				/* 鼠标按下状态 */
+			const Function& func = nullptr	/* 按钮点击后的回调函数 */
 		);
 
 		explicit Button(
-			Node * normal,					/* ͨ״̬ */
-			Node * mouseover,				/* ״̬ */
-			Node * selected,				/* 갴״̬ */
-			const Function& func = nullptr	/* ťĻص */
+			Node * normal,					/* 普通状态 */
+			Node * mouseover,				/* 鼠标移入状态 */
+			Node * selected,				/* 鼠标按下状态 */
+			const Function& func = nullptr	/* 按钮点击后的回调函数 */
 		);
 
 		explicit Button(
-			Node * normal,					/* ͨ״̬ */
-			Node * mouseover,				/* ״̬ */
-			Node * selected,				/* ״̬ */
-			Node * disabled,				/* ť״̬ */
-			const Function& func = nullptr	/* ťĻص */
+			Node * normal,					/* 普通状态 */
+			Node * mouseover,				/* 鼠标移入状态 */
+			Node * selected,				/* 鼠标移入状态 */
+			Node * disabled,				/* 按钮禁用状态 */
+			const Function& func = nullptr	/* 按钮点击后的回调函数 */
 		);
 
-		// ȡť״̬ûǽ
+		// 获取按钮状态是启用还是禁用
 		bool IsEnable() const;
 
-		// ðťû
+		// 设置按钮启用或禁用
 		void SetEnabled(
 			bool enabled
 		);
 
-		// һʾİť
+		// 设置一般情况下显示的按钮
 		virtual void SetNormal(
 			Node * normal
 		);
 
-		// 밴ťʱʾİť
+		// 设置鼠标移入按钮时显示的按钮
 		virtual void SetMouseOver(
 			Node * mouseover
 		);
 
-		// 갴°ťʱʾİť
+		// 设置鼠标按下按钮时显示的按钮
 		virtual void SetSelected(
 			Node * selected
 		);
 
-		// ðťʱʾİť
+		// 设置按钮被禁用时显示的按钮
 		virtual void SetDisabled(
 			Node * disabled
 		);
 
-		// ðťĻص
+		// 设置按钮点击后的回调函数
 		void SetCallbackOnClick(
 			const Function& func
 		);
 
-		// ֧λ
-		// ĬΪ (0, 0), Χ [0, 1]
+		// 设置支点位置
+		// 默认为 (0, 0), 范围 [0, 1]
 		virtual void SetPivot(
 			float pivot_x,
 			float pivot_y
@@ -100,25 +100,30 @@ namespace easy2d
 	protected:
 		E2D_DISABLE_COPY(Button);
 
-		// ť״̬ö
+		// 按钮状态枚举
 		enum class Status { Normal, Mouseover, Selected };
 
-		// ðť״̬
+		// 设置按钮状态
 		virtual void SetStatus(
 			Status status
 		);
 
-		// ˢ°ťʾ
+		// 刷新按钮显示
 		virtual void UpdateVisible();
 
-		// ַϢ
-		virtual bool Dispatch(
+		// 按钮总是接收鼠标消息
+		virtual bool IsMouseListener() const override;
+
+		// 处理鼠标消息
+		virtual bool OnMouseEvent(
 			const MouseEvent& e,
 			bool handled
 		) override;
 
-		// ڵ
-		virtual void Visit() override;
+		// 遍历节点
+		virtual void Visit(
+			RenderCommandList& commands
+		) override;
 
 	protected:
 		Node * normal_;
@@ -132,7 +137,7 @@ namespace easy2d
 	};
 
 
-	// ˵
+	// 菜单
 	class Menu
 		: public Node
 	{
@@ -140,31 +145,31 @@ namespace easy2d
 		Menu();
 
 		explicit Menu(
-			const std::vector<Button*>& buttons	/* ť */
+			const std::vector<Button*>& buttons	/* 按钮数组 */
 		);
 
-		// ȡ˵Ƿ
+		// 获取菜单是否禁用
 		bool IsEnable() const;
 
-		// ȡ˵еİť
+		// 获取菜单中的按钮数量
 		size_t GetButtonCount() const;
 
-		// ò˵û
+		// 设置菜单启用或禁用
 		void SetEnabled(
 			bool enabled
 		);
 
-		// Ӱť
+		// 添加按钮
 		void AddButton(
 			Button * button
 		);
 
-		// Ƴť
+		// 移除按钮
 		bool RemoveButton(
 			Button * button
 		);
 
-		// ȡаť
+		// 获取所有按钮
 		const std::vector<Button*>& GetAllButtons() const;
 
 	protected:
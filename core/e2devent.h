@@ -25,15 +25,15 @@ namespace easy2d
 {
 
 
-	// Ϣ
+	// 按键消息
 	class KeyEvent
 	{
 	public:
-		// Ϣ
+		// 按键消息类型
 		enum class Type : int
 		{
-			Down = 0x0100,	// 
-			Up				// ̧
+			Down = 0x0100,	// 按下
+			Up				// 抬起
 		};
 
 	public:
@@ -43,13 +43,13 @@ namespace easy2d
 			LPARAM l_param
 		);
 
-		// ȡ¼
+		// 获取事件类型
 		KeyEvent::Type GetType() const;
 
-		// ȡֵ
+		// 获取按键键值
 		KeyCode GetCode() const;
 
-		// ȡ
+		// 获取按键次数
 		int GetCount() const;
 
 	protected:
@@ -59,24 +59,24 @@ namespace easy2d
 	};
 
 
-	// Ϣ
+	// 鼠标消息
 	class MouseEvent
 	{
 	public:
-		// Ϣ
+		// 鼠标消息类型
 		enum class Type : int
 		{
-			MoveBy = 0x0200,		// ƶ
-			LeftDown,			// 
-			LeftUp,				// ̧
-			LeftDoubleClick,	// ˫
-			RightDown,			// Ҽ
-			RightUp,			// Ҽ̧
-			RightDoubleClick,	// Ҽ˫
-			MiddleDown,			// м
-			MiddleUp,			// м̧
-			MiddleDoubleClick,	// м˫
-			Wheel				// 
+			MoveBy = 0x0200,		// 鼠标移动
+			LeftDown,			// 鼠标左键按下
+			LeftUp,				// 鼠标左键抬起
+			LeftDoubleClick,	// 鼠标左键双击
+			RightDown,			// 鼠标右键按下
+			RightUp,			// 鼠标右键抬起
+			RightDoubleClick,	// 鼠标右键双击
+			MiddleDown,			// 鼠标中键按下
+			MiddleUp,			// 鼠标中键抬起
+			MiddleDoubleClick,	// 鼠标中键双击
+			Wheel				// 滑动滚轮
 		};
 
 	public:
@@ -86,33 +86,33 @@ namespace easy2d
 			LPARAM l_param
 		);
 
-		// ȡ
+		// 获取鼠标横坐标
 		float GetX() const;
 
-		// ȡ
+		// 获取鼠标纵坐标
 		float GetY() const;
 
-		// ȡ
+		// 获取鼠标坐标
 		Point GetPosition() const;
 
-		// ȡ¼
+		// 获取事件类型
 		MouseEvent::Type GetType() const;
 
 		float GetWheelDelta() const;
 
-		// Ƿ
+		// 鼠标左键是否按下
 		bool IsLButtonDown() const;
 
-		// ҼǷ
+		// 鼠标右键是否按下
 		bool IsRButtonDown() const;
 
-		// мǷ
+		// 鼠标中键是否按下
 		bool IsMButtonDown() const;
 
-		// Shift Ƿ
+		// Shift 键是否按下
 		bool IsShiftDown() const;
 
-		// Ctrl Ƿ
+		// Ctrl 键是否按下
 		bool IsCtrlDown() const;
 
 	protected:
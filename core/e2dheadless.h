@@ -0,0 +1,523 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+// 无窗口环境下使用的 Win32 和 Direct2D 最小替代定义
+// 只包含节点树、动作、渲染命令录制等不依赖系统设备的代码需要的部分，
+// 使这些模块和测试可以在没有 Windows SDK 的平台上编译运行
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstdarg>
+#include <cstdio>
+#include <cmath>
+#include <cwchar>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <vector>
+
+
+// 基本类型
+
+typedef int					BOOL;
+typedef unsigned char		BYTE;
+typedef unsigned char		UINT8;
+typedef unsigned short		WORD;
+typedef unsigned int		UINT;
+typedef uint32_t			UINT32;
+typedef uint64_t			UINT64;
+typedef int					INT;
+typedef int32_t				LONG;
+typedef uint32_t			DWORD;
+typedef uint32_t			ULONG;
+typedef float				FLOAT;
+typedef int32_t				HRESULT;
+typedef wchar_t				WCHAR;
+typedef char *				LPSTR;
+typedef const char *		LPCSTR;
+typedef wchar_t *			LPWSTR;
+typedef const wchar_t *		LPCWSTR;
+typedef uintptr_t			WPARAM;
+typedef intptr_t			LPARAM;
+typedef intptr_t			LRESULT;
+typedef struct HWND__ *		HWND;
+typedef struct HINSTANCE__ *	HINSTANCE;
+typedef struct HCURSOR__ *	HCURSOR;
+
+#ifndef TRUE
+#	define TRUE 1
+#endif
+
+#ifndef FALSE
+#	define FALSE 0
+#endif
+
+#ifndef CONST
+#	define CONST const
+#endif
+
+#ifndef CALLBACK
+#	define CALLBACK
+#endif
+
+#ifndef STDMETHODCALLTYPE
+#	define STDMETHODCALLTYPE
+#endif
+
+#define S_OK			((HRESULT)0L)
+#define S_FALSE			((HRESULT)1L)
+#define E_FAIL			((HRESULT)0x80004005L)
+#define E_OUTOFMEMORY	((HRESULT)0x8007000EL)
+#define E_INVALIDARG	((HRESULT)0x80070057L)
+#define E_NOTIMPL		((HRESULT)0x80004001L)
+#define SUCCEEDED(hr)	(((HRESULT)(hr)) >= 0)
+#define FAILED(hr)		(((HRESULT)(hr)) < 0)
+
+#define LOWORD(l)		((WORD)(((uintptr_t)(l)) & 0xffff))
+#define HIWORD(l)		((WORD)((((uintptr_t)(l)) >> 16) & 0xffff))
+#define GET_KEYSTATE_WPARAM(wParam)		(LOWORD(wParam))
+#define GET_WHEEL_DELTA_WPARAM(wParam)	((short)HIWORD(wParam))
+
+#define MK_LBUTTON		0x0001
+#define MK_RBUTTON		0x0002
+#define MK_SHIFT		0x0004
+#define MK_CONTROL		0x0008
+#define MK_MBUTTON		0x0010
+
+#define VK_RETURN		0x0D
+#define VK_ESCAPE		0x1B
+#define VK_SPACE		0x20
+#define VK_LEFT			0x25
+#define VK_UP			0x26
+#define VK_RIGHT		0x27
+#define VK_DOWN			0x28
+#define VK_NUMPAD0		0x60
+#define VK_NUMPAD1		0x61
+#define VK_NUMPAD2		0x62
+#define VK_NUMPAD3		0x63
+#define VK_NUMPAD4		0x64
+#define VK_NUMPAD5		0x65
+#define VK_NUMPAD6		0x66
+#define VK_NUMPAD7		0x67
+#define VK_NUMPAD8		0x68
+#define VK_NUMPAD9		0x69
+
+
+// 原子操作和内存分配
+
+inline LONG InterlockedIncrement(volatile LONG * addend)
+{
+	return __atomic_add_fetch(addend, 1, __ATOMIC_SEQ_CST);
+}
+
+inline LONG InterlockedDecrement(volatile LONG * addend)
+{
+	return __atomic_sub_fetch(addend, 1, __ATOMIC_SEQ_CST);
+}
+
+inline void * _aligned_malloc(size_t size, size_t alignment)
+{
+	void * p = nullptr;
+	return ::posix_memalign(&p, alignment, size) == 0 ? p : nullptr;
+}
+
+inline void _aligned_free(void * p)
+{
+	::free(p);
+}
+
+
+
+// MSVC 运行库中的安全格式化函数
+
+template <size_t Size>
+inline int sprintf_s(char (&buffer)[Size], const char * format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	int count = std::vsnprintf(buffer, Size, format, args);
+	va_end(args);
+	return count;
+}
+
+inline int vsprintf_s(char * buffer, size_t size, const char * format, va_list args)
+{
+	return std::vsnprintf(buffer, size, format, args);
+}
+
+inline int vswprintf_s(wchar_t * buffer, size_t size, const wchar_t * format, va_list args)
+{
+	return std::vswprintf(buffer, size, format, args);
+}
+
+inline int _vscprintf(const char * format, va_list args)
+{
+	va_list copy;
+	va_copy(copy, args);
+	int count = std::vsnprintf(nullptr, 0, format, copy);
+	va_end(copy);
+	return count;
+}
+
+inline int _vscwprintf(const wchar_t * format, va_list args)
+{
+	// vswprintf 不能计算长度，逐步扩大缓冲区直到写得下
+	std::vector<wchar_t> buffer(256);
+	for (;;)
+	{
+		va_list copy;
+		va_copy(copy, args);
+		int count = std::vswprintf(buffer.data(), buffer.size(), format, copy);
+		va_end(copy);
+
+		if (count >= 0)
+			return count;
+		if (buffer.size() > (1u << 20))
+			return -1;
+		buffer.resize(buffer.size() * 2);
+	}
+}
+
+
+// 引擎使用到的 COM 接口，只保留引用计数
+
+struct IUnknown
+{
+	virtual ULONG STDMETHODCALLTYPE AddRef() = 0;
+	virtual ULONG STDMETHODCALLTYPE Release() = 0;
+
+protected:
+	virtual ~IUnknown() {}
+};
+
+struct D2D1_POINT_2F
+{
+	FLOAT x;
+	FLOAT y;
+};
+
+struct D2D1_SIZE_F
+{
+	FLOAT width;
+	FLOAT height;
+};
+
+struct D2D1_SIZE_U
+{
+	UINT32 width;
+	UINT32 height;
+};
+
+struct D2D1_RECT_F
+{
+	FLOAT left;
+	FLOAT top;
+	FLOAT right;
+	FLOAT bottom;
+};
+
+struct D2D1_RECT_U
+{
+	UINT32 left;
+	UINT32 top;
+	UINT32 right;
+	UINT32 bottom;
+};
+
+struct D2D1_COLOR_F
+{
+	FLOAT r;
+	FLOAT g;
+	FLOAT b;
+	FLOAT a;
+};
+
+struct D2D1_MATRIX_3X2_F
+{
+	FLOAT _11, _12;
+	FLOAT _21, _22;
+	FLOAT _31, _32;
+};
+
+enum D2D1_LINE_JOIN
+{
+	D2D1_LINE_JOIN_MITER = 0,
+	D2D1_LINE_JOIN_BEVEL = 1,
+	D2D1_LINE_JOIN_ROUND = 2,
+	D2D1_LINE_JOIN_MITER_OR_BEVEL = 3
+};
+
+struct ID2D1Resource : public IUnknown {};
+struct ID2D1Image : public ID2D1Resource {};
+struct ID2D1Brush : public ID2D1Resource {};
+struct ID2D1SolidColorBrush : public ID2D1Brush {};
+struct ID2D1StrokeStyle : public ID2D1Resource {};
+struct ID2D1Layer : public ID2D1Resource {};
+struct ID2D1Geometry : public ID2D1Resource {};
+struct ID2D1RectangleGeometry : public ID2D1Geometry {};
+struct ID2D1TransformedGeometry : public ID2D1Geometry {};
+struct ID2D1Factory : public IUnknown {};
+struct ID2D1RenderTarget : public ID2D1Resource {};
+struct ID2D1HwndRenderTarget : public ID2D1RenderTarget {};
+struct ID2D1DeviceContext : public ID2D1RenderTarget {};
+struct ID2D1DeviceContext3 : public ID2D1DeviceContext {};
+struct ID2D1Effect : public IUnknown {};
+struct ID2D1SpriteBatch : public ID2D1Resource {};
+struct IDWriteFactory : public IUnknown {};
+struct IDWriteTextFormat : public IUnknown {};
+struct IDWriteTextLayout : public IDWriteTextFormat {};
+struct IWICImagingFactory : public IUnknown {};
+struct IWICBitmapDecoder : public IUnknown {};
+struct IDirectInput8W : public IUnknown {};
+struct IDirectInputDevice8W : public IUnknown {};
+struct IXAudio2 : public IUnknown {};
+struct IXAudio2SourceVoice;
+struct IXAudio2MasteringVoice;
+struct WAVEFORMATEX;
+
+struct ID2D1Bitmap : public ID2D1Image
+{
+	virtual D2D1_SIZE_F STDMETHODCALLTYPE GetSize() const = 0;
+	virtual D2D1_SIZE_U STDMETHODCALLTYPE GetPixelSize() const = 0;
+};
+
+struct D2D1_LAYER_PARAMETERS
+{
+	D2D1_RECT_F contentBounds;
+	ID2D1Geometry * geometricMask;
+	int maskAntialiasMode;
+	D2D1_MATRIX_3X2_F maskTransform;
+	FLOAT opacity;
+	ID2D1Brush * opacityBrush;
+	int layerOptions;
+};
+
+struct DIMOUSESTATE
+{
+	LONG lX;
+	LONG lY;
+	LONG lZ;
+	BYTE rgbButtons[4];
+};
+
+
+namespace D2D1
+{
+	inline D2D1_POINT_2F Point2F(FLOAT x = 0.f, FLOAT y = 0.f)
+	{
+		D2D1_POINT_2F point = { x, y };
+		return point;
+	}
+
+	inline D2D1_SIZE_F SizeF(FLOAT width = 0.f, FLOAT height = 0.f)
+	{
+		D2D1_SIZE_F size = { width, height };
+		return size;
+	}
+
+	inline D2D1_SIZE_U SizeU(UINT32 width = 0, UINT32 height = 0)
+	{
+		D2D1_SIZE_U size = { width, height };
+		return size;
+	}
+
+	inline D2D1_RECT_F RectF(FLOAT left = 0.f, FLOAT top = 0.f, FLOAT right = 0.f, FLOAT bottom = 0.f)
+	{
+		D2D1_RECT_F rect = { left, top, right, bottom };
+		return rect;
+	}
+
+	inline D2D1_RECT_U RectU(UINT32 left = 0, UINT32 top = 0, UINT32 right = 0, UINT32 bottom = 0)
+	{
+		D2D1_RECT_U rect = { left, top, right, bottom };
+		return rect;
+	}
+
+	class ColorF
+		: public D2D1_COLOR_F
+	{
+	public:
+		enum Enum
+		{
+			Black = 0x000000,
+			Blue = 0x0000FF,
+			Green = 0x008000,
+			Red = 0xFF0000,
+			White = 0xFFFFFF,
+		};
+
+		ColorF(UINT32 rgb, FLOAT alpha = 1.f)
+		{
+			r = static_cast<FLOAT>((rgb & 0xff0000) >> 16) / 255.f;
+			g = static_cast<FLOAT>((rgb & 0x00ff00) >> 8) / 255.f;
+			b = static_cast<FLOAT>((rgb & 0x0000ff)) / 255.f;
+			a = alpha;
+		}
+
+		ColorF(FLOAT red, FLOAT green, FLOAT blue, FLOAT alpha = 1.f)
+		{
+			r = red;
+			g = green;
+			b = blue;
+			a = alpha;
+		}
+	};
+
+	// 与 d2d1helper.h 中的 Matrix3x2F 行为一致
+	class Matrix3x2F
+		: public D2D1_MATRIX_3X2_F
+	{
+	public:
+		Matrix3x2F()
+		{
+		}
+
+		Matrix3x2F(FLOAT m11, FLOAT m12, FLOAT m21, FLOAT m22, FLOAT m31, FLOAT m32)
+		{
+			_11 = m11; _12 = m12;
+			_21 = m21; _22 = m22;
+			_31 = m31; _32 = m32;
+		}
+
+		Matrix3x2F(const D2D1_MATRIX_3X2_F& other)
+		{
+			_11 = other._11; _12 = other._12;
+			_21 = other._21; _22 = other._22;
+			_31 = other._31; _32 = other._32;
+		}
+
+		static Matrix3x2F Identity()
+		{
+			return Matrix3x2F(1.f, 0.f, 0.f, 1.f, 0.f, 0.f);
+		}
+
+		static Matrix3x2F Translation(FLOAT x, FLOAT y)
+		{
+			return Matrix3x2F(1.f, 0.f, 0.f, 1.f, x, y);
+		}
+
+		static Matrix3x2F Translation(D2D1_SIZE_F size)
+		{
+			return Translation(size.width, size.height);
+		}
+
+		static Matrix3x2F Scale(FLOAT x, FLOAT y, D2D1_POINT_2F center = D2D1::Point2F())
+		{
+			return Matrix3x2F(x, 0.f, 0.f, y, center.x - x * center.x, center.y - y * center.y);
+		}
+
+		static Matrix3x2F Scale(D2D1_SIZE_F size, D2D1_POINT_2F center = D2D1::Point2F())
+		{
+			return Scale(size.width, size.height, center);
+		}
+
+		static Matrix3x2F Rotation(FLOAT angle, D2D1_POINT_2F center = D2D1::Point2F())
+		{
+			const FLOAT radian = angle * 3.14159265358979f / 180.f;
+			const FLOAT c = std::cos(radian);
+			const FLOAT s = std::sin(radian);
+			return Matrix3x2F(
+				c, s,
+				-s, c,
+				center.x - c * center.x + s * center.y,
+				center.y - s * center.x - c * center.y
+			);
+		}
+
+		static Matrix3x2F Skew(FLOAT angle_x, FLOAT angle_y, D2D1_POINT_2F center = D2D1::Point2F())
+		{
+			const FLOAT tan_x = std::tan(angle_x * 3.14159265358979f / 180.f);
+			const FLOAT tan_y = std::tan(angle_y * 3.14159265358979f / 180.f);
+			return Matrix3x2F(1.f, tan_y, tan_x, 1.f, -center.y * tan_x, -center.x * tan_y);
+		}
+
+		FLOAT Determinant() const
+		{
+			return _11 * _22 - _12 * _21;
+		}
+
+		bool IsInvertible() const
+		{
+			return Determinant() != 0.f;
+		}
+
+		bool Invert()
+		{
+			const FLOAT det = Determinant();
+			if (det == 0.f)
+				return false;
+
+			const Matrix3x2F m(*this);
+			_11 = m._22 / det;
+			_12 = -m._12 / det;
+			_21 = -m._21 / det;
+			_22 = m._11 / det;
+			_31 = (m._21 * m._32 - m._22 * m._31) / det;
+			_32 = (m._12 * m._31 - m._11 * m._32) / det;
+			return true;
+		}
+
+		bool IsIdentity() const
+		{
+			return _11 == 1.f && _12 == 0.f && _21 == 0.f && _22 == 1.f && _31 == 0.f && _32 == 0.f;
+		}
+
+		void SetProduct(const Matrix3x2F& a, const Matrix3x2F& b)
+		{
+			const FLOAT m11 = a._11 * b._11 + a._12 * b._21;
+			const FLOAT m12 = a._11 * b._12 + a._12 * b._22;
+			const FLOAT m21 = a._21 * b._11 + a._22 * b._21;
+			const FLOAT m22 = a._21 * b._12 + a._22 * b._22;
+			const FLOAT m31 = a._31 * b._11 + a._32 * b._21 + b._31;
+			const FLOAT m32 = a._31 * b._12 + a._32 * b._22 + b._32;
+			_11 = m11; _12 = m12;
+			_21 = m21; _22 = m22;
+			_31 = m31; _32 = m32;
+		}
+
+		Matrix3x2F operator*(const Matrix3x2F& other) const
+		{
+			Matrix3x2F result;
+			result.SetProduct(*this, other);
+			return result;
+		}
+
+		D2D1_POINT_2F TransformPoint(D2D1_POINT_2F point) const
+		{
+			return D2D1::Point2F(
+				point.x * _11 + point.y * _21 + _31,
+				point.x * _12 + point.y * _22 + _32
+			);
+		}
+
+		static Matrix3x2F* ReinterpretBaseType(D2D1_MATRIX_3X2_F* matrix)
+		{
+			return static_cast<Matrix3x2F*>(matrix);
+		}
+
+		static const Matrix3x2F* ReinterpretBaseType(const D2D1_MATRIX_3X2_F* matrix)
+		{
+			return static_cast<const Matrix3x2F*>(matrix);
+		}
+	};
+}
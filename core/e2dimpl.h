@@ -23,7 +23,9 @@
 
 namespace easy2d
 {
-	// Ⱦ
+#if !E2D_HEADLESS
+
+	// 文字渲染器
 	class TextRenderer
 		: public IDWriteTextRenderer
 	{
@@ -119,8 +121,15 @@ namespace easy2d
 		ID2D1StrokeStyle*		pCurrStrokeStyle_;
 	};
 
+#else
+
+	class TextRenderer;
+
+#endif
+
 
-	// ʱ쳣
+	// 运行时异常
+#if !E2D_HEADLESS
 	class RuntimeException
 		: public std::exception
 	{
@@ -137,13 +146,31 @@ namespace easy2d
 		{
 		}
 	};
+#else
+	class RuntimeException
+		: public std::runtime_error
+	{
+	public:
+		RuntimeException()
+			: runtime_error("unknown runtime exception")
+		{
+		}
+
+		explicit RuntimeException(
+			char const* const message
+		)
+			: runtime_error(message)
+		{
+		}
+	};
+#endif
 
 
 	inline void ThrowIfFailed(HRESULT hr)
 	{
 		if (FAILED(hr))
 		{
-			// ڴ˴öϵԲϵͳ쳣.
+			// 在此处设置断点以捕获系统异常.
 			static char s_str[64] = {};
 			sprintf_s(s_str, "Failure with HRESULT of %08X", static_cast<unsigned int>(hr));
 			throw RuntimeException(s_str);
@@ -20,6 +20,14 @@
 
 #pragma once
 
+// 不使用窗口和系统设备，仅编译节点树、动作和渲染命令录制等模块
+// 用于在没有 Windows SDK 的平台上运行测试和性能测试
+#ifndef E2D_HEADLESS
+#	define E2D_HEADLESS 0
+#endif
+
+#if !E2D_HEADLESS
+
 #ifndef WINVER
 #	define WINVER 0x0700	   // Allow use of features specific to Windows 7 or later
 #endif
@@ -55,6 +63,8 @@
 #include <wincodec.h>
 #include <mmsystem.h>
 #include <d2d1.h>
+#include <d2d1_1.h>
+#include <d2d1effects.h>
 #include <dwrite.h>
 #include <dinput.h>
 #include <xaudio2.h>
@@ -63,19 +73,6 @@
 #include <mfreadwrite.h>
 #include <shlwapi.h>
 
-// C++ RunTime Header Files
-#include <map>
-#include <set>
-#include <list>
-#include <stack>
-#include <vector>
-#include <random>
-#include <utility>
-#include <chrono>
-#include <sstream>
-#include <functional>
-#include <algorithm>
-
 // Import Libraries
 #pragma comment(lib, "d2d1.lib")
 #pragma comment(lib, "dwrite.lib")
@@ -93,22 +90,90 @@
 #	define HINST_THISCOMPONENT ((HINSTANCE)&__ImageBase)
 #endif
 
+#else
+
+#include "e2dheadless.h"
 
-#if _MSC_VER >= 1800
+#endif
+
+// C++ RunTime Header Files
+#include <map>
+#include <unordered_map>
+#include <set>
+#include <list>
+#include <deque>
+#include <stack>
+#include <vector>
+#include <random>
+#include <utility>
+#include <chrono>
+#include <sstream>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <typeinfo>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+
+#if !defined(_MSC_VER) || _MSC_VER >= 1800
 #	define E2D_OP_EXPLICIT explicit
 #else
 #	define E2D_OP_EXPLICIT
 #endif
 
 
-#if _MSC_VER >= 1900
+// 引用计数是否使用原子操作，仅在单线程中使用引擎时可定义为 0
+// 定义为 0 时线程池和异步队列的任务在调用线程中直接执行
+#ifndef E2D_ATOMIC_REF_COUNT
+#	define E2D_ATOMIC_REF_COUNT 1
+#endif
+
+
+// 是否使用 SIMD 指令批量计算补间，非 x86 平台使用普通循环
+#ifndef E2D_SIMD
+#	if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#		define E2D_SIMD 1
+#	else
+#		define E2D_SIMD 0
+#	endif
+#endif
+
+
+// 是否使用 ID2D1SpriteBatch 绘制精灵批次，需要 Windows 10 SDK
+// 默认在找到 d2d1_3.h 时启用，运行时系统不支持时仍然逐个绘制精灵
+#ifndef E2D_SPRITE_BATCH
+#	if !E2D_HEADLESS && defined(__has_include)
+#		if __has_include(<d2d1_3.h>) && defined(NTDDI_WIN10_RS1)
+#			define E2D_SPRITE_BATCH 1
+#		endif
+#	endif
+#	ifndef E2D_SPRITE_BATCH
+#		define E2D_SPRITE_BATCH 0
+#	endif
+#endif
+
+#if E2D_SPRITE_BATCH
+// ID2D1DeviceContext3 只在目标系统版本不低于 Windows 10 1607 时声明
+#	pragma push_macro("NTDDI_VERSION")
+#	undef NTDDI_VERSION
+#	define NTDDI_VERSION NTDDI_WIN10_RS1
+#	include <d2d1_3.h>
+#	pragma pop_macro("NTDDI_VERSION")
+#endif
+
+
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
 #	define E2D_NOEXCEPT noexcept
 #else
 #	define E2D_NOEXCEPT throw()
 #endif
 
 
-#if _MSC_VER >= 1800
+#if !defined(_MSC_VER) || _MSC_VER >= 1800
 #	define E2D_DISABLE_COPY(Class) \
 	Class(const Class &) = delete; \
 	Class & operator= (const Class &) = delete
@@ -119,6 +184,14 @@
 #endif
 
 
+// 线程局部变量
+#ifdef _MSC_VER
+#	define E2D_THREAD_LOCAL __declspec(thread)
+#else
+#	define E2D_THREAD_LOCAL thread_local
+#endif
+
+
 #ifdef max
 #	undef max
 #endif
@@ -128,6 +201,28 @@
 #endif
 
 
+#if E2D_HEADLESS
+
+// 无窗口环境下警告输出到标准错误流
+#ifndef E2D_WARNING
+#	if defined( DEBUG ) || defined( _DEBUG )
+#		define E2D_WARNING(msg, ...) do { std::fprintf(stderr, "Warning: %s\n", #msg); } while(0)
+#	else
+#		define E2D_WARNING(msg, ...) ((void)0)
+#	endif
+#endif
+
+
+#ifndef E2D_WARNING_IF
+#	if defined( DEBUG ) || defined( _DEBUG )
+#		define E2D_WARNING_IF(exp, msg, ...) do { if (exp) { std::fprintf(stderr, "Warning: %s\n", #msg); } } while(0)
+#	else
+#		define E2D_WARNING_IF(exp, msg, ...) ((void)0)
+#	endif
+#endif
+
+#else
+
 #ifdef UNICODE
 #	define OutputDebugStringEx OutputDebugStringExW
 #else
@@ -182,3 +277,5 @@ void OutputDebugStringExA(LPCSTR pszOutput, ...)
 	OutputDebugStringA(psBuffer);
 	delete [] psBuffer;
 }
+
+#endif
@@ -27,8 +27,275 @@
 namespace easy2d
 {
 
-	// ͼ豸
+	// 渲染命令，只保存数值和资源指针
+	struct RenderCommand
+	{
+		enum class Type
+		{
+			Transform,	// 设置二维变换
+			PushClip,	// 压入裁剪区域
+			PopClip,	// 弹出裁剪区域
+			Opacity,	// 设置画刷透明度
+			Bitmap,		// 绘制位图
+			Text,		// 绘制文字布局
+			Geometry,	// 绘制几何图形轮廓
+			Sprites,	// 绘制精灵批次
+			Custom		// 调用节点的 Draw 函数
+		};
+
+		Type type;
+
+		union
+		{
+			D2D1_MATRIX_3X2_F transform;
+
+			D2D1_RECT_F clip;
+
+			float opacity;
+
+			struct
+			{
+				ID2D1Bitmap * bitmap;
+				D2D1_RECT_F dest;
+				D2D1_RECT_F src;
+				float opacity;
+			} bitmap;
+
+			struct
+			{
+				IDWriteTextLayout * layout;
+				D2D1_COLOR_F color;
+				D2D1_COLOR_F outline_color;
+				float outline_width;
+				BOOL outline;
+				D2D1_LINE_JOIN line_join;
+			} text;
+
+			struct
+			{
+				ID2D1Geometry * geometry;
+				D2D1_COLOR_F color;
+				float stroke_width;
+			} geometry;
+
+			struct
+			{
+				ID2D1Bitmap * bitmap;
+				const D2D1_RECT_F * dests;
+				const D2D1_RECT_F * srcs;
+				const D2D1_MATRIX_3X2_F * transforms;
+				const D2D1_COLOR_F * colors;
+				const float * opacities;
+				UINT32 count;
+				float opacity;
+			} sprites;
+
+			const Node * node;
+		};
+	};
+
+
+	// 渲染命令列表，由节点遍历生成，交给渲染后端回放
+	// 命令中的资源指针只在生成它的这一帧内有效
+	class RenderCommandList
+	{
+	public:
+		RenderCommandList();
+
+		// 清空命令，保留已分配的空间
+		void Clear();
+
+		// 设置二维变换
+		void SetTransform(
+			const D2D1_MATRIX_3X2_F& matrix
+		);
+
+		// 压入裁剪区域
+		void PushClip(
+			const D2D1_RECT_F& rect
+		);
+
+		// 弹出裁剪区域
+		void PopClip();
+
+		// 设置画刷透明度
+		void SetOpacity(
+			float opacity
+		);
+
+		// 绘制位图
+		void DrawBitmap(
+			ID2D1Bitmap * bitmap,
+			const D2D1_RECT_F& dest,
+			const D2D1_RECT_F& src,
+			float opacity
+		);
+
+		// 绘制文字布局
+		void DrawTextLayout(
+			IDWriteTextLayout * layout,
+			const D2D1_COLOR_F& color,
+			BOOL outline,
+			const D2D1_COLOR_F& outline_color,
+			float outline_width,
+			D2D1_LINE_JOIN line_join
+		);
+
+		// 绘制几何图形轮廓
+		void DrawGeometry(
+			ID2D1Geometry * geometry,
+			const D2D1_COLOR_F& color,
+			float stroke_width
+		);
+
+		// 绘制精灵批次，数组在回放前必须保持有效
+		void DrawSprites(
+			ID2D1Bitmap * bitmap,
+			const D2D1_RECT_F * dests,
+			const D2D1_RECT_F * srcs,
+			const D2D1_MATRIX_3X2_F * transforms,
+			const D2D1_COLOR_F * colors,
+			const float * opacities,
+			UINT32 count,
+			float opacity
+		);
+
+		// 回放时调用节点的 Draw 函数
+		void DrawNode(
+			const Node * node
+		);
+
+		// 丢弃指定位置之后的命令
+		void Rewind(
+			size_t count
+		);
+
+		// 获取命令数量
+		size_t GetCount() const;
+
+		// 获取全部命令
+		const std::vector<RenderCommand>& GetCommands() const;
+
+	protected:
+		E2D_DISABLE_COPY(RenderCommandList);
+
+	protected:
+		std::vector<RenderCommand> commands_;
+	};
+
+
+	// 渲染后端，回放命令列表时跳过重复的状态切换
+	class RenderBackend
+	{
+	public:
+		RenderBackend();
+
+		virtual ~RenderBackend();
+
+		// 回放渲染命令
+		void Replay(
+			const RenderCommandList& commands
+		);
+
+	protected:
+		// 清除缓存的渲染状态，下一次状态切换一定会执行
+		void ResetState();
+
+		// 设置二维变换
+		virtual void ApplyTransform(
+			const D2D1_MATRIX_3X2_F& matrix
+		) = 0;
+
+		// 设置画刷透明度
+		virtual void ApplyOpacity(
+			float opacity
+		) = 0;
+
+		// 设置画刷颜色
+		virtual void ApplyColor(
+			const D2D1_COLOR_F& color
+		) = 0;
+
+		// 压入裁剪区域
+		virtual void PushClip(
+			const D2D1_RECT_F& rect
+		) = 0;
+
+		// 弹出裁剪区域
+		virtual void PopClip() = 0;
+
+		// 执行绘制命令
+		virtual void Draw(
+			const RenderCommand& command
+		) = 0;
+
+	protected:
+		bool				transform_valid_;
+		bool				opacity_valid_;
+		bool				color_valid_;
+		float				opacity_;
+		D2D1_MATRIX_3X2_F	transform_;
+		D2D1_COLOR_F		color_;
+		int					skipped_count_;
+	};
+
+
+	// 只记录回放结果的渲染后端，不需要窗口和渲染目标
+	// 用于统计绘制调用和状态切换的次数
+	class RenderRecorder
+		: public RenderBackend
+	{
+	public:
+		RenderRecorder();
+
+		// 清空记录
+		void Clear();
+
+		// 获取实际执行的命令，不包含画刷颜色的切换
+		const std::vector<RenderCommand>& GetCommands() const;
+
+		// 获取绘制调用次数
+		int GetDrawCallCount() const;
+
+		// 获取状态切换次数，包括变换、画刷透明度和画刷颜色
+		int GetStateChangeCount() const;
+
+		// 获取被跳过的重复状态切换次数
+		int GetSkippedCount() const;
+
+	protected:
+		virtual void ApplyTransform(
+			const D2D1_MATRIX_3X2_F& matrix
+		) override;
+
+		virtual void ApplyOpacity(
+			float opacity
+		) override;
+
+		virtual void ApplyColor(
+			const D2D1_COLOR_F& color
+		) override;
+
+		virtual void PushClip(
+			const D2D1_RECT_F& rect
+		) override;
+
+		virtual void PopClip() override;
+
+		virtual void Draw(
+			const RenderCommand& command
+		) override;
+
+	protected:
+		int draw_call_count_;
+		int state_change_count_;
+		std::vector<RenderCommand> commands_;
+	};
+
+
+	// 图形设备
 	class Graphics
+		: public RenderBackend
 	{
 	public:
 		Graphics(
@@ -37,45 +304,76 @@ namespace easy2d
 
 		~Graphics();
 
-		// ʼȾ
+		// 开始渲染
 		void BeginDraw();
 
-		// Ⱦ
+		// 结束渲染
 		void EndDraw();
 
-		// ȾϢ
+		// 渲染调试信息
 		void DrawDebugInfo();
 
-		// ȡ ID2D1Factory 
+		// 获取 ID2D1Factory 对象
 		ID2D1Factory * GetFactory() const;
 
-		// ȡ IWICImagingFactory 
+		// 获取 IWICImagingFactory 对象
 		IWICImagingFactory * GetImagingFactory() const;
 
-		// ȡ IDWriteFactory 
+		// 获取 IDWriteFactory 对象
 		IDWriteFactory * GetWriteFactory() const;
 
-		// ȡ ID2D1HwndRenderTarget 
+		// 获取 ID2D1HwndRenderTarget 对象
 		ID2D1HwndRenderTarget * GetRenderTarget() const;
 
-		// ȡ ID2D1SolidColorBrush 
+		// 获取 ID2D1SolidColorBrush 对象
 		ID2D1SolidColorBrush * GetSolidBrush() const;
 
-		// ȡȾ
+		// 获取文字渲染工具
 		TextRenderer * GetTextRender() const;
 
-		// ȡ Miter ʽ ID2D1StrokeStyle
+		// 获取 Miter 样式的 ID2D1StrokeStyle
 		ID2D1StrokeStyle * GetMiterStrokeStyle();
 
-		// ȡ Bevel ʽ ID2D1StrokeStyle
+		// 获取 Bevel 样式的 ID2D1StrokeStyle
 		ID2D1StrokeStyle * GetBevelStrokeStyle();
 
-		// ȡ Round ʽ ID2D1StrokeStyle
+		// 获取 Round 样式的 ID2D1StrokeStyle
 		ID2D1StrokeStyle * GetRoundStrokeStyle();
 
-		// ȡ DPI
+		// 获取 DPI
 		static float GetDpi();
 
+		// 获取每帧共用的渲染命令列表
+		RenderCommandList& GetCommandList();
+
+	protected:
+		virtual void ApplyTransform(
+			const D2D1_MATRIX_3X2_F& matrix
+		) override;
+
+		virtual void ApplyOpacity(
+			float opacity
+		) override;
+
+		virtual void ApplyColor(
+			const D2D1_COLOR_F& color
+		) override;
+
+		virtual void PushClip(
+			const D2D1_RECT_F& rect
+		) override;
+
+		virtual void PopClip() override;
+
+		virtual void Draw(
+			const RenderCommand& command
+		) override;
+
+		// 绘制精灵批次
+		void DrawSprites(
+			const RenderCommand& command
+		);
+
 	protected:
 		D2D1_COLOR_F			clear_color_;
 		ID2D1Factory*			factory_;
@@ -89,10 +387,20 @@ namespace easy2d
 		IDWriteTextLayout*		fps_text_layout_;
 		ID2D1SolidColorBrush*	solid_brush_;
 		ID2D1HwndRenderTarget*	render_target_;
+		RenderCommandList		commands_;
+		ID2D1DeviceContext*		tint_context_;
+		ID2D1Effect*			tint_effect_;
+
+#if E2D_SPRITE_BATCH
+		ID2D1DeviceContext3*		device_context_;
+		ID2D1SpriteBatch*			sprite_batch_;
+		std::vector<D2D1_RECT_U>	sprite_srcs_;
+		std::vector<D2D1_COLOR_F>	sprite_colors_;
+#endif
 	};
 
 
-	// 豸
+	// 输入设备
 	class Input
 	{
 	public:
@@ -102,35 +410,35 @@ namespace easy2d
 
 		~Input();
 
-		// ĳǷ
+		// 检测键盘某按键是否正被按下
 		bool IsDown(
 			KeyCode key
 		);
 
-		// 갴Ƿ
+		// 检测鼠标按键是否正被按下
 		bool IsDown(
 			MouseCode code
 		);
 
-		// Xֵ
+		// 获得鼠标X轴坐标值
 		float GetMouseX();
 
-		// Yֵ
+		// 获得鼠标Y轴坐标值
 		float GetMouseY();
 
-		// ֵ
+		// 获得鼠标坐标值
 		Point GetMousePos();
 
-		// X
+		// 获得鼠标X轴坐标增量
 		float GetMouseDeltaX();
 
-		// Y
+		// 获得鼠标Y轴坐标增量
 		float GetMouseDeltaY();
 
-		// Zᣨ֣
+		// 获得鼠标Z轴（鼠标滚轮）坐标增量
 		float GetMouseDeltaZ();
 
-		// ˢ豸״̬
+		// 刷新设备状态
 		void Flush();
 
 	protected:
@@ -141,7 +449,7 @@ namespace easy2d
 		char					key_buffer_[256];
 	};
 
-	// Ƶ豸
+	// 音频设备
 	class Audio
 	{
 	public:
@@ -149,13 +457,13 @@ namespace easy2d
 
 		~Audio();
 
-		// 豸
+		// 开启设备
 		void Open();
 
-		// ر豸
+		// 关闭设备
 		void Close();
 
-		// Դ
+		// 创建音源
 		HRESULT CreateVoice(
 			IXAudio2SourceVoice ** voice,
 			WAVEFORMATEX * wfx
@@ -167,37 +475,168 @@ namespace easy2d
 	};
 
 
-	// 豸
+	// 工作线程池，空闲线程会从其他线程的队列中窃取任务
+	// 工作线程在第一次添加任务时才会创建
+	// 引用计数不使用原子操作时不创建工作线程，任务在 Submit 中直接执行
+	class ThreadPool
+	{
+	public:
+		typedef std::function<void()> Job;
+
+		explicit ThreadPool(
+			size_t thread_count = 0	/* 线程数量，为 0 时根据 CPU 核心数决定 */
+		);
+
+		~ThreadPool();
+
+		// 添加任务
+		void Submit(
+			const Job& job
+		);
+
+		// 等待所有任务完成，等待期间调用线程也会执行任务
+		// 任务中抛出的第一个异常会在这里重新抛出
+		void Wait();
+
+		// 获取工作线程数量
+		size_t GetThreadCount() const;
+
+		// 工作线程是否已经创建
+		bool IsStarted() const;
+
+	protected:
+		E2D_DISABLE_COPY(ThreadPool);
+
+		// 创建工作线程
+		void Start();
+
+		struct Worker
+		{
+			std::deque<Job> jobs;
+			std::mutex mutex;
+		};
+
+		// 取出一个任务，先从自身队列尾部取，再从其他队列头部窃取
+		bool Take(
+			size_t index,
+			Job& job
+		);
+
+		// 执行任务
+		void Run(
+			Job& job
+		);
+
+		// 工作线程主循环
+		void WorkerMain(
+			size_t index
+		);
+
+	protected:
+		bool					quit_;
+		size_t					thread_count_;
+		std::once_flag			start_flag_;
+		std::atomic<bool>		started_;
+		std::vector<Worker*>	workers_;
+		std::vector<std::thread> threads_;
+		std::atomic<size_t>		next_;
+		std::atomic<size_t>		queued_;
+		std::atomic<size_t>		pending_;
+		std::mutex				wake_mutex_;
+		std::condition_variable	wake_;
+		std::mutex				done_mutex_;
+		std::condition_variable	done_;
+		std::exception_ptr		error_;
+	};
+
+
+	// 异步任务队列，任务在独立的工作线程中执行，完成回调由主线程在每帧统一调用
+	class AsyncQueue
+	{
+	public:
+		// 取消标记，置位后尚未开始的任务和尚未调用的完成回调都会被跳过
+		typedef std::shared_ptr<std::atomic<bool>> Token;
+
+		explicit AsyncQueue(
+			size_t thread_count = 0	/* 线程数量，为 0 时根据 CPU 核心数决定 */
+		);
+
+		~AsyncQueue();
+
+		// 添加任务，任务完成后在主线程中调用完成回调
+		void Submit(
+			const Function& job,			/* 在工作线程中执行的任务 */
+			const Function& on_complete,	/* 在主线程中执行的完成回调 */
+			const Token& token				/* 取消标记 */
+		);
+
+		// 调用所有已完成任务的回调，只能在主线程中调用
+		// 任务中抛出的第一个异常会在这里重新抛出
+		void Dispatch();
+
+		// 获取尚未调用完成回调的任务数量
+		size_t GetPendingCount() const;
+
+	protected:
+		E2D_DISABLE_COPY(AsyncQueue);
+
+		struct Completion
+		{
+			Function			callback;
+			Token				token;
+			std::exception_ptr	error;
+			Completion *		next;
+		};
+
+		// 将完成的任务放入完成队列，可以在任意线程中调用
+		void Push(
+			Completion * completion
+		);
+
+	protected:
+		ThreadPool *				pool_;
+		std::atomic<Completion*>	completed_;
+		std::atomic<size_t>			pending_;
+	};
+
+
+	// 设备
 	class Device
 	{
 	public:
-		// ȡͼ豸
+		// 获取图形设备
 		static Graphics * GetGraphics();
 
-		// ȡ豸
+		// 获取输入设备
 		static Input * GetInput();
 
-		// ȡƵ豸
+		// 获取音频设备
 		static Audio * GetAudio();
 
-		// ʼ
+		// 获取工作线程池
+		static ThreadPool * GetThreadPool();
+
+		// 获取异步任务队列
+		static AsyncQueue * GetAsyncQueue();
+
+		// 初始化
 		static void Init(
 			HWND hwnd
 		);
 
-		// Դ
+		// 销毁资源
 		static void Destroy();
 	};
 
 
-	// ѡ
+	// 启动选项
 	struct Options
 	{
-		String	title;		// 
-		int		width;		// 
-		int		height;		// ߶
-		int		icon;		// ͼԴ ID
-		bool	debug_mode;	// ģʽ
+		String	title;		// 标题
+		int		width;		// 宽度
+		int		height;		// 高度
+		int		icon;		// 图标资源 ID
+		bool	debug_mode;	// 调试模式
 
 		Options()
 			: title(L"Easy2D Game")
@@ -210,80 +649,101 @@ namespace easy2d
 	};
 
 
-	// Ϸ
+	// 游戏控制器
 	class Game
 	{
 	public:
-		// ʼ
+		// 开始
 		virtual void Start() = 0;
 
-		// 
+		// 更新
 		virtual void Update(float dt) {}
 
-		// 
+		// 运行
 		void Run(
 			const Options& options = Options()
 		);
 
-		// 
+		// 结束
 		void Quit();
 
-		// رմʱ
-		// ֵ false ֹڹر
+		// 关闭窗口时触发
+		// 返回值：返回 false 将阻止窗口关闭
 		virtual bool OnExit() { return true; }
 
-		// ޸ĴС
+		// 修改窗体大小
 		void SetSize(
-			int width,			/*  */
-			int height			/* ߶ */
+			int width,			/* 窗体宽度 */
+			int height			/* 窗体高度 */
 		);
 
-		// ô
+		// 设置窗体标题
 		void SetTitle(
-			const String& title	/*  */
+			const String& title	/* 窗体标题 */
 		);
 
-		// ôͼ
+		// 设置窗体图标
 		void SetIcon(
-			int resource_id		/* ͼԴ ID */
+			int resource_id		/* 图标资源 ID */
 		);
 
-		// ȡ
+		// 获取窗体标题
 		const String& GetTitle() const;
 
-		// ȡ
+		// 获取窗体宽度
 		int GetWidth() const;
 
-		// ȡ߶
+		// 获取窗体高度
 		int GetHeight() const;
 
-		// ȡС
+		// 获取窗体大小
 		Size GetSize() const;
 
-		// ȡھ
+		// 获取窗口句柄
 		HWND GetHWnd() const;
 
-		// л
+		// 设置全局时间缩放比例
+		// 默认为 1.0
+		void SetTimeScale(
+			float scale
+		);
+
+		// 获取全局时间缩放比例
+		float GetTimeScale() const;
+
+		// 设置固定更新步长（秒），每次更新都使用相同的时间间隔，用于确定性回放
+		// 设为 0 时关闭固定步长，默认为 0
+		void SetFixedTimeStep(
+			float step
+		);
+
+		// 获取固定更新步长
+		float GetFixedTimeStep() const;
+
+		// 获取游戏时钟的当前时间，游戏时钟按缩放后的时间前进
+		const Time& GetTime() const;
+
+		// 切换场景
 		void EnterScene(
-			Scene * scene,						/*  */
-			Transition * transition	= nullptr	/*  */
+			Scene * scene,						/* 场景 */
+			Transition * transition	= nullptr	/* 场景动画 */
 		);
 
-		// ȡǰ
+		// 获取当前场景
 		Scene * GetCurrentScene();
 
-		// Ƿڽг
+		// 是否正在进行场景过渡
 		bool IsTransitioning() const;
 
-		// ³
+		// 更新场景内容
 		void UpdateScene(
 			float dt
 		);
 
-		// Ⱦ
+		// 渲染场景画面
 		void DrawScene();
 
-		// ȡʵ
+		// 获取实例
 		static Game * GetInstance();
 
 	protected:
@@ -291,16 +751,16 @@ namespace easy2d
 
 		~Game();
 
-		// ʼ
+		// 初始化
 		void Init();
 
-		// ݿͻСλ
+		// 根据客户区大小定位窗口
 		Rect Locate(
 			int width,
 			int height
 		);
 
-		// Win32 Ϣص
+		// Win32 窗口消息回调程序
 		static LRESULT CALLBACK WndProc(
 			HWND hwnd,
 			UINT msg,
@@ -319,6 +779,11 @@ namespace easy2d
 		Scene*		curr_scene_;
 		Scene*		next_scene_;
 		Transition*	transition_;
+		float		time_scale_;
+		float		time_carry_;
+		float		fixed_step_;
+		float		step_accumulator_;
+		Time		time_;
 	};
 
 }
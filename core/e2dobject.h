@@ -27,10 +27,151 @@ namespace easy2d
 {
 
 
-	// ͼƬ
+	// 图片解码器
+	// 将图片文件数据解码为预乘透明度的 32 位 BGRA 像素，Decode 可以在工作线程中调用
+	class ImageDecoder
+	{
+	public:
+		virtual ~ImageDecoder() {}
+
+		// 解码图片数据
+		virtual bool Decode(
+			const BYTE * data,
+			size_t size,
+			UINT * width,
+			UINT * height,
+			std::vector<BYTE>& pixels
+		) = 0;
+
+		// 读取图片文件并解码
+		bool DecodeFile(
+			const String& file_path,
+			UINT * width,
+			UINT * height,
+			std::vector<BYTE>& pixels
+		);
+
+		// 获取加载图片时使用的解码器，默认使用 WIC，无窗口环境下使用 PortableImageDecoder
+		static ImageDecoder * GetCurrent();
+
+		// 设置加载图片时使用的解码器，为空时恢复默认解码器
+		// 需要在没有图片正在解码时调用
+		static void SetCurrent(
+			ImageDecoder * decoder
+		);
+	};
+
+
+	// 通用图片解码器
+	// 不依赖系统组件，支持非隔行扫描的 PNG 和未压缩的 24 / 32 位 BMP
+	class PortableImageDecoder
+		: public ImageDecoder
+	{
+	public:
+		virtual bool Decode(
+			const BYTE * data,
+			size_t size,
+			UINT * width,
+			UINT * height,
+			std::vector<BYTE>& pixels
+		) override;
+	};
+
+
+	// WIC 图片解码器，支持系统中安装的所有图片格式
+	// 每个调用线程第一次解码时初始化 COM
+	class WicImageDecoder
+		: public ImageDecoder
+	{
+	public:
+		virtual bool Decode(
+			const BYTE * data,
+			size_t size,
+			UINT * width,
+			UINT * height,
+			std::vector<BYTE>& pixels
+		) override;
+	};
+
+
+	// 位图缓存
+	// 缓存持有每张位图的一个引用，超出预算时释放最近最少使用且没有被引用的位图
+	// 程序退出时不释放位图，需要在图形设备销毁前调用 Clear
+	class BitmapCache
+	{
+	public:
+		typedef LruCache::Stats Stats;
+
+		explicit BitmapCache(
+			size_t budget = 0	/* 字节预算，为 0 时不限制 */
+		);
+
+		// 设置字节预算，并释放超出预算的位图
+		void SetBudget(
+			size_t bytes
+		);
+
+		// 获取字节预算
+		size_t GetBudget() const;
+
+		// 获取缓存统计
+		const Stats& GetStats() const;
+
+		// 是否包含位图，不计入统计
+		bool Contains(
+			size_t key
+		) const;
+
+		// 查找位图，计入命中或未命中次数
+		bool Lookup(
+			size_t key
+		);
+
+		// 添加位图，缓存接管位图的一个引用
+		void Add(
+			size_t key,
+			ID2D1Bitmap * bitmap
+		);
+
+		// 获取位图，不计入统计也不增加引用，没有该位图时返回空
+		ID2D1Bitmap * Get(
+			size_t key
+		) const;
+
+		// 引用位图，被引用的位图不会被释放，没有该位图时返回空
+		ID2D1Bitmap * Acquire(
+			size_t key
+		);
+
+		// 取消引用，引用归零时释放超出预算的位图
+		void Release(
+			size_t key
+		);
+
+		// 释放超出预算且没有被引用的位图
+		void Trim();
+
+		// 释放所有位图，保留统计次数
+		void Clear();
+
+	protected:
+		E2D_DISABLE_COPY(BitmapCache);
+
+	protected:
+		std::map<size_t, ID2D1Bitmap*> bitmaps_;
+		LruCache records_;	/* 位图的字节数、引用次数和使用顺序 */
+		std::vector<size_t> evicted_;
+	};
+
+
+	// 图片
 	class Image
 		: public Ref
 	{
+	public:
+		// 位图缓存统计
+		typedef LruCache::Stats CacheStats;
+
 	public:
 		Image();
 
@@ -40,7 +181,7 @@ namespace easy2d
 
 		explicit Image(
 			const Resource& res,
-			const Rect& crop_rect	/* ü */
+			const Rect& crop_rect	/* 裁剪矩形 */
 		);
 
 		explicit Image(
@@ -49,94 +190,522 @@ namespace easy2d
 
 		explicit Image(
 			const String& file_name,
-			const Rect& crop_rect	/* ü */
+			const Rect& crop_rect	/* 裁剪矩形 */
 		);
 
 		virtual ~Image();
 
-		// ͼƬԴ
+		// 加载图片资源
 		bool Load(
 			const Resource& res
 		);
 
-		// ͼƬԴ
+		// 加载图片资源
 		bool Load(
 			const String& file_name
 		);
 
-		// ͼƬüΪ
+		// 异步加载图片文件
+		// 解码在工作线程中进行，完成前图片显示为透明的占位图
+		void LoadAsync(
+			const String& file_name,
+			const Function& on_loaded = nullptr	/* 加载完成后在主线程中调用 */
+		);
+
+		// 将图片裁剪为矩形
 		void Crop(
-			const Rect& crop_rect	/* ü */
+			const Rect& crop_rect	/* 裁剪矩形 */
 		);
 
-		// ȡ
+		// 获取宽度
 		float GetWidth() const;
 
-		// ȡ߶
+		// 获取高度
 		float GetHeight() const;
 
-		// ȡС
+		// 获取大小
 		Size GetSize() const;
 
-		// ȡԴͼƬ
+		// 获取源图片宽度
 		float GetSourceWidth() const;
 
-		// ȡԴͼƬ߶
+		// 获取源图片高度
 		float GetSourceHeight() const;
 
-		// ȡԴͼƬС
+		// 获取源图片大小
 		Size GetSourceSize() const;
 
-		// ȡüλ X 
+		// 获取裁剪位置 X 坐标
 		float GetCropX() const;
 
-		// ȡüλ Y 
+		// 获取裁剪位置 Y 坐标
 		float GetCropY() const;
 
-		// ȡüλ
+		// 获取裁剪位置
 		Point GetCropPos() const;
 
-		// ȡü
+		// 获取裁剪矩形
 		const Rect& GetCropRect() const;
 
-		// ȡ ID2D1Bitmap 
+		// 获取裁剪矩形在 ID2D1Bitmap 中的位置
+		// 图片来自图集时位图是整个图集页面
+		Rect GetBitmapRect() const;
+
+		// 获取 ID2D1Bitmap 对象
 		ID2D1Bitmap * GetBitmap() const;
 
-		// ջ
+		// 清空缓存
 		static void ClearCache();
 
+		// 设置位图缓存的字节预算，默认为 256 MB，为 0 时不限制
+		// 超出预算时按最近最少使用的顺序释放没有被 Image 引用的位图
+		static void SetCacheBudget(
+			size_t bytes
+		);
+
+		// 获取位图缓存的字节预算
+		static size_t GetCacheBudget();
+
+		// 获取位图缓存统计
+		static CacheStats GetCacheStats();
+
+		// 在工作线程中预先解码一组图片，全部加载完成后在主线程中调用回调
+		// 回调结束前这些图片不会被缓存淘汰
+		static void Preload(
+			const std::vector<String>& file_names,
+			const Function& on_complete = nullptr
+		);
+
+		// 设置每帧创建位图的时间预算，默认为 4 毫秒
+		static void SetUploadBudget(
+			const Duration& budget
+		);
+
+		// 为已解码的图片创建位图，由游戏主循环每帧调用
+		static void UploadPending();
+
+		// 获取正在异步加载的图片数量
+		static size_t GetLoadingCount();
+
 	protected:
 		E2D_DISABLE_COPY(Image);
 
-		//  Bitmap Դ
+		friend class ImageAtlas;
+
+		// 图集页面中的图片区域
+		struct Region
+		{
+			ID2D1Bitmap * bitmap;
+			Rect rect;
+		};
+
+		// 使用缓存中的位图
+		bool UseCached(
+			size_t key
+		);
+
+		// 取消对缓存位图的引用
+		void ReleaseCached();
+
+		// 登记图集中的图片区域，之后加载该图片时直接引用图集页面
+		static void AddRegion(
+			size_t key,
+			ID2D1Bitmap * bitmap,
+			const Rect& rect
+		);
+
+		// 缓存 Bitmap 资源
 		static bool CacheBitmap(
 			const String& file_name
 		);
 
-		//  Bitmap Դ
+		// 缓存 Bitmap 资源
 		static bool CacheBitmap(
 			const Resource& res
 		);
 
-		//  Bitmap
+		// 获取 WIC 工厂，没有图形设备时自行创建，使用后需要释放
+		static IWICImagingFactory * AcquireImagingFactory();
+
+		// 解码第一帧并转换为 32bppPBGRA 像素，可以在工作线程中调用
+		static HRESULT DecodePixels(
+			IWICImagingFactory * factory,
+			IWICBitmapDecoder * decoder,
+			UINT * width,
+			UINT * height,
+			std::vector<BYTE>& pixels
+		);
+
+		// 使用当前的图片解码器解码图片文件，可以在工作线程中调用
+		static HRESULT DecodeFile(
+			const String& file_path,
+			UINT * width,
+			UINT * height,
+			std::vector<BYTE>& pixels
+		);
+
+		// 在工作线程中解码图片，创建位图后在主线程中调用回调
+		static void RequestDecode(
+			const String& file_name,
+			const Function& on_ready
+		);
+
+		// 获取透明的占位图
+		static ID2D1Bitmap * GetPlaceholder();
+
+		// 设置 Bitmap
 		void SetBitmap(
 			ID2D1Bitmap * bitmap
 		);
 
+		// 设置 Bitmap 及图片在其中的区域
+		void SetBitmap(
+			ID2D1Bitmap * bitmap,
+			const Rect& source_rect
+		);
+
 	protected:
 		Rect crop_rect_;
+		Rect source_rect_;
 		ID2D1Bitmap * bitmap_;
+		size_t loading_key_;
+		size_t cache_key_;
+		bool cache_referenced_;
+
+		static BitmapCache bitmap_cache_;
+		static std::map<size_t, Region> atlas_regions_;
+	};
+
+
+	// 图集
+	// 将多张小图片打包到少量大位图中，打包后通过 Image::Load 加载
+	// 这些图片得到的是图集页面中的区域，可以和同一页面的其他图片一起批量绘制
+	class ImageAtlas
+		: public Ref
+	{
+	public:
+		explicit ImageAtlas(
+			int page_width = 2048,		/* 页面宽度 */
+			int page_height = 2048,		/* 页面高度 */
+			int padding = 1,			/* 图片之间的透明间隔 */
+			int extrude = 1				/* 向外重复边缘像素的宽度 */
+		);
+
+		virtual ~ImageAtlas();
+
+		// 添加图片文件
+		bool Add(
+			const String& file_name
+		);
+
+		// 添加图片资源
+		bool Add(
+			const Resource& res
+		);
+
+		// 添加已解码的图片，像素格式为预乘透明度的 32 位 BGRA
+		// 之后通过同名的 Image::Load 加载
+		bool Add(
+			const String& name,
+			UINT width,
+			UINT height,
+			const std::vector<BYTE>& pixels
+		);
+
+		// 打包所有添加的图片
+		// 没有图形设备时只在内存中生成页面，可以用于离线保存图集
+		// 超出页面大小的图片单独占用一个页面，超出图形设备最大位图尺寸的图片不会被打包，此时返回 false
+		bool Build();
+
+		// 保存图集，页面保存为同目录下的 PNG 文件，图片资源不会被保存
+		// 任一页面保存失败时不写入图集文件
+		bool Save(
+			const String& file_name
+		) const;
+
+		// 加载预先打包的图集
+		bool Load(
+			const String& file_name
+		);
+
+		// 获取页面数量
+		int GetPageCount() const;
+
+		// 获取页面中被图片占用的像素比例
+		float GetOccupancy() const;
+
+	protected:
+		E2D_DISABLE_COPY(ImageAtlas);
+
+		// 待打包的图片
+		struct Source
+		{
+			size_t				key;
+			String				name;
+			UINT				width;
+			UINT				height;
+			std::vector<BYTE>	pixels;
+		};
+
+		// 图集页面，像素格式为 32bppPBGRA
+		struct Page
+		{
+			UINT				width;
+			UINT				height;
+			std::vector<BYTE>	pixels;
+			ID2D1Bitmap *		bitmap;
+		};
+
+		// 图片在页面中的位置
+		struct Entry
+		{
+			size_t	key;
+			String	name;
+			int		page;
+			Rect	rect;
+		};
 
-		static std::map<size_t, ID2D1Bitmap*> bitmap_cache_;
+	protected:
+		int page_width_;
+		int page_height_;
+		int padding_;
+		int extrude_;
+		std::vector<Source> sources_;
+		std::vector<Page> pages_;
+		std::vector<Entry> entries_;
 	};
 
 
 	class Node;
+	class RenderCommandList;
+
+	// 变换缓存
+	// 按深度优先顺序连续存放场景内所有节点的局部矩阵、父节点索引和世界矩阵，
+	// 每帧只对脏区间做一次线性遍历，父节点总是排在子节点之前
+	class TransformStore
+	{
+	public:
+		TransformStore();
+
+		// 节点的子节点发生改变，下次更新前只重新收集该节点的子树
+		// 为空时重建整个缓存
+		void MarkHierarchyDirty(
+			Node * node = nullptr
+		);
+
+		// 节点离开场景，不再等待重新收集
+		void Forget(
+			Node * node
+		);
+
+		// 节点的二维转换发生改变
+		void MarkDirty(
+			Node * node
+		);
+
+		// 场景的转换矩阵发生改变
+		void MarkRootDirty();
+
+		// 是否有待更新的内容
+		bool IsDirty() const;
+
+		// 更新所有节点的世界矩阵
+		void Update(
+			Node * root,
+			const D2D1::Matrix3x2F& scene_transform
+		);
+
+		// 获取缓存的节点数量
+		size_t GetCount() const;
+
+	protected:
+		E2D_DISABLE_COPY(TransformStore);
+
+		// 按深度优先顺序重建缓存
+		void Rebuild(
+			Node * root
+		);
+
+		// 深度优先收集节点
+		void Collect(
+			Node * node,
+			int parent
+		);
+
+		// 重新收集子节点发生改变的子树
+		void Splice();
+
+		// 用重新收集的结果替换一个节点的子树区间，之后的节点整体移动
+		// 返回序号发生移动的第一个位置
+		size_t SpliceSubtree(
+			size_t index
+		);
+
+		// 收集子树到临时数组，没有改变的子节点区间整块复制
+		void CollectRange(
+			Node * node,
+			int parent,
+			int source,
+			size_t begin
+		);
+
+		// 根据节点的二维转换计算局部矩阵
+		void UpdateLocal(
+			size_t index
+		);
+
+		// 自下而上更新脏节点及其祖先节点的子树包围盒
+		void UpdateBounds(
+			bool all
+		);
+
+	protected:
+		bool	dirty_hierarchy_;
+		bool	dirty_root_;
+		size_t	dirty_begin_;
+		std::vector<Node*>				nodes_;
+		std::vector<int>				parents_;
+		std::vector<int>				sizes_;
+		std::vector<UINT8>				dirty_flags_;
+		std::vector<D2D1::Matrix3x2F>	local_initial_;
+		std::vector<D2D1::Matrix3x2F>	local_final_;
+		std::vector<D2D1::Matrix3x2F>	world_initial_;
+		std::vector<D2D1::Matrix3x2F>	world_final_;
+		std::vector<size_t>				dirty_locals_;
+		std::vector<Node*>				dirty_parents_;
+		std::vector<int>				splice_order_;
+		std::vector<Node*>				splice_nodes_;
+		std::vector<int>				splice_parents_;
+		std::vector<int>				splice_sizes_;
+		std::vector<int>				splice_sources_;
+		std::vector<UINT8>				splice_flags_;
+		std::vector<D2D1::Matrix3x2F>	splice_matrices_;
+		std::vector<size_t>				bounds_queue_;
+	};
+
+
+	// 空间索引
+	// 使用动态 AABB 树维护节点的世界包围盒，快速查询点、矩形或射线所经过的节点
+	class SpatialIndex
+	{
+	public:
+		SpatialIndex();
+
+		// 插入节点，返回代理编号
+		int Insert(
+			Node * node,
+			const Rect& bounds
+		);
+
+		// 移除节点
+		void Remove(
+			int proxy
+		);
+
+		// 更新节点包围盒
+		void Move(
+			int proxy,
+			const Rect& bounds
+		);
+
+		// 清空索引
+		void Clear();
+
+		// 获取索引中的节点数量
+		size_t GetCount() const;
+
+		// 查询包围盒包含某点的节点
+		void QueryPoint(
+			const Point& point,
+			std::vector<Node*>& result
+		) const;
+
+		// 查询包围盒与矩形相交的节点
+		void QueryRect(
+			const Rect& rect,
+			std::vector<Node*>& result
+		) const;
+
+		// 查询包围盒与射线相交的节点
+		void QueryRay(
+			const Point& origin,
+			const Point& direction,
+			float max_distance,
+			std::vector<Node*>& result
+		) const;
+
+	protected:
+		E2D_DISABLE_COPY(SpatialIndex);
+
+		// 树节点
+		struct TreeNode
+		{
+			float	min_x;
+			float	min_y;
+			float	max_x;
+			float	max_y;
+			Node *	node;
+			int		parent;
+			int		left;
+			int		right;
+			int		height;
+
+			bool IsLeaf() const { return left == -1; }
+		};
+
+		int AllocateNode();
+
+		void FreeNode(
+			int index
+		);
 
-	// 
+		void InsertLeaf(
+			int leaf
+		);
+
+		void RemoveLeaf(
+			int leaf
+		);
+
+		// 自下而上平衡并更新包围盒
+		void Refit(
+			int index
+		);
+
+		int Balance(
+			int index
+		);
+
+		int Rotate(
+			int index,
+			int index_up,
+			int index_other
+		);
+
+		static TreeNode Combine(
+			const TreeNode& a,
+			const TreeNode& b
+		);
+
+		static float Perimeter(
+			const TreeNode& node
+		);
+
+	protected:
+		int		root_;
+		int		free_list_;
+		size_t	count_;
+		std::vector<TreeNode>		nodes_;
+		mutable std::vector<int>	stack_;
+	};
+
+
+	// 场景
 	class Scene
 		: public Ref
 	{
+		friend class Node;
+
 	public:
 		Scene();
 
@@ -146,54 +715,134 @@ namespace easy2d
 
 		virtual ~Scene();
 
-		// 볡
+		// 进入场景
 		virtual void OnEnter() {}
 
-		// ˳
+		// 退出场景
 		virtual void OnExit() {}
 
-		// ³
+		// 更新场景
 		virtual void Update(float dt) {}
 
-		// øڵ
+		// 设置根节点
 		void SetRoot(
 			Node * root
 		);
 
-		// ȡڵ
+		// 获取根节点
 		Node* GetRoot() const;
 
-		// Ⱦ
+		// 渲染场景
 		void Draw();
 
-		// ַϢ
+		// 生成场景的渲染命令
+		void Draw(
+			RenderCommandList& commands,
+			const Size& view_size
+		);
+
+		// 分发鼠标消息
 		virtual void Dispatch(
 			const MouseEvent& e
 		);
 
-		// ַϢ
+		// 分发按键消息
 		virtual void Dispatch(
 			const KeyEvent& e
 		);
 
-		// ת
+		// 设置转换矩阵
 		void SetTransform(
 			const D2D1::Matrix3x2F& matrix
 		);
 
-		// ȡת
+		// 获取转换矩阵
 		const D2D1::Matrix3x2F& GetTransform() const;
 
+		// 更新场景内所有节点的转换矩阵
+		void UpdateTransform();
+
+		// 启用或关闭空间索引
+		// 启用后鼠标消息只分发给光标下的节点
+		void SetSpatialIndexEnabled(
+			bool enabled
+		);
+
+		// 是否启用了空间索引
+		bool IsSpatialIndexEnabled() const;
+
+		// 获取空间索引，未启用时返回空指针
+		SpatialIndex * GetSpatialIndex();
+
+		// 获取上一次渲染时遍历的节点数量
+		int GetVisitedCount() const;
+
+		// 获取上一次渲染时被剔除的节点数量
+		int GetCulledCount() const;
+
+		// 获取上一次渲染时绘制的节点数量
+		int GetDrawnCount() const;
+
 	protected:
 		E2D_DISABLE_COPY(Scene);
 
+		// 更新节点在空间索引中的包围盒
+		void UpdateProxy(
+			Node * node
+		);
+
+		// 从空间索引中移除节点
+		void RemoveProxy(
+			Node * node
+		);
+
+		// 清除所有节点的空间索引代理
+		void ClearProxies(
+			Node * node
+		);
+
+		// 通过空间索引分发鼠标消息
+		void DispatchToHits(
+			const MouseEvent& e
+		);
+
+		// 注册节点的消息监听
+		void AddListener(
+			Node * node
+		);
+
+		// 移除节点的消息监听
+		void RemoveListener(
+			Node * node
+		);
+
+		// 结束分发消息，删除分发期间移除的监听节点
+		void EndDispatch();
+
+		// 按优先级和节点层级排列监听节点
+		void SortListeners();
+
 	protected:
 		Node*	root_;
+		int		visited_count_;
+		int		culled_count_;
+		int		drawn_count_;
+		Rect	cull_rect_;
 		D2D1::Matrix3x2F transform_;
+		TransformStore transform_store_;
+		SpatialIndex * spatial_index_;
+		std::vector<Node*> mouse_hits_;
+		std::vector<Node*> hovered_nodes_;
+		std::vector<Node*> mouse_listeners_;
+		std::vector<Node*> key_listeners_;
+		std::vector<Node*> removed_nodes_;
+		bool	dirty_listeners_;
+		bool	removed_listeners_;
+		int		dispatch_depth_;
 	};
 
 
-	// ʱ
+	// 定时任务
 	class Task
 		: public Ref
 	{
@@ -201,38 +850,48 @@ namespace easy2d
 
 	public:
 		explicit Task(
-			const Function& func,		/* ִк */
-			const String& name = L""	/*  */
+			const Function& func,		/* 执行函数 */
+			const String& name = L""	/* 任务名称 */
 		);
 
 		explicit Task(
-			const Function& func,		/* ִк */
-			float delay,				/* ʱ룩 */
-			int times = -1,				/* ִд -1 ΪִУ */
-			const String& name = L""	/*  */
+			const Function& func,		/* 执行函数 */
+			float delay,				/* 时间间隔（秒） */
+			int times = -1,				/* 执行次数（设 -1 为永久执行） */
+			const String& name = L""	/* 任务名称 */
 		);
 
-		// 
+		// 启动任务
 		void Start();
 
-		// ֹͣ
+		// 停止任务
 		void Stop();
 
-		// Ƿִ
+		// 任务是否正在执行
 		bool IsRunning() const;
 
-		// ȡ
+		// 获取任务名称
 		const String& GetName() const;
 
-		// Ƿ
+		// 任务是否就绪
 		bool IsReady() const;
 
-		// ִ
+		// 获取下一次执行的时间
+		Time GetNextTime() const;
+
+		// 执行任务
 		void Update();
 
-		// üʱ
+		// 重置计时
 		void ResetTime();
 
+	protected:
+		// 获取所属节点的时钟时间
+		Time GetTime() const;
+
+		// 将任务按下一次执行时间重新放入节点的任务队列
+		void Reschedule();
+
 	protected:
 		bool		running_;
 		bool		stopped_;
@@ -243,462 +902,697 @@ namespace easy2d
 		Time		last_time_;
 		Function	callback_;
 		Node *		target_;
+		unsigned	schedule_id_;
 	};
 
 
-	// Ϣӿ
+	// 按键消息处理接口
 	class KeyEventHandler
 	{
 	public:
-		// Ϣ
+		// 处理按键消息
 		virtual void Handle(KeyEvent e) = 0;
 	};
 
 
-	// Ϣӿ
+	// 鼠标消息处理接口
 	class MouseEventHandler
 	{
 	public:
-		// Ϣ
+		// 处理鼠标消息
 		virtual void Handle(MouseEvent e) = 0;
 	};
 
 
 	class Action;
+	class RunProgram;
 
-	// ڵ
+	// 节点
 	class Node
 		: public Ref
 	{
 		friend class Game;
 		friend class Scene;
+		friend class TransformStore;
+		friend class ActionManager;
+		friend class TweenManager;
+		friend class Task;
 
 	public:
 		typedef std::vector<Node*> Nodes;
+		typedef std::unordered_multimap<size_t, Node*> NameIndex;
 		typedef std::vector<Action*> Actions;
 		typedef std::vector<Task*> Tasks;
+		typedef std::unordered_multimap<size_t, Task*> TaskIndex;
 
 		Node();
 
 		virtual ~Node();
 
-		// Ⱦڵ
-		virtual void Draw() const {}
+		// 渲染节点，在回放渲染命令时调用
+		// 没有重写时，第一次回放后不再为节点生成绘制命令
+		virtual void Draw() const;
+
+		// 生成节点的渲染命令，默认在回放时调用 Draw
+		virtual void Record(
+			RenderCommandList& commands
+		) const;
 
-		// ½ڵ
+		// 更新节点
 		virtual void Update(float dt) {}
 
-		// ȡڵʾ״̬
+		// 获取节点显示状态
 		bool IsVisible() const;
 
-		// ȡڵ
+		// 获取消息优先级
+		int GetEventPriority() const;
+
+		// 是否吞噬已处理的消息
+		bool IsSwallowEvents() const;
+
+		// 是否与其他子树并行更新
+		bool IsParallelUpdate() const;
+
+		// 获取节点时钟的当前时间
+		// 节点时钟只在节点更新时按缩放后的时间前进，动作和任务都使用这个时钟
+		const Time& GetTime() const;
+
+		// 获取时间缩放比例
+		float GetTimeScale() const;
+
+		// 节点时钟是否暂停
+		bool IsPaused() const;
+
+		// 获取节点名称
 		const String& GetName() const;
 
-		// ȡڵƵ Hash ֵ
+		// 获取节点名称的 Hash 值，与 String::GetHash 的结果相同
 		size_t GetHashName() const;
 
-		// ȡڵͼ˳
+		// 获取节点绘图顺序
 		int GetOrder() const;
 
-		// ȡڵ
+		// 获取节点坐标
 		const Point& GetPosition() const;
 
-		// ȡڵ
+		// 获取节点宽度
 		float GetWidth() const;
 
-		// ȡڵ߶
+		// 获取节点高度
 		float GetHeight() const;
 
-		// ȡڵȣţ
+		// 获取节点宽度（不考虑缩放）
 		float GetRealWidth() const;
 
-		// ȡڵ߶ȣţ
+		// 获取节点高度（不考虑缩放）
 		float GetRealHeight() const;
 
-		// ȡڵСţ
+		// 获取节点大小（不考虑缩放）
 		const Size& GetRealSize() const;
 
-		// ȡڵ֧
+		// 获取节点的支点
 		float GetPivotX() const;
 
-		// ȡڵ֧
+		// 获取节点的支点
 		float GetPivotY() const;
 
-		// ȡڵС
+		// 获取节点大小
 		Size GetSize() const;
 
-		// ȡڵű
+		// 获取节点横向缩放比例
 		float GetScaleX() const;
 
-		// ȡڵű
+		// 获取节点纵向缩放比例
 		float GetScaleY() const;
 
-		// ȡڵбǶ
+		// 获取节点横向倾斜角度
 		float GetSkewX() const;
 
-		// ȡڵбǶ
+		// 获取节点纵向倾斜角度
 		float GetSkewY() const;
 
-		// ȡڵתǶ
+		// 获取节点旋转角度
 		float GetRotation() const;
 
-		// ȡάת
+		// 获取二维转换
 		const Transform& GetTransform() const;
 
-		// ȡڵ͸
+		// 获取节点透明度
 		float GetOpacity() const;
 
-		// ȡڵ
+		// 获取父节点
 		Node * GetParent() const;
 
-		// ȡڵڳ
+		// 获取节点所在场景
 		Scene * GetParentScene() const;
 
-		// ýڵǷʾ
+		// 设置节点是否显示
 		void SetVisible(
 			bool value
 		);
 
-		// ýڵ
+		// 设置消息优先级，优先级高的节点先收到消息
+		// 默认为 0，优先级相同时子节点先于父节点、后添加的兄弟节点先于前面的节点收到消息
+		void SetEventPriority(
+			int priority
+		);
+
+		// 设置是否吞噬已处理的消息，被吞噬的消息不再传递给其他节点
+		// 默认为 false
+		void SetSwallowEvents(
+			bool swallow
+		);
+
+		// 设置子树是否与其他子树并行更新
+		// 并行更新的子树不能访问子树外的节点，期间的结构修改会在所有子树更新完成后按顺序执行
+		// 默认为 false
+		void SetParallelUpdate(
+			bool enabled
+		);
+
+		// 设置时间缩放比例，同时影响子节点的更新、动作和任务
+		// 默认为 1.0
+		void SetTimeScale(
+			float scale
+		);
+
+		// 暂停或继续节点时钟，暂停后自身及子节点都不再更新
+		// 默认为 false
+		void SetPaused(
+			bool paused
+		);
+
+		// 设置节点名称
 		void SetName(
 			const String& name
 		);
 
-		// ýڵ
+		// 设置节点横坐标
 		virtual void SetPositionX(
 			float x
 		);
 
-		// ýڵ
+		// 设置节点纵坐标
 		virtual void SetPositionY(
 			float y
 		);
 
-		// ýڵ
+		// 设置节点坐标
 		virtual void SetPosition(
 			const Point & point
 		);
 
-		// ýڵ
+		// 设置节点坐标
 		virtual void SetPosition(
 			float x,
 			float y
 		);
 
-		// ƶڵ
+		// 移动节点
 		virtual void MoveBy(
 			float x,
 			float y
 		);
 
-		// ƶڵ
+		// 移动节点
 		virtual void MoveBy(
 			const Point & vector
 		);
 
-		// ýڵͼ˳
-		// ĬΪ 0
+		// 设置节点绘图顺序
+		// 默认为 0
 		virtual void SetOrder(
 			int order
 		);
 
-		// úű
-		// ĬΪ 1.0
+		// 设置横向缩放比例
+		// 默认为 1.0
 		virtual void SetScaleX(
 			float scale_x
 		);
 
-		// ű
-		// ĬΪ 1.0
+		// 设置纵向缩放比例
+		// 默认为 1.0
 		virtual void SetScaleY(
 			float scale_y
 		);
 
-		// ű
-		// ĬΪ (1.0, 1.0)
+		// 设置缩放比例
+		// 默认为 (1.0, 1.0)
 		virtual void SetScale(
 			float scale_x,
 			float scale_y
 		);
 
-		// ű
-		// ĬΪ 1.0
+		// 设置缩放比例
+		// 默认为 1.0
 		virtual void SetScale(
 			float scale
 		);
 
-		// úбǶ
-		// ĬΪ 0
+		// 设置横向倾斜角度
+		// 默认为 0
 		virtual void SetSkewX(
 			float skew_x
 		);
 
-		// бǶ
-		// ĬΪ 0
+		// 设置纵向倾斜角度
+		// 默认为 0
 		virtual void SetSkewY(
 			float skew_y
 		);
 
-		// бǶ
-		// ĬΪ (0, 0)
+		// 设置倾斜角度
+		// 默认为 (0, 0)
 		virtual void SetSkew(
 			float skew_x,
 			float skew_y
 		);
 
-		// תǶ
-		// ĬΪ 0
+		// 设置旋转角度
+		// 默认为 0
 		virtual void SetRotation(
 			float rotation
 		);
 
-		// ͸
-		// ĬΪ 1.0, Χ [0, 1]
+		// 设置透明度
+		// 默认为 1.0, 范围 [0, 1]
 		virtual void SetOpacity(
 			float opacity
 		);
 
-		// ֧ĺλ
-		// ĬΪ 0, Χ [0, 1]
+		// 设置支点的横向位置
+		// 默认为 0, 范围 [0, 1]
 		virtual void SetPivotX(
 			float pivot_x
 		);
 
-		// ֧λ
-		// ĬΪ 0, Χ [0, 1]
+		// 设置支点的纵向位置
+		// 默认为 0, 范围 [0, 1]
 		virtual void SetPivotY(
 			float pivot_y
 		);
 
-		// ֧λ
-		// ĬΪ (0, 0), Χ [0, 1]
+		// 设置支点位置
+		// 默认为 (0, 0), 范围 [0, 1]
 		virtual void SetPivot(
 			float pivot_x,
 			float pivot_y
 		);
 
-		// ޸Ľڵ
+		// 修改节点宽度
 		virtual void SetWidth(
 			float width
 		);
 
-		// ޸Ľڵ߶
+		// 修改节点高度
 		virtual void SetHeight(
 			float height
 		);
 
-		// ޸ĽڵС
+		// 修改节点大小
 		virtual void SetSize(
 			float width,
 			float height
 		);
 
-		// ޸ĽڵС
+		// 修改节点大小
 		virtual void SetSize(
 			const Size & size
 		);
 
-		// öάת
+		// 设置二维转换
 		virtual void SetTransform(
 			const Transform& transform
 		);
 
-		// ûرȾü
+		// 启用或关闭渲染区域裁剪
 		virtual void SetClipEnabled(
 			bool enabled
 		);
 
-		// ýڵԵɫ
+		// 设置节点边缘颜色
 		virtual void SetBorderColor(
 			const Color& color
 		);
 
-		// жϵǷڽڵ
+		// 设置节点的绘制范围（节点坐标系）
+		// 重写了 Draw 的节点只有设置了绘制范围才会被剔除
+		void SetDrawBounds(
+			const Rect& bounds
+		);
+
+		// 取消绘制范围，使用节点大小作为绘制范围
+		void ResetDrawBounds();
+
+		// 启用或关闭可见性剔除，关闭后节点总是会被绘制
+		// 默认启用，此时不绘制内容的节点按子节点范围剔除，重写了 Draw 的节点需要设置绘制范围
+		void SetCullingEnabled(
+			bool enabled
+		);
+
+		// 是否启用了可见性剔除
+		bool IsCullingEnabled() const;
+
+		// 判断点是否在节点内
 		bool ContainsPoint(
 			const Point& point
 		);
 
-		// жǷཻ
+		// 判断两物体是否相交
 		bool Intersects(
 			Node * node
 		);
 
-		// ӽڵ
+		// 获取节点在世界坐标系中的包围盒
+		Rect GetBoundingBox();
+
+		// 添加子节点
 		void AddChild(
 			Node * child,
-			int order = 0		/* Ⱦ˳ */
+			int order = 0		/* 渲染顺序 */
 		);
 
-		// Ӷӽڵ
+		// 添加多个子节点
 		void AddChild(
-			const Nodes& nodes,	/* ڵ */
-			int order = 0		/* Ⱦ˳ */
+			const Nodes& nodes,	/* 节点数组 */
+			int order = 0		/* 渲染顺序 */
 		);
 
-		// ȡͬӽڵ
+		// 获取所有名称相同的子节点
 		Nodes GetChildren(
 			const String& name
 		) const;
 
-		// ȡͬӽڵ
+		// 获取名称相同的子节点
 		Node* GetChild(
 			const String& name
 		) const;
 
-		// ȡӽڵ
+		// 根据路径查找子孙节点，如 "hud/score/label"
+		Node* Find(
+			const String& path
+		) const;
+
+		// 获取所有子节点
 		const Nodes& GetAllChildren() const;
 
-		// ȡӽڵ
+		// 获取子节点数量
 		int GetChildrenCount() const;
 
-		// Ƴӽڵ
+		// 移除子节点
 		bool RemoveChild(
 			Node * child
 		);
 
-		// Ƴͬӽڵ
+		// 移除所有名称相同的子节点
 		void RemoveChildren(
 			const String& child_name
 		);
 
-		// Ƴнڵ
+		// 移除所有节点
 		void RemoveAllChildren();
 
-		// ӸڵƳ
+		// 从父节点移除
 		void RemoveFromParent();
 
-		// ִж
-		void RunAction(
+		// 执行动作，返回在该节点上的执行
+		// 动作作为共享的定义，节点只分配自己的执行状态，同一个动作可以在多个节点上执行
+		// 暂停、停止动作或修改名称和标签时同时作用于它在所有节点上的执行，只控制该节点时使用返回的执行
+		// 在并行更新的节点中调用时，执行延迟到本帧更新结束后开始，此时返回空指针
+		RunProgram * RunAction(
 			Action * action
 		);
 
-		// 
+		// 继续动作
 		void ResumeAction(
 			const String& name
 		);
 
-		// ͣ
+		// 暂停动作
 		void PauseAction(
 			const String& name
 		);
 
-		// ֹͣ
+		// 停止动作
 		void StopAction(
 			const String& name
 		);
 
-		// ͣ
+		// 继续所有暂停动作
 		void ResumeAllActions();
 
-		// ͣж
+		// 暂停所有动作
 		void PauseAllActions();
 
-		// ֹͣж
+		// 停止所有动作
 		void StopAllActions();
 
-		// ȡж
+		// 获取所有动作，返回的是节点上的执行，通过 RunProgram::GetSource 获取执行的动作
 		const Actions& GetAllActions() const;
 
-		// 
+		// 添加任务
 		void AddTask(
 			Task * task
 		);
 
-		// 
+		// 启动任务
 		void StartTasks(
 			const String& task_name
 		);
 
-		// ֹͣ
+		// 停止任务
 		void StopTasks(
 			const String& task_name
 		);
 
-		// Ƴ
+		// 移除任务
 		void RemoveTasks(
 			const String& task_name
 		);
 
-		// 
+		// 启动所有任务
 		void StartAllTasks();
 
-		// ֹͣ
+		// 停止所有任务
 		void StopAllTasks();
 
-		// Ƴ
+		// 移除所有任务
 		void RemoveAllTasks();
 
-		// ȡ
+		// 获取所有任务
 		const Tasks& GetAllTasks() const;
 
+		// 在工作线程中执行任务，完成后在主线程中调用 on_complete
+		// 节点离开场景或被销毁时，尚未完成的任务会被自动取消
+		void RunAsync(
+			const Function& job,
+			const Function& on_complete = nullptr
+		);
+
+		// 取消所有尚未完成的异步任务
+		void CancelAsync();
+
 	protected:
 		E2D_DISABLE_COPY(Node);
 
-		// ڵ
-		virtual void Visit();
+		// 遍历节点，生成渲染命令
+		virtual void Visit(
+			RenderCommandList& commands
+		);
 
-		// ȾڵԵ
-		void DrawBorder();
+		// 生成节点边缘的渲染命令
+		void DrawBorder(
+			RenderCommandList& commands
+		);
+
+		// 更新节点边缘的调试几何体
+		void UpdateBorder();
 
-		// ýڵڳ
+		// 设置节点所在场景
 		void SetParentScene(
 			Scene * scene
 		);
 
-		// ַϢ
+		// 节点是否接收鼠标消息，在节点进入场景时检查
+		virtual bool IsMouseListener() const;
+
+		// 节点是否接收按键消息，在节点进入场景时检查
+		virtual bool IsKeyListener() const;
+
+		// 处理鼠标消息（不包括子节点）
+		virtual bool OnMouseEvent(
+			const MouseEvent& e,
+			bool handled
+		);
+
+		// 处理按键消息（不包括子节点）
+		virtual bool OnKeyEvent(
+			const KeyEvent& e,
+			bool handled
+		);
+
+		// 分发鼠标消息到节点和子节点
+		// 已弃用：场景不再调用此函数，请重写 OnMouseEvent
 		virtual bool Dispatch(
 			const MouseEvent& e,
 			bool handled
 		);
 
-		// ַϢ
+		// 分发按键消息到节点和子节点
+		// 已弃用：场景不再调用此函数，请重写 OnKeyEvent
 		virtual bool Dispatch(
 			const KeyEvent& e,
 			bool handled
 		);
 
-		// ӽڵ
-		void UpdateChildren(float dt);
+		// 设置是否在回放时调用 Draw
+		// 通过 Record 生成命令的节点在构造时关闭，这类节点的子类重写 Draw 时需要重新开启
+		void SetCustomDraw(
+			bool enabled
+		);
+
+		// 获取没有重写属性设置函数的类型，补间管理器直接写入该类型节点的属性
+		virtual const std::type_info& GetSetterType() const;
+
+		// 更新子节点，step 是父节点换算好的时间段
+		void UpdateChildren(
+			float dt,
+			Duration step
+		);
+
+		// 在工作线程中更新可以并行的子节点
+		void UpdateParallelChildren(
+			float dt,
+			Duration step
+		);
+
+		// 推进节点时钟，返回子节点使用的时间段
+		Duration AdvanceTime(
+			float dt,
+			Duration step
+		);
 
-		// ת
+		// 更新转换矩阵
 		void UpdateTransform();
 
-		// ½ڵ͸
+		// 标记转换矩阵需要更新
+		void MarkTransformDirty();
+
+		// 根据转换矩阵计算轮廓顶点
+		void UpdateBorderVertices();
+
+		// 按 Order 将子节点插入到有序位置
+		void InsertOrderedChild(
+			Node * child
+		);
+
+		// 从有序的子节点数组中移除节点
+		void EraseOrderedChild(
+			Node * child
+		);
+
+		// 获取第一个 Order 不小于零的子节点位置
+		size_t FindOrderSplit() const;
+
+		// 将子节点加入名称索引
+		void IndexChildName(
+			Node * child
+		);
+
+		// 将子节点移出名称索引
+		void UnindexChildName(
+			Node * child
+		);
+
+		// 根据自身及子节点的包围盒计算子树包围盒
+		void UpdateSubtreeBounds();
+
+		// 节点大小是否能确定其绘制范围
+		bool IsBounded() const;
+
+		// 节点自身是否不绘制任何内容
+		bool IsContentEmpty() const;
+
+		// 更新节点透明度
 		void UpdateOpacity();
 
-		// ¶
-		void UpdateActions();
+		// 将任务放入按执行时间排列的任务队列
+		void ScheduleTask(
+			Task * task
+		);
 
-		// 
+		// 更新任务
 		void UpdateTasks();
 
-		// ½ڵʱ
+		// 清除已结束的任务
+		void RemoveStoppedTasks();
+
+		// 更新节点时间
 		void UpdateTime();
 
 	protected:
+		// 任务队列项，serial 与任务当前的 schedule_id_ 不同时说明已失效
+		struct TaskEntry
+		{
+			Time		time;
+			unsigned	serial;
+			Task *		task;
+		};
+
 		String		name_;
 		size_t		hash_name_;
+		size_t		name_key_;
 		Transform	transform_;
 		float		display_opacity_;
 		float		real_opacity_;
 		int			order_;
 		bool		visible_;
 		bool		clip_enabled_;
-		bool		dirty_sort_;
 		bool		dirty_transform_;
+		bool		dirty_border_;
+		bool		dirty_children_;
+		int			transform_index_;
+		int			proxy_id_;
+		int			event_priority_;
+		bool		swallow_events_;
+		bool		parallel_update_;
+		bool		paused_;
+		float		time_scale_;
+		float		time_carry_;
+		Time		time_;
+		int			mouse_listener_index_;
+		int			key_listener_index_;
+		Rect		bounds_;
+		Rect		draw_bounds_;
+		Rect		cull_bounds_;
+		Rect		subtree_bounds_;
+		bool		subtree_bounded_;
+		bool		subtree_empty_;
+		bool		culling_enabled_;
+		bool		has_draw_bounds_;
+		mutable bool	custom_draw_;
+		mutable bool	empty_draw_;
 		Scene *		parent_scene_;
 		Node *		parent_;
 		Color		border_color_;
 		Actions		actions_;
 		Tasks		tasks_;
+		TaskIndex	named_tasks_;
+		bool		dirty_tasks_;
+		std::vector<TaskEntry>	task_queue_;
+		std::vector<TaskEntry>	due_tasks_;
+		std::shared_ptr<std::atomic<bool>>	async_token_;
 		Nodes		children_;
+		NameIndex	named_children_;
+		Point		border_vertices_[4];
 		ID2D1Geometry*		border_;
 		D2D1::Matrix3x2F	initial_matrix_;
 		D2D1::Matrix3x2F	final_matrix_;
 	};
 
 
-	// 
+	// 精灵
 	class Sprite
 		: public Node
 	{
@@ -715,7 +1609,7 @@ namespace easy2d
 
 		explicit Sprite(
 			const Resource& res,
-			const Rect& crop_rect	/* ü */
+			const Rect& crop_rect	/* 裁剪矩形 */
 		);
 
 		explicit Sprite(
@@ -724,73 +1618,214 @@ namespace easy2d
 
 		explicit Sprite(
 			const String& file_name,
-			const Rect& crop_rect	/* ü */
+			const Rect& crop_rect	/* 裁剪矩形 */
 		);
 
 		virtual ~Sprite();
 
-		// ͼƬļ
+		// 加载图片文件
 		bool Load(
 			const Resource& res
 		);
 
-		// ͼƬļ
+		// 加载图片文件
 		bool Load(
 			const String& file_name
 		);
 
-		// ͼƬ
+		// 加载图片
 		bool Load(
 			Image * image
 		);
 
-		// ͼƬüΪ
+		// 异步加载图片文件
+		// 加载完成前显示透明的占位图，完成后精灵大小更新为图片大小
+		void LoadAsync(
+			const String& file_name,
+			const Function& on_loaded = nullptr	/* 加载完成后在主线程中调用 */
+		);
+
+		// 将图片裁剪为矩形
 		void Crop(
-			const Rect& crop_rect	/* ü */
+			const Rect& crop_rect	/* 裁剪矩形 */
 		);
 
-		// ȡ Image 
+		// 获取 Image 对象
 		Image * GetImage() const;
 
-		// Ⱦ
+		// 渲染精灵
+		// 已弃用：精灵通过 Record 生成命令，子类重写此函数时需要调用 SetCustomDraw(true)
 		virtual void Draw() const override;
 
+		// 生成精灵的渲染命令
+		virtual void Record(
+			RenderCommandList& commands
+		) const override;
+
 	protected:
 		E2D_DISABLE_COPY(Sprite);
 
+		// 获取没有重写属性设置函数的类型
+		virtual const std::type_info& GetSetterType() const override;
+
+		// 生成图片的绘制命令
+		void RecordImage(
+			RenderCommandList& commands
+		) const;
+
 	protected:
 		Image * image_;
 	};
 
 
-	// ı
+	// 精灵批次，同一张图集中的大量精灵作为一次绘制提交
+	// 精灵数据按属性保存在连续数组中，不需要为每个精灵创建节点
+	class SpriteBatch
+		: public Node
+	{
+	public:
+		SpriteBatch();
+
+		explicit SpriteBatch(
+			Image * atlas
+		);
+
+		virtual ~SpriteBatch();
+
+		// 设置图集
+		void SetAtlas(
+			Image * atlas
+		);
+
+		// 获取图集
+		Image * GetAtlas() const;
+
+		// 预留精灵数量
+		void Reserve(
+			size_t count
+		);
+
+		// 添加精灵，返回精灵序号
+		// 精灵以 pos 为中心旋转和缩放
+		size_t AddSprite(
+			const Rect& atlas_rect,		/* 图集中的区域 */
+			const Point& pos,			/* 中心位置 */
+			float rotation = 0.f,		/* 旋转角度 */
+			float scale = 1.f,			/* 缩放 */
+			float opacity = 1.f,		/* 透明度 */
+			const Color& color = Color::White
+		);
+
+		// 添加精灵，使用任意二维变换
+		size_t AddSprite(
+			const Rect& atlas_rect,		/* 图集中的区域 */
+			const D2D1::Matrix3x2F& transform,
+			float opacity = 1.f,		/* 透明度 */
+			const Color& color = Color::White
+		);
+
+		// 设置精灵在图集中的区域
+		// 区域不是整数像素时无法使用 ID2D1SpriteBatch，整个批次会逐个绘制
+		void SetSpriteRect(
+			size_t index,
+			const Rect& atlas_rect
+		);
+
+		// 设置精灵的位置、旋转角度和缩放
+		void SetSpriteTransform(
+			size_t index,
+			const Point& pos,
+			float rotation = 0.f,
+			float scale = 1.f
+		);
+
+		// 设置精灵的二维变换
+		void SetSpriteTransform(
+			size_t index,
+			const D2D1::Matrix3x2F& transform
+		);
+
+		// 设置精灵透明度
+		void SetSpriteOpacity(
+			size_t index,
+			float opacity
+		);
+
+		// 设置精灵颜色，系统不支持 Direct2D 1.1 时只使用颜色的透明度
+		void SetSpriteColor(
+			size_t index,
+			const Color& color
+		);
+
+		// 移除精灵，最后一个精灵会移动到被移除的位置
+		void RemoveSprite(
+			size_t index
+		);
+
+		// 移除所有精灵
+		void ClearSprites();
+
+		// 获取精灵数量
+		size_t GetSpriteCount() const;
+
+		// 生成精灵批次的渲染命令
+		virtual void Record(
+			RenderCommandList& commands
+		) const override;
+
+	protected:
+		E2D_DISABLE_COPY(SpriteBatch);
+
+		// 获取没有重写属性设置函数的类型
+		virtual const std::type_info& GetSetterType() const override;
+
+		// 计算以 pos 为中心的二维变换
+		static D2D1::Matrix3x2F MakeTransform(
+			const Rect& atlas_rect,
+			const Point& pos,
+			float rotation,
+			float scale
+		);
+
+	protected:
+		Image *							atlas_;
+		std::vector<D2D1_RECT_F>		rects_;
+		std::vector<D2D1_RECT_F>		dests_;
+		std::vector<D2D1_MATRIX_3X2_F>	transforms_;
+		std::vector<D2D1_COLOR_F>		colors_;
+		std::vector<float>				opacities_;
+		mutable std::vector<D2D1_RECT_F> bitmap_rects_;
+	};
+
+
+	// 文本
 	class Text
 		: public Node
 	{
 	public:
-		// ı뷽ʽ
+		// 文本对齐方式
 		enum class Align
 		{
-			Left,		/*  */
-			Right,		/* Ҷ */
-			Center		/* ж */
+			Left,		/* 左对齐 */
+			Right,		/* 右对齐 */
+			Center		/* 居中对齐 */
 		};
 
-		// ıʽ
+		// 文本样式
 		class Style
 		{
 		public:
-			Color		color;				// ɫ
-			Align		alignment;			// 뷽ʽ
-			bool		wrap;				// Զ
-			float		wrap_width;			// Զп
-			float		line_spacing;		// м
-			bool		underline;			// »
-			bool		strikethrough;		// ɾ
-			bool		outline;			// ʾ
-			Color		outline_color;		// ɫ
-			float		outline_width;		// ߿
-			Stroke		outline_stroke;		// ཻʽ
+			Color		color;				// 颜色
+			Align		alignment;			// 对齐方式
+			bool		wrap;				// 打开自动换行
+			float		wrap_width;			// 自动换行宽度
+			float		line_spacing;		// 行间距
+			bool		underline;			// 下划线
+			bool		strikethrough;		// 删除线
+			bool		outline;			// 显示描边
+			Color		outline_color;		// 描边颜色
+			float		outline_width;		// 描边线宽
+			Stroke		outline_stroke;		// 描边线相交样式
 
 		public:
 			Style();
@@ -814,161 +1849,175 @@ namespace easy2d
 		Text();
 
 		explicit Text(
-			const String& text,						/*  */
-			const Font& font = Font(),				/*  */
-			const Style& style = Style()			/* ıʽ */
+			const String& text,						/* 文字内容 */
+			const Font& font = Font(),				/* 字体 */
+			const Style& style = Style()			/* 文本样式 */
 		);
 
 		virtual ~Text();
 
-		// ȡı
+		// 获取文本
 		const String& GetText() const;
 
-		// ȡ
+		// 获取字体
 		const Font& GetFont() const;
 
-		// ȡıʽ
+		// 获取文本样式
 		const Style& GetStyle() const;
 
-		// ȡ
+		// 获取字体族
 		const String& GetFontFamily() const;
 
-		// ȡǰֺ
+		// 获取当前字号
 		float GetFontSize() const;
 
-		// ȡǰϸֵ
+		// 获取当前字体粗细值
 		UINT GetFontWeight() const;
 
-		// ȡɫ
+		// 获取文字颜色
 		const Color& GetColor() const;
 
-		// ȡɫ
+		// 获取描边颜色
 		const Color& GetOutlineColor() const;
 
-		// ȡ߿
+		// 获取描边线宽
 		float GetOutlineWidth() const;
 
-		// ȡཻʽ
+		// 获取描边线相交样式
 		Stroke GetOutlineStroke() const;
 
-		// ȡıʾ
+		// 获取文本显示行数
 		int GetLineCount() const;
 
-		// Ƿб
+		// 是否是斜体
 		bool IsItalic() const;
 
-		// Ƿʾɾ
+		// 是否显示删除线
 		bool strikethrough() const;
 
-		// Ƿʾ»
+		// 是否显示下划线
 		bool underline() const;
 
-		// Ƿʾ
+		// 是否显示描边
 		bool outline() const;
 
-		// ı
+		// 设置文本
 		void SetText(
 			const String& text
 		);
 
-		// ıʽ
+		// 设置文本样式
 		void SetStyle(
 			const Style& style
 		);
 
-		// 
+		// 设置字体
 		void SetFont(
 			const Font& font
 		);
 
-		// 
+		// 设置字体族
 		void SetFontFamily(
 			const String& family
 		);
 
-		// ֺţĬֵΪ 22
+		// 设置字号（默认值为 22）
 		void SetFontSize(
 			float size
 		);
 
-		// ϸֵĬֵΪ Text::Font::Weight::Normal
+		// 设置字体粗细值（默认值为 Text::Font::Weight::Normal）
 		void SetFontWeight(
 			UINT weight
 		);
 
-		// ɫĬֵΪ Color::WHITE
+		// 设置文字颜色（默认值为 Color::WHITE）
 		void SetColor(
 			Color color
 		);
 
-		// б壨ĬֵΪ false
+		// 设置文字斜体（默认值为 false）
 		void SetItalic(
 			bool value
 		);
 
-		// 򿪻رıԶУĬΪرգ
+		// 打开或关闭文本自动换行（默认为关闭）
 		void SetWrapEnabled(
 			bool wrap
 		);
 
-		// ıԶеĿȣĬΪ 0
+		// 设置文本自动换行的宽度（默认为 0）
 		void SetWrapWidth(
 			float wrap_width
 		);
 
-		// мࣨĬΪ 0
+		// 设置行间距（默认为 0）
 		void SetLineSpacing(
 			float line_spacing
 		);
 
-		// ö뷽ʽĬΪ Align::Left
+		// 设置对齐方式（默认为 Align::Left）
 		void SetAlignment(
 			Align align
 		);
 
-		// »ߣĬֵΪ false
+		// 设置下划线（默认值为 false）
 		void SetUnderline(
 			bool underline
 		);
 
-		// ɾߣĬֵΪ false
+		// 设置删除线（默认值为 false）
 		void SetStrikethrough(
 			bool strikethrough
 		);
 
-		// Ƿʾ
+		// 设置是否显示描边
 		void SetOutline(
 			bool outline
 		);
 
-		// ɫ
+		// 设置描边颜色
 		void SetOutlineColor(
 			Color outline_color
 		);
 
-		// ߿
+		// 设置描边线宽
 		void SetOutlineWidth(
 			float outline_width
 		);
 
-		// ཻʽ
+		// 设置描边线相交样式
 		void SetOutlineStroke(
 			Stroke outline_stroke
 		);
 
-		// Ⱦ
+		// 渲染文字
+		// 已弃用：文字通过 Record 生成命令，子类重写此函数时需要调用 SetCustomDraw(true)
 		virtual void Draw() const override;
 
+		// 生成文字的渲染命令
+		virtual void Record(
+			RenderCommandList& commands
+		) const override;
+
 	protected:
 		E2D_DISABLE_COPY(Text);
 
-		// Ű
+		// 获取没有重写属性设置函数的类型
+		virtual const std::type_info& GetSetterType() const override;
+
+		// 生成文字布局的绘制命令
+		void RecordLayout(
+			RenderCommandList& commands
+		) const;
+
+		// 重新排版文字
 		void Reset();
 
-		// ָʽ
+		// 创建文字格式化
 		void CreateFormat();
 
-		// ֲ
+		// 创建文字布局
 		void CreateLayout();
 
 	protected:
@@ -980,7 +2029,7 @@ namespace easy2d
 	};
 
 
-	// 
+	// 画布
 	class Canvas
 		: public Node
 	{
@@ -992,88 +2041,88 @@ namespace easy2d
 
 		virtual ~Canvas();
 
-		// ɫ
+		// 设置线条颜色
 		void SetLineColor(
 			const Color& color
 		);
 
-		// ɫ
+		// 设置填充颜色
 		void SetFillColor(
 			const Color& color
 		);
 
-		// 
+		// 设置线条宽度
 		void SetStrokeWidth(
 			float width
 		);
 
-		// ཻʽ
+		// 设置线条相交样式
 		void SetStrokeStyle(
 			Stroke strokeStyle
 		);
 
-		// ȡɫ
+		// 获取线条颜色
 		Color GetLineColor() const;
 
-		// ȡɫ
+		// 获取填充颜色
 		Color GetFillColor() const;
 
-		// ȡ
+		// 获取线条宽度
 		float GetStrokeWidth() const;
 
-		// ȡཻʽ
+		// 获取线条相交样式
 		Stroke GetStrokeStyle() const;
 
-		// ֱ
+		// 画直线
 		void DrawLine(
 			const Point& begin,
 			const Point& end
 		);
 
-		// Բα߿
+		// 画圆形边框
 		void DrawCircle(
 			const Point& center,
 			float radius
 		);
 
-		// Բα߿
+		// 画椭圆形边框
 		void DrawEllipse(
 			const Point& center,
 			float radius_x,
 			float radius_y
 		);
 
-		// α߿
+		// 画矩形边框
 		void DrawRect(
 			const Rect& rect
 		);
 
-		// ԲǾα߿
+		// 画圆角矩形边框
 		void DrawRoundedRect(
 			const Rect& rect,
 			float radius_x,
 			float radius_y
 		);
 
-		// Բ
+		// 填充圆形
 		void FillCircle(
 			const Point& center,
 			float radius
 		);
 
-		// Բ
+		// 填充椭圆形
 		void FillEllipse(
 			const Point& center,
 			float radius_x,
 			float radius_y
 		);
 
-		// 
+		// 填充矩形
 		void FillRect(
 			const Rect& rect
 		);
 
-		// ԲǾ
+		// 填充圆角矩形
 		void FillRoundedRect(
 			const Rect& rect,
 			float radius_x,
@@ -25,24 +25,24 @@
 namespace easy2d
 {
 
-	// 
+	// 随机数产生器
 	class Random
 	{
 	public:
-		// ȡ÷Χڵһ
+		// 取得范围内的一个整型随机数
 		template<typename T>
 		static inline T Range(T min, T max)
 		{
 			return easy2d::Random::RandomInt(min, max);
 		}
 
-		// ȡ÷Χڵһ
+		// 取得范围内的一个浮点数随机数
 		static inline float Range(float min, float max)
 		{
 			return easy2d::Random::RandomReal(min, max);
 		}
 
-		// ȡ÷Χڵһ
+		// 取得范围内的一个浮点数随机数
 		static inline double Range(double min, double max)
 		{
 			return easy2d::Random::RandomReal(min, max);
@@ -63,12 +63,12 @@ namespace easy2d
 			return dist(Random::GetEngine());
 		}
 
-		// ȡ
+		// 获取随机数产生器
 		static std::default_random_engine &GetEngine();
 	};
 
 
-	// 
+	// 音乐
 	class Music
 		: public Ref
 	{
@@ -76,54 +76,54 @@ namespace easy2d
 		Music();
 
 		Music(
-			const easy2d::String& file_path	/* ļ· */
+			const easy2d::String& file_path	/* 音乐文件路径 */
 		);
 
 		Music(
-			const Resource& res				/* Դ */
+			const Resource& res				/* 音乐资源 */
 		);
 
 		virtual ~Music();
 
-		// ļ
+		// 打开音乐文件
 		bool Load(
-			const easy2d::String& file_path	/* ļ· */
+			const easy2d::String& file_path	/* 音乐文件路径 */
 		);
 
-		// Դ
+		// 打开音乐资源
 		bool Load(
-			const Resource& res				/* Դ */
+			const Resource& res				/* 音乐资源 */
 		);
 
-		// 
+		// 播放
 		bool Play(
-			int loop_count = 0		/* ѭ (-1 Ϊѭ) */
+			int loop_count = 0		/* 播放循环次数 (-1 为循环播放) */
 		);
 
-		// ͣ
+		// 暂停
 		void Pause();
 
-		// 
+		// 继续
 		void Resume();
 
-		// ֹͣ
+		// 停止
 		void Stop();
 
-		// رղԴ
+		// 关闭并回收资源
 		void Close();
 
-		// Ƿڲ
+		// 是否正在播放
 		bool IsPlaying() const;
 
-		// ȡ
+		// 获取音量
 		float GetVolume() const;
 
-		// 
+		// 设置音量
 		bool SetVolume(
-			float volume	/* 1 Ϊԭʼ,  1 ΪŴ, 0 ΪС */
+			float volume	/* 1 为原始音量, 大于 1 为放大音量, 0 为最小音量 */
 		);
 
-		// ȡ IXAudio2SourceVoice 
+		// 获取 IXAudio2SourceVoice 对象
 		IXAudio2SourceVoice * GetSourceVoice() const;
 
 	protected:
@@ -138,7 +138,7 @@ namespace easy2d
 	};
 
 
-	// ֲ
+	// 音乐播放器
 	class Player
 	{
 	public:
@@ -146,86 +146,86 @@ namespace easy2d
 
 		~Player();
 
-		// ԤԴ
+		// 预加载音乐资源
 		bool Load(
-			const String& file_path	/* ļ· */
+			const String& file_path	/* 音乐文件路径 */
 		);
 
-		// 
+		// 播放音乐
 		bool Play(
-			const String& file_path,	/* ļ· */
-			int loop_count = 0			/* ѭ (-1 Ϊѭ) */
+			const String& file_path,	/* 音乐文件路径 */
+			int loop_count = 0			/* 播放循环次数 (-1 为循环播放) */
 		);
 
-		// ͣ
+		// 暂停音乐
 		void Pause(
-			const String& file_path	/* ļ· */
+			const String& file_path	/* 音乐文件路径 */
 		);
 
-		// 
+		// 继续播放音乐
 		void Resume(
-			const String& file_path	/* ļ· */
+			const String& file_path	/* 音乐文件路径 */
 		);
 
-		// ֹͣ
+		// 停止音乐
 		void Stop(
-			const String& file_path	/* ļ· */
+			const String& file_path	/* 音乐文件路径 */
 		);
 
-		// ȡֲ״̬
+		// 获取音乐播放状态
 		bool IsPlaying(
-			const String& file_path	/* ļ· */
+			const String& file_path	/* 音乐文件路径 */
 		);
 
-		// ԤԴ
+		// 预加载音乐资源
 		bool Load(
-			const Resource& res		/* Դ */
+			const Resource& res		/* 音乐资源 */
 		);
 
-		// 
+		// 播放音乐
 		bool Play(
-			const Resource& res,	/* Դ */
-			int loop_count = 0		/* ѭ (-1 Ϊѭ) */
+			const Resource& res,	/* 音乐资源 */
+			int loop_count = 0		/* 播放循环次数 (-1 为循环播放) */
 		);
 
-		// ͣ
+		// 暂停音乐
 		void Pause(
-			const Resource& res		/* Դ */
+			const Resource& res		/* 音乐资源 */
 		);
 
-		// 
+		// 继续播放音乐
 		void Resume(
-			const Resource& res		/* Դ */
+			const Resource& res		/* 音乐资源 */
 		);
 
-		// ֹͣ
+		// 停止音乐
 		void Stop(
-			const Resource& res		/* Դ */
+			const Resource& res		/* 音乐资源 */
 		);
 
-		// ȡֲ״̬
+		// 获取音乐播放状态
 		bool IsPlaying(
-			const Resource& res		/* Դ */
+			const Resource& res		/* 音乐资源 */
 		);
 
-		// ȡ
+		// 获取音量
 		float GetVolume() const;
 
-		// 
+		// 设置音量
 		void SetVolume(
-			float volume			/* 1.0 Ϊԭʼ */
+			float volume			/* 1.0 为原始音量 */
 		);
 
-		// ͣ
+		// 暂停所有音乐
 		void PauseAll();
 
-		// 
+		// 继续播放所有音乐
 		void ResumeAll();
 
-		// ֹͣ
+		// 停止所有音乐
 		void StopAll();
 
-		// 
+		// 清除缓存
 		static void ClearCache();
 
 	protected:
@@ -238,56 +238,56 @@ namespace easy2d
 	};
 
 
-	// ݹ
+	// 数据管理工具
 	class Data
 	{
 	public:
 		Data(
-			const String& key,					/* ֵ */
-			const String& field = L"Defalut"	/* ֶ */
+			const String& key,					/* 键值 */
+			const String& field = L"Defalut"	/* 字段名称 */
 		);
 
-		// Ƿ
+		// 该数据是否存在
 		bool Exists() const;
 
-		//  int ͵ֵ
+		// 保存 int 类型的值
 		bool SaveInt(
 			int value
 		);
 
-		//  float ͵ֵ
+		// 保存 float 类型的值
 		bool SaveFloat(
 			float value
 		);
 
-		//  double ͵ֵ
+		// 保存 double 类型的值
 		bool SaveDouble(
 			double value
 		);
 
-		//  bool ͵ֵ
+		// 保存 bool 类型的值
 		bool SaveBool(
 			bool value
 		);
 
-		//  String ͵ֵ
+		// 保存 String 类型的值
 		bool SaveString(
 			const String& value
 		);
 
-		// ȡ int ͵ֵ
+		// 获取 int 类型的值
 		int GetInt() const;
 
-		// ȡ float ͵ֵ
+		// 获取 float 类型的值
 		float GetFloat() const;
 
-		// ȡ double ͵ֵ
+		// 获取 double 类型的值
 		double GetDouble() const;
 
-		// ȡ bool ͵ֵ
+		// 获取 bool 类型的值
 		bool GetBool() const;
 
-		// ȡ ַ ͵ֵ
+		// 获取 字符串 类型的值
 		String GetString();
 
 	protected:
@@ -297,7 +297,7 @@ namespace easy2d
 	};
 
 
-	// ļ
+	// 文件
 	class File
 	{
 	public:
@@ -309,45 +309,45 @@ namespace easy2d
 
 		virtual ~File();
 
-		// ļ
+		// 打开文件
 		bool Open(
 			const String& file_name
 		);
 
-		// ļǷ
+		// 文件是否存在
 		bool Exists() const;
 
-		// ɾļ
+		// 删除文件
 		bool Delete();
 
-		// ȡļ·
+		// 获取文件路径
 		const String& GetPath() const;
 
-		// ȡļչ
+		// 获取文件扩展名
 		String GetExtension() const;
 
-		// ͷԴʱļĿ¼
+		// 释放资源到临时文件目录
 		static File Extract(
-			const Resource& res,			/* Դ */
-			const String& dest_file_name	/* Ŀļ */
+			const Resource& res,			/* 资源 */
+			const String& dest_file_name	/* 目标文件名 */
 		);
 
-		// ļ·
+		// 添加文件搜索路径
 		static void AddSearchPath(
 			const String& path
 		);
 
-		// ļԻ
+		// 弹出打开文件对话框
 		static File ShowOpenDialog(
-			const String& title = L"",	/* Ի */
-			const String& filter = L""		/* ɸѡչ "*.jpg;*.jpeg" */
+			const String& title = L"打开",	/* 对话框标题 */
+			const String& filter = L""		/* 筛选扩展名，例如 "*.jpg;*.jpeg" */
 		);
 
-		// ļԻ
+		// 弹出保存文件对话框
 		static File ShowSaveDialog(
-			const String& title = L"",	/* Ի */
-			const String& def_file = L"",	/* Ĭϱļ */
-			const String& def_ext = L""		/* Ĭ׷ӵչ "txt" */
+			const String& title = L"保存",	/* 对话框标题 */
+			const String& def_file = L"",	/* 默认保存的文件名 */
+			const String& def_ext = L""		/* 默认追加的扩展名，例如 "txt" */
 		);
 
 	protected:
@@ -357,20 +357,20 @@ namespace easy2d
 	};
 
 
-	// ·
+	// 路径
 	class Path
 	{
 	public:
-		// ȡݵĬϱ·
+		// 获取数据的默认保存路径
 		static const String& GetDataPath();
 
-		// ȡʱļĿ¼
+		// 获取临时文件目录
 		static const String& GetTemporaryPath();
 
-		// ȡ LocalAppData Ŀ¼
+		// 获取 LocalAppData 目录
 		static const String& GetLocalAppDataPath();
 
-		// ȡǰ·
+		// 获取当前程序的运行路径
 		static const String& GetExeFilePath();
 	};
 
@@ -28,7 +28,7 @@ namespace easy2d
 	class Game;
 	class Scene;
 
-	// 
+	// 场景过渡
 	class Transition
 		: public Ref
 	{
@@ -41,27 +41,27 @@ namespace easy2d
 
 		virtual ~Transition();
 
-		// ɶǷ
+		// 场景过渡动画是否结束
 		bool IsDone();
 
 	protected:
-		// ʼɶ
+		// 初始化场景过渡动画
 		virtual void Init(
 			Scene * prev,
 			Scene * next,
 			Game * game
 		);
 
-		// ³ɶ
+		// 更新场景过渡动画
 		virtual void Update();
 
-		// Ⱦɶ
+		// 渲染场景过渡动画
 		virtual void Draw();
 
-		// ֹͣɶ
+		// 停止场景过渡动画
 		virtual void Stop();
 
-		// óɶ
+		// 重置场景过渡动画
 		virtual void Reset() { };
 
 	protected:
@@ -79,17 +79,17 @@ namespace easy2d
 	};
 
 
-	// 뵭
+	// 淡入淡出过渡
 	class FadeTransition
 		: public Transition
 	{
 	public:
 		explicit FadeTransition(
-			float duration		/* ʱ */
+			float duration		/* 动画持续时长 */
 		);
 
 	protected:
-		// ¶
+		// 更新动画
 		virtual void Update() override;
 
 		virtual void Init(
@@ -100,13 +100,13 @@ namespace easy2d
 	};
 
 
-	// 
+	// 渐变过渡
 	class EmergeTransition
 		: public Transition
 	{
 	public:
 		explicit EmergeTransition(
-			float duration		/* ʱ */
+			float duration		/* 动画持续时长 */
 		);
 
 	protected:
@@ -120,13 +120,13 @@ namespace easy2d
 	};
 
 
-	// ״
+	// 盒状过渡
 	class BoxTransition
 		: public Transition
 	{
 	public:
 		explicit BoxTransition(
-			float duration		/* ʱ */
+			float duration		/* 动画持续时长 */
 		);
 
 	protected:
@@ -140,14 +140,14 @@ namespace easy2d
 	};
 
 
-	// λƹ
+	// 位移过渡
 	class MoveTransition
 		: public Transition
 	{
 	public:
 		explicit MoveTransition(
-			float moveDuration,						/* ʱ */
-			Direction direction = Direction::Left	/* ƶ */
+			float moveDuration,						/* 动画持续时长 */
+			Direction direction = Direction::Left	/* 移动方向 */
 		);
 
 	protected:
@@ -168,14 +168,14 @@ namespace easy2d
 	};
 
 
-	// ת
+	// 旋转过渡
 	class RotationTransition
 		: public Transition
 	{
 	public:
 		explicit RotationTransition(
-			float moveDuration,		/* ʱ */
-			float rotation = 360	/* ת */
+			float moveDuration,		/* 动画持续时长 */
+			float rotation = 360	/* 旋转度数 */
 		);
 
 	protected:
@@ -25,33 +25,33 @@ namespace easy2d
 {
 
 
-	// 
+	// 方向
 	enum class Direction : int
 	{
-		Up,			/*  */
-		Down,		/*  */
-		Left,		/*  */
-		Right		/*  */
+		Up,			/* 上 */
+		Down,		/* 下 */
+		Left,		/* 左 */
+		Right		/* 右 */
 	};
 
 
-	// ཻʽ
+	// 线条相交样式
 	enum class Stroke : int
 	{
-		Miter = 0,	/* б */
-		Bevel = 1,	/* б */
-		Round = 2	/* Բ */
+		Miter = 0,	/* 斜切 */
+		Bevel = 1,	/* 斜角 */
+		Round = 2	/* 圆角 */
 	};
 
 
 	class Size;
 
-	// 
+	// 坐标
 	class Point
 	{
 	public:
-		float x;	// X 
-		float y;	// Y 
+		float x;	// X 坐标
+		float y;	// Y 坐标
 
 	public:
 		Point();
@@ -74,7 +74,7 @@ namespace easy2d
 
 		E2D_OP_EXPLICIT operator easy2d::Size() const;
 
-		// ж
+		// 判断两点间距离
 		static float Distance(
 			const Point& p1,
 			const Point& p2
@@ -82,12 +82,12 @@ namespace easy2d
 	};
 
 
-	// С
+	// 大小
 	class Size
 	{
 	public:
-		float width;	// 
-		float height;	// ߶
+		float width;	// 宽度
+		float height;	// 高度
 
 	public:
 		Size();
@@ -112,12 +112,12 @@ namespace easy2d
 	};
 
 
-	// 
+	// 矩形
 	class Rect
 	{
 	public:
-		Point origin;	// ԭ
-		Size  size;		// Ⱥ͸߶
+		Point origin;	// 原点坐标
+		Size  size;		// 宽度和高度
 
 	public:
 		Rect();
@@ -142,19 +142,19 @@ namespace easy2d
 
 		bool operator== (const Rect& rect) const;
 
-		// жϵǷھ
+		// 判断点是否在矩形内
 		bool ContainsPoint(
 			const Point& point
 		) const;
 
-		// жǷཻ
+		// 判断两矩形是否相交
 		bool Intersects(
 			const Rect& rect
 		) const;
 	};
 
 
-	// ַ
+	// 字符串
 	class String
 	{
 	public:
@@ -178,92 +178,92 @@ namespace easy2d
 
 		~String();
 
-		// ȡַ
+		// 获取字符串长度
 		int Length() const;
 
-		// ȡַ Hash ֵ
+		// 获取该字符串的 Hash 值
 		size_t GetHash() const;
 
-		// жַǷΪ
+		// 判断字符串是否为空
 		bool IsEmpty() const;
 
-		// ȡָλַ
+		// 获取指定位置字符
 		const wchar_t& At(
 			size_t index
 		) const;
 
-		// Ƚַ
+		// 比较字符串
 		int Compare(
 			const String & str
 		) const;
 
-		// ȡַ
+		// 截取字符串
 		String Subtract(
-			int offset,		/* ƫ */
-			int count = -1	/* ȡַ */
+			int offset,		/* 偏移量 */
+			int count = -1	/* 截取字符数量 */
 		) const;
 
-		// ַ
+		// 插入字符串
 		void Insert(
 			const String & str,
 			int pos
 		);
 
-		// 滻ַеָ
+		// 替换字符串中的指定内容
 		void Replace(
-			const String & from,	/* 滻 */
-			const String & to		/* 滻 */
+			const String & from,	/* 需替换内容 */
+			const String & to		/* 替换成内容 */
 		);
 
-		// ɾַеָ
+		// 删除字符串中的指定内容
 		void Erase(
-			int offset,		/* ƫ */
-			int count		/* ɾַ */
+			int offset,		/* 偏移量 */
+			int count		/* 删除字符数量 */
 		);
 
-		// ַ
+		// 搜索字符串
 		int Find(
-			const String & str,	/*  */
-			int offset = 0		/* ƫ */
+			const String & str,	/* 查找内容 */
+			int offset = 0		/* 偏移量 */
 		) const;
 
-		// ַ
+		// 清空字符串
 		void Clear();
 
-		// ȡдַ
+		// 获取大写字符串
 		String ToUpper() const;
 
-		// ȡСдַ
+		// 获取小写字符串
 		String ToLower() const;
 
-		// ַתΪ int 
+		// 将字符串转化为 int 型
 		int ToInt() const;
 
-		// ַתΪ float 
+		// 将字符串转化为 float 型
 		float ToFloat() const;
 
-		// ַתΪ double 
+		// 将字符串转化为 double 型
 		double ToDouble() const;
 
-		// ַתΪ bool 
+		// 将字符串转化为 bool 型
 		bool ToBool() const;
 
-		// תַ
+		// 数字类型转字符串
 		static String Parse(int value);
 		static String Parse(unsigned int value);
 		static String Parse(float value);
 		static String Parse(double value);
 
-		// ʽַ
+		// 格式化字符串
 		static String Format(const char * format, ...);
 		static String Format(const wchar_t * format, ...);
 
-		// ֵ
+		// 赋值运算符
 		String& operator= (const String &);
 		String& operator= (const char *);
 		String& operator= (const wchar_t *);
 
-		// 
+		// 运算符
 		String& operator+= (const String &);
 		String& operator+= (const char *);
 		String& operator+= (const wchar_t *);
@@ -271,17 +271,17 @@ namespace easy2d
 		String operator+ (const char *) const;
 		String operator+ (const wchar_t *) const;
 
-		// Ԫ
+		// 友元运算符
 		friend String operator+ (const char *, const String &);
 		friend String operator+ (const wchar_t*, const String &);
 
-		// ת
+		// 类型转换操作符
 		E2D_OP_EXPLICIT operator const wchar_t* () const;
 		E2D_OP_EXPLICIT operator wchar_t* () const;
 		E2D_OP_EXPLICIT operator std::wstring() const;
 		E2D_OP_EXPLICIT operator std::string() const;
 
-		// Ƚ
+		// 比较运算符
 		bool operator== (const String &) const;
 		bool operator== (const char *) const;
 		bool operator== (const wchar_t *) const;
@@ -293,7 +293,7 @@ namespace easy2d
 		bool operator< (const String &) const;
 		bool operator<= (const String &) const;
 
-		// << ַ
+		// << 运算符（后接字符串）
 		String& operator<< (const String &);
 		String& operator<< (const char *);
 		String& operator<< (char *);
@@ -304,7 +304,7 @@ namespace easy2d
 		String& operator<< (float value);
 		String& operator<< (double value);
 
-		// 
+		// 其他运算符
 		wchar_t& operator[] (size_t);
 
 		friend std::ostream& operator<< (std::ostream &, const String &);
@@ -318,7 +318,7 @@ namespace easy2d
 	};
 
 
-	// ɫ
+	// 颜色
 	class Color
 	{
 	public:
@@ -404,7 +404,7 @@ namespace easy2d
 	};
 
 
-	// ֵ̼
+	// 键盘键值
 	enum class KeyCode : int
 	{
 		Unknown = 0,
@@ -464,16 +464,16 @@ namespace easy2d
 	};
 
 
-	// ֵ
+	// 鼠标键值
 	enum class MouseCode : int
 	{
-		Left,		/*  */
-		Right,		/* Ҽ */
-		Middle		/* м */
+		Left,		/* 鼠标左键 */
+		Right,		/* 鼠标右键 */
+		Middle		/* 鼠标中键 */
 	};
 
 
-	// 
+	// 函数对象
 	class Function
 	{
 	public:
@@ -508,9 +508,11 @@ namespace easy2d
 	};
 
 
-	// ʱ
+	// 时间段
 	class Duration
 	{
+		friend class Time;
+
 	public:
 		Duration();
 
@@ -518,10 +520,18 @@ namespace easy2d
 			float seconds
 		);
 
-		// ȡ
+		// 根据微秒数创建时间段
+		static Duration FromMicroseconds(
+			long long microseconds
+		);
+
+		// 获取微秒数
+		long long Microseconds() const;
+
+		// 获取毫秒数
 		int Milliseconds() const;
 
-		// ȡ
+		// 获取秒数
 		float Seconds() const;
 
 		bool operator== (const Duration &) const;
@@ -538,20 +548,20 @@ namespace easy2d
 		Duration& operator -= (Duration const &);
 
 	protected:
-		std::chrono::milliseconds duration_ms_;
+		std::chrono::microseconds duration_;
 	};
 
 
-	// ʱ
+	// 时间点
 	class Time
 	{
 	public:
 		Time();
 
-		// ȡʱ
+		// 获取时间戳
 		time_t GetTimeStamp() const;
 
-		// Ƿ
+		// 是否是
 		bool IsZero() const;
 
 		Time operator + (Duration const &) const;
@@ -562,7 +572,7 @@ namespace easy2d
 
 		Duration operator - (Time const &) const;
 
-		// ȡǰʱ
+		// 获取当前时间
 		static Time Now();
 
 	protected:
@@ -570,17 +580,17 @@ namespace easy2d
 	};
 
 
-	// 
+	// 字体
 	class Font
 	{
 	public:
-		String	family;			// 
-		float	size;			// ֺ
-		UINT	weight;			// ϸֵ
-		bool	italic;			// Ƿб
+		String	family;			// 字体族
+		float	size;			// 字号
+		UINT	weight;			// 粗细值
+		bool	italic;			// 是否斜体
 
 	public:
-		// ϸֵ
+		// 字体粗细值
 		enum Weight : UINT
 		{
 			Thin = 100,
@@ -606,13 +616,13 @@ namespace easy2d
 	};
 
 
-	// Դ
+	// 资源
 	class Resource
 	{
 	public:
 		Resource(
-			int resource_id,				/* Դ */
-			const String& resource_type		/* Դ */
+			int resource_id,				/* 资源名称 */
+			const String& resource_type		/* 资源类型 */
 		);
 
 	public:
@@ -621,19 +631,19 @@ namespace easy2d
 	};
 
 
-	// άת
+	// 二维转换
 	class Transform
 	{
 	public:
-		Point position;		// 
-		Size size;			// С
-		float scale_x;		// 
-		float scale_y;		// 
-		float rotation;		// ת
-		float skew_x;		// бǶ
-		float skew_y;		// бǶ
-		float pivot_x;		// ֧
-		float pivot_y;		// ֧
+		Point position;		// 坐标
+		Size size;			// 大小
+		float scale_x;		// 横向缩放
+		float scale_y;		// 纵向缩放
+		float rotation;		// 旋转
+		float skew_x;		// 横向倾斜角度
+		float skew_y;		// 纵向倾斜角度
+		float pivot_x;		// 支点横坐标
+		float pivot_y;		// 支点纵坐标
 
 	public:
 		Transform();
@@ -644,7 +654,129 @@ namespace easy2d
 	};
 
 
-	// ü
+	// 最近最少使用缓存的记录，只保存键、字节数和引用计数，不持有资源本身
+	// 超出预算时淘汰最久没有使用且没有被引用的项，被淘汰的资源由调用者释放
+	class LruCache
+	{
+	public:
+		// 缓存统计
+		struct Stats
+		{
+			size_t hits;		// 命中次数
+			size_t misses;		// 未命中次数
+			size_t evictions;	// 被淘汰的项数量
+			size_t bytes;		// 缓存项占用的字节数
+			size_t count;		// 缓存项数量
+		};
+
+	public:
+		explicit LruCache(
+			size_t budget = 0	/* 字节预算，为 0 时不限制 */
+		);
+
+		// 设置字节预算，为 0 时不限制
+		void SetBudget(
+			size_t bytes
+		);
+
+		// 获取字节预算
+		size_t GetBudget() const;
+
+		// 获取缓存统计
+		const Stats& GetStats() const;
+
+		// 是否包含缓存项
+		bool Contains(
+			size_t key
+		) const;
+
+		// 查找缓存项，计入命中或未命中次数
+		bool Lookup(
+			size_t key
+		);
+
+		// 添加缓存项，新的项没有被引用，作为最近使用的项
+		void Add(
+			size_t key,
+			size_t bytes
+		);
+
+		// 引用缓存项，被引用的项不会被淘汰
+		bool Retain(
+			size_t key
+		);
+
+		// 取消引用，返回剩余的引用次数，引用归零时作为最近使用的项
+		int Release(
+			size_t key
+		);
+
+		// 获取缓存项的引用次数
+		int GetRefCount(
+			size_t key
+		) const;
+
+		// 淘汰超出预算且没有被引用的项，被淘汰的键按淘汰顺序追加到 evicted 中
+		void Trim(
+			std::vector<size_t>& evicted
+		);
+
+		// 清空所有缓存项，保留命中、未命中和淘汰次数
+		void Clear();
+
+	protected:
+		// 缓存项
+		struct Entry
+		{
+			size_t						bytes;
+			int							refs;
+			std::list<size_t>::iterator	order;	// 在最近使用顺序中的位置
+		};
+
+	protected:
+		size_t budget_;
+		Stats stats_;
+		std::list<size_t> order_;
+		std::map<size_t, Entry> entries_;
+	};
+
+
+	// 内存池，按大小分级缓存引用计数对象的内存
+	// 每个线程使用独立的空闲链表，分配和释放不需要加锁
+	class MemoryPool
+	{
+	public:
+		// 分配内存
+		static void * Allocate(
+			size_t size
+		);
+
+		// 释放内存
+		static void Free(
+			void * p,
+			size_t size
+		);
+
+		// 释放内存，大小未知时使用
+		static void Free(
+			void * p
+		);
+
+		// 获取存活的对象数量
+		static size_t GetLiveCount();
+
+		// 获取存活对象数量的峰值
+		static size_t GetPeakCount();
+
+		// 获取存活对象占用的字节数
+		static size_t GetLiveBytes();
+
+		// 获取内存池向系统申请的字节数
+		static size_t GetReservedBytes();
+	};
+
+
+	// 引用计数对象
 	class Ref
 	{
 	public:
@@ -652,20 +784,76 @@ namespace easy2d
 
 		virtual ~Ref();
 
-		// ü
+		// 从内存池中分配对象
+		static void * operator new(
+			size_t size
+		);
+
+		static void * operator new(
+			size_t size,
+			const std::nothrow_t&
+		) E2D_NOEXCEPT;
+
+		static void operator delete(
+			void * p,
+			size_t size
+		);
+
+		static void operator delete(
+			void * p,
+			const std::nothrow_t&
+		) E2D_NOEXCEPT;
+
+		// 增加引用计数
 		LONG Retain();
 
-		// ü
+		// 减少引用计数
 		LONG Release();
 
-		// ȡü
+		// 获取引用计数
 		LONG GetRefCount() const;
 
+		// 自动释放，对象将在本帧结束时释放一次
+		Ref * Autorelease();
+
 	protected:
 		LONG ref_count_;
 	};
 
 
+	// 自动释放池
+	class AutoreleasePool
+	{
+	public:
+		// 添加对象，对象将在 Drain 时释放一次
+		static void Add(
+			Ref * ref
+		);
+
+		// 设置引用计数归零的对象是否延迟到 Drain 时删除
+		static void SetDeferred(
+			bool deferred
+		);
+
+		// 是否延迟删除对象
+		static bool IsDeferred();
+
+		// 获取等待释放和删除的对象数量
+		static size_t GetCount();
+
+		// 释放池中的对象，并删除引用计数归零的对象
+		static void Drain();
+
+	protected:
+		// 延迟删除对象
+		static void Defer(
+			Ref * ref
+		);
+
+		friend class Ref;
+	};
+
+
 	template<class Interface>
 	inline void SafeRelease(Interface*& p)
 	{
@@ -26,11 +26,11 @@
 #pragma once
 
 #ifndef __cplusplus
-#	error  C++ ʹ Easy2D
+#	error 仅能在 C++ 环境下使用 Easy2D
 #endif
 
-#if _MSC_VER < 1700
-#	error Easy2D ֧ Visual Studio 2012 °汾
+#if defined(_MSC_VER) && _MSC_VER < 1700
+#	error Easy2D 不支持 Visual Studio 2012 以下版本
 #endif
 
 
@@ -44,8 +44,10 @@
 #include "e2dmodule.h"
 
 
-#if defined(DEBUG) || defined(_DEBUG)
-#	pragma comment(lib, "Easy2Ddw.lib")
-#else
-#	pragma comment(lib, "Easy2Dw.lib")
+#if !E2D_HEADLESS
+#	if defined(DEBUG) || defined(_DEBUG)
+#		pragma comment(lib, "Easy2Ddw.lib")
+#	else
+#		pragma comment(lib, "Easy2Dw.lib")
+#	endif
 #endif
@@ -18,7 +18,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2devent.h"
+#include "../e2devent.h"
 
 
 easy2d::KeyEvent::KeyEvent(UINT message, WPARAM w_param, LPARAM l_param)
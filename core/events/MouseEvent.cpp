@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2devent.h"
-#include "..\e2dmodule.h"
+#include "../e2devent.h"
+#include "../e2dmodule.h"
 
 easy2d::MouseEvent::MouseEvent(UINT message, WPARAM w_param, LPARAM l_param)
 	: message_(message)
@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dimpl.h"
-#include "..\e2dmodule.h"
+#include "../e2dimpl.h"
+#include "../e2dmodule.h"
 
 using namespace easy2d;
 
@@ -0,0 +1,145 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "../e2dmodule.h"
+
+easy2d::AsyncQueue::AsyncQueue(size_t thread_count)
+	: pool_(nullptr)
+	, completed_(nullptr)
+	, pending_(0)
+{
+	pool_ = new ThreadPool(thread_count);
+}
+
+easy2d::AsyncQueue::~AsyncQueue()
+{
+	// 先等待工作线程退出，之后完成队列不会再被修改
+	delete pool_;
+	pool_ = nullptr;
+
+	Completion * completion = completed_.exchange(nullptr);
+	while (completion)
+	{
+		Completion * next = completion->next;
+		delete completion;
+		completion = next;
+	}
+}
+
+void easy2d::AsyncQueue::Submit(const Function& job, const Function& on_complete, const Token& token)
+{
+	Completion * completion = new Completion();
+	completion->callback = on_complete;
+	completion->token = token;
+	completion->next = nullptr;
+
+	++pending_;
+	pool_->Submit([this, job, completion]()
+	{
+		// 已取消的任务不再执行，但仍要进入完成队列以便在主线程中释放
+		if (!completion->token || !completion->token->load())
+		{
+			try
+			{
+				if (job)
+				{
+					job();
+				}
+			}
+			catch (...)
+			{
+				completion->error = std::current_exception();
+			}
+		}
+		Push(completion);
+	});
+}
+
+void easy2d::AsyncQueue::Dispatch()
+{
+	Completion * list = completed_.exchange(nullptr, std::memory_order_acquire);
+	if (!list)
+		return;
+
+	// 完成队列是后进先出的链表，翻转后按完成顺序调用回调
+	Completion * ordered = nullptr;
+	while (list)
+	{
+		Completion * next = list->next;
+		list->next = ordered;
+		ordered = list;
+		list = next;
+	}
+
+	std::exception_ptr error;
+	while (ordered)
+	{
+		Completion * completion = ordered;
+		ordered = completion->next;
+		--pending_;
+
+		const bool cancelled = completion->token && completion->token->load();
+		if (!cancelled)
+		{
+			if (completion->error)
+			{
+				if (!error)
+				{
+					error = completion->error;
+				}
+			}
+			else if (completion->callback)
+			{
+				try
+				{
+					completion->callback();
+				}
+				catch (...)
+				{
+					if (!error)
+					{
+						error = std::current_exception();
+					}
+				}
+			}
+		}
+		delete completion;
+	}
+
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+}
+
+size_t easy2d::AsyncQueue::GetPendingCount() const
+{
+	return pending_;
+}
+
+void easy2d::AsyncQueue::Push(Completion * completion)
+{
+	// 多个工作线程同时写入，主线程一次性取走整个链表，因此不存在 ABA 问题
+	Completion * head = completed_.load(std::memory_order_relaxed);
+	do
+	{
+		completion->next = head;
+	} while (!completed_.compare_exchange_weak(head, completion, std::memory_order_release, std::memory_order_relaxed));
+}
@@ -18,7 +18,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dmodule.h"
+#include "../e2dmodule.h"
 
 
 easy2d::Audio::Audio()
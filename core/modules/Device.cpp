@@ -18,11 +18,13 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dmodule.h"
+#include "../e2dmodule.h"
 
 static easy2d::Graphics *	graphics_device = nullptr;
 static easy2d::Input *		input_device = nullptr;
 static easy2d::Audio *		audio_device = nullptr;
+static easy2d::ThreadPool *	thread_pool = nullptr;
+static easy2d::AsyncQueue *	async_queue = nullptr;
 
 easy2d::Graphics * easy2d::Device::GetGraphics()
 {
@@ -39,15 +41,43 @@ easy2d::Audio * easy2d::Device::GetAudio()
 	return audio_device;
 }
 
+easy2d::ThreadPool * easy2d::Device::GetThreadPool()
+{
+	return thread_pool;
+}
+
+easy2d::AsyncQueue * easy2d::Device::GetAsyncQueue()
+{
+	return async_queue;
+}
+
 void easy2d::Device::Init(HWND hwnd)
 {
+#if !E2D_HEADLESS
 	graphics_device = new (std::nothrow) Graphics(hwnd);
 	input_device = new (std::nothrow) Input(hwnd);
 	audio_device = new (std::nothrow) Audio();
+#endif
+	// 线程池在第一次添加任务时才创建工作线程
+	thread_pool = new (std::nothrow) ThreadPool();
+	async_queue = new (std::nothrow) AsyncQueue();
 }
 
 void easy2d::Device::Destroy()
 {
+	if (async_queue)
+	{
+		delete async_queue;
+		async_queue = nullptr;
+	}
+
+	if (thread_pool)
+	{
+		delete thread_pool;
+		thread_pool = nullptr;
+	}
+
+#if !E2D_HEADLESS
 	if (audio_device)
 	{
 		delete audio_device;
@@ -65,4 +95,13 @@ void easy2d::Device::Destroy()
 		delete graphics_device;
 		graphics_device = nullptr;
 	}
+#endif
+}
+
+#if E2D_HEADLESS
+float easy2d::Graphics::GetDpi()
+{
+	// 没有显示设备时按标准 DPI 计算
+	return 96.f;
 }
+#endif
@@ -18,10 +18,11 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dmodule.h"
-#include "..\e2dobject.h"
-#include "..\e2dtool.h"
-#include "..\e2dtransition.h"
+#include "../e2dmodule.h"
+#include "../e2dobject.h"
+#include "../e2daction.h"
+#include "../e2dtool.h"
+#include "../e2dtransition.h"
 #include <thread>
 #include <imm.h>
 #pragma comment (lib ,"imm32.lib")
@@ -48,10 +49,15 @@ easy2d::Game::Game()
 	, height_(480)
 	, icon_(0)
 	, debug_mode_(false)
+	, time_scale_(1.f)
+	, time_carry_(0.f)
+	, fixed_step_(0.f)
+	, step_accumulator_(0.f)
+	, time_()
 {
 	if (instance)
 	{
-		throw RuntimeException("ͬʱֻܴһϷʵ");
+		throw RuntimeException("同时只能存在一个游戏实例");
 	}
 	instance = this;
 
@@ -86,13 +92,13 @@ void easy2d::Game::Run(const Options& options)
 	icon_ = options.icon;
 	debug_mode_ = options.debug_mode;
 
-	// ʼ
+	// 初始化
 	Init();
 
-	// ʼ
+	// 开始
 	Start();
 
-	// ˢ³
+	// 刷新场景
 	if (next_scene_)
 	{
 		next_scene_->OnEnter();
@@ -102,8 +108,11 @@ void easy2d::Game::Run(const Options& options)
 	::ShowWindow(hwnd_, SW_SHOWNORMAL);
 	::UpdateWindow(hwnd_);
 
-	// 
-	const int min_interval = 5;
+	// 运行期间引用计数归零的对象在每帧结束时统一删除
+	AutoreleasePool::SetDeferred(true);
+
+	// 运行
+	const Duration min_interval = Duration::FromMicroseconds(5000);
 	Time last = Time::Now();
 	MSG msg = { 0 };
 	
@@ -112,14 +121,47 @@ void easy2d::Game::Run(const Options& options)
 		auto now = Time::Now();
 		auto dur = now - last;
 
-		if (dur.Milliseconds() > min_interval)
+		if (dur > min_interval)
 		{
-			float dt = (now - last).Seconds();
-			last = now;
+			// 每帧只读取一次系统时钟
+			// 差值截断到微秒，上一帧时间只前进截断后的部分，余下的时间留到下一帧
+			float dt = dur.Seconds() * time_scale_;
+			last += dur;
 
 			Device::GetInput()->Flush();
-			Update(dt);
-			UpdateScene(dt);
+
+			// 异步任务的完成回调在每帧更新之前统一调用
+			Device::GetAsyncQueue()->Dispatch();
+
+			// 在时间预算内为解码完成的图片创建位图
+			Image::UploadPending();
+
+			if (fixed_step_ > 0.f)
+			{
+				// 固定步长模式下按相同的时间间隔更新，落后过多时丢弃多余的时间
+				const int max_steps = 8;
+				step_accumulator_ += dt;
+
+				int steps = 0;
+				while (step_accumulator_ >= fixed_step_ && steps < max_steps)
+				{
+					Update(fixed_step_);
+					UpdateScene(fixed_step_);
+					step_accumulator_ -= fixed_step_;
+					++steps;
+				}
+
+				if (steps == max_steps)
+				{
+					step_accumulator_ = 0.f;
+				}
+			}
+			else
+			{
+				Update(dt);
+				UpdateScene(dt);
+			}
+
 			DrawScene();
 
 			while (::PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
@@ -127,19 +169,24 @@ void easy2d::Game::Run(const Options& options)
 				::TranslateMessage(&msg);
 				::DispatchMessage(&msg);
 			}
+
+			AutoreleasePool::Drain();
 		}
 		else
 		{
-			// ID2D1HwndRenderTarget ˴ֱͬȾʱȴʾˢ£
-			// ˷ǳȶʱãԴ󲿷ʱҪֶ߳̽ʱ
-			// ĴһЩ£細Сʱֹ̣߳ռù CPU 
-			int wait = min_interval - dur.Milliseconds();
+			// ID2D1HwndRenderTarget 开启了垂直同步，在渲染时会等待显示器刷新，
+			// 它起到了非常稳定的延时作用，所以大部分时候不需要手动挂起线程进行延时。
+			// 下面的代码仅在一些情况下（例如窗口最小化时）挂起线程，防止占用过高 CPU 。
+			int wait = (min_interval - dur).Milliseconds();
 			if (wait > 1)
 			{
 				std::this_thread::sleep_for(std::chrono::milliseconds(wait));
 			}
 		}
 	}
+
+	AutoreleasePool::Drain();
+	AutoreleasePool::SetDeferred(false);
 }
 
 void easy2d::Game::Quit()
@@ -182,6 +229,32 @@ void easy2d::Game::EnterScene(Scene * scene, Transition * transition)
 	}
 }
 
+void easy2d::Game::SetTimeScale(float scale)
+{
+	time_scale_ = std::max(scale, 0.f);
+}
+
+float easy2d::Game::GetTimeScale() const
+{
+	return time_scale_;
+}
+
+void easy2d::Game::SetFixedTimeStep(float step)
+{
+	fixed_step_ = std::max(step, 0.f);
+	step_accumulator_ = 0.f;
+}
+
+float easy2d::Game::GetFixedTimeStep() const
+{
+	return fixed_step_;
+}
+
+const easy2d::Time& easy2d::Game::GetTime() const
+{
+	return time_;
+}
+
 easy2d::Scene * easy2d::Game::GetCurrentScene()
 {
 	return curr_scene_;
@@ -194,6 +267,11 @@ bool easy2d::Game::IsTransitioning() const
 
 void easy2d::Game::UpdateScene(float dt)
 {
+	// Duration 的精度有限，保留不足精度的部分留到下一帧
+	Duration step(dt + time_carry_);
+	time_carry_ = dt + time_carry_ - step.Seconds();
+	time_ += step;
+
 	auto update = [&](Scene * scene) -> void
 	{
 		if (scene)
@@ -202,8 +280,12 @@ void easy2d::Game::UpdateScene(float dt)
 			Node * root = scene->GetRoot();
 			if (root)
 			{
-				root->UpdateChildren(dt);
+				// 时间段每帧只换算一次，节点没有缩放时直接沿用
+				root->UpdateChildren(dt, step);
 			}
+			ActionManager::GetInstance()->Update(scene);
+			TweenManager::GetInstance()->Update(scene);
+			scene->UpdateTransform();
 		}
 	};
 
@@ -256,18 +338,21 @@ void easy2d::Game::DrawScene()
 
 	if (debug_mode_)
 	{
+		// 节点边缘已经是世界坐标系下的几何体
+		auto& commands = graphics->GetCommandList();
+		commands.Clear();
+		commands.SetTransform(D2D1::Matrix3x2F::Identity());
+		commands.SetOpacity(1.f);
+
 		if (curr_scene_ && curr_scene_->GetRoot())
 		{
-			graphics->GetRenderTarget()->SetTransform(D2D1::Matrix3x2F::Identity());
-			graphics->GetSolidBrush()->SetOpacity(1.f);
-			curr_scene_->GetRoot()->DrawBorder();
+			curr_scene_->GetRoot()->DrawBorder(commands);
 		}
 		if (next_scene_ && next_scene_->GetRoot())
 		{
-			graphics->GetRenderTarget()->SetTransform(D2D1::Matrix3x2F::Identity());
-			graphics->GetSolidBrush()->SetOpacity(1.f);
-			next_scene_->GetRoot()->DrawBorder();
+			next_scene_->GetRoot()->DrawBorder(commands);
 		}
+		graphics->Replay(commands);
 
 		graphics->DrawDebugInfo();
 	}
@@ -301,13 +386,13 @@ void easy2d::Game::Init()
 		);
 	}
 
-	// עᴰ
+	// 注册窗口类
 	::RegisterClassEx(&wcex);
 
-	// 㴰ڴС
+	// 计算窗口大小
 	Rect client_rect = Locate(width_, height_);
 
-	// 
+	// 创建窗口
 	hwnd_ = ::CreateWindowEx(
 		NULL,
 		REGISTER_CLASS,
@@ -336,15 +421,15 @@ void easy2d::Game::Init()
 		PtrToUlong(this)
 	);
 
-	// ʼ豸
+	// 初始化设备
 	Device::Init(hwnd_);
 
-	// 뷨
+	// 禁用输入法
 	::ImmAssociateContext(hwnd_, nullptr);
 
-	// ˵ģʽ򿪿̨
+	// 若开启了调试模式，打开控制台
 	HWND console = ::GetConsoleWindow();
-	// رտ̨
+	// 关闭控制台
 	if (debug_mode_)
 	{
 		if (console)
@@ -353,16 +438,16 @@ void easy2d::Game::Init()
 		}
 		else
 		{
-			// ʾһ¿̨
+			// 显示一个新控制台
 			if (::AllocConsole())
 			{
 				console = ::GetConsoleWindow();
-				// ض
+				// 重定向输入输出
 				FILE * stdoutStream, *stdinStream, *stderrStream;
 				freopen_s(&stdoutStream, "conout$", "w+t", stdout);
 				freopen_s(&stdinStream, "conin$", "r+t", stdin);
 				freopen_s(&stderrStream, "conout$", "w+t", stderr);
-				// ÿ̨رհť
+				// 禁用控制台关闭按钮
 				HMENU hmenu = ::GetSystemMenu(console, FALSE);
 				::RemoveMenu(hmenu, SC_CLOSE, MF_BYCOMMAND);
 			}
@@ -387,12 +472,12 @@ easy2d::Rect easy2d::Game::Locate(int width, int height)
 	float dpi = Graphics::GetDpi();
 	RECT rect = { 0, 0, LONG(ceil(width * dpi / 96.f)), LONG(ceil(height * dpi / 96.f)) };
 
-	// ʵĴڴС
+	// 计算合适的窗口大小
 	::AdjustWindowRectEx(&rect, WINDOW_STYLE, FALSE, NULL);
 	width = static_cast<int>(rect.right - rect.left);
 	height = static_cast<int>(rect.bottom - rect.top);
 
-	// ĴڴСȷֱʴʱ
+	// 当输入的窗口大小比分辨率大时，给出警告
 	E2D_WARNING_IF(max_width < width || max_height < height, "The window Is larger than screen!");
 	width = std::min(width, max_width);
 	height = std::min(height, max_height);
@@ -499,7 +584,7 @@ LRESULT easy2d::Game::WndProc(HWND hwnd, UINT msg, WPARAM w_param, LPARAM l_para
 	switch (msg)
 	{
 
-	// Ϣ
+	// 处理鼠标消息
 	case WM_LBUTTONUP:
 	case WM_LBUTTONDOWN:
 	case WM_LBUTTONDBLCLK:
@@ -525,7 +610,7 @@ LRESULT easy2d::Game::WndProc(HWND hwnd, UINT msg, WPARAM w_param, LPARAM l_para
 	was_handled = true;
 	break;
 
-	// Ϣ
+	// 处理按键消息
 	case WM_KEYDOWN:
 	case WM_KEYUP:
 	{
@@ -542,7 +627,7 @@ LRESULT easy2d::Game::WndProc(HWND hwnd, UINT msg, WPARAM w_param, LPARAM l_para
 	was_handled = true;
 	break;
 
-	// ڴС仯Ϣ
+	// 处理窗口大小变化消息
 	case WM_SIZE:
 	{
 		UINT width = LOWORD(l_param);
@@ -555,9 +640,9 @@ LRESULT easy2d::Game::WndProc(HWND hwnd, UINT msg, WPARAM w_param, LPARAM l_para
 			game->height_ = static_cast<int>(height * 96.f / dpi);
 		}
 
-		// յһ WM_SIZE ϢȾ
-		// ĿĴСܻʧܣԺпܵ
-		// Ϊһε EndDraw ʱ
+		// 如果程序接收到一个 WM_SIZE 消息，这个方法将调整渲染
+		// 目标的大小。它可能会调用失败，但是这里可以忽略有可能的
+		// 错误，因为这个错误将在下一次调用 EndDraw 时产生
 		auto render_target = Device::GetGraphics()->GetRenderTarget();
 		if (render_target)
 		{
@@ -566,24 +651,24 @@ LRESULT easy2d::Game::WndProc(HWND hwnd, UINT msg, WPARAM w_param, LPARAM l_para
 	}
 	break;
 
-	// ڱ仯Ϣ
+	// 处理窗口标题变化消息
 	case WM_SETTEXT:
 	{
 		game->title_ = (const wchar_t*)l_param;
 	}
 	break;
 
-	// ֱʱ仯Ϣ
+	// 处理分辨率变化消息
 	case WM_DISPLAYCHANGE:
 	{
-		// ػͻ
+		// 重绘客户区
 		::InvalidateRect(hwnd, nullptr, FALSE);
 	}
 	result = 0;
 	was_handled = true;
 	break;
 
-	// ػ洰
+	// 重绘窗口
 	case WM_PAINT:
 	{
 		game->DrawScene();
@@ -593,7 +678,7 @@ LRESULT easy2d::Game::WndProc(HWND hwnd, UINT msg, WPARAM w_param, LPARAM l_para
 	was_handled = true;
 	break;
 
-	// ڹرϢ
+	// 窗口关闭消息
 	case WM_CLOSE:
 	{
 		if (game->OnExit())
@@ -605,7 +690,7 @@ LRESULT easy2d::Game::WndProc(HWND hwnd, UINT msg, WPARAM w_param, LPARAM l_para
 	was_handled = true;
 	break;
 
-	// Ϣ
+	// 窗口销毁消息
 	case WM_DESTROY:
 	{
 		::PostQuitMessage(0);
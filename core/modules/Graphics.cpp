@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dmodule.h"
-#include "..\e2dobject.h"
+#include "../e2dmodule.h"
+#include "../e2dobject.h"
 
 
 easy2d::Graphics::Graphics(HWND hwnd)
@@ -35,6 +35,12 @@ easy2d::Graphics::Graphics(HWND hwnd)
 	, solid_brush_(nullptr)
 	, text_renderer_(nullptr)
 	, clear_color_(D2D1::ColorF(D2D1::ColorF::Black))
+	, tint_context_(nullptr)
+	, tint_effect_(nullptr)
+#if E2D_SPRITE_BATCH
+	, device_context_(nullptr)
+	, sprite_batch_(nullptr)
+#endif
 {
 	ThrowIfFailed(
 		D2D1CreateFactory(
@@ -69,8 +75,8 @@ easy2d::Graphics::Graphics(HWND hwnd)
 		rc.bottom - rc.top
 	);
 
-	// 豸ԴЩԴӦ Direct2D 豸ʧʱؽ
-	// һ Direct2D ȾĿ
+	// 创建设备相关资源。这些资源应在 Direct2D 设备消失时重建
+	// 创建一个 Direct2D 渲染目标
 	ThrowIfFailed(
 		factory_->CreateHwndRenderTarget(
 			D2D1::RenderTargetProperties(),
@@ -82,7 +88,7 @@ easy2d::Graphics::Graphics(HWND hwnd)
 		)
 	);
 
-	// ˢ
+	// 创建画刷
 	ThrowIfFailed(
 		render_target_->CreateSolidColorBrush(
 			D2D1::ColorF(D2D1::ColorF::White),
@@ -90,7 +96,7 @@ easy2d::Graphics::Graphics(HWND hwnd)
 		)
 	);
 
-	// ԶȾ
+	// 创建自定义的文字渲染器
 	ThrowIfFailed(
 		TextRenderer::Create(
 			&text_renderer_,
@@ -99,10 +105,36 @@ easy2d::Graphics::Graphics(HWND hwnd)
 			solid_brush_
 		)
 	);
+#if E2D_SPRITE_BATCH
+	// 系统不支持 ID2D1DeviceContext3 时逐个绘制精灵
+	if (SUCCEEDED(render_target_->QueryInterface(&device_context_)))
+	{
+		if (FAILED(device_context_->CreateSpriteBatch(&sprite_batch_)))
+		{
+			SafeRelease(device_context_);
+		}
+	}
+#endif
+
+	// 逐个绘制精灵时使用颜色矩阵效果着色，需要 Direct2D 1.1
+	if (SUCCEEDED(render_target_->QueryInterface(&tint_context_)))
+	{
+		if (FAILED(tint_context_->CreateEffect(CLSID_D2D1ColorMatrix, &tint_effect_)))
+		{
+			SafeRelease(tint_context_);
+		}
+	}
 }
 
 easy2d::Graphics::~Graphics()
 {
+#if E2D_SPRITE_BATCH
+	SafeRelease(sprite_batch_);
+	SafeRelease(device_context_);
+#endif
+	SafeRelease(tint_effect_);
+	SafeRelease(tint_context_);
+
 	SafeRelease(fps_text_format_);
 	SafeRelease(fps_text_layout_);
 	SafeRelease(text_renderer_);
@@ -129,14 +161,20 @@ void easy2d::Graphics::EndDraw()
 
 	if (hr == D2DERR_RECREATE_TARGET)
 	{
-		//  Direct3D 豸ִйʧǰ豸Դ
-		// һεʱؽԴ
+		// 如果 Direct3D 设备在执行过程中消失，将丢弃当前的设备相关资源
+		// 并在下一次调用时重建资源
 		hr = S_OK;
 
 		SafeRelease(fps_text_format_);
 		SafeRelease(fps_text_layout_);
 		SafeRelease(text_renderer_);
 		SafeRelease(solid_brush_);
+#if E2D_SPRITE_BATCH
+		SafeRelease(sprite_batch_);
+		SafeRelease(device_context_);
+#endif
+		SafeRelease(tint_effect_);
+		SafeRelease(tint_context_);
 		SafeRelease(render_target_);
 	}
 
@@ -228,6 +266,204 @@ easy2d::TextRenderer * easy2d::Graphics::GetTextRender() const
 	return text_renderer_;
 }
 
+easy2d::RenderCommandList & easy2d::Graphics::GetCommandList()
+{
+	return commands_;
+}
+
+void easy2d::Graphics::ApplyTransform(const D2D1_MATRIX_3X2_F & matrix)
+{
+	render_target_->SetTransform(matrix);
+}
+
+void easy2d::Graphics::ApplyOpacity(float opacity)
+{
+	solid_brush_->SetOpacity(opacity);
+}
+
+void easy2d::Graphics::ApplyColor(const D2D1_COLOR_F & color)
+{
+	solid_brush_->SetColor(color);
+}
+
+void easy2d::Graphics::PushClip(const D2D1_RECT_F & rect)
+{
+	render_target_->PushAxisAlignedClip(rect, D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
+}
+
+void easy2d::Graphics::PopClip()
+{
+	render_target_->PopAxisAlignedClip();
+}
+
+void easy2d::Graphics::Draw(const RenderCommand & command)
+{
+	switch (command.type)
+	{
+	case RenderCommand::Type::Bitmap:
+		render_target_->DrawBitmap(
+			command.bitmap.bitmap,
+			command.bitmap.dest,
+			command.bitmap.opacity,
+			D2D1_BITMAP_INTERPOLATION_MODE_LINEAR,
+			command.bitmap.src
+		);
+		break;
+
+	case RenderCommand::Type::Text:
+		text_renderer_->SetTextStyle(
+			command.text.color,
+			command.text.outline,
+			command.text.outline_color,
+			command.text.outline_width,
+			command.text.line_join
+		);
+		command.text.layout->Draw(nullptr, text_renderer_, 0, 0);
+		break;
+
+	case RenderCommand::Type::Geometry:
+		render_target_->DrawGeometry(
+			command.geometry.geometry,
+			solid_brush_,
+			command.geometry.stroke_width
+		);
+		break;
+
+	case RenderCommand::Type::Sprites:
+		DrawSprites(command);
+		break;
+
+	case RenderCommand::Type::Custom:
+		command.node->Draw();
+		break;
+
+	default:
+		break;
+	}
+}
+
+void easy2d::Graphics::DrawSprites(const RenderCommand & command)
+{
+	const auto& sprites = command.sprites;
+
+#if E2D_SPRITE_BATCH
+	if (sprite_batch_)
+	{
+		// 精灵批次只接受整数像素区域，存在非整数区域时逐个绘制
+		bool integral = true;
+		sprite_srcs_.resize(sprites.count);
+		sprite_colors_.resize(sprites.count);
+		for (UINT32 i = 0; i < sprites.count && integral; ++i)
+		{
+			const auto& src = sprites.srcs[i];
+			auto& rect = sprite_srcs_[i];
+			rect = D2D1::RectU(
+				static_cast<UINT32>(src.left),
+				static_cast<UINT32>(src.top),
+				static_cast<UINT32>(src.right),
+				static_cast<UINT32>(src.bottom)
+			);
+			integral = rect.left == src.left && rect.top == src.top &&
+				rect.right == src.right && rect.bottom == src.bottom;
+
+			// 透明度合并到颜色中
+			sprite_colors_[i] = sprites.colors[i];
+			sprite_colors_[i].a *= sprites.opacities[i] * sprites.opacity;
+		}
+
+		if (integral)
+		{
+			sprite_batch_->Clear();
+			ThrowIfFailed(
+				sprite_batch_->AddSprites(
+					sprites.count,
+					sprites.dests,
+					&sprite_srcs_[0],
+					&sprite_colors_[0],
+					sprites.transforms
+				)
+			);
+
+			// 精灵批次只能在非抗锯齿模式下绘制
+			device_context_->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+			device_context_->DrawSpriteBatch(sprite_batch_, sprites.bitmap);
+			device_context_->SetAntialiasMode(D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
+			return;
+		}
+	}
+#endif
+
+	D2D1::Matrix3x2F world;
+	render_target_->GetTransform(&world);
+
+	if (tint_effect_)
+	{
+		tint_effect_->SetInput(0, sprites.bitmap);
+	}
+
+	for (UINT32 i = 0; i < sprites.count; ++i)
+	{
+		const auto& m = sprites.transforms[i];
+		const auto& color = sprites.colors[i];
+		const auto& dest = sprites.dests[i];
+		const auto& src = sprites.srcs[i];
+		const float opacity = color.a * sprites.opacities[i] * sprites.opacity;
+		const D2D1::Matrix3x2F transform = D2D1::Matrix3x2F(m._11, m._12, m._21, m._22, m._31, m._32) * world;
+
+		if (tint_effect_ && (color.r != 1.f || color.g != 1.f || color.b != 1.f))
+		{
+			// 颜色矩阵作用于反预乘后的像素，RGB 乘以颜色，透明度乘以不透明度
+			tint_effect_->SetValue(
+				D2D1_COLORMATRIX_PROP_COLOR_MATRIX,
+				D2D1::Matrix5x4F(
+					color.r, 0, 0, 0,
+					0, color.g, 0, 0,
+					0, 0, color.b, 0,
+					0, 0, 0, opacity,
+					0, 0, 0, 0
+				)
+			);
+
+			// DrawImage 不能缩放，源区域到目标区域的缩放合并到变换中
+			const float src_width = src.right - src.left;
+			const float src_height = src.bottom - src.top;
+			if (src_width <= 0 || src_height <= 0)
+				continue;
+
+			tint_context_->SetTransform(
+				D2D1::Matrix3x2F::Scale((dest.right - dest.left) / src_width, (dest.bottom - dest.top) / src_height) *
+				D2D1::Matrix3x2F::Translation(dest.left, dest.top) *
+				transform
+			);
+			tint_context_->DrawImage(
+				tint_effect_,
+				D2D1::Point2F(0, 0),
+				src,
+				D2D1_INTERPOLATION_MODE_LINEAR,
+				D2D1_COMPOSITE_MODE_SOURCE_OVER
+			);
+			continue;
+		}
+
+		// 白色精灵直接绘制，系统不支持 Direct2D 1.1 时只使用颜色的透明度
+		render_target_->SetTransform(transform);
+		render_target_->DrawBitmap(
+			sprites.bitmap,
+			dest,
+			opacity,
+			D2D1_BITMAP_INTERPOLATION_MODE_LINEAR,
+			src
+		);
+	}
+	render_target_->SetTransform(world);
+
+	// 不让效果继续引用位图
+	if (tint_effect_)
+	{
+		tint_effect_->SetInput(0, nullptr);
+	}
+}
+
 ID2D1Factory * easy2d::Graphics::GetFactory() const
 {
 	return factory_;
@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dmodule.h"
-#include "..\e2dtool.h"
+#include "../e2dmodule.h"
+#include "../e2dtool.h"
 
 
 easy2d::Input::Input(HWND hwnd)
@@ -30,7 +30,7 @@ easy2d::Input::Input(HWND hwnd)
 	ZeroMemory(key_buffer_, sizeof(key_buffer_));
 	ZeroMemory(&mouse_state_, sizeof(mouse_state_));
 
-	// ʼӿڶ
+	// 初始化接口对象
 	ThrowIfFailed(
 		DirectInput8Create(
 			HINST_THISCOMPONENT,
@@ -41,7 +41,7 @@ easy2d::Input::Input(HWND hwnd)
 		)
 	);
 
-	// ʼ豸
+	// 初始化键盘设备
 	ThrowIfFailed(
 		direct_input_->CreateDevice(
 			GUID_SysKeyboard,
@@ -55,7 +55,7 @@ easy2d::Input::Input(HWND hwnd)
 	keyboard_device_->Acquire();
 	keyboard_device_->Poll();
 
-	// ʼ豸
+	// 初始化鼠标设备
 	ThrowIfFailed(
 		direct_input_->CreateDevice(
 			GUID_SysMouse,
@@ -0,0 +1,131 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "../e2dmodule.h"
+
+namespace
+{
+	bool IsSameMatrix(const D2D1_MATRIX_3X2_F& lhs, const D2D1_MATRIX_3X2_F& rhs)
+	{
+		return lhs._11 == rhs._11 && lhs._12 == rhs._12 &&
+			lhs._21 == rhs._21 && lhs._22 == rhs._22 &&
+			lhs._31 == rhs._31 && lhs._32 == rhs._32;
+	}
+
+	bool IsSameColor(const D2D1_COLOR_F& lhs, const D2D1_COLOR_F& rhs)
+	{
+		return lhs.r == rhs.r && lhs.g == rhs.g && lhs.b == rhs.b && lhs.a == rhs.a;
+	}
+}
+
+easy2d::RenderBackend::RenderBackend()
+	: transform_valid_(false)
+	, opacity_valid_(false)
+	, color_valid_(false)
+	, opacity_(1.f)
+	, transform_()
+	, color_()
+	, skipped_count_(0)
+{
+}
+
+easy2d::RenderBackend::~RenderBackend()
+{
+}
+
+void easy2d::RenderBackend::Replay(const RenderCommandList & commands)
+{
+	// 两次回放之间渲染目标的状态可能被直接修改过
+	ResetState();
+
+	for (const auto& command : commands.GetCommands())
+	{
+		switch (command.type)
+		{
+		case RenderCommand::Type::Transform:
+			if (transform_valid_ && IsSameMatrix(transform_, command.transform))
+			{
+				++skipped_count_;
+				break;
+			}
+			transform_ = command.transform;
+			transform_valid_ = true;
+			ApplyTransform(command.transform);
+			break;
+
+		case RenderCommand::Type::Opacity:
+			if (opacity_valid_ && opacity_ == command.opacity)
+			{
+				++skipped_count_;
+				break;
+			}
+			opacity_ = command.opacity;
+			opacity_valid_ = true;
+			ApplyOpacity(command.opacity);
+			break;
+
+		case RenderCommand::Type::PushClip:
+			PushClip(command.clip);
+			break;
+
+		case RenderCommand::Type::PopClip:
+			PopClip();
+			break;
+
+		case RenderCommand::Type::Geometry:
+			if (color_valid_ && IsSameColor(color_, command.geometry.color))
+			{
+				++skipped_count_;
+			}
+			else
+			{
+				color_ = command.geometry.color;
+				color_valid_ = true;
+				ApplyColor(command.geometry.color);
+			}
+			Draw(command);
+			break;
+
+		case RenderCommand::Type::Text:
+			Draw(command);
+			// 文字渲染器会修改画刷颜色
+			color_valid_ = false;
+			break;
+
+		case RenderCommand::Type::Custom:
+			Draw(command);
+			// 节点可以任意修改渲染目标的状态
+			ResetState();
+			break;
+
+		default:
+			Draw(command);
+			break;
+		}
+	}
+}
+
+void easy2d::RenderBackend::ResetState()
+{
+	transform_valid_ = false;
+	opacity_valid_ = false;
+	color_valid_ = false;
+}
@@ -0,0 +1,162 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "../e2dmodule.h"
+
+easy2d::RenderCommandList::RenderCommandList()
+{
+}
+
+void easy2d::RenderCommandList::Clear()
+{
+	commands_.clear();
+}
+
+void easy2d::RenderCommandList::SetTransform(const D2D1_MATRIX_3X2_F & matrix)
+{
+	RenderCommand command;
+	command.type = RenderCommand::Type::Transform;
+	command.transform = matrix;
+	commands_.push_back(command);
+}
+
+void easy2d::RenderCommandList::PushClip(const D2D1_RECT_F & rect)
+{
+	RenderCommand command;
+	command.type = RenderCommand::Type::PushClip;
+	command.clip = rect;
+	commands_.push_back(command);
+}
+
+void easy2d::RenderCommandList::PopClip()
+{
+	RenderCommand command;
+	command.type = RenderCommand::Type::PopClip;
+	commands_.push_back(command);
+}
+
+void easy2d::RenderCommandList::SetOpacity(float opacity)
+{
+	RenderCommand command;
+	command.type = RenderCommand::Type::Opacity;
+	command.opacity = opacity;
+	commands_.push_back(command);
+}
+
+void easy2d::RenderCommandList::DrawBitmap(
+	ID2D1Bitmap * bitmap,
+	const D2D1_RECT_F & dest,
+	const D2D1_RECT_F & src,
+	float opacity
+)
+{
+	RenderCommand command;
+	command.type = RenderCommand::Type::Bitmap;
+	command.bitmap.bitmap = bitmap;
+	command.bitmap.dest = dest;
+	command.bitmap.src = src;
+	command.bitmap.opacity = opacity;
+	commands_.push_back(command);
+}
+
+void easy2d::RenderCommandList::DrawTextLayout(
+	IDWriteTextLayout * layout,
+	const D2D1_COLOR_F & color,
+	BOOL outline,
+	const D2D1_COLOR_F & outline_color,
+	float outline_width,
+	D2D1_LINE_JOIN line_join
+)
+{
+	RenderCommand command;
+	command.type = RenderCommand::Type::Text;
+	command.text.layout = layout;
+	command.text.color = color;
+	command.text.outline = outline;
+	command.text.outline_color = outline_color;
+	command.text.outline_width = outline_width;
+	command.text.line_join = line_join;
+	commands_.push_back(command);
+}
+
+void easy2d::RenderCommandList::DrawGeometry(
+	ID2D1Geometry * geometry,
+	const D2D1_COLOR_F & color,
+	float stroke_width
+)
+{
+	RenderCommand command;
+	command.type = RenderCommand::Type::Geometry;
+	command.geometry.geometry = geometry;
+	command.geometry.color = color;
+	command.geometry.stroke_width = stroke_width;
+	commands_.push_back(command);
+}
+
+void easy2d::RenderCommandList::DrawSprites(
+	ID2D1Bitmap * bitmap,
+	const D2D1_RECT_F * dests,
+	const D2D1_RECT_F * srcs,
+	const D2D1_MATRIX_3X2_F * transforms,
+	const D2D1_COLOR_F * colors,
+	const float * opacities,
+	UINT32 count,
+	float opacity
+)
+{
+	RenderCommand command;
+	command.type = RenderCommand::Type::Sprites;
+	command.sprites.bitmap = bitmap;
+	command.sprites.dests = dests;
+	command.sprites.srcs = srcs;
+	command.sprites.transforms = transforms;
+	command.sprites.colors = colors;
+	command.sprites.opacities = opacities;
+	command.sprites.count = count;
+	command.sprites.opacity = opacity;
+	commands_.push_back(command);
+}
+
+void easy2d::RenderCommandList::DrawNode(const Node * node)
+{
+	RenderCommand command;
+	command.type = RenderCommand::Type::Custom;
+	command.node = node;
+	commands_.push_back(command);
+}
+
+void easy2d::RenderCommandList::Rewind(size_t count)
+{
+	if (count < commands_.size())
+	{
+		commands_.resize(count);
+	}
+}
+
+size_t easy2d::RenderCommandList::GetCount() const
+{
+	return commands_.size();
+}
+
+const std::vector<easy2d::RenderCommand>& easy2d::RenderCommandList::GetCommands() const
+{
+	return commands_;
+}
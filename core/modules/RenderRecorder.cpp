@@ -0,0 +1,100 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "../e2dmodule.h"
+
+easy2d::RenderRecorder::RenderRecorder()
+	: draw_call_count_(0)
+	, state_change_count_(0)
+{
+}
+
+void easy2d::RenderRecorder::Clear()
+{
+	draw_call_count_ = 0;
+	state_change_count_ = 0;
+	skipped_count_ = 0;
+	commands_.clear();
+}
+
+const std::vector<easy2d::RenderCommand>& easy2d::RenderRecorder::GetCommands() const
+{
+	return commands_;
+}
+
+int easy2d::RenderRecorder::GetDrawCallCount() const
+{
+	return draw_call_count_;
+}
+
+int easy2d::RenderRecorder::GetStateChangeCount() const
+{
+	return state_change_count_;
+}
+
+int easy2d::RenderRecorder::GetSkippedCount() const
+{
+	return skipped_count_;
+}
+
+void easy2d::RenderRecorder::ApplyTransform(const D2D1_MATRIX_3X2_F & matrix)
+{
+	RenderCommand command;
+	command.type = RenderCommand::Type::Transform;
+	command.transform = matrix;
+	commands_.push_back(command);
+	++state_change_count_;
+}
+
+void easy2d::RenderRecorder::ApplyOpacity(float opacity)
+{
+	RenderCommand command;
+	command.type = RenderCommand::Type::Opacity;
+	command.opacity = opacity;
+	commands_.push_back(command);
+	++state_change_count_;
+}
+
+void easy2d::RenderRecorder::ApplyColor(const D2D1_COLOR_F &)
+{
+	++state_change_count_;
+}
+
+void easy2d::RenderRecorder::PushClip(const D2D1_RECT_F & rect)
+{
+	RenderCommand command;
+	command.type = RenderCommand::Type::PushClip;
+	command.clip = rect;
+	commands_.push_back(command);
+}
+
+void easy2d::RenderRecorder::PopClip()
+{
+	RenderCommand command;
+	command.type = RenderCommand::Type::PopClip;
+	commands_.push_back(command);
+}
+
+void easy2d::RenderRecorder::Draw(const RenderCommand & command)
+{
+	commands_.push_back(command);
+	++draw_call_count_;
+}
@@ -0,0 +1,218 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "../e2dmodule.h"
+
+easy2d::ThreadPool::ThreadPool(size_t thread_count)
+	: quit_(false)
+	, thread_count_(thread_count)
+	, started_(false)
+	, next_(0)
+	, queued_(0)
+	, pending_(0)
+{
+	if (thread_count_ == 0)
+	{
+		// 主线程在等待时也会执行任务，因此少创建一个线程
+		size_t cores = static_cast<size_t>(std::thread::hardware_concurrency());
+		thread_count_ = cores > 1 ? cores - 1 : 1;
+	}
+
+#if !E2D_ATOMIC_REF_COUNT
+	thread_count_ = 0;
+#endif
+}
+
+easy2d::ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(wake_mutex_);
+		quit_ = true;
+	}
+	wake_.notify_all();
+
+	for (auto& thread : threads_)
+	{
+		thread.join();
+	}
+
+	for (auto worker : workers_)
+	{
+		delete worker;
+	}
+}
+
+void easy2d::ThreadPool::Submit(const Job& job)
+{
+#if !E2D_ATOMIC_REF_COUNT
+	// 任务中的 Retain 和 Release 不是线程安全的，直接在调用线程中执行
+	++pending_;
+	Job inline_job(job);
+	Run(inline_job);
+#else
+	// 不使用线程池的游戏不会创建任何工作线程
+	std::call_once(start_flag_, &ThreadPool::Start, this);
+
+	++pending_;
+
+	Worker * worker = workers_[next_++ % workers_.size()];
+	{
+		std::lock_guard<std::mutex> lock(worker->mutex);
+		worker->jobs.push_back(job);
+	}
+	++queued_;
+
+	// 先获取锁再通知，避免线程在检查条件和开始等待之间错过通知
+	{
+		std::lock_guard<std::mutex> lock(wake_mutex_);
+	}
+	wake_.notify_one();
+#endif
+}
+
+void easy2d::ThreadPool::Wait()
+{
+	while (pending_ > 0)
+	{
+		Job job;
+		if (Take(workers_.size(), job))
+		{
+			Run(job);
+		}
+		else
+		{
+			std::unique_lock<std::mutex> lock(done_mutex_);
+			done_.wait_for(lock, std::chrono::milliseconds(1), [this]() { return pending_ == 0; });
+		}
+	}
+
+	std::exception_ptr error;
+	{
+		std::lock_guard<std::mutex> lock(done_mutex_);
+		std::swap(error, error_);
+	}
+
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+}
+
+size_t easy2d::ThreadPool::GetThreadCount() const
+{
+	return thread_count_;
+}
+
+bool easy2d::ThreadPool::IsStarted() const
+{
+	return started_;
+}
+
+void easy2d::ThreadPool::Start()
+{
+	for (size_t i = 0; i < thread_count_; ++i)
+	{
+		workers_.push_back(new Worker());
+	}
+
+	for (size_t i = 0; i < thread_count_; ++i)
+	{
+		threads_.push_back(std::thread(&ThreadPool::WorkerMain, this, i));
+	}
+	started_ = true;
+}
+
+bool easy2d::ThreadPool::Take(size_t index, Job& job)
+{
+	if (queued_ == 0)
+		return false;
+
+	const size_t count = workers_.size();
+	if (index < count)
+	{
+		Worker * worker = workers_[index];
+		std::lock_guard<std::mutex> lock(worker->mutex);
+		if (!worker->jobs.empty())
+		{
+			job = std::move(worker->jobs.back());
+			worker->jobs.pop_back();
+			--queued_;
+			return true;
+		}
+	}
+
+	for (size_t i = 1; i <= count; ++i)
+	{
+		Worker * victim = workers_[(index + i) % count];
+		std::lock_guard<std::mutex> lock(victim->mutex);
+		if (!victim->jobs.empty())
+		{
+			job = std::move(victim->jobs.front());
+			victim->jobs.pop_front();
+			--queued_;
+			return true;
+		}
+	}
+	return false;
+}
+
+void easy2d::ThreadPool::Run(Job& job)
+{
+	try
+	{
+		job();
+	}
+	catch (...)
+	{
+		std::lock_guard<std::mutex> lock(done_mutex_);
+		if (!error_)
+		{
+			error_ = std::current_exception();
+		}
+	}
+
+	if (--pending_ == 0)
+	{
+		{
+			std::lock_guard<std::mutex> lock(done_mutex_);
+		}
+		done_.notify_all();
+	}
+}
+
+void easy2d::ThreadPool::WorkerMain(size_t index)
+{
+	for (;;)
+	{
+		Job job;
+		if (Take(index, job))
+		{
+			Run(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(wake_mutex_);
+		wake_.wait(lock, [this]() { return quit_ || queued_ > 0; });
+
+		if (quit_ && queued_ == 0)
+			return;
+	}
+}
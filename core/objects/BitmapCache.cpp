@@ -0,0 +1,118 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "../e2dobject.h"
+
+easy2d::BitmapCache::BitmapCache(size_t budget)
+	: bitmaps_()
+	, records_(budget)
+	, evicted_()
+{
+}
+
+void easy2d::BitmapCache::SetBudget(size_t bytes)
+{
+	records_.SetBudget(bytes);
+	Trim();
+}
+
+size_t easy2d::BitmapCache::GetBudget() const
+{
+	return records_.GetBudget();
+}
+
+const easy2d::BitmapCache::Stats & easy2d::BitmapCache::GetStats() const
+{
+	return records_.GetStats();
+}
+
+bool easy2d::BitmapCache::Contains(size_t key) const
+{
+	return records_.Contains(key);
+}
+
+bool easy2d::BitmapCache::Lookup(size_t key)
+{
+	return records_.Lookup(key);
+}
+
+void easy2d::BitmapCache::Add(size_t key, ID2D1Bitmap * bitmap)
+{
+	// 同一个键只保存一张位图，重复添加时释放新的位图
+	if (bitmaps_.find(key) != bitmaps_.end())
+	{
+		bitmap->Release();
+		return;
+	}
+
+	auto size = bitmap->GetPixelSize();
+	bitmaps_.insert(std::make_pair(key, bitmap));
+	records_.Add(key, static_cast<size_t>(size.width) * size.height * 4);
+}
+
+ID2D1Bitmap * easy2d::BitmapCache::Get(size_t key) const
+{
+	auto iter = bitmaps_.find(key);
+	return (iter == bitmaps_.end()) ? nullptr : iter->second;
+}
+
+ID2D1Bitmap * easy2d::BitmapCache::Acquire(size_t key)
+{
+	auto iter = bitmaps_.find(key);
+	if (iter == bitmaps_.end())
+		return nullptr;
+
+	records_.Retain(key);
+	return iter->second;
+}
+
+void easy2d::BitmapCache::Release(size_t key)
+{
+	if (records_.Release(key) == 0)
+	{
+		Trim();
+	}
+}
+
+void easy2d::BitmapCache::Trim()
+{
+	evicted_.clear();
+	records_.Trim(evicted_);
+
+	for (auto key : evicted_)
+	{
+		auto iter = bitmaps_.find(key);
+		if (iter != bitmaps_.end())
+		{
+			iter->second->Release();
+			bitmaps_.erase(iter);
+		}
+	}
+}
+
+void easy2d::BitmapCache::Clear()
+{
+	for (const auto& entry : bitmaps_)
+	{
+		entry.second->Release();
+	}
+	bitmaps_.clear();
+	records_.Clear();
+}
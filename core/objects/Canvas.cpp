@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dobject.h"
-#include "..\e2dmodule.h"
+#include "../e2dobject.h"
+#include "../e2dmodule.h"
 
 easy2d::Canvas::Canvas(float width, float height)
 	: render_target_(nullptr)
@@ -18,21 +18,64 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dobject.h"
-#include "..\e2dmodule.h"
-#include "..\e2dtool.h"
+#include "../e2dobject.h"
+#include "../e2dmodule.h"
+#include "../e2dtool.h"
 
-std::map<size_t, ID2D1Bitmap*> easy2d::Image::bitmap_cache_;
+easy2d::BitmapCache easy2d::Image::bitmap_cache_(256 * 1024 * 1024);
+std::map<size_t, easy2d::Image::Region> easy2d::Image::atlas_regions_;
+
+namespace
+{
+	// 解码完成、等待创建位图的图片
+	struct DecodedImage
+	{
+		size_t				key;
+		UINT				width;
+		UINT				height;
+		std::vector<BYTE>	pixels;
+		bool				succeeded;
+	};
+
+	std::deque<std::shared_ptr<DecodedImage>> upload_queue;
+	std::unordered_map<size_t, std::vector<easy2d::Function>> waiting_callbacks;
+	easy2d::AsyncQueue::Token decode_token;
+	easy2d::Duration upload_budget = easy2d::Duration::FromMicroseconds(4000);
+	ID2D1Bitmap * placeholder_bitmap = nullptr;
+
+	ID2D1Bitmap * CreateBitmapFromPixels(UINT width, UINT height, const std::vector<BYTE>& pixels)
+	{
+		ID2D1Bitmap * bitmap = nullptr;
+		easy2d::Device::GetGraphics()->GetRenderTarget()->CreateBitmap(
+			D2D1::SizeU(width, height),
+			pixels.empty() ? nullptr : &pixels[0],
+			width * 4,
+			D2D1::BitmapProperties(
+				D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)
+			),
+			&bitmap
+		);
+		return bitmap;
+	}
+}
 
 easy2d::Image::Image()
 	: bitmap_(nullptr)
 	, crop_rect_()
+	, source_rect_()
+	, loading_key_(0)
+	, cache_key_(0)
+	, cache_referenced_(false)
 {
 }
 
 easy2d::Image::Image(const Resource& res)
 	: bitmap_(nullptr)
 	, crop_rect_()
+	, source_rect_()
+	, loading_key_(0)
+	, cache_key_(0)
+	, cache_referenced_(false)
 {
 	this->Load(res);
 }
@@ -40,6 +83,10 @@ easy2d::Image::Image(const Resource& res)
 easy2d::Image::Image(const Resource& res, const Rect& crop_rect)
 	: bitmap_(nullptr)
 	, crop_rect_()
+	, source_rect_()
+	, loading_key_(0)
+	, cache_key_(0)
+	, cache_referenced_(false)
 {
 	this->Load(res);
 	this->Crop(crop_rect);
@@ -48,6 +95,10 @@ easy2d::Image::Image(const Resource& res, const Rect& crop_rect)
 easy2d::Image::Image(const String & file_name)
 	: bitmap_(nullptr)
 	, crop_rect_()
+	, source_rect_()
+	, loading_key_(0)
+	, cache_key_(0)
+	, cache_referenced_(false)
 {
 	this->Load(file_name);
 }
@@ -55,6 +106,10 @@ easy2d::Image::Image(const String & file_name)
 easy2d::Image::Image(const String & file_name, const Rect & crop_rect)
 	: bitmap_(nullptr)
 	, crop_rect_()
+	, source_rect_()
+	, loading_key_(0)
+	, cache_key_(0)
+	, cache_referenced_(false)
 {
 	this->Load(file_name);
 	this->Crop(crop_rect);
@@ -62,18 +117,29 @@ easy2d::Image::Image(const String & file_name, const Rect & crop_rect)
 
 easy2d::Image::~Image()
 {
+	ReleaseCached();
 	SafeRelease(bitmap_);
 }
 
 bool easy2d::Image::Load(const Resource& res)
 {
+	loading_key_ = 0;
+
+	// 已经合并到图集中的图片只引用图集页面中的区域
+	auto iter = atlas_regions_.find(res.id);
+	if (iter != atlas_regions_.end())
+	{
+		this->SetBitmap(iter->second.bitmap, iter->second.rect);
+		return true;
+	}
+
 	if (!Image::CacheBitmap(res))
 	{
 		E2D_WARNING("Load Image from file failed!");
 		return false;
 	}
 
-	this->SetBitmap(bitmap_cache_.at(res.id));
+	this->UseCached(res.id);
 	return true;
 }
 
@@ -84,25 +150,90 @@ bool easy2d::Image::Load(const String & file_name)
 	if (file_name.IsEmpty())
 		return false;
 
+	loading_key_ = 0;
+
+	auto iter = atlas_regions_.find(file_name.GetHash());
+	if (iter != atlas_regions_.end())
+	{
+		this->SetBitmap(iter->second.bitmap, iter->second.rect);
+		return true;
+	}
+
 	if (!Image::CacheBitmap(file_name))
 	{
 		E2D_WARNING("Load Image from file failed!");
 		return false;
 	}
 
-	this->SetBitmap(bitmap_cache_.at(file_name.GetHash()));
+	this->UseCached(file_name.GetHash());
 	return true;
 }
 
+void easy2d::Image::LoadAsync(const String & file_name, const Function & on_loaded)
+{
+	E2D_WARNING_IF(file_name.IsEmpty(), "Image LoadAsync failed! Invalid file name.");
+
+	if (file_name.IsEmpty())
+		return;
+
+	// 图集中的图片和不能异步加载时直接加载
+	const size_t key = file_name.GetHash();
+	if (!Device::GetAsyncQueue() ||
+		atlas_regions_.find(key) != atlas_regions_.end())
+	{
+		Load(file_name);
+		if (on_loaded)
+		{
+			on_loaded();
+		}
+		return;
+	}
+
+	// 已经缓存的图片直接使用，查找计入缓存统计
+	if (bitmap_cache_.Lookup(key))
+	{
+		loading_key_ = 0;
+		UseCached(key);
+		if (on_loaded)
+		{
+			on_loaded();
+		}
+		return;
+	}
+
+	SetBitmap(GetPlaceholder());
+	loading_key_ = key;
+
+	// 加载完成前保持图片不被释放
+	Retain();
+	Image * image = this;
+	RequestDecode(file_name, [=]()
+	{
+		// 加载期间可能又加载了其他图片
+		if (image->loading_key_ == key)
+		{
+			image->loading_key_ = 0;
+
+			image->UseCached(key);
+		}
+
+		if (on_loaded)
+		{
+			on_loaded();
+		}
+		image->Release();
+	});
+}
+
 void easy2d::Image::Crop(const Rect& crop_rect)
 {
 	if (bitmap_)
 	{
-		auto bitmap_size = bitmap_->GetSize();
-		crop_rect_.origin.x = std::min(std::max(crop_rect.origin.x, 0.f), bitmap_size.width);
-		crop_rect_.origin.y = std::min(std::max(crop_rect.origin.y, 0.f), bitmap_size.height);
-		crop_rect_.size.width = std::min(std::max(crop_rect.size.width, 0.f), bitmap_size.width - crop_rect.origin.x);
-		crop_rect_.size.height = std::min(std::max(crop_rect.size.height, 0.f), bitmap_size.height - crop_rect.origin.y);
+		const auto& source_size = source_rect_.size;
+		crop_rect_.origin.x = std::min(std::max(crop_rect.origin.x, 0.f), source_size.width);
+		crop_rect_.origin.y = std::min(std::max(crop_rect.origin.y, 0.f), source_size.height);
+		crop_rect_.size.width = std::min(std::max(crop_rect.size.width, 0.f), source_size.width - crop_rect.origin.x);
+		crop_rect_.size.height = std::min(std::max(crop_rect.size.height, 0.f), source_size.height - crop_rect.origin.y);
 	}
 }
 
@@ -123,38 +254,17 @@ easy2d::Size easy2d::Image::GetSize() const
 
 float easy2d::Image::GetSourceWidth() const
 {
-	if (bitmap_)
-	{
-		return bitmap_->GetSize().width;
-	}
-	else
-	{
-		return 0;
-	}
+	return source_rect_.size.width;
 }
 
 float easy2d::Image::GetSourceHeight() const
 {
-	if (bitmap_)
-	{
-		return bitmap_->GetSize().height;
-	}
-	else
-	{
-		return 0;
-	}
+	return source_rect_.size.height;
 }
 
 easy2d::Size easy2d::Image::GetSourceSize() const
 {
-	Size source_size;
-	if (bitmap_)
-	{
-		auto bitmap_size = bitmap_->GetSize();
-		source_size.width = bitmap_size.width;
-		source_size.height = bitmap_size.height;
-	}
-	return std::move(source_size);
+	return source_rect_.size;
 }
 
 float easy2d::Image::GetCropX() const
@@ -177,6 +287,16 @@ const easy2d::Rect & easy2d::Image::GetCropRect() const
 	return crop_rect_;
 }
 
+easy2d::Rect easy2d::Image::GetBitmapRect() const
+{
+	return Rect(
+		source_rect_.origin.x + crop_rect_.origin.x,
+		source_rect_.origin.y + crop_rect_.origin.y,
+		crop_rect_.size.width,
+		crop_rect_.size.height
+	);
+}
+
 ID2D1Bitmap * easy2d::Image::GetBitmap() const
 {
 	return bitmap_;
@@ -184,10 +304,8 @@ ID2D1Bitmap * easy2d::Image::GetBitmap() const
 
 bool easy2d::Image::CacheBitmap(const Resource& res)
 {
-	if (bitmap_cache_.find(res.id) != bitmap_cache_.end())
-	{
+	if (bitmap_cache_.Lookup(res.id))
 		return true;
-	}
 
 	IWICImagingFactory *imaging_factory = Device::GetGraphics()->GetImagingFactory();
 	ID2D1HwndRenderTarget* render_target = Device::GetGraphics()->GetRenderTarget();
@@ -201,7 +319,7 @@ bool easy2d::Image::CacheBitmap(const Resource& res)
 	void *image_file = nullptr;
 	DWORD image_file_size = 0;
 
-	// λԴ
+	// 定位资源
 	res_handle = ::FindResourceW(
 		HINST_THISCOMPONENT,
 		MAKEINTRESOURCE(res.id),
@@ -211,7 +329,7 @@ bool easy2d::Image::CacheBitmap(const Resource& res)
 	HRESULT hr = res_handle ? S_OK : E_FAIL;
 	if (SUCCEEDED(hr))
 	{
-		// Դ
+		// 加载资源
 		res_data_handle = ::LoadResource(HINST_THISCOMPONENT, res_handle);
 
 		hr = res_data_handle ? S_OK : E_FAIL;
@@ -219,7 +337,7 @@ bool easy2d::Image::CacheBitmap(const Resource& res)
 
 	if (SUCCEEDED(hr))
 	{
-		// ȡļָ룬Դ
+		// 获取文件指针，并锁定资源
 		image_file = ::LockResource(res_data_handle);
 
 		hr = image_file ? S_OK : E_FAIL;
@@ -227,7 +345,7 @@ bool easy2d::Image::CacheBitmap(const Resource& res)
 
 	if (SUCCEEDED(hr))
 	{
-		// С
+		// 计算大小
 		image_file_size = ::SizeofResource(HINST_THISCOMPONENT, res_handle);
 
 		hr = image_file_size ? S_OK : E_FAIL;
@@ -235,13 +353,13 @@ bool easy2d::Image::CacheBitmap(const Resource& res)
 
 	if (SUCCEEDED(hr))
 	{
-		//  WIC 
+		// 创建 WIC 流
 		hr = imaging_factory->CreateStream(&stream);
 	}
 
 	if (SUCCEEDED(hr))
 	{
-		// ʼ
+		// 初始化流
 		hr = stream->InitializeFromMemory(
 			reinterpret_cast<BYTE*>(image_file),
 			image_file_size
@@ -250,7 +368,7 @@ bool easy2d::Image::CacheBitmap(const Resource& res)
 
 	if (SUCCEEDED(hr))
 	{
-		// Ľ
+		// 创建流的解码器
 		hr = imaging_factory->CreateDecoderFromStream(
 			stream,
 			nullptr,
@@ -261,19 +379,19 @@ bool easy2d::Image::CacheBitmap(const Resource& res)
 
 	if (SUCCEEDED(hr))
 	{
-		// ʼ
+		// 创建初始化框架
 		hr = decoder->GetFrame(0, &source);
 	}
 
 	if (SUCCEEDED(hr))
 	{
-		// ͼƬʽת
+		// 创建图片格式转换器
 		hr = imaging_factory->CreateFormatConverter(&converter);
 	}
 
 	if (SUCCEEDED(hr))
 	{
-		// ͼƬʽת 32bppPBGRA
+		// 图片格式转换成 32bppPBGRA
 		hr = converter->Initialize(
 			source,
 			GUID_WICPixelFormat32bppPBGRA,
@@ -286,7 +404,7 @@ bool easy2d::Image::CacheBitmap(const Resource& res)
 
 	if (SUCCEEDED(hr))
 	{
-		//  WIC λͼһ Direct2D λͼ
+		// 从 WIC 位图创建一个 Direct2D 位图
 		hr = render_target->CreateBitmapFromWicBitmap(
 			converter,
 			nullptr,
@@ -296,10 +414,10 @@ bool easy2d::Image::CacheBitmap(const Resource& res)
 
 	if (SUCCEEDED(hr))
 	{
-		bitmap_cache_.insert(std::make_pair(res.id, bitmap));
+		bitmap_cache_.Add(res.id, bitmap);
 	}
 
-	// ͷԴ
+	// 释放相关资源
 	SafeRelease(decoder);
 	SafeRelease(source);
 	SafeRelease(stream);
@@ -311,15 +429,15 @@ bool easy2d::Image::CacheBitmap(const Resource& res)
 bool easy2d::Image::CacheBitmap(const String & file_name)
 {
 	size_t hash = file_name.GetHash();
-	if (bitmap_cache_.find(hash) != bitmap_cache_.end())
+	if (bitmap_cache_.Lookup(hash))
 		return true;
 
 	File image_file;
 	if (!image_file.Open(file_name))
 		return false;
 
-	// û·һ·Ϊûͨ File::AddSearchPath 
-	// Ĭ·Ҫͨ File::GetPath ȡ·
+	// 用户输入的路径不一定是完整路径，因为用户可能通过 File::AddSearchPath 添加
+	// 默认搜索路径，所以需要通过 File::GetPath 获取完整路径
 	String image_file_path = image_file.GetPath();
 
 	Graphics * graphics_device = Device::GetGraphics();
@@ -331,7 +449,7 @@ bool easy2d::Image::CacheBitmap(const String & file_name)
 	IWICFormatConverter *converter = nullptr;
 	ID2D1Bitmap *bitmap = nullptr;
 
-	// 
+	// 创建解码器
 	HRESULT hr = imaging_factory->CreateDecoderFromFilename(
 		(LPCWSTR)image_file_path,
 		nullptr,
@@ -342,19 +460,19 @@ bool easy2d::Image::CacheBitmap(const String & file_name)
 
 	if (SUCCEEDED(hr))
 	{
-		// ʼ
+		// 创建初始化框架
 		hr = decoder->GetFrame(0, &source);
 	}
 
 	if (SUCCEEDED(hr))
 	{
-		// ͼƬʽת
+		// 创建图片格式转换器
 		hr = imaging_factory->CreateFormatConverter(&converter);
 	}
 
 	if (SUCCEEDED(hr))
 	{
-		// ͼƬʽת 32bppPBGRA
+		// 图片格式转换成 32bppPBGRA
 		hr = converter->Initialize(
 			source,
 			GUID_WICPixelFormat32bppPBGRA,
@@ -367,7 +485,7 @@ bool easy2d::Image::CacheBitmap(const String & file_name)
 
 	if (SUCCEEDED(hr))
 	{
-		//  WIC λͼһ Direct2D λͼ
+		// 从 WIC 位图创建一个 Direct2D 位图
 		hr = render_target->CreateBitmapFromWicBitmap(
 			converter,
 			nullptr,
@@ -377,10 +495,10 @@ bool easy2d::Image::CacheBitmap(const String & file_name)
 
 	if (SUCCEEDED(hr))
 	{
-		bitmap_cache_.insert(std::make_pair(hash, bitmap));
+		bitmap_cache_.Add(hash, bitmap);
 	}
 
-	// ͷԴ
+	// 释放相关资源
 	SafeRelease(decoder);
 	SafeRelease(source);
 	SafeRelease(stream);
@@ -391,33 +509,404 @@ bool easy2d::Image::CacheBitmap(const String & file_name)
 
 void easy2d::Image::ClearCache()
 {
-	if (bitmap_cache_.empty())
+	bitmap_cache_.Clear();
+
+	for (const auto& region : atlas_regions_)
+	{
+		region.second.bitmap->Release();
+	}
+	atlas_regions_.clear();
+	SafeRelease(placeholder_bitmap);
+}
+
+void easy2d::Image::SetCacheBudget(size_t bytes)
+{
+	bitmap_cache_.SetBudget(bytes);
+}
+
+size_t easy2d::Image::GetCacheBudget()
+{
+	return bitmap_cache_.GetBudget();
+}
+
+easy2d::Image::CacheStats easy2d::Image::GetCacheStats()
+{
+	return bitmap_cache_.GetStats();
+}
+
+bool easy2d::Image::UseCached(size_t key)
+{
+	// 先增加引用，设置位图时释放旧的引用不会淘汰这张位图
+	ID2D1Bitmap * bitmap = bitmap_cache_.Acquire(key);
+	if (!bitmap)
+		return false;
+
+	SetBitmap(bitmap);
+	cache_key_ = key;
+	cache_referenced_ = true;
+
+	bitmap_cache_.Trim();
+	return true;
+}
+
+void easy2d::Image::ReleaseCached()
+{
+	if (!cache_referenced_)
+		return;
+
+	cache_referenced_ = false;
+
+	bitmap_cache_.Release(cache_key_);
+}
+
+void easy2d::Image::Preload(const std::vector<String>& file_names, const Function & on_complete)
+{
+	// 计数只在主线程中修改，多计一次防止在提交过程中提前完成
+	auto remaining = std::make_shared<size_t>(file_names.size() + 1);
+	auto pinned = std::make_shared<std::vector<size_t>>();
+	Function count_down = [=]()
+	{
+		if (--(*remaining) > 0)
+			return;
+
+		if (on_complete)
+		{
+			on_complete();
+		}
+
+		// 回调中加载的图片已经被引用，之后才允许淘汰预加载的位图
+		for (auto key : *pinned)
+		{
+			bitmap_cache_.Release(key);
+		}
+	};
+
+	// 加载完成的图片在整批完成前保持引用，其他图片的加载不会淘汰它
+	auto pin = [=](size_t key)
+	{
+		if (bitmap_cache_.Acquire(key))
+		{
+			pinned->push_back(key);
+		}
+	};
+
+	for (const auto& file_name : file_names)
+	{
+		const size_t key = file_name.GetHash();
+		if (file_name.IsEmpty() ||
+			atlas_regions_.find(key) != atlas_regions_.end())
+		{
+			count_down();
+		}
+		else if (!Device::GetAsyncQueue())
+		{
+			CacheBitmap(file_name);
+			pin(key);
+			count_down();
+		}
+		else if (bitmap_cache_.Lookup(key))
+		{
+			pin(key);
+			count_down();
+		}
+		else
+		{
+			RequestDecode(file_name, [=]()
+			{
+				pin(key);
+				count_down();
+			});
+		}
+	}
+	count_down();
+}
+
+void easy2d::Image::SetUploadBudget(const Duration & budget)
+{
+	upload_budget = budget;
+}
+
+void easy2d::Image::UploadPending()
+{
+	if (upload_queue.empty())
 		return;
 
-	for (const auto& bitmap : bitmap_cache_)
+	// 至少处理一张图片，避免预算过小时永远无法完成
+	const Time start = Time::Now();
+	while (!upload_queue.empty())
 	{
-		bitmap.second->Release();
+		auto image = upload_queue.front();
+		upload_queue.pop_front();
+
+		E2D_WARNING_IF(!image->succeeded, "Load Image asynchronously failed!");
+
+		if (image->succeeded &&
+			!image->pixels.empty() &&
+			!bitmap_cache_.Contains(image->key))
+		{
+			ID2D1Bitmap * bitmap = CreateBitmapFromPixels(image->width, image->height, image->pixels);
+			if (bitmap)
+			{
+				bitmap_cache_.Add(image->key, bitmap);
+			}
+		}
+
+		// 回调中可能再次请求加载同一张图片，先取出等待列表
+		auto iter = waiting_callbacks.find(image->key);
+		if (iter != waiting_callbacks.end())
+		{
+			auto callbacks = std::move(iter->second);
+			waiting_callbacks.erase(iter);
+
+			for (const auto& callback : callbacks)
+			{
+				if (callback)
+				{
+					callback();
+				}
+			}
+		}
+
+		if (Time::Now() - start >= upload_budget)
+			break;
 	}
-	bitmap_cache_.clear();
+
+	// 等待中的图片和预加载的图片已经引用了各自的位图
+	bitmap_cache_.Trim();
 }
 
-void easy2d::Image::SetBitmap(ID2D1Bitmap * bitmap)
+size_t easy2d::Image::GetLoadingCount()
+{
+	return waiting_callbacks.size();
+}
+
+void easy2d::Image::RequestDecode(const String & file_name, const Function & on_ready)
 {
-	if (bitmap_ == bitmap)
+	// 同一张图片只解码一次
+	const size_t key = file_name.GetHash();
+	auto iter = waiting_callbacks.find(key);
+	if (iter != waiting_callbacks.end())
+	{
+		iter->second.push_back(on_ready);
 		return;
+	}
+	waiting_callbacks[key].push_back(on_ready);
 
-	if (bitmap_)
+	// 搜索路径只在主线程中访问
+	File image_file;
+	String file_path = image_file.Open(file_name) ? image_file.GetPath() : String();
+
+	auto image = std::make_shared<DecodedImage>();
+	image->key = key;
+	image->width = 0;
+	image->height = 0;
+	image->succeeded = false;
+
+	if (!decode_token)
+	{
+		decode_token = std::make_shared<std::atomic<bool>>(false);
+	}
+
+	Device::GetAsyncQueue()->Submit(
+		[=]()
+		{
+			image->succeeded = !file_path.IsEmpty() &&
+				SUCCEEDED(DecodeFile(file_path, &image->width, &image->height, image->pixels));
+		},
+		[=]()
+		{
+			upload_queue.push_back(image);
+		},
+		decode_token
+	);
+}
+
+ID2D1Bitmap * easy2d::Image::GetPlaceholder()
+{
+	if (!placeholder_bitmap)
+	{
+		placeholder_bitmap = CreateBitmapFromPixels(1, 1, std::vector<BYTE>(4, 0));
+	}
+	return placeholder_bitmap;
+}
+
+IWICImagingFactory * easy2d::Image::AcquireImagingFactory()
+{
+	IWICImagingFactory * factory = nullptr;
+	auto graphics = Device::GetGraphics();
+	if (graphics)
+	{
+		factory = graphics->GetImagingFactory();
+		factory->AddRef();
+	}
+	else
+	{
+		CoCreateInstance(
+			CLSID_WICImagingFactory,
+			nullptr,
+			CLSCTX_INPROC_SERVER,
+			IID_IWICImagingFactory,
+			reinterpret_cast<void**>(&factory)
+		);
+	}
+	return factory;
+}
+
+HRESULT easy2d::Image::DecodePixels(
+	IWICImagingFactory * factory,
+	IWICBitmapDecoder * decoder,
+	UINT * width,
+	UINT * height,
+	std::vector<BYTE>& pixels
+)
+{
+	IWICBitmapFrameDecode *source = nullptr;
+	IWICFormatConverter *converter = nullptr;
+
+	HRESULT hr = decoder->GetFrame(0, &source);
+
+	if (SUCCEEDED(hr))
 	{
-		bitmap_->Release();
+		hr = factory->CreateFormatConverter(&converter);
 	}
 
+	if (SUCCEEDED(hr))
+	{
+		hr = converter->Initialize(
+			source,
+			GUID_WICPixelFormat32bppPBGRA,
+			WICBitmapDitherTypeNone,
+			nullptr,
+			0.f,
+			WICBitmapPaletteTypeMedianCut
+		);
+	}
+
+	if (SUCCEEDED(hr))
+	{
+		hr = converter->GetSize(width, height);
+	}
+
+	if (SUCCEEDED(hr))
+	{
+		pixels.resize(static_cast<size_t>(*width) * (*height) * 4);
+		hr = converter->CopyPixels(
+			nullptr,
+			(*width) * 4,
+			static_cast<UINT>(pixels.size()),
+			pixels.empty() ? nullptr : &pixels[0]
+		);
+	}
+
+	SafeRelease(source);
+	SafeRelease(converter);
+	return hr;
+}
+
+HRESULT easy2d::Image::DecodeFile(
+	const String & file_path,
+	UINT * width,
+	UINT * height,
+	std::vector<BYTE>& pixels
+)
+{
+	return ImageDecoder::GetCurrent()->DecodeFile(file_path, width, height, pixels) ? S_OK : E_FAIL;
+}
+
+bool easy2d::WicImageDecoder::Decode(
+	const BYTE * data,
+	size_t size,
+	UINT * width,
+	UINT * height,
+	std::vector<BYTE>& pixels
+)
+{
+	// 工作线程第一次解码时初始化 COM，之后一直保持到线程退出
+	// 主线程中已经初始化为单线程套间，会返回 RPC_E_CHANGED_MODE，不影响使用
+	static E2D_THREAD_LOCAL bool com_initialized = false;
+	if (!com_initialized)
+	{
+		::CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+		com_initialized = true;
+	}
+
+	IWICImagingFactory *factory = Image::AcquireImagingFactory();
+	IWICStream *stream = nullptr;
+	IWICBitmapDecoder *decoder = nullptr;
+
+	HRESULT hr = (factory && data && size) ? S_OK : E_FAIL;
+	if (SUCCEEDED(hr))
+	{
+		hr = factory->CreateStream(&stream);
+	}
+
+	if (SUCCEEDED(hr))
+	{
+		hr = stream->InitializeFromMemory(
+			const_cast<BYTE*>(data),
+			static_cast<DWORD>(size)
+		);
+	}
+
+	if (SUCCEEDED(hr))
+	{
+		hr = factory->CreateDecoderFromStream(
+			stream,
+			nullptr,
+			WICDecodeMetadataCacheOnLoad,
+			&decoder
+		);
+	}
+
+	if (SUCCEEDED(hr))
+	{
+		hr = Image::DecodePixels(factory, decoder, width, height, pixels);
+	}
+
+	SafeRelease(decoder);
+	SafeRelease(stream);
+	SafeRelease(factory);
+	return SUCCEEDED(hr);
+}
+
+void easy2d::Image::AddRegion(size_t key, ID2D1Bitmap * bitmap, const Rect & rect)
+{
+	bitmap->AddRef();
+
+	auto iter = atlas_regions_.find(key);
+	if (iter != atlas_regions_.end())
+	{
+		iter->second.bitmap->Release();
+		iter->second.bitmap = bitmap;
+		iter->second.rect = rect;
+	}
+	else
+	{
+		Region region = { bitmap, rect };
+		atlas_regions_.insert(std::make_pair(key, region));
+	}
+}
+
+void easy2d::Image::SetBitmap(ID2D1Bitmap * bitmap)
+{
 	if (bitmap)
 	{
-		bitmap->AddRef();
+		auto bitmap_size = bitmap->GetSize();
+		SetBitmap(bitmap, Rect(0, 0, bitmap_size.width, bitmap_size.height));
+	}
+}
 
-		bitmap_ = bitmap;
-		crop_rect_.origin.x = crop_rect_.origin.y = 0;
-		crop_rect_.size.width = bitmap_->GetSize().width;
-		crop_rect_.size.height = bitmap_->GetSize().height;
+void easy2d::Image::SetBitmap(ID2D1Bitmap * bitmap, const Rect & source_rect)
+{
+	ReleaseCached();
+
+	if (bitmap)
+	{
+		bitmap->AddRef();
 	}
+
+	SafeRelease(bitmap_);
+	bitmap_ = bitmap;
+	source_rect_ = bitmap_ ? source_rect : Rect();
+	crop_rect_ = Rect(Point(), source_rect_.size);
 }
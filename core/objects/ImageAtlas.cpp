@@ -0,0 +1,741 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "../e2dobject.h"
+#include "../e2dmodule.h"
+#include "../e2dtool.h"
+
+namespace
+{
+	// 天际线装箱，每次把矩形放到顶边最低的位置
+	class SkylinePacker
+	{
+	public:
+		SkylinePacker(int width, int height)
+			: width_(width)
+			, height_(height)
+			, used_width_(0)
+			, used_height_(0)
+		{
+			Segment segment = { 0, 0, width };
+			skyline_.push_back(segment);
+		}
+
+		bool Insert(int width, int height, int* out_x, int* out_y)
+		{
+			// 正好填满页面的矩形也要能放入
+			int best_index = -1;
+			int best_top = std::numeric_limits<int>::max();
+			int best_width = std::numeric_limits<int>::max();
+			for (size_t i = 0; i < skyline_.size(); ++i)
+			{
+				int y = Fit(i, width, height);
+				if (y < 0)
+					continue;
+
+				if (y + height < best_top ||
+					(y + height == best_top && skyline_[i].width < best_width))
+				{
+					best_index = static_cast<int>(i);
+					best_top = y + height;
+					best_width = skyline_[i].width;
+				}
+			}
+
+			if (best_index < 0)
+				return false;
+
+			*out_x = skyline_[best_index].x;
+			*out_y = best_top - height;
+			AddSegment(best_index, *out_x, best_top, width);
+
+			used_width_ = std::max(used_width_, *out_x + width);
+			used_height_ = std::max(used_height_, best_top);
+			return true;
+		}
+
+		int GetUsedWidth() const { return used_width_; }
+
+		int GetUsedHeight() const { return used_height_; }
+
+	private:
+		struct Segment
+		{
+			int x;
+			int y;
+			int width;
+		};
+
+		// 返回矩形左边对齐第 index 段时的顶边位置，放不下时返回 -1
+		int Fit(size_t index, int width, int height) const
+		{
+			int x = skyline_[index].x;
+			if (x + width > width_)
+				return -1;
+
+			int y = skyline_[index].y;
+			int width_left = width;
+			while (width_left > 0)
+			{
+				y = std::max(y, skyline_[index].y);
+				if (y + height > height_)
+					return -1;
+
+				width_left -= skyline_[index].width;
+				++index;
+			}
+			return y;
+		}
+
+		void AddSegment(int index, int x, int y, int width)
+		{
+			Segment segment = { x, y, width };
+			skyline_.insert(skyline_.begin() + index, segment);
+
+			// 新的一段覆盖了后面的段
+			for (size_t i = index + 1; i < skyline_.size();)
+			{
+				const auto& prev = skyline_[i - 1];
+				int shrink = prev.x + prev.width - skyline_[i].x;
+				if (shrink <= 0)
+					break;
+
+				skyline_[i].x += shrink;
+				skyline_[i].width -= shrink;
+				if (skyline_[i].width > 0)
+					break;
+
+				skyline_.erase(skyline_.begin() + i);
+			}
+
+			// 合并高度相同的相邻段
+			for (size_t i = 0; i + 1 < skyline_.size();)
+			{
+				if (skyline_[i].y == skyline_[i + 1].y)
+				{
+					skyline_[i].width += skyline_[i + 1].width;
+					skyline_.erase(skyline_.begin() + i + 1);
+				}
+				else
+				{
+					++i;
+				}
+			}
+		}
+
+	private:
+		int width_;
+		int height_;
+		int used_width_;
+		int used_height_;
+		std::vector<Segment> skyline_;
+	};
+
+#if !E2D_HEADLESS
+	// 保存为 PNG 文件，PNG 不支持预乘透明度，需要先还原颜色
+	HRESULT SavePng(
+		IWICImagingFactory * factory,
+		const wchar_t * file_path,
+		UINT width,
+		UINT height,
+		const std::vector<BYTE>& pixels
+	)
+	{
+		std::vector<BYTE> straight(pixels);
+		for (size_t i = 0; i + 3 < straight.size(); i += 4)
+		{
+			BYTE alpha = straight[i + 3];
+			if (alpha != 0 && alpha != 255)
+			{
+				for (size_t c = 0; c < 3; ++c)
+				{
+					straight[i + c] = static_cast<BYTE>(std::min(straight[i + c] * 255 / alpha, 255));
+				}
+			}
+		}
+
+		IWICStream *stream = nullptr;
+		IWICBitmapEncoder *encoder = nullptr;
+		IWICBitmapFrameEncode *frame = nullptr;
+		WICPixelFormatGUID format = GUID_WICPixelFormat32bppBGRA;
+
+		HRESULT hr = factory->CreateStream(&stream);
+
+		if (SUCCEEDED(hr))
+		{
+			hr = stream->InitializeFromFilename(file_path, GENERIC_WRITE);
+		}
+
+		if (SUCCEEDED(hr))
+		{
+			hr = factory->CreateEncoder(GUID_ContainerFormatPng, nullptr, &encoder);
+		}
+
+		if (SUCCEEDED(hr))
+		{
+			hr = encoder->Initialize(stream, WICBitmapEncoderNoCache);
+		}
+
+		if (SUCCEEDED(hr))
+		{
+			hr = encoder->CreateNewFrame(&frame, nullptr);
+		}
+
+		if (SUCCEEDED(hr))
+		{
+			hr = frame->Initialize(nullptr);
+		}
+
+		if (SUCCEEDED(hr))
+		{
+			hr = frame->SetSize(width, height);
+		}
+
+		if (SUCCEEDED(hr))
+		{
+			hr = frame->SetPixelFormat(&format);
+		}
+
+		if (SUCCEEDED(hr))
+		{
+			hr = IsEqualGUID(format, GUID_WICPixelFormat32bppBGRA) ? S_OK : E_FAIL;
+		}
+
+		if (SUCCEEDED(hr))
+		{
+			hr = frame->WritePixels(
+				height,
+				width * 4,
+				static_cast<UINT>(straight.size()),
+				straight.empty() ? nullptr : &straight[0]
+			);
+		}
+
+		if (SUCCEEDED(hr))
+		{
+			hr = frame->Commit();
+		}
+
+		if (SUCCEEDED(hr))
+		{
+			hr = encoder->Commit();
+		}
+
+		SafeRelease(frame);
+		SafeRelease(encoder);
+		SafeRelease(stream);
+		return hr;
+	}
+
+	// 获取文件所在的目录，包含末尾的分隔符
+	std::wstring GetDirectory(const std::wstring& path)
+	{
+		size_t pos = path.find_last_of(L"\\/");
+		return (pos == std::wstring::npos) ? std::wstring() : path.substr(0, pos + 1);
+	}
+#endif
+}
+
+easy2d::ImageAtlas::ImageAtlas(int page_width, int page_height, int padding, int extrude)
+	: page_width_(page_width)
+	, page_height_(page_height)
+	, padding_(std::max(padding, 0))
+	, extrude_(std::max(extrude, 0))
+{
+}
+
+easy2d::ImageAtlas::~ImageAtlas()
+{
+	for (auto& page : pages_)
+	{
+		SafeRelease(page.bitmap);
+	}
+}
+
+bool easy2d::ImageAtlas::Add(const String & file_name)
+{
+	E2D_WARNING_IF(file_name.IsEmpty(), "ImageAtlas Add failed! Invalid file name.");
+
+	if (file_name.IsEmpty())
+		return false;
+
+	String file_path = file_name;
+#if !E2D_HEADLESS
+	File image_file;
+	if (!image_file.Open(file_name))
+		return false;
+
+	file_path = image_file.GetPath();
+#endif
+
+	Source source;
+	source.key = file_name.GetHash();
+	source.name = file_name;
+
+	if (!ImageDecoder::GetCurrent()->DecodeFile(file_path, &source.width, &source.height, source.pixels))
+		return false;
+
+	sources_.push_back(std::move(source));
+	return true;
+}
+
+bool easy2d::ImageAtlas::Add(const Resource & res)
+{
+#if E2D_HEADLESS
+	// 没有系统组件时无法读取图片资源
+	E2D_WARNING("ImageAtlas Add failed! Resources are not supported.");
+	return false;
+#else
+	IWICImagingFactory *factory = Image::AcquireImagingFactory();
+	IWICBitmapDecoder *decoder = nullptr;
+	IWICStream *stream = nullptr;
+	HRSRC res_handle = nullptr;
+	HGLOBAL res_data_handle = nullptr;
+	void *image_file = nullptr;
+	DWORD image_file_size = 0;
+	Source source;
+	source.key = res.id;
+
+	HRESULT hr = factory ? S_OK : E_FAIL;
+	if (SUCCEEDED(hr))
+	{
+		res_handle = ::FindResourceW(
+			HINST_THISCOMPONENT,
+			MAKEINTRESOURCE(res.id),
+			(LPCWSTR)res.type
+		);
+
+		hr = res_handle ? S_OK : E_FAIL;
+	}
+
+	if (SUCCEEDED(hr))
+	{
+		res_data_handle = ::LoadResource(HINST_THISCOMPONENT, res_handle);
+
+		hr = res_data_handle ? S_OK : E_FAIL;
+	}
+
+	if (SUCCEEDED(hr))
+	{
+		image_file = ::LockResource(res_data_handle);
+		image_file_size = ::SizeofResource(HINST_THISCOMPONENT, res_handle);
+
+		hr = (image_file && image_file_size) ? S_OK : E_FAIL;
+	}
+
+	if (SUCCEEDED(hr))
+	{
+		hr = factory->CreateStream(&stream);
+	}
+
+	if (SUCCEEDED(hr))
+	{
+		hr = stream->InitializeFromMemory(
+			reinterpret_cast<BYTE*>(image_file),
+			image_file_size
+		);
+	}
+
+	if (SUCCEEDED(hr))
+	{
+		hr = factory->CreateDecoderFromStream(
+			stream,
+			nullptr,
+			WICDecodeMetadataCacheOnLoad,
+			&decoder
+		);
+	}
+
+	if (SUCCEEDED(hr))
+	{
+		hr = Image::DecodePixels(factory, decoder, &source.width, &source.height, source.pixels);
+	}
+
+	if (SUCCEEDED(hr))
+	{
+		sources_.push_back(std::move(source));
+	}
+
+	SafeRelease(decoder);
+	SafeRelease(stream);
+	SafeRelease(factory);
+	return SUCCEEDED(hr);
+#endif
+}
+
+bool easy2d::ImageAtlas::Add(const String & name, UINT width, UINT height, const std::vector<BYTE>& pixels)
+{
+	E2D_WARNING_IF(name.IsEmpty(), "ImageAtlas Add failed! Invalid image name.");
+
+	if (name.IsEmpty() || width == 0 || height == 0 ||
+		pixels.size() != static_cast<size_t>(width) * height * 4)
+		return false;
+
+	Source source;
+	source.key = name.GetHash();
+	source.name = name;
+	source.width = width;
+	source.height = height;
+	source.pixels = pixels;
+	sources_.push_back(std::move(source));
+	return true;
+}
+
+bool easy2d::ImageAtlas::Build()
+{
+	if (sources_.empty())
+		return false;
+
+	auto graphics = Device::GetGraphics();
+	int page_width = page_width_;
+	int page_height = page_height_;
+	int max_size = std::numeric_limits<int>::max();
+#if !E2D_HEADLESS
+	if (graphics)
+	{
+		max_size = static_cast<int>(graphics->GetRenderTarget()->GetMaximumBitmapSize());
+		page_width = std::min(page_width, max_size);
+		page_height = std::min(page_height, max_size);
+	}
+#endif
+
+	// 先放入较高的图片，天际线更平整
+	std::vector<size_t> order(sources_.size());
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs)
+	{
+		const auto& a = sources_[lhs];
+		const auto& b = sources_[rhs];
+		return a.height != b.height ? a.height > b.height : a.width > b.width;
+	});
+
+	// 每张图片占用的区域包含两侧的边缘像素和一侧的间隔
+	const int border = extrude_ * 2 + padding_;
+	const size_t first_page = pages_.size();
+	std::vector<SkylinePacker> packers;
+	std::vector<int> placement(sources_.size() * 3, -1);
+	bool all_packed = true;
+
+	for (auto index : order)
+	{
+		const auto& source = sources_[index];
+		const int width = static_cast<int>(source.width) + border;
+		const int height = static_cast<int>(source.height) + border;
+
+		// 超出页面大小的图片单独占用一个页面，超出最大位图尺寸时无法创建页面
+		if (width > page_width || height > page_height)
+		{
+			E2D_WARNING_IF(width > max_size || height > max_size, "ImageAtlas: image is larger than the maximum bitmap size.");
+
+			if (width > max_size || height > max_size)
+			{
+				all_packed = false;
+				continue;
+			}
+
+			int x = 0, y = 0;
+			packers.push_back(SkylinePacker(width, height));
+			packers.back().Insert(width, height, &x, &y);
+
+			placement[index * 3] = static_cast<int>(packers.size() - 1);
+			placement[index * 3 + 1] = x;
+			placement[index * 3 + 2] = y;
+			continue;
+		}
+
+		int x = 0, y = 0;
+		size_t page = 0;
+		for (; page < packers.size(); ++page)
+		{
+			if (packers[page].Insert(width, height, &x, &y))
+				break;
+		}
+
+		if (page == packers.size())
+		{
+			packers.push_back(SkylinePacker(page_width, page_height));
+			packers.back().Insert(width, height, &x, &y);
+		}
+
+		placement[index * 3] = static_cast<int>(page);
+		placement[index * 3 + 1] = x;
+		placement[index * 3 + 2] = y;
+	}
+
+	// 页面只保留实际用到的区域
+	for (const auto& packer : packers)
+	{
+		Page page;
+		page.width = static_cast<UINT>(packer.GetUsedWidth());
+		page.height = static_cast<UINT>(packer.GetUsedHeight());
+		page.pixels.assign(static_cast<size_t>(page.width) * page.height * 4, 0);
+		page.bitmap = nullptr;
+		pages_.push_back(std::move(page));
+	}
+
+	for (size_t index = 0; index < sources_.size(); ++index)
+	{
+		if (placement[index * 3] < 0)
+			continue;
+
+		const auto& source = sources_[index];
+		auto& page = pages_[first_page + placement[index * 3]];
+		const UINT left = static_cast<UINT>(placement[index * 3 + 1] + extrude_);
+		const UINT top = static_cast<UINT>(placement[index * 3 + 2] + extrude_);
+		const UINT pitch = page.width * 4;
+
+		for (UINT row = 0; row < source.height; ++row)
+		{
+			memcpy(
+				&page.pixels[(top + row) * pitch + left * 4],
+				&source.pixels[row * source.width * 4],
+				source.width * 4
+			);
+		}
+
+		// 重复边缘像素，避免缩放采样时混入相邻图片的颜色
+		for (int e = 1; e <= extrude_; ++e)
+		{
+			memcpy(
+				&page.pixels[(top - e) * pitch + left * 4],
+				&page.pixels[top * pitch + left * 4],
+				source.width * 4
+			);
+			memcpy(
+				&page.pixels[(top + source.height - 1 + e) * pitch + left * 4],
+				&page.pixels[(top + source.height - 1) * pitch + left * 4],
+				source.width * 4
+			);
+		}
+
+		for (UINT row = top - extrude_; row < top + source.height + extrude_; ++row)
+		{
+			BYTE * line = &page.pixels[row * pitch];
+			for (int e = 1; e <= extrude_; ++e)
+			{
+				memcpy(&line[(left - e) * 4], &line[left * 4], 4);
+				memcpy(&line[(left + source.width - 1 + e) * 4], &line[(left + source.width - 1) * 4], 4);
+			}
+		}
+
+		Entry entry;
+		entry.key = source.key;
+		entry.name = source.name;
+		entry.page = static_cast<int>(first_page) + placement[index * 3];
+		entry.rect = Rect(
+			static_cast<float>(left),
+			static_cast<float>(top),
+			static_cast<float>(source.width),
+			static_cast<float>(source.height)
+		);
+		entries_.push_back(entry);
+	}
+
+	sources_.clear();
+
+#if !E2D_HEADLESS
+	if (!graphics)
+		return all_packed;
+
+	for (size_t i = first_page; i < pages_.size(); ++i)
+	{
+		auto& page = pages_[i];
+		ThrowIfFailed(
+			graphics->GetRenderTarget()->CreateBitmap(
+				D2D1::SizeU(page.width, page.height),
+				&page.pixels[0],
+				page.width * 4,
+				D2D1::BitmapProperties(
+					D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)
+				),
+				&page.bitmap
+			)
+		);
+	}
+
+	for (const auto& entry : entries_)
+	{
+		if (static_cast<size_t>(entry.page) >= first_page)
+		{
+			Image::AddRegion(entry.key, pages_[entry.page].bitmap, entry.rect);
+		}
+	}
+#endif
+	return all_packed;
+}
+
+bool easy2d::ImageAtlas::Save(const String & file_name) const
+{
+#if E2D_HEADLESS
+	// 没有系统组件时无法编码 PNG
+	return false;
+#else
+	std::wstring path = (std::wstring)file_name;
+	std::wstring directory = GetDirectory(path);
+	std::wstring base = path.substr(directory.size());
+
+	IWICImagingFactory *factory = Image::AcquireImagingFactory();
+	HRESULT hr = factory ? S_OK : E_FAIL;
+
+	// 所有页面保存成功后才写入图集文件，避免留下引用缺失页面的图集
+	std::wostringstream stream;
+	stream << L"easy2d-atlas 1\n";
+	for (size_t i = 0; i < pages_.size() && SUCCEEDED(hr); ++i)
+	{
+		// 从文件加载的页面没有保留像素，无法再次保存
+		const auto& page = pages_[i];
+		hr = page.pixels.empty() ? E_FAIL : S_OK;
+
+		std::wstring page_name = base + L"_" + std::to_wstring(static_cast<long long>(i)) + L".png";
+		if (SUCCEEDED(hr))
+		{
+			hr = SavePng(factory, (directory + page_name).c_str(), page.width, page.height, page.pixels);
+		}
+
+		if (SUCCEEDED(hr))
+		{
+			stream << L"page " << page_name << L"\n";
+		}
+	}
+	SafeRelease(factory);
+
+	if (FAILED(hr))
+		return false;
+
+	for (const auto& entry : entries_)
+	{
+		E2D_WARNING_IF(entry.name.IsEmpty(), "ImageAtlas: images loaded from resources are not saved.");
+
+		if (entry.name.IsEmpty())
+			continue;
+
+		stream << L"image " << entry.page << L" "
+			<< entry.rect.origin.x << L" " << entry.rect.origin.y << L" "
+			<< entry.rect.size.width << L" " << entry.rect.size.height << L" "
+			<< (const wchar_t*)entry.name << L"\n";
+	}
+
+	std::wofstream file(path.c_str());
+	file << stream.str();
+	return !file.fail();
+#endif
+}
+
+bool easy2d::ImageAtlas::Load(const String & file_name)
+{
+#if E2D_HEADLESS
+	// 页面需要由图形设备创建
+	return false;
+#else
+	// 页面需要由图形设备创建
+	if (!Device::GetGraphics())
+		return false;
+
+	File atlas_file;
+	if (!atlas_file.Open(file_name))
+		return false;
+
+	std::wstring path = (std::wstring)atlas_file.GetPath();
+	std::wstring directory = GetDirectory(path);
+
+	std::wifstream stream(path.c_str());
+	std::wstring header;
+	int version = 0;
+	stream >> header >> version;
+	if (header != L"easy2d-atlas" || version != 1)
+	{
+		E2D_WARNING("ImageAtlas Load failed! Invalid atlas file.");
+		return false;
+	}
+
+	const size_t first_page = pages_.size();
+	std::wstring tag;
+	while (stream >> tag)
+	{
+		if (tag == L"page")
+		{
+			std::wstring page_name;
+			stream >> std::ws;
+			std::getline(stream, page_name);
+
+			String page_path = (directory + page_name).c_str();
+			if (!Image::CacheBitmap(page_path))
+				return false;
+
+			// 页面由图片缓存持有，这里只增加引用
+			Page page;
+			page.bitmap = Image::bitmap_cache_.Get(page_path.GetHash());
+			page.bitmap->AddRef();
+			page.width = static_cast<UINT>(page.bitmap->GetPixelSize().width);
+			page.height = static_cast<UINT>(page.bitmap->GetPixelSize().height);
+			pages_.push_back(std::move(page));
+		}
+		else if (tag == L"image")
+		{
+			Entry entry;
+			float x, y, width, height;
+			stream >> entry.page >> x >> y >> width >> height >> std::ws;
+
+			std::wstring name;
+			std::getline(stream, name);
+			entry.page += static_cast<int>(first_page);
+			if (!stream || entry.page >= static_cast<int>(pages_.size()))
+				return false;
+
+			entry.name = name.c_str();
+			entry.key = entry.name.GetHash();
+			entry.rect = Rect(x, y, width, height);
+			entries_.push_back(entry);
+
+			Image::AddRegion(entry.key, pages_[entry.page].bitmap, entry.rect);
+		}
+		else
+		{
+			return false;
+		}
+	}
+	return true;
+#endif
+}
+
+int easy2d::ImageAtlas::GetPageCount() const
+{
+	return static_cast<int>(pages_.size());
+}
+
+float easy2d::ImageAtlas::GetOccupancy() const
+{
+	double page_area = 0;
+	for (const auto& page : pages_)
+	{
+		page_area += static_cast<double>(page.width) * page.height;
+	}
+
+	double image_area = 0;
+	for (const auto& entry : entries_)
+	{
+		image_area += static_cast<double>(entry.rect.size.width) * entry.rect.size.height;
+	}
+	return page_area > 0 ? static_cast<float>(image_area / page_area) : 0.f;
+}
@@ -0,0 +1,844 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "../e2dobject.h"
+
+namespace
+{
+	easy2d::ImageDecoder * current_decoder = nullptr;
+	easy2d::PortableImageDecoder portable_decoder;
+#if !E2D_HEADLESS
+	easy2d::WicImageDecoder wic_decoder;
+#endif
+
+	const int kFastBits = 9;
+	const int kMaxCodeBits = 15;
+
+	const UINT kLengthBase[29] = {
+		3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+		35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+	};
+	const int kLengthExtra[29] = {
+		0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+		3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+	};
+	const UINT kDistBase[30] = {
+		1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+		257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+	};
+	const int kDistExtra[30] = {
+		0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+		7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+	};
+
+	UINT ReadBE32(const BYTE * p)
+	{
+		return (UINT(p[0]) << 24) | (UINT(p[1]) << 16) | (UINT(p[2]) << 8) | UINT(p[3]);
+	}
+
+	UINT ReadLE32(const BYTE * p)
+	{
+		return UINT(p[0]) | (UINT(p[1]) << 8) | (UINT(p[2]) << 16) | (UINT(p[3]) << 24);
+	}
+
+	UINT ReadLE16(const BYTE * p)
+	{
+		return UINT(p[0]) | (UINT(p[1]) << 8);
+	}
+
+	BYTE Premultiply(UINT color, UINT alpha)
+	{
+		return static_cast<BYTE>((color * alpha + 127) / 255);
+	}
+
+	void StorePixel(BYTE * dest, UINT r, UINT g, UINT b, UINT a)
+	{
+		dest[0] = Premultiply(b, a);
+		dest[1] = Premultiply(g, a);
+		dest[2] = Premultiply(r, a);
+		dest[3] = static_cast<BYTE>(a);
+	}
+
+	// deflate 数据流的按位读取，低位在前
+	class BitReader
+	{
+	public:
+		BitReader(const BYTE * data, size_t size)
+			: data_(data)
+			, end_(data + size)
+			, bits_(0)
+			, count_(0)
+		{
+		}
+
+		// 尽量填满缓冲，数据流结束时缓冲中的位数可能不足
+		void Fill()
+		{
+			while (count_ <= 56 && data_ != end_)
+			{
+				bits_ |= static_cast<unsigned long long>(*data_++) << count_;
+				count_ += 8;
+			}
+		}
+
+		int GetCount() const { return count_; }
+
+		UINT Peek(int n) const { return static_cast<UINT>(bits_ & ((1ull << n) - 1)); }
+
+		void Drop(int n) { bits_ >>= n; count_ -= n; }
+
+		bool Read(int n, UINT * value)
+		{
+			if (count_ < n)
+			{
+				Fill();
+				if (count_ < n)
+					return false;
+			}
+			*value = Peek(n);
+			Drop(n);
+			return true;
+		}
+
+		// 跳到下一个字节边界，缓冲中剩余的整字节退回数据流
+		void AlignToByte()
+		{
+			Drop(count_ & 7);
+			data_ -= count_ / 8;
+			bits_ = 0;
+			count_ = 0;
+		}
+
+		// 对齐后按字节复制
+		bool Copy(BYTE * dest, size_t size)
+		{
+			if (static_cast<size_t>(end_ - data_) < size)
+				return false;
+			::memcpy(dest, data_, size);
+			data_ += size;
+			return true;
+		}
+
+	private:
+		const BYTE *		data_;
+		const BYTE *		end_;
+		unsigned long long	bits_;
+		int					count_;
+	};
+
+	// 范式 Huffman 解码表，短编码直接查表，长编码逐位查找
+	struct Huffman
+	{
+		unsigned short	fast[1 << kFastBits];
+		unsigned short	counts[kMaxCodeBits + 1];
+		unsigned short	symbols[288];
+
+		bool Build(const BYTE * lengths, int count)
+		{
+			::memset(fast, 0, sizeof(fast));
+			::memset(counts, 0, sizeof(counts));
+			for (int i = 0; i < count; ++i)
+			{
+				++counts[lengths[i]];
+			}
+			counts[0] = 0;
+
+			// 编码不能超额，不完整的编码允许存在（只有一个距离编码时）
+			int left = 1;
+			for (int len = 1; len <= kMaxCodeBits; ++len)
+			{
+				left = (left << 1) - counts[len];
+				if (left < 0)
+					return false;
+			}
+
+			int offsets[kMaxCodeBits + 2] = { 0 };
+			int next_code[kMaxCodeBits + 2] = { 0 };
+			for (int len = 1, code = 0; len <= kMaxCodeBits; ++len)
+			{
+				offsets[len + 1] = offsets[len] + counts[len];
+				code = (code + counts[len - 1]) << 1;
+				next_code[len] = code;
+			}
+
+			for (int i = 0; i < count; ++i)
+			{
+				const int len = lengths[i];
+				if (len == 0)
+					continue;
+
+				symbols[offsets[len]++] = static_cast<unsigned short>(i);
+
+				const int code = next_code[len]++;
+				if (len <= kFastBits)
+				{
+					// 编码高位在前，数据流低位在前，查表前先翻转
+					int reversed = 0;
+					for (int b = 0; b < len; ++b)
+					{
+						reversed |= ((code >> b) & 1) << (len - 1 - b);
+					}
+					for (int j = reversed; j < (1 << kFastBits); j += (1 << len))
+					{
+						fast[j] = static_cast<unsigned short>((i << 4) | len);
+					}
+				}
+			}
+			return true;
+		}
+
+		int Decode(BitReader& in) const
+		{
+			in.Fill();
+			const UINT entry = fast[in.Peek(kFastBits)];
+			if (entry)
+			{
+				const int len = entry & 15;
+				if (len > in.GetCount())
+					return -1;
+				in.Drop(len);
+				return static_cast<int>(entry >> 4);
+			}
+
+			int code = 0, first = 0, index = 0;
+			const UINT bits = in.Peek(std::min(in.GetCount(), kMaxCodeBits));
+			for (int len = 1; len <= kMaxCodeBits && len <= in.GetCount(); ++len)
+			{
+				code |= (bits >> (len - 1)) & 1;
+				const int count = counts[len];
+				if (code - count < first)
+				{
+					in.Drop(len);
+					return symbols[index + (code - first)];
+				}
+				index += count;
+				first = (first + count) << 1;
+				code <<= 1;
+			}
+			return -1;
+		}
+	};
+
+	bool BuildFixedTables(Huffman& lit, Huffman& dist)
+	{
+		BYTE lengths[288];
+		for (int i = 0; i < 144; ++i) lengths[i] = 8;
+		for (int i = 144; i < 256; ++i) lengths[i] = 9;
+		for (int i = 256; i < 280; ++i) lengths[i] = 7;
+		for (int i = 280; i < 288; ++i) lengths[i] = 8;
+		if (!lit.Build(lengths, 288))
+			return false;
+
+		for (int i = 0; i < 30; ++i) lengths[i] = 5;
+		return dist.Build(lengths, 30);
+	}
+
+	bool BuildDynamicTables(BitReader& in, Huffman& lit, Huffman& dist)
+	{
+		static const BYTE order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+		UINT hlit, hdist, hclen;
+		if (!in.Read(5, &hlit) || !in.Read(5, &hdist) || !in.Read(4, &hclen))
+			return false;
+		hlit += 257;
+		hdist += 1;
+		hclen += 4;
+		if (hlit > 286 || hdist > 30)
+			return false;
+
+		BYTE lengths[286 + 30] = { 0 };
+		for (UINT i = 0; i < hclen; ++i)
+		{
+			UINT len;
+			if (!in.Read(3, &len))
+				return false;
+			lengths[order[i]] = static_cast<BYTE>(len);
+		}
+
+		Huffman code_lengths;
+		if (!code_lengths.Build(lengths, 19))
+			return false;
+
+		::memset(lengths, 0, sizeof(lengths));
+		for (UINT i = 0; i < hlit + hdist;)
+		{
+			const int symbol = code_lengths.Decode(in);
+			if (symbol < 0)
+				return false;
+
+			if (symbol < 16)
+			{
+				lengths[i++] = static_cast<BYTE>(symbol);
+				continue;
+			}
+
+			UINT repeat;
+			BYTE value = 0;
+			if (symbol == 16)
+			{
+				if (i == 0 || !in.Read(2, &repeat))
+					return false;
+				value = lengths[i - 1];
+				repeat += 3;
+			}
+			else if (symbol == 17)
+			{
+				if (!in.Read(3, &repeat))
+					return false;
+				repeat += 3;
+			}
+			else
+			{
+				if (!in.Read(7, &repeat))
+					return false;
+				repeat += 11;
+			}
+
+			if (i + repeat > hlit + hdist)
+				return false;
+			while (repeat--)
+			{
+				lengths[i++] = value;
+			}
+		}
+
+		// 缺少块结束符的编码无法结束
+		if (lengths[256] == 0)
+			return false;
+
+		return lit.Build(lengths, hlit) && dist.Build(lengths + hlit, hdist);
+	}
+
+	// 解压 deflate 数据到大小已知的缓冲区
+	bool Inflate(const BYTE * data, size_t size, BYTE * out, size_t out_size)
+	{
+		BitReader in(data, size);
+		size_t pos = 0;
+
+		UINT last = 0;
+		while (!last)
+		{
+			UINT type;
+			if (!in.Read(1, &last) || !in.Read(2, &type))
+				return false;
+
+			if (type == 0)
+			{
+				in.AlignToByte();
+				BYTE header[4];
+				if (!in.Copy(header, 4))
+					return false;
+
+				const UINT len = ReadLE16(header);
+				if (len != (~ReadLE16(header + 2) & 0xFFFF) || len > out_size - pos)
+					return false;
+				if (!in.Copy(out + pos, len))
+					return false;
+				pos += len;
+				continue;
+			}
+
+			Huffman lit, dist;
+			if (type == 1)
+			{
+				if (!BuildFixedTables(lit, dist))
+					return false;
+			}
+			else if (type == 2)
+			{
+				if (!BuildDynamicTables(in, lit, dist))
+					return false;
+			}
+			else
+			{
+				return false;
+			}
+
+			for (;;)
+			{
+				const int symbol = lit.Decode(in);
+				if (symbol < 0)
+					return false;
+
+				if (symbol < 256)
+				{
+					if (pos == out_size)
+						return false;
+					out[pos++] = static_cast<BYTE>(symbol);
+					continue;
+				}
+
+				if (symbol == 256)
+					break;
+
+				const int length_index = symbol - 257;
+				if (length_index >= 29)
+					return false;
+
+				UINT length, extra;
+				if (!in.Read(kLengthExtra[length_index], &extra))
+					return false;
+				length = kLengthBase[length_index] + extra;
+
+				const int dist_index = dist.Decode(in);
+				if (dist_index < 0 || dist_index >= 30)
+					return false;
+
+				UINT distance;
+				if (!in.Read(kDistExtra[dist_index], &extra))
+					return false;
+				distance = kDistBase[dist_index] + extra;
+
+				if (distance > pos || length > out_size - pos)
+					return false;
+
+				// 源和目标可能重叠，逐字节复制
+				const BYTE * src = out + pos - distance;
+				BYTE * dest = out + pos;
+				for (UINT i = 0; i < length; ++i)
+				{
+					dest[i] = src[i];
+				}
+				pos += length;
+			}
+		}
+		return pos == out_size;
+	}
+
+	int Paeth(int a, int b, int c)
+	{
+		const int p = a + b - c;
+		const int pa = std::abs(p - a);
+		const int pb = std::abs(p - b);
+		const int pc = std::abs(p - c);
+		if (pa <= pb && pa <= pc)
+			return a;
+		return (pb <= pc) ? b : c;
+	}
+
+	// 还原一行扫描线的过滤，prev 为空时表示第一行
+	bool Unfilter(BYTE filter, BYTE * row, const BYTE * prev, size_t size, size_t bpp)
+	{
+		switch (filter)
+		{
+		case 0:
+			break;
+		case 1:
+			for (size_t i = bpp; i < size; ++i)
+				row[i] = static_cast<BYTE>(row[i] + row[i - bpp]);
+			break;
+		case 2:
+			if (prev)
+			{
+				for (size_t i = 0; i < size; ++i)
+					row[i] = static_cast<BYTE>(row[i] + prev[i]);
+			}
+			break;
+		case 3:
+			for (size_t i = 0; i < size; ++i)
+			{
+				const int left = (i >= bpp) ? row[i - bpp] : 0;
+				const int up = prev ? prev[i] : 0;
+				row[i] = static_cast<BYTE>(row[i] + ((left + up) >> 1));
+			}
+			break;
+		case 4:
+			for (size_t i = 0; i < size; ++i)
+			{
+				const int left = (i >= bpp) ? row[i - bpp] : 0;
+				const int up = prev ? prev[i] : 0;
+				const int up_left = (prev && i >= bpp) ? prev[i - bpp] : 0;
+				row[i] = static_cast<BYTE>(row[i] + Paeth(left, up, up_left));
+			}
+			break;
+		default:
+			return false;
+		}
+		return true;
+	}
+
+	// 读取一个采样的原始值
+	UINT ReadSample(const BYTE * row, UINT index, int depth)
+	{
+		switch (depth)
+		{
+		case 8:
+			return row[index];
+		case 16:
+			return (UINT(row[index * 2]) << 8) | row[index * 2 + 1];
+		default:
+		{
+			const UINT bit = index * depth;
+			const int shift = 8 - depth - static_cast<int>(bit & 7);
+			return (row[bit >> 3] >> shift) & ((1u << depth) - 1);
+		}
+		}
+	}
+
+	// 将采样值缩放到 8 位
+	UINT ScaleSample(UINT value, int depth)
+	{
+		switch (depth)
+		{
+		case 8:
+			return value;
+		case 16:
+			return value >> 8;
+		default:
+			return value * 255 / ((1u << depth) - 1);
+		}
+	}
+
+	bool DecodePng(const BYTE * data, size_t size, UINT * width, UINT * height, std::vector<BYTE>& pixels)
+	{
+		UINT w = 0, h = 0;
+		int depth = 0, color_type = -1;
+		bool has_key = false;
+		UINT key[3] = { 0 };
+		BYTE palette[256 * 4];
+		UINT palette_size = 0;
+		for (int i = 0; i < 256; ++i)
+		{
+			palette[i * 4 + 3] = 255;
+		}
+		std::vector<BYTE> compressed;
+
+		size_t pos = 8;
+		for (;;)
+		{
+			if (size - pos < 12)
+				return false;
+
+			const UINT len = ReadBE32(data + pos);
+			const BYTE * type = data + pos + 4;
+			const BYTE * chunk = data + pos + 8;
+			if (len > size - pos - 12)
+				return false;
+
+			if (::memcmp(type, "IHDR", 4) == 0)
+			{
+				if (len < 13)
+					return false;
+				w = ReadBE32(chunk);
+				h = ReadBE32(chunk + 4);
+				depth = chunk[8];
+				color_type = chunk[9];
+				// 不支持隔行扫描
+				if (chunk[10] != 0 || chunk[11] != 0 || chunk[12] != 0)
+					return false;
+			}
+			else if (::memcmp(type, "PLTE", 4) == 0)
+			{
+				palette_size = std::min(len / 3, 256u);
+				for (UINT i = 0; i < palette_size; ++i)
+				{
+					palette[i * 4 + 0] = chunk[i * 3 + 0];
+					palette[i * 4 + 1] = chunk[i * 3 + 1];
+					palette[i * 4 + 2] = chunk[i * 3 + 2];
+				}
+			}
+			else if (::memcmp(type, "tRNS", 4) == 0)
+			{
+				if (color_type == 3)
+				{
+					for (UINT i = 0; i < len && i < 256; ++i)
+					{
+						palette[i * 4 + 3] = chunk[i];
+					}
+				}
+				else if (color_type == 0 && len >= 2)
+				{
+					has_key = true;
+					key[0] = (UINT(chunk[0]) << 8) | chunk[1];
+				}
+				else if (color_type == 2 && len >= 6)
+				{
+					has_key = true;
+					for (int i = 0; i < 3; ++i)
+					{
+						key[i] = (UINT(chunk[i * 2]) << 8) | chunk[i * 2 + 1];
+					}
+				}
+			}
+			else if (::memcmp(type, "IDAT", 4) == 0)
+			{
+				compressed.insert(compressed.end(), chunk, chunk + len);
+			}
+			else if (::memcmp(type, "IEND", 4) == 0)
+			{
+				break;
+			}
+			pos += 12 + len;
+		}
+
+		int channels;
+		switch (color_type)
+		{
+		case 0: channels = 1; break;
+		case 2: channels = 3; break;
+		case 3: channels = 1; break;
+		case 4: channels = 2; break;
+		case 6: channels = 4; break;
+		default: return false;
+		}
+
+		const bool valid_depth =
+			(depth == 8) ||
+			(depth == 16 && color_type != 3) ||
+			((depth == 1 || depth == 2 || depth == 4) && (color_type == 0 || color_type == 3));
+		// 超出 Direct2D 位图尺寸上限的图片没有意义
+		if (!valid_depth || w == 0 || h == 0 || w > 16384 || h > 16384)
+			return false;
+		if (color_type == 3 && palette_size == 0)
+			return false;
+
+		// zlib 头：deflate 压缩、校验正确且没有预设字典
+		if (compressed.size() < 2 ||
+			(compressed[0] & 0x0F) != 8 ||
+			((UINT(compressed[0]) << 8) | compressed[1]) % 31 != 0 ||
+			(compressed[1] & 0x20) != 0)
+			return false;
+
+		const size_t bits_per_pixel = static_cast<size_t>(channels) * depth;
+		const size_t row_size = (w * bits_per_pixel + 7) / 8;
+		const size_t bpp = std::max<size_t>(1, bits_per_pixel / 8);
+
+		std::vector<BYTE> raw(h * (row_size + 1));
+		if (!Inflate(&compressed[2], compressed.size() - 2, &raw[0], raw.size()))
+			return false;
+
+		pixels.resize(static_cast<size_t>(w) * h * 4);
+		for (UINT y = 0; y < h; ++y)
+		{
+			BYTE * line = &raw[y * (row_size + 1)];
+			BYTE * row = line + 1;
+			const BYTE * prev = y ? row - (row_size + 1) : nullptr;
+			if (!Unfilter(line[0], row, prev, row_size, bpp))
+				return false;
+
+			BYTE * dest = &pixels[static_cast<size_t>(y) * w * 4];
+			if (depth == 8 && color_type == 6)
+			{
+				for (UINT x = 0; x < w; ++x, row += 4, dest += 4)
+				{
+					StorePixel(dest, row[0], row[1], row[2], row[3]);
+				}
+				continue;
+			}
+
+			if (depth == 8 && color_type == 2 && !has_key)
+			{
+				for (UINT x = 0; x < w; ++x, row += 3, dest += 4)
+				{
+					dest[0] = row[2];
+					dest[1] = row[1];
+					dest[2] = row[0];
+					dest[3] = 255;
+				}
+				continue;
+			}
+
+			for (UINT x = 0; x < w; ++x, dest += 4)
+			{
+				switch (color_type)
+				{
+				case 0:
+				{
+					const UINT v = ReadSample(row, x, depth);
+					const UINT g = ScaleSample(v, depth);
+					StorePixel(dest, g, g, g, (has_key && v == key[0]) ? 0 : 255);
+					break;
+				}
+				case 2:
+				{
+					UINT v[3];
+					for (int c = 0; c < 3; ++c)
+					{
+						v[c] = ReadSample(row, x * 3 + c, depth);
+					}
+					const bool transparent = has_key && v[0] == key[0] && v[1] == key[1] && v[2] == key[2];
+					StorePixel(dest, ScaleSample(v[0], depth), ScaleSample(v[1], depth), ScaleSample(v[2], depth), transparent ? 0 : 255);
+					break;
+				}
+				case 3:
+				{
+					const UINT index = ReadSample(row, x, depth);
+					if (index >= palette_size)
+						return false;
+					const BYTE * entry = &palette[index * 4];
+					StorePixel(dest, entry[0], entry[1], entry[2], entry[3]);
+					break;
+				}
+				case 4:
+				{
+					const UINT g = ScaleSample(ReadSample(row, x * 2, depth), depth);
+					StorePixel(dest, g, g, g, ScaleSample(ReadSample(row, x * 2 + 1, depth), depth));
+					break;
+				}
+				default:
+				{
+					UINT v[4];
+					for (int c = 0; c < 4; ++c)
+					{
+						v[c] = ScaleSample(ReadSample(row, x * 4 + c, depth), depth);
+					}
+					StorePixel(dest, v[0], v[1], v[2], v[3]);
+					break;
+				}
+				}
+			}
+		}
+
+		*width = w;
+		*height = h;
+		return true;
+	}
+
+	bool DecodeBmp(const BYTE * data, size_t size, UINT * width, UINT * height, std::vector<BYTE>& pixels)
+	{
+		if (size < 54)
+			return false;
+
+		const UINT offset = ReadLE32(data + 10);
+		const UINT header_size = ReadLE32(data + 14);
+		const int w = static_cast<int>(ReadLE32(data + 18));
+		const int h = static_cast<int>(ReadLE32(data + 22));
+		const UINT bit_count = ReadLE16(data + 28);
+		const UINT compression = ReadLE32(data + 30);
+		if (header_size < 40 || ReadLE16(data + 26) != 1 || w <= 0 || h == 0)
+			return false;
+
+		// 32 位图片只有声明了透明通道掩码时才使用透明度，否则按不透明处理
+		bool has_alpha = false;
+		if (compression == 3 && bit_count == 32)
+		{
+			if (size < 66 ||
+				ReadLE32(data + 54) != 0x00FF0000 ||
+				ReadLE32(data + 58) != 0x0000FF00 ||
+				ReadLE32(data + 62) != 0x000000FF)
+				return false;
+			has_alpha = header_size >= 56 && ReadLE32(data + 66) == 0xFF000000;
+		}
+		else if (compression != 0 || (bit_count != 24 && bit_count != 32))
+		{
+			return false;
+		}
+
+		const bool top_down = h < 0;
+		const UINT w_abs = static_cast<UINT>(w);
+		const UINT h_abs = static_cast<UINT>(top_down ? -h : h);
+		if (w_abs > 16384 || h_abs > 16384)
+			return false;
+
+		const size_t stride = ((static_cast<size_t>(w_abs) * bit_count + 31) / 32) * 4;
+		if (offset > size || stride * h_abs > size - offset)
+			return false;
+
+		const size_t step = bit_count / 8;
+		pixels.resize(static_cast<size_t>(w_abs) * h_abs * 4);
+		for (UINT y = 0; y < h_abs; ++y)
+		{
+			const BYTE * row = data + offset + stride * (top_down ? y : h_abs - 1 - y);
+			BYTE * dest = &pixels[static_cast<size_t>(y) * w_abs * 4];
+			for (UINT x = 0; x < w_abs; ++x, row += step, dest += 4)
+			{
+				if (has_alpha)
+				{
+					StorePixel(dest, row[2], row[1], row[0], row[3]);
+				}
+				else
+				{
+					dest[0] = row[0];
+					dest[1] = row[1];
+					dest[2] = row[2];
+					dest[3] = 255;
+				}
+			}
+		}
+
+		*width = w_abs;
+		*height = h_abs;
+		return true;
+	}
+}
+
+bool easy2d::ImageDecoder::DecodeFile(
+	const String & file_path,
+	UINT * width,
+	UINT * height,
+	std::vector<BYTE>& pixels
+)
+{
+#if E2D_HEADLESS
+	FILE * file = ::fopen(static_cast<std::string>(file_path).c_str(), "rb");
+#else
+	FILE * file = ::_wfopen(static_cast<const wchar_t*>(file_path), L"rb");
+#endif
+	if (!file)
+		return false;
+
+	std::vector<BYTE> data;
+	BYTE buffer[64 * 1024];
+	size_t count;
+	while ((count = ::fread(buffer, 1, sizeof(buffer), file)) > 0)
+	{
+		data.insert(data.end(), buffer, buffer + count);
+	}
+	::fclose(file);
+
+	return !data.empty() && Decode(&data[0], data.size(), width, height, pixels);
+}
+
+easy2d::ImageDecoder * easy2d::ImageDecoder::GetCurrent()
+{
+	if (current_decoder)
+		return current_decoder;
+#if E2D_HEADLESS
+	return &portable_decoder;
+#else
+	return &wic_decoder;
+#endif
+}
+
+void easy2d::ImageDecoder::SetCurrent(ImageDecoder * decoder)
+{
+	current_decoder = decoder;
+}
+
+bool easy2d::PortableImageDecoder::Decode(
+	const BYTE * data,
+	size_t size,
+	UINT * width,
+	UINT * height,
+	std::vector<BYTE>& pixels
+)
+{
+	static const BYTE png_signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+	if (data && size >= 8 && ::memcmp(data, png_signature, 8) == 0)
+	{
+		return DecodePng(data, size, width, height, pixels);
+	}
+	if (data && size >= 2 && data[0] == 'B' && data[1] == 'M')
+	{
+		return DecodeBmp(data, size, width, height, pixels);
+	}
+	return false;
+}
@@ -18,28 +18,161 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dobject.h"
-#include "..\e2devent.h"
-#include "..\e2daction.h"
-#include "..\e2dmodule.h"
+#include "../e2dobject.h"
+#include "../e2devent.h"
+#include "../e2daction.h"
+#include "../e2dmodule.h"
 
 
+namespace
+{
+	// 计算四边形在某一轴上的投影区间
+	void ProjectVertices(const easy2d::Point * vertices, float axis_x, float axis_y, float& min_val, float& max_val)
+	{
+		min_val = max_val = vertices[0].x * axis_x + vertices[0].y * axis_y;
+		for (int i = 1; i < 4; ++i)
+		{
+			float val = vertices[i].x * axis_x + vertices[i].y * axis_y;
+			min_val = std::min(min_val, val);
+			max_val = std::max(max_val, val);
+		}
+	}
+
+	// 判断四边形面积是否为 0，节点缩放为 0 时轮廓会退化成线段或点
+	bool IsDegenerate(const easy2d::Point * vertices)
+	{
+		float area = (vertices[1].x - vertices[0].x) * (vertices[3].y - vertices[0].y)
+			- (vertices[1].y - vertices[0].y) * (vertices[3].x - vertices[0].x);
+		return area == 0.f;
+	}
+
+	// 判断 a 的边所在的轴能否分离两个四边形
+	bool HasSeparatingAxis(const easy2d::Point * a, const easy2d::Point * b)
+	{
+		// 节点轮廓经过仿射变换后是平行四边形，只需检查相邻两条边的法线
+		for (int i = 0; i < 2; ++i)
+		{
+			float axis_x = a[i].y - a[i + 1].y;
+			float axis_y = a[i + 1].x - a[i].x;
+
+			float min_a, max_a, min_b, max_b;
+			ProjectVertices(a, axis_x, axis_y, min_a, max_a);
+			ProjectVertices(b, axis_x, axis_y, min_b, max_b);
+
+			if (max_a < min_b || max_b < min_a)
+				return true;
+		}
+		return false;
+	}
+
+	// 计算名称索引使用的 Hash 值，可以直接对路径中的一段进行计算
+	// 与 String::GetHash 的结果不同，只在节点内部使用
+	size_t HashName(const wchar_t* str, size_t length)
+	{
+		size_t hash = 2166136261U;
+		for (size_t i = 0; i < length; ++i)
+		{
+			hash ^= static_cast<size_t>(str[i]);
+			hash *= 16777619U;
+		}
+		return hash;
+	}
+
+	size_t HashName(const easy2d::String& name)
+	{
+		return HashName(static_cast<const wchar_t*>(name), static_cast<size_t>(name.Length()));
+	}
+
+	// 任务队列是以执行时间排列的小顶堆
+	template<typename Entry>
+	bool LaterTask(const Entry& lhs, const Entry& rhs)
+	{
+		return lhs.time - rhs.time > easy2d::Duration();
+	}
+
+	// 判断节点名称是否与字符串片段相同
+	bool NameEquals(const easy2d::String& name, const wchar_t* str, size_t length)
+	{
+		return static_cast<size_t>(name.Length()) == length
+			&& std::char_traits<wchar_t>::compare(static_cast<const wchar_t*>(name), str, length) == 0;
+	}
+
+	// 并行更新时记录的延迟操作，在所有子树更新完成后按子树顺序执行
+	struct UpdateContext
+	{
+		std::vector<std::function<void()>> commands;
+		std::vector<easy2d::Node*> dirty_nodes;
+	};
+
+	// 当前线程正在更新的并行子树，为空时表示处于串行阶段
+	E2D_THREAD_LOCAL UpdateContext * update_context = nullptr;
+
+	// 并行更新期间将结构修改推迟到串行阶段执行
+	bool DeferCommand(const std::function<void()>& command)
+	{
+		if (!update_context)
+			return false;
+
+		update_context->commands.push_back(command);
+		return true;
+	}
+
+	// 计算两矩形的交集
+	easy2d::Rect IntersectRect(const easy2d::Rect& a, const easy2d::Rect& b)
+	{
+		float min_x = std::max(a.origin.x, b.origin.x);
+		float min_y = std::max(a.origin.y, b.origin.y);
+		float max_x = std::min(a.origin.x + a.size.width, b.origin.x + b.size.width);
+		float max_y = std::min(a.origin.y + a.size.height, b.origin.y + b.size.height);
+		return easy2d::Rect(min_x, min_y, std::max(max_x - min_x, 0.f), std::max(max_y - min_y, 0.f));
+	}
+}
+
 easy2d::Node::Node()
 	: visible_(true)
 	, parent_(nullptr)
 	, parent_scene_(nullptr)
 	, hash_name_(0)
+	, name_key_(0)
 	, clip_enabled_(false)
-	, dirty_sort_(false)
 	, dirty_transform_(false)
+	, dirty_border_(false)
+	, dirty_children_(false)
+	, transform_index_(-1)
+	, proxy_id_(-1)
+	, event_priority_(0)
+	, swallow_events_(false)
+	, parallel_update_(false)
+	, paused_(false)
+	, time_scale_(1.f)
+	, time_carry_(0.f)
+	, time_()
+	, mouse_listener_index_(-1)
+	, key_listener_index_(-1)
+	, bounds_()
+	, draw_bounds_()
+	, cull_bounds_()
+	, subtree_bounds_()
+	, subtree_bounded_(false)
+	, subtree_empty_(false)
+	, culling_enabled_(true)
+	, has_draw_bounds_(false)
+	, custom_draw_(true)
+	, empty_draw_(false)
 	, border_(nullptr)
 	, order_(0)
 	, transform_()
 	, display_opacity_(1.f)
 	, real_opacity_(1.f)
 	, children_()
+	, named_children_()
 	, actions_()
 	, tasks_()
+	, named_tasks_()
+	, dirty_tasks_(false)
+	, task_queue_()
+	, due_tasks_()
+	, async_token_()
 	, initial_matrix_(D2D1::Matrix3x2F::Identity())
 	, final_matrix_(D2D1::Matrix3x2F::Identity())
 	, border_color_(Color::Red, 0.6f)
@@ -48,15 +181,25 @@ easy2d::Node::Node()
 
 easy2d::Node::~Node()
 {
+	if (parent_scene_)
+	{
+		parent_scene_->RemoveProxy(this);
+		parent_scene_->RemoveListener(this);
+	}
+
 	SafeRelease(border_);
 
+	CancelAsync();
+
 	for (auto action : actions_)
 	{
+		ActionManager::GetInstance()->Remove(action);
 		SafeRelease(action);
 	}
 
 	for (auto task : tasks_)
 	{
+		task->target_ = nullptr;
 		SafeRelease(task);
 	}
 
@@ -66,131 +209,328 @@ easy2d::Node::~Node()
 	}
 }
 
-void easy2d::Node::Visit()
+void easy2d::Node::Draw() const
+{
+	// 基类的 Draw 被调用说明节点没有重写它，之后不再生成绘制命令
+	custom_draw_ = false;
+
+	// 节点不绘制内容，重新计算所在子树的包围盒
+	empty_draw_ = true;
+	const_cast<Node*>(this)->MarkTransformDirty();
+}
+
+void easy2d::Node::Record(RenderCommandList & commands) const
+{
+	// 普通节点不绘制任何内容，其他节点在回放时调用 Draw
+	if (custom_draw_ && typeid(*this) != typeid(Node))
+	{
+		commands.DrawNode(this);
+	}
+}
+
+void easy2d::Node::SetCustomDraw(bool enabled)
+{
+	custom_draw_ = enabled;
+}
+
+const std::type_info & easy2d::Node::GetSetterType() const
+{
+	return typeid(Node);
+}
+
+void easy2d::Node::Visit(RenderCommandList & commands)
 {
 	if (!visible_)
 		return;
 
-	auto render_target = Device::GetGraphics()->GetRenderTarget();
-	if (clip_enabled_)
+	UpdateOpacity();
+
+	Scene * scene = parent_scene_;
+	Rect cull_rect;
+	if (scene)
 	{
-		render_target->SetTransform(final_matrix_);
-		render_target->PushAxisAlignedClip(
-			D2D1::RectF(0, 0, transform_.size.width, transform_.size.height),
-			D2D1_ANTIALIAS_MODE_PER_PRIMITIVE
-		);
+		++scene->visited_count_;
+
+		// 完全透明或整个子树都在可见区域外时直接跳过
+		if (display_opacity_ <= 0.f ||
+			(subtree_bounded_ && !subtree_empty_ && !subtree_bounds_.Intersects(scene->cull_rect_)))
+		{
+			++scene->culled_count_;
+			return;
+		}
+		cull_rect = scene->cull_rect_;
+	}
+	else if (display_opacity_ <= 0.f)
+	{
+		return;
 	}
 
-	if (children_.empty())
+	if (clip_enabled_)
 	{
-		render_target->SetTransform(final_matrix_);
-		Draw();
+		commands.SetTransform(final_matrix_);
+		commands.PushClip(
+			D2D1::RectF(0, 0, transform_.size.width, transform_.size.height)
+		);
+
+		// 裁剪区域外的子节点不可见
+		if (scene)
+		{
+			scene->cull_rect_ = IntersectRect(cull_rect, bounds_);
+		}
 	}
-	else
+
+	auto draw_self = [&]()
 	{
-		// ӽڵ
-		if (dirty_sort_)
+		if (scene)
 		{
-			std::sort(
-				std::begin(children_),
-				std::end(children_),
-				[](Node * n1, Node * n2) { return n1->GetOrder() < n2->GetOrder(); }
-			);
+			if (IsBounded() && !cull_bounds_.Intersects(scene->cull_rect_))
+			{
+				++scene->culled_count_;
+				return;
+			}
+		}
+
+		const size_t count = commands.GetCount();
+		commands.SetTransform(final_matrix_);
+		Record(commands);
 
-			dirty_sort_ = false;
+		// 节点没有绘制内容时撤销变换命令
+		if (commands.GetCount() == count + 1)
+		{
+			commands.Rewind(count);
+		}
+		else if (scene)
+		{
+			++scene->drawn_count_;
 		}
+	};
 
+	if (children_.empty())
+	{
+		draw_self();
+	}
+	else
+	{
+		// 子节点始终按 Order 排列，先访问 Order 小于零的节点
+		const size_t split = FindOrderSplit();
 		size_t i;
-		for (i = 0; i < children_.size(); ++i)
+		for (i = 0; i < split && i < children_.size(); ++i)
 		{
-			auto child = children_[i];
-			//  Order СĽڵ
-			if (child->GetOrder() < 0)
-			{
-				child->Visit();
-			}
-			else
-			{
-				break;
-			}
+			children_[i]->Visit(commands);
 		}
-		
-		render_target->SetTransform(final_matrix_);
-		Draw();
 
-		// ʣڵ
+		draw_self();
+
+		// 访问剩余节点
 		for (; i < children_.size(); ++i)
-			children_[i]->Visit();
+			children_[i]->Visit(commands);
 	}
 
 	if (clip_enabled_)
 	{
-		render_target->PopAxisAlignedClip();
+		commands.PopClip();
+
+		if (scene)
+		{
+			scene->cull_rect_ = cull_rect;
+		}
 	}
 }
 
-void easy2d::Node::UpdateChildren(float dt)
+void easy2d::Node::UpdateChildren(float dt, Duration step)
 {
+	if (paused_)
+		return;
+
+	// 子节点收到的时间间隔已经过父节点缩放
+	dt *= time_scale_;
+	step = AdvanceTime(dt, step);
+
+	// 并行子树只在最外层的串行阶段展开，子树内部的并行标记被忽略
+	const bool skip_parallel = (update_context == nullptr);
+	if (skip_parallel)
+	{
+		UpdateParallelChildren(dt, step);
+	}
+
 	if (children_.empty())
 	{
 		Update(dt);
-		UpdateActions();
 		UpdateTasks();
-		UpdateTransform();
 	}
 	else
 	{
+		// 子节点始终按 Order 排列，先访问 Order 小于零的节点
+		const size_t split = FindOrderSplit();
 		size_t i;
-		for (i = 0; i < children_.size(); ++i)
+		for (i = 0; i < split && i < children_.size(); ++i)
 		{
-			auto child = children_[i];
-			//  Order СĽڵ
-			if (child->GetOrder() < 0)
+			if (!skip_parallel || !children_[i]->parallel_update_)
+				children_[i]->UpdateChildren(dt, step);
+		}
+
+		Update(dt);
+		UpdateTasks();
+
+		// 访问剩余节点
+		for (; i < children_.size(); ++i)
+		{
+			if (!skip_parallel || !children_[i]->parallel_update_)
+				children_[i]->UpdateChildren(dt, step);
+		}
+	}
+}
+
+easy2d::Duration easy2d::Node::AdvanceTime(float dt, Duration step)
+{
+	// 没有缩放时直接使用父节点的时间段，只有缩放过的节点需要重新换算
+	if (time_scale_ != 1.f)
+	{
+		// Duration 的精度有限，保留不足精度的部分留到下一帧，避免时钟误差累积
+		step = Duration(dt + time_carry_);
+		time_carry_ = dt + time_carry_ - step.Seconds();
+	}
+	time_ += step;
+	return step;
+}
+
+void easy2d::Node::UpdateParallelChildren(float dt, Duration step)
+{
+	Nodes children;
+	for (const auto& child : children_)
+	{
+		if (child->parallel_update_)
+		{
+			children.push_back(child);
+		}
+	}
+
+	if (children.empty())
+		return;
+
+	std::vector<UpdateContext> contexts(children.size());
+	auto pool = Device::GetThreadPool();
+
+	for (size_t i = 0; i < children.size(); ++i)
+	{
+		Node * child = children[i];
+		UpdateContext * context = &contexts[i];
+
+		auto job = [child, context, dt, step]()
+		{
+			UpdateContext * last = update_context;
+			update_context = context;
+			try
 			{
-				child->UpdateChildren(dt);
+				child->UpdateChildren(dt, step);
 			}
-			else
+			catch (...)
 			{
-				break;
+				update_context = last;
+				throw;
 			}
+			update_context = last;
+		};
+
+		if (pool)
+		{
+			pool->Submit(job);
 		}
+		else
+		{
+			job();
+		}
+	}
 
-		Update(dt);
-		UpdateActions();
-		UpdateTasks();
-		UpdateTransform();
+	if (pool)
+	{
+		pool->Wait();
+	}
 
-		// ʣڵ
-		for (; i < children_.size(); ++i)
-			children_[i]->UpdateChildren(dt);
+	// 按子树顺序执行延迟的操作，保证结果与线程调度无关
+	for (auto& context : contexts)
+	{
+		for (auto node : context.dirty_nodes)
+		{
+			if (node->parent_scene_)
+			{
+				node->parent_scene_->transform_store_.MarkDirty(node);
+			}
+		}
+
+		for (const auto& command : context.commands)
+		{
+			command();
+		}
 	}
 }
 
-void easy2d::Node::DrawBorder()
+void easy2d::Node::DrawBorder(RenderCommandList & commands)
 {
 	if (visible_)
 	{
+		UpdateBorder();
+
 		if (border_)
 		{
-			auto graphics = Device::GetGraphics();
-			auto brush = graphics->GetSolidBrush();
-			brush->SetColor(D2D1_COLOR_F(border_color_));
-			graphics->GetRenderTarget()->DrawGeometry(
+			commands.DrawGeometry(
 				border_,
-				brush,
+				D2D1_COLOR_F(border_color_),
 				1.5f
 			);
 		}
 
 		for (const auto& child : children_)
 		{
-			child->DrawBorder();
+			child->DrawBorder(commands);
 		}
 	}
 }
 
+void easy2d::Node::UpdateBorder()
+{
+	if (!dirty_border_)
+		return;
+
+	dirty_border_ = false;
+
+	SafeRelease(border_);
+
+#if !E2D_HEADLESS
+	ID2D1Factory * factory = Device::GetGraphics()->GetFactory();
+	ID2D1RectangleGeometry * rectangle = nullptr;
+	ID2D1TransformedGeometry * transformed = nullptr;
+	ThrowIfFailed(
+		factory->CreateRectangleGeometry(
+			D2D1::RectF(0, 0, transform_.size.width, transform_.size.height),
+			&rectangle
+		)
+	);
+	ThrowIfFailed(
+		factory->CreateTransformedGeometry(
+			rectangle,
+			final_matrix_,
+			&transformed
+		)
+	);
+	border_ = transformed;
+
+	SafeRelease(rectangle);
+#endif
+}
+
 void easy2d::Node::UpdateTransform()
 {
+	// 场景中的节点由场景的变换缓存统一更新，并行更新期间使用上一次的结果
+	if (parent_scene_)
+	{
+		if (!update_context)
+		{
+			parent_scene_->UpdateTransform();
+		}
+		return;
+	}
+
 	if (!dirty_transform_)
 		return;
 
@@ -198,7 +538,7 @@ void easy2d::Node::UpdateTransform()
 
 	final_matrix_ = static_cast<D2D1::Matrix3x2F>(transform_);
 
-	// ֧ Initial ӽڵ㽫б任
+	// 根据自身支点计算 Initial 矩阵，子节点将根据这个矩阵进行变换
 	auto pivot = Point(
 		transform_.size.width * transform_.pivot_x,
 		transform_.size.height * transform_.pivot_y
@@ -207,43 +547,264 @@ void easy2d::Node::UpdateTransform()
 
 	if (parent_)
 	{
-		initial_matrix_ = initial_matrix_ * parent_->initial_matrix_;
-		final_matrix_ = final_matrix_ * parent_->initial_matrix_;
+		initial_matrix_ = initial_matrix_ * parent_->initial_matrix_;
+		final_matrix_ = final_matrix_ * parent_->initial_matrix_;
+	}
+
+	UpdateBorderVertices();
+
+	// 通知子节点进行转换
+	for (const auto& child : children_)
+	{
+		child->dirty_transform_ = true;
+	}
+}
+
+void easy2d::Node::MarkTransformDirty()
+{
+	if (dirty_transform_)
+		return;
+
+	dirty_transform_ = true;
+
+	if (parent_scene_)
+	{
+		// 并行更新期间不能修改场景的变换缓存
+		if (update_context)
+		{
+			update_context->dirty_nodes.push_back(this);
+		}
+		else
+		{
+			parent_scene_->transform_store_.MarkDirty(this);
+		}
+	}
+}
+
+bool easy2d::Node::IsBounded() const
+{
+	if (!culling_enabled_)
+		return false;
+
+	if (has_draw_bounds_)
+		return true;
+
+	// 重写了 Draw 的节点可能在节点大小之外绘制
+	if (custom_draw_ && typeid(*this) != typeid(Node))
+		return false;
+
+	// 大小为零的节点可能绘制任意内容，除非指定了绘制范围
+	return transform_.size.width != 0.f || transform_.size.height != 0.f;
+}
+
+bool easy2d::Node::IsContentEmpty() const
+{
+	if (!culling_enabled_ || has_draw_bounds_)
+		return false;
+
+	// 普通节点和回放时调用了基类 Draw 的节点只是容器
+	return empty_draw_ || typeid(*this) == typeid(Node);
+}
+
+void easy2d::Node::InsertOrderedChild(Node * child)
+{
+	// 插入到相同 Order 的节点之后，保证排序稳定
+	auto iter = std::upper_bound(
+		children_.begin(),
+		children_.end(),
+		child->order_,
+		[](int order, const Node * node) { return order < node->order_; }
+	);
+	children_.insert(iter, child);
+}
+
+void easy2d::Node::EraseOrderedChild(Node * child)
+{
+	auto first = std::lower_bound(
+		children_.begin(),
+		children_.end(),
+		child->order_,
+		[](const Node * node, int order) { return node->order_ < order; }
+	);
+
+	for (auto iter = first; iter != children_.end() && (*iter)->order_ == child->order_; ++iter)
+	{
+		if (*iter == child)
+		{
+			children_.erase(iter);
+			return;
+		}
+	}
+}
+
+size_t easy2d::Node::FindOrderSplit() const
+{
+	auto iter = std::lower_bound(
+		children_.begin(),
+		children_.end(),
+		0,
+		[](const Node * node, int order) { return node->order_ < order; }
+	);
+	return static_cast<size_t>(iter - children_.begin());
+}
+
+void easy2d::Node::IndexChildName(Node * child)
+{
+	if (!child->name_.IsEmpty())
+	{
+		named_children_.insert(std::make_pair(child->name_key_, child));
+	}
+}
+
+void easy2d::Node::UnindexChildName(Node * child)
+{
+	if (child->name_.IsEmpty())
+		return;
+
+	auto range = named_children_.equal_range(child->name_key_);
+	for (auto iter = range.first; iter != range.second; ++iter)
+	{
+		if (iter->second == child)
+		{
+			named_children_.erase(iter);
+			return;
+		}
+	}
+}
+
+void easy2d::Node::UpdateSubtreeBounds()
+{
+	// 不绘制内容的节点只包含子节点的范围，大小为零的容器也能整体剔除
+	subtree_empty_ = IsContentEmpty();
+	subtree_bounded_ = subtree_empty_ || IsBounded();
+	if (!subtree_bounded_)
+		return;
+
+	float min_x = cull_bounds_.origin.x;
+	float min_y = cull_bounds_.origin.y;
+	float max_x = cull_bounds_.origin.x + cull_bounds_.size.width;
+	float max_y = cull_bounds_.origin.y + cull_bounds_.size.height;
+
+	for (const auto& child : children_)
+	{
+		if (!child->subtree_bounded_)
+		{
+			subtree_bounded_ = false;
+			return;
+		}
+
+		if (child->subtree_empty_)
+			continue;
+
+		const Rect& rect = child->subtree_bounds_;
+		if (subtree_empty_)
+		{
+			subtree_empty_ = false;
+			min_x = rect.origin.x;
+			min_y = rect.origin.y;
+			max_x = rect.origin.x + rect.size.width;
+			max_y = rect.origin.y + rect.size.height;
+			continue;
+		}
+		min_x = std::min(min_x, rect.origin.x);
+		min_y = std::min(min_y, rect.origin.y);
+		max_x = std::max(max_x, rect.origin.x + rect.size.width);
+		max_y = std::max(max_y, rect.origin.y + rect.size.height);
+	}
+
+	// 整个子树都不绘制内容时不需要剔除
+	subtree_bounds_ = subtree_empty_ ? Rect() : Rect(min_x, min_y, max_x - min_x, max_y - min_y);
+}
+
+void easy2d::Node::UpdateBorderVertices()
+{
+	auto to_point = [this](float x, float y) -> Point
+	{
+		auto p = final_matrix_.TransformPoint(D2D1::Point2F(x, y));
+		return Point(p.x, p.y);
+	};
+	border_vertices_[0] = to_point(0, 0);
+	border_vertices_[1] = to_point(transform_.size.width, 0);
+	border_vertices_[2] = to_point(transform_.size.width, transform_.size.height);
+	border_vertices_[3] = to_point(0, transform_.size.height);
+
+	float min_x = border_vertices_[0].x, max_x = border_vertices_[0].x;
+	float min_y = border_vertices_[0].y, max_y = border_vertices_[0].y;
+	for (int i = 1; i < 4; ++i)
+	{
+		min_x = std::min(min_x, border_vertices_[i].x);
+		max_x = std::max(max_x, border_vertices_[i].x);
+		min_y = std::min(min_y, border_vertices_[i].y);
+		max_y = std::max(max_y, border_vertices_[i].y);
+	}
+	bounds_ = Rect(min_x, min_y, max_x - min_x, max_y - min_y);
+
+	// 剔除使用绘制范围，鼠标检测和裁剪仍使用节点大小
+	if (has_draw_bounds_)
+	{
+		const float left = draw_bounds_.origin.x;
+		const float top = draw_bounds_.origin.y;
+		const float right = left + draw_bounds_.size.width;
+		const float bottom = top + draw_bounds_.size.height;
+		const Point corners[] = { to_point(left, top), to_point(right, top), to_point(right, bottom), to_point(left, bottom) };
+
+		min_x = max_x = corners[0].x;
+		min_y = max_y = corners[0].y;
+		for (int i = 1; i < 4; ++i)
+		{
+			min_x = std::min(min_x, corners[i].x);
+			max_x = std::max(max_x, corners[i].x);
+			min_y = std::min(min_y, corners[i].y);
+			max_y = std::max(max_y, corners[i].y);
+		}
+		cull_bounds_ = Rect(min_x, min_y, max_x - min_x, max_y - min_y);
 	}
-	else if (parent_scene_)
+	else
 	{
-		initial_matrix_ = initial_matrix_ * parent_scene_->GetTransform();
-		final_matrix_ = final_matrix_ * parent_scene_->GetTransform();
+		cull_bounds_ = bounds_;
 	}
 
-	// ¹
-	SafeRelease(border_);
+	if (parent_scene_)
+	{
+		parent_scene_->UpdateProxy(this);
+	}
 
-	ID2D1Factory * factory = Device::GetGraphics()->GetFactory();
-	ID2D1RectangleGeometry * rectangle = nullptr;
-	ID2D1TransformedGeometry * transformed = nullptr;
-	ThrowIfFailed(
-		factory->CreateRectangleGeometry(
-			D2D1::RectF(0, 0, transform_.size.width, transform_.size.height),
-			&rectangle
-		)
-	);
-	ThrowIfFailed(
-		factory->CreateTransformedGeometry(
-			rectangle,
-			final_matrix_,
-			&transformed
-		)
-	);
-	border_ = transformed;
+	// 轮廓几何体仅在调试模式渲染边缘时才重新构造
+	dirty_border_ = true;
+}
 
-	SafeRelease(rectangle);
+bool easy2d::Node::IsMouseListener() const
+{
+	return dynamic_cast<const MouseEventHandler*>(this) != nullptr;
+}
 
-	// ֪ͨӽڵת
-	for (const auto& child : children_)
+bool easy2d::Node::IsKeyListener() const
+{
+	return dynamic_cast<const KeyEventHandler*>(this) != nullptr;
+}
+
+bool easy2d::Node::OnMouseEvent(const MouseEvent & e, bool handled)
+{
+	auto handler = dynamic_cast<MouseEventHandler*>(this);
+	if (handler)
 	{
-		child->dirty_transform_ = true;
+		handler->Handle(e);
+		handled = handled || swallow_events_;
+	}
+
+	return handled;
+}
+
+bool easy2d::Node::OnKeyEvent(const KeyEvent & e, bool handled)
+{
+	auto handler = dynamic_cast<KeyEventHandler*>(this);
+	if (handler)
+	{
+		handler->Handle(e);
+		handled = handled || swallow_events_;
 	}
+
+	return handled;
 }
 
 bool easy2d::Node::Dispatch(const MouseEvent & e, bool handled)
@@ -253,9 +814,7 @@ bool easy2d::Node::Dispatch(const MouseEvent & e, bool handled)
 		for (auto riter = children_.crbegin(); riter != children_.crend(); ++riter)
 			handled = (*riter)->Dispatch(e, handled);
 
-		auto handler = dynamic_cast<MouseEventHandler*>(this);
-		if (handler)
-			handler->Handle(e);
+		handled = OnMouseEvent(e, handled);
 	}
 
 	return handled;
@@ -268,9 +827,7 @@ bool easy2d::Node::Dispatch(const KeyEvent & e, bool handled)
 		for (auto riter = children_.crbegin(); riter != children_.crend(); ++riter)
 			handled = (*riter)->Dispatch(e, handled);
 
-		auto handler = dynamic_cast<KeyEventHandler*>(this);
-		if (handler)
-			handler->Handle(e);
+		handled = OnKeyEvent(e, handled);
 	}
 
 	return handled;
@@ -278,52 +835,43 @@ bool easy2d::Node::Dispatch(const KeyEvent & e, bool handled)
 
 void easy2d::Node::UpdateOpacity()
 {
-	if (parent_)
-	{
-		display_opacity_ = real_opacity_ * parent_->display_opacity_;
-	}
-	for (const auto& child : children_)
-	{
-		child->UpdateOpacity();
-	}
+	// 父节点总是先于子节点被访问，因此父节点的透明度已是最新的
+	display_opacity_ = parent_ ? real_opacity_ * parent_->display_opacity_ : real_opacity_;
 }
 
-void easy2d::Node::UpdateActions()
+bool easy2d::Node::IsVisible() const
 {
-	if (actions_.empty())
-		return;
+	return visible_;
+}
 
-	std::vector<Action*> currActions;
-	currActions.reserve(actions_.size());
-	std::copy_if(
-		actions_.begin(),
-		actions_.end(),
-		std::back_inserter(currActions),
-		[](Action* action) { return action->IsRunning() && !action->IsDone(); }
-	);
+int easy2d::Node::GetEventPriority() const
+{
+	return event_priority_;
+}
 
-	// еĶ
-	for (const auto& action : currActions)
-		action->Update();
+bool easy2d::Node::IsSwallowEvents() const
+{
+	return swallow_events_;
+}
 
-	// ɵĶ
-	for (auto iter = actions_.begin(); iter != actions_.end();)
-	{
-		if ((*iter)->IsDone())
-		{
-			(*iter)->Release();
-			iter = actions_.erase(iter);
-		}
-		else
-		{
-			++iter;
-		}
-	}
+bool easy2d::Node::IsParallelUpdate() const
+{
+	return parallel_update_;
 }
 
-bool easy2d::Node::IsVisible() const
+const easy2d::Time& easy2d::Node::GetTime() const
 {
-	return visible_;
+	return time_;
+}
+
+float easy2d::Node::GetTimeScale() const
+{
+	return time_scale_;
+}
+
+bool easy2d::Node::IsPaused() const
+{
+	return paused_;
 }
 
 const easy2d::String& easy2d::Node::GetName() const
@@ -426,10 +974,27 @@ void easy2d::Node::SetOrder(int order)
 	if (order_ == order)
 		return;
 
-	order_ = order;
+	// 修改的是父节点的子节点数组
+	if (parent_ && DeferCommand([=]() { this->SetOrder(order); }))
+		return;
+
 	if (parent_)
 	{
-		parent_->dirty_sort_ = true;
+		// 将节点移动到新的位置，保持子节点有序
+		parent_->EraseOrderedChild(this);
+		order_ = order;
+		parent_->InsertOrderedChild(this);
+
+		// 兄弟节点的先后顺序决定了消息的分发顺序
+		if (parent_scene_)
+		{
+			parent_scene_->transform_store_.MarkHierarchyDirty(parent_);
+			parent_scene_->dirty_listeners_ = true;
+		}
+	}
+	else
+	{
+		order_ = order;
 	}
 }
 
@@ -455,7 +1020,7 @@ void easy2d::Node::SetPosition(float x, float y)
 
 	transform_.position.x = x;
 	transform_.position.y = y;
-	dirty_transform_ = true;
+	MarkTransformDirty();
 }
 
 void easy2d::Node::MoveBy(float x, float y)
@@ -490,7 +1055,7 @@ void easy2d::Node::SetScale(float scale_x, float scale_y)
 
 	transform_.scale_x = scale_x;
 	transform_.scale_y = scale_y;
-	dirty_transform_ = true;
+	MarkTransformDirty();
 }
 
 void easy2d::Node::SetSkewX(float skew_x)
@@ -510,7 +1075,7 @@ void easy2d::Node::SetSkew(float skew_x, float skew_y)
 
 	transform_.skew_x = skew_x;
 	transform_.skew_y = skew_y;
-	dirty_transform_ = true;
+	MarkTransformDirty();
 }
 
 void easy2d::Node::SetRotation(float angle)
@@ -519,7 +1084,7 @@ void easy2d::Node::SetRotation(float angle)
 		return;
 
 	transform_.rotation = angle;
-	dirty_transform_ = true;
+	MarkTransformDirty();
 }
 
 void easy2d::Node::SetOpacity(float opacity)
@@ -527,9 +1092,8 @@ void easy2d::Node::SetOpacity(float opacity)
 	if (real_opacity_ == opacity)
 		return;
 
-	display_opacity_ = real_opacity_ = std::min(std::max(opacity, 0.f), 1.f);
-	// ½ڵ͸
-	UpdateOpacity();
+	// 显示透明度在下一次渲染时更新
+	real_opacity_ = std::min(std::max(opacity, 0.f), 1.f);
 }
 
 void easy2d::Node::SetPivotX(float pivot_x)
@@ -549,7 +1113,7 @@ void easy2d::Node::SetPivot(float pivot_x, float pivot_y)
 
 	transform_.pivot_x = pivot_x;
 	transform_.pivot_y = pivot_y;
-	dirty_transform_ = true;
+	MarkTransformDirty();
 }
 
 void easy2d::Node::SetWidth(float width)
@@ -569,7 +1133,7 @@ void easy2d::Node::SetSize(float width, float height)
 
 	transform_.size.width = width;
 	transform_.size.height = height;
-	dirty_transform_ = true;
+	MarkTransformDirty();
 }
 
 void easy2d::Node::SetSize(const Size& size)
@@ -580,7 +1144,7 @@ void easy2d::Node::SetSize(const Size& size)
 void easy2d::Node::SetTransform(const Transform & transform)
 {
 	transform_ = transform;
-	dirty_transform_ = true;
+	MarkTransformDirty();
 }
 
 void easy2d::Node::SetClipEnabled(bool enabled)
@@ -593,40 +1157,72 @@ void easy2d::Node::SetBorderColor(const Color & color)
 	border_color_ = color;
 }
 
+void easy2d::Node::SetDrawBounds(const Rect & bounds)
+{
+	draw_bounds_ = bounds;
+	has_draw_bounds_ = true;
+	MarkTransformDirty();
+}
+
+void easy2d::Node::ResetDrawBounds()
+{
+	if (!has_draw_bounds_)
+		return;
+
+	has_draw_bounds_ = false;
+	MarkTransformDirty();
+}
+
+void easy2d::Node::SetCullingEnabled(bool enabled)
+{
+	if (culling_enabled_ == enabled)
+		return;
+
+	// 重新计算所在子树的包围盒
+	culling_enabled_ = enabled;
+	MarkTransformDirty();
+}
+
+bool easy2d::Node::IsCullingEnabled() const
+{
+	return culling_enabled_;
+}
+
 void easy2d::Node::AddChild(Node * child, int order)
 {
 	E2D_WARNING_IF(child == nullptr, "Node::AddChild NULL pointer exception.");
 
+	if (child && DeferCommand([=]() { this->AddChild(child, order); }))
+		return;
+
 	if (child)
 	{
 		if (child->parent_ != nullptr)
 		{
-			throw RuntimeException("ڵиڵ, ӵڵ");
+			throw RuntimeException("节点已有父节点, 不能再添加到其他节点");
 		}
 
 		for (Node * parent = this; parent != nullptr; parent = parent->GetParent())
 		{
 			if (child == parent)
 			{
-				throw RuntimeException("һڵ㲻ͬʱһڵĸڵӽڵ");
+				throw RuntimeException("一个节点不能同时是另一个节点的父节点和子节点");
 			}
 		}
 
 		child->Retain();
-		children_.push_back(child);
 		child->SetOrder(order);
+		InsertOrderedChild(child);
 		child->parent_ = this;
+		IndexChildName(child);
 		if (this->parent_scene_)
 		{
 			child->SetParentScene(this->parent_scene_);
+			this->parent_scene_->transform_store_.MarkHierarchyDirty(this);
 		}
 
-		// ӽڵ͸
-		child->UpdateOpacity();
-		// ½ڵת
-		child->dirty_transform_ = true;
-		// ӽڵ
-		dirty_sort_ = true;
+		// 更新节点转换
+		child->MarkTransformDirty();
 	}
 }
 
@@ -651,14 +1247,14 @@ easy2d::Scene * easy2d::Node::GetParentScene() const
 easy2d::Node::Nodes easy2d::Node::GetChildren(const String& name) const
 {
 	Nodes children;
-	size_t hash = name.GetHash();
+	auto range = named_children_.equal_range(HashName(name));
 
-	for (const auto& child : children_)
+	for (auto iter = range.first; iter != range.second; ++iter)
 	{
-		// ͬƿܻͬ Hash ֵȱȽ Hash ٶ
-		if (child->hash_name_ == hash && child->name_ == name)
+		// 不同的名称可能会有相同的 Hash 值
+		if (iter->second->name_ == name)
 		{
-			children.push_back(child);
+			children.push_back(iter->second);
 		}
 	}
 	return std::move(children);
@@ -666,19 +1262,56 @@ easy2d::Node::Nodes easy2d::Node::GetChildren(const String& name) const
 
 easy2d::Node * easy2d::Node::GetChild(const String& name) const
 {
-	size_t hash = name.GetHash();
+	auto range = named_children_.equal_range(HashName(name));
 
-	for (const auto& child : children_)
+	for (auto iter = range.first; iter != range.second; ++iter)
 	{
-		// ͬƿܻͬ Hash ֵȱȽ Hash ٶ
-		if (child->hash_name_ == hash && child->name_ == name)
+		// 不同的名称可能会有相同的 Hash 值
+		if (iter->second->name_ == name)
 		{
-			return child;
+			return iter->second;
 		}
 	}
 	return nullptr;
 }
 
+easy2d::Node * easy2d::Node::Find(const String& path) const
+{
+	const wchar_t * begin = static_cast<const wchar_t*>(path);
+	const wchar_t * end = begin + path.Length();
+	const Node * node = this;
+
+	while (begin != end)
+	{
+		// 截取路径中的一段，忽略多余的分隔符
+		const wchar_t * separator = std::find(begin, end, L'/');
+		const size_t length = static_cast<size_t>(separator - begin);
+
+		if (length)
+		{
+			auto range = node->named_children_.equal_range(HashName(begin, length));
+
+			const Node * found = nullptr;
+			for (auto iter = range.first; iter != range.second; ++iter)
+			{
+				if (NameEquals(iter->second->name_, begin, length))
+				{
+					found = iter->second;
+					break;
+				}
+			}
+
+			if (!found)
+				return nullptr;
+
+			node = found;
+		}
+
+		begin = (separator == end) ? end : separator + 1;
+	}
+	return (node == this) ? nullptr : const_cast<Node*>(node);
+}
+
 const std::vector<easy2d::Node*>& easy2d::Node::GetAllChildren() const
 {
 	return children_;
@@ -708,15 +1341,19 @@ bool easy2d::Node::RemoveChild(Node * child)
 
 	if (child)
 	{
-		auto iter = std::find(children_.begin(), children_.end(), child);
-		if (iter != children_.end())
+		if (child->parent_ == this && DeferCommand([=]() { this->RemoveChild(child); }))
+			return true;
+
+		if (child->parent_ == this)
 		{
-			children_.erase(iter);
+			EraseOrderedChild(child);
+			UnindexChildName(child);
 			child->parent_ = nullptr;
 
 			if (child->parent_scene_)
 			{
 				child->SetParentScene(nullptr);
+				parent_scene_->transform_store_.MarkHierarchyDirty(this);
 			}
 
 			child->Release();
@@ -733,18 +1370,25 @@ void easy2d::Node::RemoveChildren(const String& child_name)
 		return;
 	}
 
-	size_t hash = child_name.GetHash();
-	for (auto iter = children_.begin(); iter != children_.end();)
+	if (DeferCommand([=]() { this->RemoveChildren(child_name); }))
+		return;
+
+	auto range = named_children_.equal_range(HashName(child_name));
+	for (auto iter = range.first; iter != range.second;)
 	{
-		if ((*iter)->hash_name_ == hash && (*iter)->name_ == child_name)
+		Node * child = iter->second;
+		if (child->name_ == child_name)
 		{
-			(*iter)->parent_ = nullptr;
-			if ((*iter)->parent_scene_)
+			iter = named_children_.erase(iter);
+			EraseOrderedChild(child);
+
+			child->parent_ = nullptr;
+			if (child->parent_scene_)
 			{
-				(*iter)->SetParentScene(nullptr);
+				child->SetParentScene(nullptr);
+				parent_scene_->transform_store_.MarkHierarchyDirty(this);
 			}
-			(*iter)->Release();
-			iter = children_.erase(iter);
+			child->Release();
 		}
 		else
 		{
@@ -755,36 +1399,46 @@ void easy2d::Node::RemoveChildren(const String& child_name)
 
 void easy2d::Node::RemoveAllChildren()
 {
-	// нڵüһ
+	if (DeferCommand([=]() { this->RemoveAllChildren(); }))
+		return;
+
+	// 所有节点的引用计数减一
 	for (const auto& child : children_)
 	{
+		child->parent_ = nullptr;
+		if (child->parent_scene_)
+		{
+			child->SetParentScene(nullptr);
+		}
 		child->Release();
 	}
-	// մڵ
+	// 清空储存节点的容器
 	children_.clear();
+	named_children_.clear();
+
+	if (parent_scene_)
+	{
+		parent_scene_->transform_store_.MarkHierarchyDirty(this);
+	}
 }
 
-void easy2d::Node::RunAction(Action * action)
+easy2d::RunProgram * easy2d::Node::RunAction(Action * action)
 {
 	E2D_WARNING_IF(action == nullptr, "Action NULL pointer exception!");
 
-	if (action)
-	{
-		if (action->GetTarget() == nullptr)
-		{
-			auto iter = std::find(actions_.begin(), actions_.end(), action);
-			if (iter == actions_.end())
-			{
-				action->Retain();
-				action->StartWithTarget(this);
-				actions_.push_back(action);
-			}
-		}
-		else
-		{
-			throw RuntimeException(" Action ִĿ");
-		}
-	}
+	if (action && DeferCommand([=]() { this->RunAction(action); }))
+		return nullptr;
+
+	if (!action)
+		return nullptr;
+
+	// 动作只作为定义使用，每次执行都创建新的执行状态，第一次执行与之后的执行行为相同
+	auto run = new RunProgram(action->GetProgram(), action);
+	run->Retain();
+	run->StartWithTarget(this);
+	actions_.push_back(run);
+	ActionManager::GetInstance()->Add(run);
+	return run;
 }
 
 void easy2d::Node::ResumeAction(const String& name)
@@ -836,15 +1490,25 @@ bool easy2d::Node::ContainsPoint(const Point& point)
 
 	UpdateTransform();
 
-	BOOL ret = 0;
-	ThrowIfFailed(
-		border_->FillContainsPoint(
-			D2D1::Point2F(point.x, point.y),
-			D2D1::Matrix3x2F::Identity(),
-			&ret
-		)
-	);
-	return ret != 0;
+	// 退化的轮廓与所有边的叉积都为 0，不能视为包含
+	if (IsDegenerate(border_vertices_))
+		return false;
+
+	// 点在凸四边形内时，与四条边的叉积符号相同
+	bool has_negative = false;
+	bool has_positive = false;
+	for (int i = 0; i < 4; ++i)
+	{
+		const auto& a = border_vertices_[i];
+		const auto& b = border_vertices_[(i + 1) % 4];
+		float cross = (b.x - a.x) * (point.y - a.y) - (b.y - a.y) * (point.x - a.x);
+
+		if (cross < 0)
+			has_negative = true;
+		else if (cross > 0)
+			has_positive = true;
+	}
+	return !(has_negative && has_positive);
 }
 
 bool easy2d::Node::Intersects(Node * node)
@@ -852,21 +1516,17 @@ bool easy2d::Node::Intersects(Node * node)
 	if (transform_.size.width == 0.f || transform_.size.height == 0.f || node->transform_.size.width == 0.f || node->transform_.size.height == 0.f)
 		return false;
 
-	// ת
+	// 更新转换矩阵
 	UpdateTransform();
 	node->UpdateTransform();
 
-	// ȡཻ״̬
-	D2D1_GEOMETRY_RELATION relation = D2D1_GEOMETRY_RELATION_UNKNOWN;
-	ThrowIfFailed(
-		border_->CompareWithGeometry(
-			node->border_,
-			D2D1::Matrix3x2F::Identity(),
-			&relation
-		)
-	);
-	return relation != D2D1_GEOMETRY_RELATION_UNKNOWN &&
-		relation != D2D1_GEOMETRY_RELATION_DISJOINT;
+	// 退化的轮廓无法给出分离轴
+	if (IsDegenerate(border_vertices_) || IsDegenerate(node->border_vertices_))
+		return false;
+
+	// 分离轴检测
+	return !HasSeparatingAxis(border_vertices_, node->border_vertices_) &&
+		!HasSeparatingAxis(node->border_vertices_, border_vertices_);
 }
 
 void easy2d::Node::ResumeAllActions()
@@ -902,6 +1562,12 @@ void easy2d::Node::StopAllActions()
 	}
 }
 
+easy2d::Rect easy2d::Node::GetBoundingBox()
+{
+	UpdateTransform();
+	return bounds_;
+}
+
 const easy2d::Node::Actions & easy2d::Node::GetAllActions() const
 {
 	return actions_;
@@ -909,47 +1575,54 @@ const easy2d::Node::Actions & easy2d::Node::GetAllActions() const
 
 void easy2d::Node::AddTask(Task * task)
 {
-	if (task)
+	if (task && task->target_ != this)
 	{
-		auto iter = std::find(tasks_.begin(), tasks_.end(), task);
-		if (iter == tasks_.end())
+		task->Retain();
+		task->target_ = this;
+		task->last_time_ = time_;
+		tasks_.push_back(task);
+		named_tasks_.insert(std::make_pair(HashName(task->GetName()), task));
+
+		if (task->running_)
 		{
-			task->Retain();
-			task->last_time_ = Time::Now();
-			tasks_.push_back(task);
+			ScheduleTask(task);
 		}
 	}
 }
 
 void easy2d::Node::StopTasks(const String& name)
 {
-	for (const auto& task : tasks_)
+	auto range = named_tasks_.equal_range(HashName(name));
+	for (auto iter = range.first; iter != range.second; ++iter)
 	{
-		if (task->GetName() == name)
+		if (iter->second->GetName() == name)
 		{
-			task->Stop();
+			iter->second->Stop();
 		}
 	}
 }
 
 void easy2d::Node::StartTasks(const String& name)
 {
-	for (const auto& task : tasks_)
+	auto range = named_tasks_.equal_range(HashName(name));
+	for (auto iter = range.first; iter != range.second; ++iter)
 	{
-		if (task->GetName() == name)
+		if (iter->second->GetName() == name)
 		{
-			task->Start();
+			iter->second->Start();
 		}
 	}
 }
 
 void easy2d::Node::RemoveTasks(const String& name)
 {
-	for (const auto& task : tasks_)
+	auto range = named_tasks_.equal_range(HashName(name));
+	for (auto iter = range.first; iter != range.second; ++iter)
 	{
-		if (task->GetName() == name)
+		if (iter->second->GetName() == name)
 		{
-			task->stopped_ = true;
+			iter->second->stopped_ = true;
+			dirty_tasks_ = true;
 		}
 	}
 }
@@ -976,6 +1649,7 @@ void easy2d::Node::RemoveAllTasks()
 	{
 		task->stopped_ = true;
 	}
+	dirty_tasks_ = !tasks_.empty();
 }
 
 const easy2d::Node::Tasks & easy2d::Node::GetAllTasks() const
@@ -983,30 +1657,86 @@ const easy2d::Node::Tasks & easy2d::Node::GetAllTasks() const
 	return tasks_;
 }
 
+void easy2d::Node::ScheduleTask(Task * task)
+{
+	// 旧的队列项不立即删除，出队时根据序号跳过
+	TaskEntry entry = { task->GetNextTime(), ++task->schedule_id_, task };
+	task_queue_.push_back(entry);
+	std::push_heap(task_queue_.begin(), task_queue_.end(), LaterTask<TaskEntry>);
+}
+
 void easy2d::Node::UpdateTasks()
 {
-	if (tasks_.empty())
-		return;
+	if (!task_queue_.empty())
+	{
+		// 先取出所有到期的任务再执行，间隔为零的任务每帧只执行一次
+		// 到期列表保留容量重复使用，避免每帧分配内存
+		due_tasks_.clear();
+		while (!task_queue_.empty() && time_ - task_queue_.front().time >= Duration())
+		{
+			std::pop_heap(task_queue_.begin(), task_queue_.end(), LaterTask<TaskEntry>);
+			due_tasks_.push_back(task_queue_.back());
+			task_queue_.pop_back();
+		}
 
-	std::vector<Task*> currTasks;
-	currTasks.reserve(tasks_.size());
-	std::copy_if(
-		tasks_.begin(),
-		tasks_.end(),
-		std::back_inserter(currTasks),
-		[](Task* task) { return task->IsReady() && !task->stopped_; }
-	);
+		for (size_t i = 0; i < due_tasks_.size(); ++i)
+		{
+			const TaskEntry entry = due_tasks_[i];
+			Task * task = entry.task;
+			if (entry.serial != task->schedule_id_ || !task->running_ || task->stopped_)
+				continue;
+
+			task->Update();
+
+			if (task->stopped_)
+			{
+				dirty_tasks_ = true;
+			}
+			else if (entry.serial == task->schedule_id_ && task->running_)
+			{
+				ScheduleTask(task);
+			}
+		}
+	}
+
+	if (dirty_tasks_)
+	{
+		RemoveStoppedTasks();
+	}
+}
+
+void easy2d::Node::RemoveStoppedTasks()
+{
+	dirty_tasks_ = false;
 
-	// 
-	for (const auto& task : currTasks)
-		task->Update();
+	// 先移出任务队列，防止队列中留下已释放的任务
+	task_queue_.erase(
+		std::remove_if(
+			task_queue_.begin(),
+			task_queue_.end(),
+			[](const TaskEntry& entry) { return entry.task->stopped_; }
+		),
+		task_queue_.end()
+	);
+	std::make_heap(task_queue_.begin(), task_queue_.end(), LaterTask<TaskEntry>);
 
-	// 
 	for (auto iter = tasks_.begin(); iter != tasks_.end();)
 	{
-		if ((*iter)->stopped_)
+		Task * task = *iter;
+		if (task->stopped_)
 		{
-			(*iter)->Release();
+			auto range = named_tasks_.equal_range(HashName(task->GetName()));
+			for (auto name_iter = range.first; name_iter != range.second; ++name_iter)
+			{
+				if (name_iter->second == task)
+				{
+					named_tasks_.erase(name_iter);
+					break;
+				}
+			}
+
+			task->target_ = nullptr;
+			task->Release();
 			iter = tasks_.erase(iter);
 		}
 		else
@@ -1016,6 +1746,32 @@ void easy2d::Node::UpdateTasks()
 	}
 }
 
+void easy2d::Node::RunAsync(const Function& job, const Function& on_complete)
+{
+	auto queue = Device::GetAsyncQueue();
+	if (!queue)
+	{
+		E2D_WARNING("Async queue is not initialized!");
+		return;
+	}
+
+	// 同一节点的任务共享取消标记，取消后为之后的任务创建新的标记
+	if (!async_token_)
+	{
+		async_token_ = std::make_shared<std::atomic<bool>>(false);
+	}
+	queue->Submit(job, on_complete, async_token_);
+}
+
+void easy2d::Node::CancelAsync()
+{
+	if (async_token_)
+	{
+		async_token_->store(true);
+		async_token_.reset();
+	}
+}
+
 void easy2d::Node::UpdateTime()
 {
 	for (const auto& action : actions_)
@@ -1023,6 +1779,8 @@ void easy2d::Node::UpdateTime()
 		action->ResetTime();
 	}
 
+	// 所有任务都会重新入队，旧的队列项可以直接丢弃
+	task_queue_.clear();
 	for (const auto& task : tasks_)
 	{
 		task->ResetTime();
@@ -1039,22 +1797,90 @@ void easy2d::Node::SetVisible(bool value)
 	visible_ = value;
 }
 
+void easy2d::Node::SetEventPriority(int priority)
+{
+	if (event_priority_ == priority)
+		return;
+
+	event_priority_ = priority;
+	if (parent_scene_)
+	{
+		parent_scene_->dirty_listeners_ = true;
+	}
+}
+
+void easy2d::Node::SetSwallowEvents(bool swallow)
+{
+	swallow_events_ = swallow;
+}
+
+void easy2d::Node::SetParallelUpdate(bool enabled)
+{
+	parallel_update_ = enabled;
+}
+
+void easy2d::Node::SetTimeScale(float scale)
+{
+	time_scale_ = std::max(scale, 0.f);
+}
+
+void easy2d::Node::SetPaused(bool paused)
+{
+	paused_ = paused;
+}
+
 void easy2d::Node::SetName(const String& name)
 {
 	E2D_WARNING_IF(name.IsEmpty(), "Invalid Node name.");
 
+	// 修改的是父节点的名称索引
+	if (parent_ && DeferCommand([=]() { this->SetName(name); }))
+		return;
+
 	if (!name.IsEmpty() && name_ != name)
 	{
-		// ڵ
+		if (parent_)
+		{
+			parent_->UnindexChildName(this);
+		}
+
+		// 保存节点名
 		name_ = name;
-		// ڵ Hash 
+		// 保存节点 Hash 名
 		hash_name_ = name.GetHash();
+		name_key_ = HashName(name);
+
+		if (parent_)
+		{
+			parent_->IndexChildName(this);
+		}
 	}
 }
 
 void easy2d::Node::SetParentScene(Scene * scene)
 {
-	parent_scene_ = scene;
+	if (parent_scene_ != scene)
+	{
+		// 父节点负责标记变换缓存，这里只让节点脱离缓存
+		if (parent_scene_)
+		{
+			// 节点离开场景时取消未完成的异步任务
+			CancelAsync();
+
+			parent_scene_->RemoveProxy(this);
+			parent_scene_->RemoveListener(this);
+			parent_scene_->transform_store_.Forget(this);
+		}
+
+		parent_scene_ = scene;
+		transform_index_ = -1;
+
+		if (scene)
+		{
+			scene->AddListener(this);
+		}
+	}
+
 	for (const auto& child : children_)
 	{
 		child->SetParentScene(scene);
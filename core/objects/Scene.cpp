@@ -18,29 +18,70 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dmodule.h"
-#include "..\e2dobject.h"
+#include "../e2dmodule.h"
+#include "../e2dobject.h"
+
+namespace
+{
+	// 判断节点自身或任意父节点是否不可见
+	bool IsHidden(easy2d::Node * node)
+	{
+		for (; node != nullptr; node = node->GetParent())
+		{
+			if (!node->IsVisible())
+				return true;
+		}
+		return false;
+	}
+}
 
 easy2d::Scene::Scene()
 	: root_(nullptr)
+	, visited_count_(0)
+	, culled_count_(0)
+	, drawn_count_(0)
+	, cull_rect_()
 	, transform_(D2D1::Matrix3x2F::Identity())
+	, spatial_index_(nullptr)
+	, dirty_listeners_(false)
+	, removed_listeners_(false)
+	, dispatch_depth_(0)
 {
 }
 
 easy2d::Scene::Scene(Node * root)
 	: root_(nullptr)
+	, visited_count_(0)
+	, culled_count_(0)
+	, drawn_count_(0)
+	, cull_rect_()
 	, transform_(D2D1::Matrix3x2F::Identity())
+	, spatial_index_(nullptr)
+	, dirty_listeners_(false)
+	, removed_listeners_(false)
+	, dispatch_depth_(0)
 {
 	this->SetRoot(root);
 }
 
 easy2d::Scene::~Scene()
 {
+	for (auto node : hovered_nodes_)
+	{
+		node->Release();
+	}
+
 	if (root_)
 	{
 		root_->SetParentScene(nullptr);
 		root_->Release();
 	}
+
+	if (spatial_index_)
+	{
+		delete spatial_index_;
+		spatial_index_ = nullptr;
+	}
 }
 
 void easy2d::Scene::SetRoot(Node * root)
@@ -61,6 +102,7 @@ void easy2d::Scene::SetRoot(Node * root)
 	}
 
 	root_ = root;
+	transform_store_.MarkHierarchyDirty();
 }
 
 easy2d::Node * easy2d::Scene::GetRoot() const
@@ -69,10 +111,34 @@ easy2d::Node * easy2d::Scene::GetRoot() const
 }
 
 void easy2d::Scene::Draw()
+{
+#if !E2D_HEADLESS
+	if (root_)
+	{
+		auto graphics = Device::GetGraphics();
+		auto size = graphics->GetRenderTarget()->GetSize();
+
+		auto& commands = graphics->GetCommandList();
+		commands.Clear();
+		Draw(commands, Size(size.width, size.height));
+		graphics->Replay(commands);
+	}
+#endif
+}
+
+void easy2d::Scene::Draw(RenderCommandList & commands, const Size & view_size)
 {
 	if (root_)
 	{
-		root_->Visit();
+		UpdateTransform();
+		visited_count_ = 0;
+		culled_count_ = 0;
+		drawn_count_ = 0;
+
+		// 可见区域为整个视口
+		cull_rect_ = Rect(Point(), view_size);
+
+		root_->Visit(commands);
 	}
 }
 
@@ -84,10 +150,28 @@ void easy2d::Scene::Dispatch(const MouseEvent & e)
 		handler->Handle(e);
 	}
 
-	if (root_)
+	if (spatial_index_)
+	{
+		DispatchToHits(e);
+		return;
+	}
+
+	SortListeners();
+
+	// 消息处理过程中移除的节点只清空位置并保留到分发结束，新加入的节点不接收本次消息
+	++dispatch_depth_;
+	bool handled = false;
+	for (size_t i = 0, count = mouse_listeners_.size(); i < count; ++i)
 	{
-		root_->Dispatch(e, false);
+		Node * node = mouse_listeners_[i];
+		if (!node || IsHidden(node))
+			continue;
+
+		handled = node->OnMouseEvent(e, handled);
+		if (handled && node->swallow_events_)
+			break;
 	}
+	EndDispatch();
 }
 
 void easy2d::Scene::Dispatch(const KeyEvent & e)
@@ -98,23 +182,337 @@ void easy2d::Scene::Dispatch(const KeyEvent & e)
 		handler->Handle(e);
 	}
 
-	if (root_)
+	SortListeners();
+
+	// 消息处理过程中移除的节点只清空位置并保留到分发结束，新加入的节点不接收本次消息
+	++dispatch_depth_;
+	bool handled = false;
+	for (size_t i = 0, count = key_listeners_.size(); i < count; ++i)
 	{
-		root_->Dispatch(e, false);
+		Node * node = key_listeners_[i];
+		if (!node || IsHidden(node))
+			continue;
+
+		handled = node->OnKeyEvent(e, handled);
+		if (handled && node->swallow_events_)
+			break;
 	}
+	EndDispatch();
 }
 
 void easy2d::Scene::SetTransform(const D2D1::Matrix3x2F& matrix)
 {
 	transform_ = matrix;
+	transform_store_.MarkRootDirty();
+}
 
-	if (root_)
+const D2D1::Matrix3x2F & easy2d::Scene::GetTransform() const
+{
+	return transform_;
+}
+
+void easy2d::Scene::UpdateTransform()
+{
+	transform_store_.Update(root_, transform_);
+}
+
+void easy2d::Scene::SetSpatialIndexEnabled(bool enabled)
+{
+	if (enabled == (spatial_index_ != nullptr))
+		return;
+
+	if (enabled)
+	{
+		spatial_index_ = new SpatialIndex();
+		// 重新计算所有节点的转换，同时将节点加入空间索引
+		transform_store_.MarkRootDirty();
+	}
+	else
 	{
-		root_->dirty_transform_ = true;
+		ClearProxies(root_);
+		delete spatial_index_;
+		spatial_index_ = nullptr;
+
+		for (auto node : hovered_nodes_)
+		{
+			node->Release();
+		}
+		hovered_nodes_.clear();
 	}
 }
 
-const D2D1::Matrix3x2F & easy2d::Scene::GetTransform() const
+bool easy2d::Scene::IsSpatialIndexEnabled() const
 {
-	return transform_;
+	return spatial_index_ != nullptr;
+}
+
+easy2d::SpatialIndex * easy2d::Scene::GetSpatialIndex()
+{
+	if (spatial_index_)
+	{
+		UpdateTransform();
+	}
+	return spatial_index_;
+}
+
+int easy2d::Scene::GetVisitedCount() const
+{
+	return visited_count_;
+}
+
+int easy2d::Scene::GetCulledCount() const
+{
+	return culled_count_;
+}
+
+int easy2d::Scene::GetDrawnCount() const
+{
+	return drawn_count_;
+}
+
+void easy2d::Scene::UpdateProxy(Node * node)
+{
+	if (!spatial_index_)
+		return;
+
+	const Size& size = node->transform_.size;
+	if (size.width == 0.f || size.height == 0.f)
+	{
+		RemoveProxy(node);
+		return;
+	}
+
+	if (node->proxy_id_ == -1)
+	{
+		node->proxy_id_ = spatial_index_->Insert(node, node->bounds_);
+	}
+	else
+	{
+		spatial_index_->Move(node->proxy_id_, node->bounds_);
+	}
+}
+
+void easy2d::Scene::RemoveProxy(Node * node)
+{
+	if (spatial_index_ && node->proxy_id_ != -1)
+	{
+		spatial_index_->Remove(node->proxy_id_);
+	}
+	node->proxy_id_ = -1;
+}
+
+void easy2d::Scene::ClearProxies(Node * node)
+{
+	if (!node)
+		return;
+
+	node->proxy_id_ = -1;
+	for (const auto& child : node->children_)
+	{
+		ClearProxies(child);
+	}
+}
+
+void easy2d::Scene::DispatchToHits(const MouseEvent & e)
+{
+	UpdateTransform();
+
+	const Point point = e.GetPosition();
+
+	mouse_hits_.clear();
+	spatial_index_->QueryPoint(point, mouse_hits_);
+
+	// 过滤掉不接收鼠标消息和不在光标下的节点，但上一次在光标下的节点仍需收到消息以处理鼠标移出
+	auto is_hovered = [this](Node * node)
+	{
+		return std::find(hovered_nodes_.begin(), hovered_nodes_.end(), node) != hovered_nodes_.end();
+	};
+
+	mouse_hits_.erase(
+		std::remove_if(
+			mouse_hits_.begin(),
+			mouse_hits_.end(),
+			[&](Node * node) { return node->mouse_listener_index_ < 0 || (!is_hovered(node) && !node->ContainsPoint(point)); }
+		),
+		mouse_hits_.end()
+	);
+
+	for (auto node : hovered_nodes_)
+	{
+		if (node->parent_scene_ == this &&
+			std::find(mouse_hits_.begin(), mouse_hits_.end(), node) == mouse_hits_.end())
+		{
+			mouse_hits_.push_back(node);
+		}
+	}
+
+	// 只有自身及所有父节点都可见的节点才能收到消息
+	mouse_hits_.erase(
+		std::remove_if(mouse_hits_.begin(), mouse_hits_.end(), IsHidden),
+		mouse_hits_.end()
+	);
+
+	// 优先级高的节点先收到消息，优先级相同时按深度优先顺序倒序分发
+	std::sort(
+		mouse_hits_.begin(),
+		mouse_hits_.end(),
+		[](Node * n1, Node * n2)
+		{
+			if (n1->event_priority_ != n2->event_priority_)
+				return n1->event_priority_ > n2->event_priority_;
+			return n1->transform_index_ > n2->transform_index_;
+		}
+	);
+
+	// 消息处理过程中节点可能被移除
+	for (auto node : mouse_hits_)
+	{
+		node->Retain();
+	}
+
+	for (auto node : hovered_nodes_)
+	{
+		node->Release();
+	}
+	hovered_nodes_.clear();
+
+	bool handled = false;
+	for (auto node : mouse_hits_)
+	{
+		handled = node->OnMouseEvent(e, handled);
+		if (handled && node->swallow_events_)
+			break;
+	}
+
+	for (auto node : mouse_hits_)
+	{
+		if (node->parent_scene_ == this && node->ContainsPoint(point))
+		{
+			node->Retain();
+			hovered_nodes_.push_back(node);
+		}
+		node->Release();
+	}
+}
+
+void easy2d::Scene::AddListener(Node * node)
+{
+	if (node->IsMouseListener())
+	{
+		node->mouse_listener_index_ = static_cast<int>(mouse_listeners_.size());
+		mouse_listeners_.push_back(node);
+		dirty_listeners_ = true;
+	}
+
+	if (node->IsKeyListener())
+	{
+		node->key_listener_index_ = static_cast<int>(key_listeners_.size());
+		key_listeners_.push_back(node);
+		dirty_listeners_ = true;
+	}
+}
+
+void easy2d::Scene::RemoveListener(Node * node)
+{
+	// 与最后一个节点交换后删除，监听数组在下次分发消息前重新排序
+	auto remove = [this](Node::Nodes& listeners, int Node::* index_of, Node * node)
+	{
+		const int index = node->*index_of;
+		if (index < 0)
+			return;
+
+		if (dispatch_depth_ > 0)
+		{
+			// 正在分发消息，分发结束后再删除
+			listeners[index] = nullptr;
+			removed_listeners_ = true;
+		}
+		else
+		{
+			Node * last = listeners.back();
+			listeners[index] = last;
+			last->*index_of = index;
+			listeners.pop_back();
+		}
+
+		node->*index_of = -1;
+		dirty_listeners_ = true;
+	};
+
+	// 分发消息时被移除的节点可能正在处理消息，保留到分发结束
+	// 节点析构时引用计数已经为零，不需要保留
+	if (dispatch_depth_ > 0 && node->GetRefCount() > 0 &&
+		(node->mouse_listener_index_ >= 0 || node->key_listener_index_ >= 0))
+	{
+		node->Retain();
+		removed_nodes_.push_back(node);
+	}
+
+	remove(mouse_listeners_, &Node::mouse_listener_index_, node);
+	remove(key_listeners_, &Node::key_listener_index_, node);
+}
+
+void easy2d::Scene::EndDispatch()
+{
+	if (--dispatch_depth_ > 0 || !removed_listeners_)
+		return;
+
+	// 删除分发期间移除的节点留下的空位
+	auto compact = [](Node::Nodes& listeners, int Node::* index_of)
+	{
+		listeners.erase(
+			std::remove(listeners.begin(), listeners.end(), nullptr),
+			listeners.end()
+		);
+
+		for (size_t i = 0; i < listeners.size(); ++i)
+		{
+			listeners[i]->*index_of = static_cast<int>(i);
+		}
+	};
+
+	compact(mouse_listeners_, &Node::mouse_listener_index_);
+	compact(key_listeners_, &Node::key_listener_index_);
+	removed_listeners_ = false;
+
+	// 释放节点时可能触发新的移除，先交换出数组
+	Node::Nodes removed;
+	removed.swap(removed_nodes_);
+	for (auto node : removed)
+	{
+		node->Release();
+	}
+}
+
+void easy2d::Scene::SortListeners()
+{
+	// 节点的深度优先序号由变换缓存维护，层级改变后在这里更新
+	UpdateTransform();
+
+	// 分发消息时不能改变监听数组的顺序
+	if (!dirty_listeners_ || dispatch_depth_ > 0)
+		return;
+
+	// 优先级高的节点先收到消息，优先级相同时按深度优先顺序倒序分发
+	// 即子节点先于父节点、后面的兄弟节点先于前面的兄弟节点
+	auto compare = [](Node * n1, Node * n2)
+	{
+		if (n1->event_priority_ != n2->event_priority_)
+			return n1->event_priority_ > n2->event_priority_;
+		return n1->transform_index_ > n2->transform_index_;
+	};
+
+	std::sort(mouse_listeners_.begin(), mouse_listeners_.end(), compare);
+	std::sort(key_listeners_.begin(), key_listeners_.end(), compare);
+
+	for (size_t i = 0; i < mouse_listeners_.size(); ++i)
+	{
+		mouse_listeners_[i]->mouse_listener_index_ = static_cast<int>(i);
+	}
+
+	for (size_t i = 0; i < key_listeners_.size(); ++i)
+	{
+		key_listeners_[i]->key_listener_index_ = static_cast<int>(i);
+	}
+	dirty_listeners_ = false;
 }
@@ -0,0 +1,498 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "../e2dobject.h"
+
+
+namespace
+{
+	// 叶节点包围盒的扩展量，节点小幅移动时无需调整树结构
+	const float kBoundsMargin = 4.f;
+}
+
+
+easy2d::SpatialIndex::SpatialIndex()
+	: root_(-1)
+	, free_list_(-1)
+	, count_(0)
+{
+}
+
+int easy2d::SpatialIndex::Insert(Node * node, const Rect& bounds)
+{
+	int leaf = AllocateNode();
+	auto& tree_node = nodes_[leaf];
+	tree_node.min_x = bounds.origin.x - kBoundsMargin;
+	tree_node.min_y = bounds.origin.y - kBoundsMargin;
+	tree_node.max_x = bounds.origin.x + bounds.size.width + kBoundsMargin;
+	tree_node.max_y = bounds.origin.y + bounds.size.height + kBoundsMargin;
+	tree_node.node = node;
+	tree_node.height = 0;
+
+	InsertLeaf(leaf);
+	++count_;
+	return leaf;
+}
+
+void easy2d::SpatialIndex::Remove(int proxy)
+{
+	if (proxy < 0 || static_cast<size_t>(proxy) >= nodes_.size() || nodes_[proxy].height < 0)
+		return;
+
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+	--count_;
+}
+
+void easy2d::SpatialIndex::Move(int proxy, const Rect& bounds)
+{
+	if (proxy < 0 || static_cast<size_t>(proxy) >= nodes_.size() || nodes_[proxy].height < 0)
+		return;
+
+	auto& tree_node = nodes_[proxy];
+	float min_x = bounds.origin.x;
+	float min_y = bounds.origin.y;
+	float max_x = bounds.origin.x + bounds.size.width;
+	float max_y = bounds.origin.y + bounds.size.height;
+
+	// 仍在扩展后的包围盒内时不需要更新
+	if (tree_node.min_x <= min_x && tree_node.min_y <= min_y &&
+		max_x <= tree_node.max_x && max_y <= tree_node.max_y)
+	{
+		return;
+	}
+
+	RemoveLeaf(proxy);
+
+	tree_node.min_x = min_x - kBoundsMargin;
+	tree_node.min_y = min_y - kBoundsMargin;
+	tree_node.max_x = max_x + kBoundsMargin;
+	tree_node.max_y = max_y + kBoundsMargin;
+
+	InsertLeaf(proxy);
+}
+
+void easy2d::SpatialIndex::Clear()
+{
+	nodes_.clear();
+	root_ = -1;
+	free_list_ = -1;
+	count_ = 0;
+}
+
+size_t easy2d::SpatialIndex::GetCount() const
+{
+	return count_;
+}
+
+void easy2d::SpatialIndex::QueryPoint(const Point & point, std::vector<Node*>& result) const
+{
+	if (root_ == -1)
+		return;
+
+	stack_.clear();
+	stack_.push_back(root_);
+
+	while (!stack_.empty())
+	{
+		const auto& tree_node = nodes_[stack_.back()];
+		stack_.pop_back();
+
+		if (point.x < tree_node.min_x || point.x > tree_node.max_x ||
+			point.y < tree_node.min_y || point.y > tree_node.max_y)
+		{
+			continue;
+		}
+
+		if (tree_node.IsLeaf())
+		{
+			result.push_back(tree_node.node);
+		}
+		else
+		{
+			stack_.push_back(tree_node.left);
+			stack_.push_back(tree_node.right);
+		}
+	}
+}
+
+void easy2d::SpatialIndex::QueryRect(const Rect & rect, std::vector<Node*>& result) const
+{
+	if (root_ == -1)
+		return;
+
+	float min_x = rect.origin.x;
+	float min_y = rect.origin.y;
+	float max_x = rect.origin.x + rect.size.width;
+	float max_y = rect.origin.y + rect.size.height;
+
+	stack_.clear();
+	stack_.push_back(root_);
+
+	while (!stack_.empty())
+	{
+		const auto& tree_node = nodes_[stack_.back()];
+		stack_.pop_back();
+
+		if (max_x < tree_node.min_x || tree_node.max_x < min_x ||
+			max_y < tree_node.min_y || tree_node.max_y < min_y)
+		{
+			continue;
+		}
+
+		if (tree_node.IsLeaf())
+		{
+			result.push_back(tree_node.node);
+		}
+		else
+		{
+			stack_.push_back(tree_node.left);
+			stack_.push_back(tree_node.right);
+		}
+	}
+}
+
+void easy2d::SpatialIndex::QueryRay(const Point & origin, const Point & direction, float max_distance, std::vector<Node*>& result) const
+{
+	if (root_ == -1)
+		return;
+
+	float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+	if (length == 0.f)
+		return;
+
+	float dir_x = direction.x / length;
+	float dir_y = direction.y / length;
+
+	stack_.clear();
+	stack_.push_back(root_);
+
+	while (!stack_.empty())
+	{
+		const auto& tree_node = nodes_[stack_.back()];
+		stack_.pop_back();
+
+		// 射线与包围盒的 Slab 检测
+		float t_min = 0.f;
+		float t_max = max_distance;
+		bool hit = true;
+
+		const float origins[2] = { origin.x, origin.y };
+		const float dirs[2] = { dir_x, dir_y };
+		const float mins[2] = { tree_node.min_x, tree_node.min_y };
+		const float maxs[2] = { tree_node.max_x, tree_node.max_y };
+
+		for (int i = 0; i < 2 && hit; ++i)
+		{
+			if (dirs[i] == 0.f)
+			{
+				hit = (origins[i] >= mins[i] && origins[i] <= maxs[i]);
+			}
+			else
+			{
+				float t1 = (mins[i] - origins[i]) / dirs[i];
+				float t2 = (maxs[i] - origins[i]) / dirs[i];
+				t_min = std::max(t_min, std::min(t1, t2));
+				t_max = std::min(t_max, std::max(t1, t2));
+				hit = (t_min <= t_max);
+			}
+		}
+
+		if (!hit)
+			continue;
+
+		if (tree_node.IsLeaf())
+		{
+			result.push_back(tree_node.node);
+		}
+		else
+		{
+			stack_.push_back(tree_node.left);
+			stack_.push_back(tree_node.right);
+		}
+	}
+}
+
+int easy2d::SpatialIndex::AllocateNode()
+{
+	int index;
+	if (free_list_ != -1)
+	{
+		index = free_list_;
+		free_list_ = nodes_[index].parent;
+	}
+	else
+	{
+		index = static_cast<int>(nodes_.size());
+		nodes_.push_back(TreeNode());
+	}
+
+	auto& tree_node = nodes_[index];
+	tree_node.node = nullptr;
+	tree_node.parent = -1;
+	tree_node.left = -1;
+	tree_node.right = -1;
+	tree_node.height = 0;
+	return index;
+}
+
+void easy2d::SpatialIndex::FreeNode(int index)
+{
+	nodes_[index].node = nullptr;
+	nodes_[index].height = -1;
+	nodes_[index].parent = free_list_;
+	free_list_ = index;
+}
+
+void easy2d::SpatialIndex::InsertLeaf(int leaf)
+{
+	if (root_ == -1)
+	{
+		root_ = leaf;
+		nodes_[root_].parent = -1;
+		return;
+	}
+
+	// 按周长代价寻找最合适的兄弟节点
+	const TreeNode leaf_node = nodes_[leaf];
+	int index = root_;
+	while (!nodes_[index].IsLeaf())
+	{
+		const auto& tree_node = nodes_[index];
+		int left = tree_node.left;
+		int right = tree_node.right;
+
+		float perimeter = Perimeter(tree_node);
+		float combined = Perimeter(Combine(tree_node, leaf_node));
+
+		// 在此处创建新的父节点的代价
+		float cost = 2.f * combined;
+		// 继续向下时需要承担的包围盒增长代价
+		float inheritance = 2.f * (combined - perimeter);
+
+		auto child_cost = [&](int child) -> float
+		{
+			const auto& child_node = nodes_[child];
+			float new_perimeter = Perimeter(Combine(child_node, leaf_node));
+			if (child_node.IsLeaf())
+				return new_perimeter + inheritance;
+			return (new_perimeter - Perimeter(child_node)) + inheritance;
+		};
+
+		float cost_left = child_cost(left);
+		float cost_right = child_cost(right);
+
+		if (cost < cost_left && cost < cost_right)
+			break;
+
+		index = (cost_left < cost_right) ? left : right;
+	}
+
+	int sibling = index;
+	int old_parent = nodes_[sibling].parent;
+	int new_parent = AllocateNode();
+
+	TreeNode combined = Combine(nodes_[sibling], leaf_node);
+	auto& parent_node = nodes_[new_parent];
+	parent_node.min_x = combined.min_x;
+	parent_node.min_y = combined.min_y;
+	parent_node.max_x = combined.max_x;
+	parent_node.max_y = combined.max_y;
+	parent_node.parent = old_parent;
+	parent_node.left = sibling;
+	parent_node.right = leaf;
+	parent_node.height = nodes_[sibling].height + 1;
+
+	if (old_parent != -1)
+	{
+		if (nodes_[old_parent].left == sibling)
+			nodes_[old_parent].left = new_parent;
+		else
+			nodes_[old_parent].right = new_parent;
+	}
+	else
+	{
+		root_ = new_parent;
+	}
+
+	nodes_[sibling].parent = new_parent;
+	nodes_[leaf].parent = new_parent;
+
+	Refit(nodes_[leaf].parent);
+}
+
+void easy2d::SpatialIndex::RemoveLeaf(int leaf)
+{
+	if (leaf == root_)
+	{
+		root_ = -1;
+		return;
+	}
+
+	int parent = nodes_[leaf].parent;
+	int grand_parent = nodes_[parent].parent;
+	int sibling = (nodes_[parent].left == leaf) ? nodes_[parent].right : nodes_[parent].left;
+
+	if (grand_parent != -1)
+	{
+		// 用兄弟节点替换父节点
+		if (nodes_[grand_parent].left == parent)
+			nodes_[grand_parent].left = sibling;
+		else
+			nodes_[grand_parent].right = sibling;
+
+		nodes_[sibling].parent = grand_parent;
+		FreeNode(parent);
+
+		Refit(grand_parent);
+	}
+	else
+	{
+		root_ = sibling;
+		nodes_[sibling].parent = -1;
+		FreeNode(parent);
+	}
+}
+
+void easy2d::SpatialIndex::Refit(int index)
+{
+	// 自下而上平衡并更新包围盒
+	while (index != -1)
+	{
+		index = Balance(index);
+
+		auto& tree_node = nodes_[index];
+		const auto& left = nodes_[tree_node.left];
+		const auto& right = nodes_[tree_node.right];
+
+		tree_node.height = 1 + std::max(left.height, right.height);
+		tree_node.min_x = std::min(left.min_x, right.min_x);
+		tree_node.min_y = std::min(left.min_y, right.min_y);
+		tree_node.max_x = std::max(left.max_x, right.max_x);
+		tree_node.max_y = std::max(left.max_y, right.max_y);
+
+		index = tree_node.parent;
+	}
+}
+
+int easy2d::SpatialIndex::Balance(int index_a)
+{
+	TreeNode * a = &nodes_[index_a];
+	if (a->IsLeaf() || a->height < 2)
+		return index_a;
+
+	int index_b = a->left;
+	int index_c = a->right;
+	int balance = nodes_[index_c].height - nodes_[index_b].height;
+
+	// 右子树过高时将 C 提升
+	if (balance > 1)
+	{
+		return Rotate(index_a, index_c, index_b);
+	}
+
+	// 左子树过高时将 B 提升
+	if (balance < -1)
+	{
+		return Rotate(index_a, index_b, index_c);
+	}
+
+	return index_a;
+}
+
+int easy2d::SpatialIndex::Rotate(int index_a, int index_up, int index_other)
+{
+	// index_up 为 A 较高的子节点，将其提升为 A 的父节点
+	TreeNode * a = &nodes_[index_a];
+	TreeNode * up = &nodes_[index_up];
+	TreeNode * other = &nodes_[index_other];
+
+	int index_f = up->left;
+	int index_g = up->right;
+	TreeNode * f = &nodes_[index_f];
+	TreeNode * g = &nodes_[index_g];
+
+	up->left = index_a;
+	up->parent = a->parent;
+	a->parent = index_up;
+
+	if (up->parent != -1)
+	{
+		if (nodes_[up->parent].left == index_a)
+			nodes_[up->parent].left = index_up;
+		else
+			nodes_[up->parent].right = index_up;
+	}
+	else
+	{
+		root_ = index_up;
+	}
+
+	// 较高的孙节点留在 up 下，较矮的交给 A
+	int index_keep = index_f;
+	int index_give = index_g;
+	if (f->height <= g->height)
+	{
+		index_keep = index_g;
+		index_give = index_f;
+	}
+
+	TreeNode * keep = &nodes_[index_keep];
+	TreeNode * give = &nodes_[index_give];
+
+	up->right = index_keep;
+	if (a->left == index_up)
+		a->left = index_give;
+	else
+		a->right = index_give;
+	give->parent = index_a;
+
+	TreeNode combined_a = Combine(*other, *give);
+	a->min_x = combined_a.min_x;
+	a->min_y = combined_a.min_y;
+	a->max_x = combined_a.max_x;
+	a->max_y = combined_a.max_y;
+	a->height = 1 + std::max(other->height, give->height);
+
+	TreeNode combined_up = Combine(*a, *keep);
+	up->min_x = combined_up.min_x;
+	up->min_y = combined_up.min_y;
+	up->max_x = combined_up.max_x;
+	up->max_y = combined_up.max_y;
+	up->height = 1 + std::max(a->height, keep->height);
+
+	return index_up;
+}
+
+easy2d::SpatialIndex::TreeNode easy2d::SpatialIndex::Combine(const TreeNode & a, const TreeNode & b)
+{
+	TreeNode result = a;
+	result.min_x = std::min(a.min_x, b.min_x);
+	result.min_y = std::min(a.min_y, b.min_y);
+	result.max_x = std::max(a.max_x, b.max_x);
+	result.max_y = std::max(a.max_y, b.max_y);
+	return result;
+}
+
+float easy2d::SpatialIndex::Perimeter(const TreeNode & node)
+{
+	return 2.f * ((node.max_x - node.min_x) + (node.max_y - node.min_y));
+}
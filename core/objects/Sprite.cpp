@@ -18,29 +18,33 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dobject.h"
-#include "..\e2dmodule.h"
+#include "../e2dobject.h"
+#include "../e2dmodule.h"
 
 easy2d::Sprite::Sprite()
 	: image_(nullptr)
 {
+	SetCustomDraw(false);
 }
 
 easy2d::Sprite::Sprite(Image * image)
 	: image_(nullptr)
 {
+	SetCustomDraw(false);
 	Load(image);
 }
 
 easy2d::Sprite::Sprite(const Resource& res)
 	: image_(nullptr)
 {
+	SetCustomDraw(false);
 	Load(res);
 }
 
 easy2d::Sprite::Sprite(const Resource& res, const Rect& crop_rect)
 	: image_(nullptr)
 {
+	SetCustomDraw(false);
 	Load(res);
 	Crop(crop_rect);
 }
@@ -48,12 +52,14 @@ easy2d::Sprite::Sprite(const Resource& res, const Rect& crop_rect)
 easy2d::Sprite::Sprite(const String & file_name)
 	: image_(nullptr)
 {
+	SetCustomDraw(false);
 	Load(file_name);
 }
 
 easy2d::Sprite::Sprite(const String & file_name, const Rect & crop_rect)
 	: image_(nullptr)
 {
+	SetCustomDraw(false);
 	Load(file_name);
 	Crop(crop_rect);
 }
@@ -113,6 +119,34 @@ bool easy2d::Sprite::Load(const String & file_name)
 	return false;
 }
 
+void easy2d::Sprite::LoadAsync(const String & file_name, const Function & on_loaded)
+{
+	if (!image_)
+	{
+		image_ = new Image();
+		image_->Retain();
+	}
+
+	// 加载完成前保持精灵不被释放
+	Retain();
+	Sprite * sprite = this;
+	Image * image = image_;
+	image_->LoadAsync(file_name, [=]()
+	{
+		// 加载期间精灵可能换了图片
+		if (sprite->image_ == image)
+		{
+			sprite->Node::SetSize(image->GetWidth(), image->GetHeight());
+		}
+
+		if (on_loaded)
+		{
+			on_loaded();
+		}
+		sprite->Release();
+	});
+}
+
 void easy2d::Sprite::Crop(const Rect& crop_rect)
 {
 	image_->Crop(crop_rect);
@@ -128,21 +162,46 @@ easy2d::Image * easy2d::Sprite::GetImage() const
 }
 
 void easy2d::Sprite::Draw() const
+{
+	// 立即回放精灵的绘制命令
+	RenderCommandList commands;
+	RecordImage(commands);
+	Device::GetGraphics()->Replay(commands);
+}
+
+const std::type_info & easy2d::Sprite::GetSetterType() const
+{
+	return typeid(Sprite);
+}
+
+void easy2d::Sprite::Record(RenderCommandList & commands) const
+{
+	// 重写了 Draw 的子类在回放时绘制
+	if (custom_draw_)
+	{
+		commands.DrawNode(this);
+		return;
+	}
+
+	RecordImage(commands);
+}
+
+void easy2d::Sprite::RecordImage(RenderCommandList & commands) const
 {
 	if (image_ && image_->GetBitmap())
 	{
-		auto crop_pos = image_->GetCropPos();
-		Device::GetGraphics()->GetRenderTarget()->DrawBitmap(
+		// 图片可能只是图集页面中的一块区域
+		auto crop_pos = image_->GetBitmapRect().origin;
+		commands.DrawBitmap(
 			image_->GetBitmap(),
 			D2D1::RectF(0, 0, transform_.size.width, transform_.size.height),
-			display_opacity_,
-			D2D1_BITMAP_INTERPOLATION_MODE_LINEAR,
 			D2D1::RectF(
 				crop_pos.x,
 				crop_pos.y,
-				crop_pos.y + transform_.size.width,
+				crop_pos.x + transform_.size.width,
 				crop_pos.y + transform_.size.height
-			)
+			),
+			display_opacity_
 		);
 	}
 }
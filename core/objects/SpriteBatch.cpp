@@ -0,0 +1,248 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "../e2dobject.h"
+#include "../e2dmodule.h"
+
+namespace
+{
+	D2D1_RECT_F ToRectF(const easy2d::Rect& rect)
+	{
+		return D2D1::RectF(
+			rect.origin.x,
+			rect.origin.y,
+			rect.origin.x + rect.size.width,
+			rect.origin.y + rect.size.height
+		);
+	}
+}
+
+easy2d::SpriteBatch::SpriteBatch()
+	: atlas_(nullptr)
+{
+	SetCustomDraw(false);
+}
+
+easy2d::SpriteBatch::SpriteBatch(Image * atlas)
+	: atlas_(nullptr)
+{
+	SetCustomDraw(false);
+	SetAtlas(atlas);
+}
+
+easy2d::SpriteBatch::~SpriteBatch()
+{
+	SafeRelease(atlas_);
+}
+
+void easy2d::SpriteBatch::SetAtlas(Image * atlas)
+{
+	if (atlas_ == atlas)
+		return;
+
+	SafeRelease(atlas_);
+	atlas_ = atlas;
+	if (atlas_)
+	{
+		atlas_->Retain();
+	}
+}
+
+easy2d::Image * easy2d::SpriteBatch::GetAtlas() const
+{
+	return atlas_;
+}
+
+void easy2d::SpriteBatch::Reserve(size_t count)
+{
+	rects_.reserve(count);
+	dests_.reserve(count);
+	transforms_.reserve(count);
+	colors_.reserve(count);
+	opacities_.reserve(count);
+}
+
+size_t easy2d::SpriteBatch::AddSprite(
+	const Rect & atlas_rect,
+	const Point & pos,
+	float rotation,
+	float scale,
+	float opacity,
+	const Color & color
+)
+{
+	return AddSprite(
+		atlas_rect,
+		MakeTransform(atlas_rect, pos, rotation, scale),
+		opacity,
+		color
+	);
+}
+
+size_t easy2d::SpriteBatch::AddSprite(
+	const Rect & atlas_rect,
+	const D2D1::Matrix3x2F & transform,
+	float opacity,
+	const Color & color
+)
+{
+	rects_.push_back(ToRectF(atlas_rect));
+	dests_.push_back(D2D1::RectF(0, 0, atlas_rect.size.width, atlas_rect.size.height));
+	transforms_.push_back(transform);
+	colors_.push_back(D2D1_COLOR_F(color));
+	opacities_.push_back(opacity);
+	return rects_.size() - 1;
+}
+
+void easy2d::SpriteBatch::SetSpriteRect(size_t index, const Rect & atlas_rect)
+{
+	if (index < rects_.size())
+	{
+		rects_[index] = ToRectF(atlas_rect);
+		dests_[index] = D2D1::RectF(0, 0, atlas_rect.size.width, atlas_rect.size.height);
+	}
+}
+
+void easy2d::SpriteBatch::SetSpriteTransform(size_t index, const Point & pos, float rotation, float scale)
+{
+	if (index < rects_.size())
+	{
+		const auto& dest = dests_[index];
+		transforms_[index] = MakeTransform(
+			Rect(0, 0, dest.right, dest.bottom),
+			pos,
+			rotation,
+			scale
+		);
+	}
+}
+
+void easy2d::SpriteBatch::SetSpriteTransform(size_t index, const D2D1::Matrix3x2F & transform)
+{
+	if (index < rects_.size())
+	{
+		transforms_[index] = transform;
+	}
+}
+
+void easy2d::SpriteBatch::SetSpriteOpacity(size_t index, float opacity)
+{
+	if (index < rects_.size())
+	{
+		opacities_[index] = opacity;
+	}
+}
+
+void easy2d::SpriteBatch::SetSpriteColor(size_t index, const Color & color)
+{
+	if (index < rects_.size())
+	{
+		colors_[index] = D2D1_COLOR_F(color);
+	}
+}
+
+void easy2d::SpriteBatch::RemoveSprite(size_t index)
+{
+	if (index < rects_.size())
+	{
+		rects_[index] = rects_.back();
+		dests_[index] = dests_.back();
+		transforms_[index] = transforms_.back();
+		colors_[index] = colors_.back();
+		opacities_[index] = opacities_.back();
+
+		rects_.pop_back();
+		dests_.pop_back();
+		transforms_.pop_back();
+		colors_.pop_back();
+		opacities_.pop_back();
+	}
+}
+
+void easy2d::SpriteBatch::ClearSprites()
+{
+	rects_.clear();
+	dests_.clear();
+	transforms_.clear();
+	colors_.clear();
+	opacities_.clear();
+}
+
+size_t easy2d::SpriteBatch::GetSpriteCount() const
+{
+	return rects_.size();
+}
+
+const std::type_info & easy2d::SpriteBatch::GetSetterType() const
+{
+	return typeid(SpriteBatch);
+}
+
+void easy2d::SpriteBatch::Record(RenderCommandList & commands) const
+{
+	if (atlas_ && atlas_->GetBitmap() && !rects_.empty())
+	{
+		// 图集可能只是位图中的一块区域，精灵区域需要转换到位图坐标
+		const D2D1_RECT_F * rects = &rects_[0];
+		const Point origin = atlas_->GetBitmapRect().origin;
+		if (origin.x != 0 || origin.y != 0)
+		{
+			bitmap_rects_.resize(rects_.size());
+			for (size_t i = 0; i < rects_.size(); ++i)
+			{
+				const auto& rect = rects_[i];
+				bitmap_rects_[i] = D2D1::RectF(
+					rect.left + origin.x,
+					rect.top + origin.y,
+					rect.right + origin.x,
+					rect.bottom + origin.y
+				);
+			}
+			rects = &bitmap_rects_[0];
+		}
+
+		commands.DrawSprites(
+			atlas_->GetBitmap(),
+			&dests_[0],
+			rects,
+			&transforms_[0],
+			&colors_[0],
+			&opacities_[0],
+			static_cast<UINT32>(rects_.size()),
+			display_opacity_
+		);
+	}
+}
+
+D2D1::Matrix3x2F easy2d::SpriteBatch::MakeTransform(
+	const Rect & atlas_rect,
+	const Point & pos,
+	float rotation,
+	float scale
+)
+{
+	return D2D1::Matrix3x2F::Translation(
+		-atlas_rect.size.width / 2,
+		-atlas_rect.size.height / 2
+	) * D2D1::Matrix3x2F::Scale(scale, scale) *
+		D2D1::Matrix3x2F::Rotation(rotation) *
+		D2D1::Matrix3x2F::Translation(pos.x, pos.y);
+}
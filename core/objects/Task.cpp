@@ -18,7 +18,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dobject.h"
+#include "../e2dobject.h"
 
 
 easy2d::Task::Task(const Function & func, const String & name)
@@ -29,6 +29,8 @@ easy2d::Task::Task(const Function & func, const String & name)
 	, delay_()
 	, callback_(func)
 	, name_(name)
+	, target_(nullptr)
+	, schedule_id_(0)
 {
 }
 
@@ -40,13 +42,16 @@ easy2d::Task::Task(const Function & func, float delay, int times, const String &
 	, total_times_(times)
 	, callback_(func)
 	, name_(name)
+	, target_(nullptr)
+	, schedule_id_(0)
 {
 }
 
 void easy2d::Task::Start()
 {
 	running_ = true;
-	last_time_ = Time::Now();
+	last_time_ = GetTime();
+	Reschedule();
 }
 
 void easy2d::Task::Stop()
@@ -79,18 +84,19 @@ void easy2d::Task::Update()
 
 void easy2d::Task::ResetTime()
 {
-	last_time_ = Time::Now();
+	last_time_ = GetTime();
+	Reschedule();
 }
 
 bool easy2d::Task::IsReady() const
 {
 	if (running_)
 	{
-		if (delay_.Milliseconds() == 0)
+		if (delay_ == Duration())
 		{
 			return true;
 		}
-		if (Time::Now() - last_time_ >= delay_)
+		if (GetTime() - last_time_ >= delay_)
 		{
 			return true;
 		}
@@ -98,6 +104,11 @@ bool easy2d::Task::IsReady() const
 	return false;
 }
 
+easy2d::Time easy2d::Task::GetNextTime() const
+{
+	return last_time_ + delay_;
+}
+
 bool easy2d::Task::IsRunning() const
 {
 	return running_;
@@ -107,3 +118,18 @@ const easy2d::String& easy2d::Task::GetName() const
 {
 	return name_;
 }
+
+easy2d::Time easy2d::Task::GetTime() const
+{
+	// 任务跟随所属节点的时钟，受节点的时间缩放和暂停影响
+	return target_ ? target_->GetTime() : Time::Now();
+}
+
+void easy2d::Task::Reschedule()
+{
+	// 计时改变后旧的队列项失效，需要按新的执行时间重新入队
+	if (target_ && running_ && !stopped_)
+	{
+		target_->ScheduleTask(this);
+	}
+}
@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dobject.h"
-#include "..\e2dmodule.h"
+#include "../e2dobject.h"
+#include "../e2dmodule.h"
 
 //-------------------------------------------------------
 // Style
@@ -77,6 +77,7 @@ easy2d::Text::Text()
 	, text_layout_(nullptr)
 	, text_format_(nullptr)
 {
+	SetCustomDraw(false);
 }
 
 easy2d::Text::Text(const String & text, const Font & font, const Style & style)
@@ -86,6 +87,7 @@ easy2d::Text::Text(const String & text, const Font & font, const Style & style)
 	, text_format_(nullptr)
 	, text_(text)
 {
+	SetCustomDraw(false);
 	Reset();
 }
 
@@ -309,32 +311,52 @@ void easy2d::Text::SetOutlineStroke(Stroke outline_stroke)
 }
 
 void easy2d::Text::Draw() const
+{
+	// 立即回放文字的绘制命令
+	RenderCommandList commands;
+	RecordLayout(commands);
+	Device::GetGraphics()->Replay(commands);
+}
+
+const std::type_info & easy2d::Text::GetSetterType() const
+{
+	return typeid(Text);
+}
+
+void easy2d::Text::Record(RenderCommandList & commands) const
+{
+	// 重写了 Draw 的子类在回放时绘制
+	if (custom_draw_)
+	{
+		commands.DrawNode(this);
+		return;
+	}
+
+	RecordLayout(commands);
+}
+
+void easy2d::Text::RecordLayout(RenderCommandList & commands) const
 {
 	if (text_layout_)
 	{
-		auto graphics = Device::GetGraphics();
-		// ı
-		D2D1_RECT_F textLayoutRect = D2D1::RectF(0, 0, transform_.size.width, transform_.size.height);
-		// ûˢɫ͸
-		graphics->GetSolidBrush()->SetOpacity(display_opacity_);
-		// ȡıȾ
-		auto text_renderer = graphics->GetTextRender();
-		text_renderer->SetTextStyle(
+		// 文字使用公共画刷，先设置画刷透明度
+		commands.SetOpacity(display_opacity_);
+		commands.DrawTextLayout(
+			text_layout_,
 			(D2D1_COLOR_F)style_.color,
 			style_.outline,
 			(D2D1_COLOR_F)style_.outline_color,
 			style_.outline_width,
 			D2D1_LINE_JOIN(style_.outline_stroke)
 		);
-		text_layout_->Draw(nullptr, text_renderer, 0, 0);
 	}
 }
 
 void easy2d::Text::Reset()
 {
-	// ָʽ
+	// 创建文字格式化
 	CreateFormat();
-	// ֲ
+	// 创建文字布局
 	CreateLayout();
 }
 
@@ -355,10 +377,10 @@ void easy2d::Text::CreateFormat()
 		)
 	);
 
-	// ֶ뷽ʽ
+	// 设置文字对齐方式
 	text_format_->SetTextAlignment(DWRITE_TEXT_ALIGNMENT(style_.alignment));
 
-	// м
+	// 设置行间距
 	if (style_.line_spacing == 0.f)
 	{
 		text_format_->SetLineSpacing(DWRITE_LINE_SPACING_METHOD_DEFAULT, 0, 0);
@@ -372,7 +394,7 @@ void easy2d::Text::CreateFormat()
 		);
 	}
 
-	// ıԶʱû
+	// 打开文本自动换行时，设置换行属性
 	if (style_.wrap)
 	{
 		text_format_->SetWordWrapping(DWRITE_WORD_WRAPPING_WRAP);
@@ -387,7 +409,7 @@ void easy2d::Text::CreateLayout()
 {
 	SafeRelease(text_layout_);
 
-	// ıΪַʱ
+	// 文本为空字符串时，重置属性
 	if (text_.IsEmpty())
 	{
 		this->SetSize(0, 0);
@@ -403,7 +425,7 @@ void easy2d::Text::CreateLayout()
 	UINT32 length = (UINT32)text_.Length();
 	auto writeFactory = Device::GetGraphics()->GetWriteFactory();
 
-	// ıԶ½д
+	// 对文本自动换行情况下进行处理
 	if (style_.wrap)
 	{
 		ThrowIfFailed(
@@ -416,15 +438,15 @@ void easy2d::Text::CreateLayout()
 				&text_layout_
 			)
 		);
-		// ȡıֵĿȺ͸߶
+		// 获取文本布局的宽度和高度
 		DWRITE_TEXT_METRICS metrics;
 		text_layout_->GetMetrics(&metrics);
-		// ı
+		// 重设文本宽高
 		this->SetSize(metrics.layoutWidth, metrics.height);
 	}
 	else
 	{
-		// Ϊֹı⣬ȴ layout Իȡ
+		// 为防止文本对齐问题，根据先创建 layout 以获取宽度
 		ThrowIfFailed(
 			writeFactory->CreateTextLayout(
 				(const wchar_t *)text_,
@@ -436,13 +458,13 @@ void easy2d::Text::CreateLayout()
 			)
 		);
 
-		// ȡıֵĿȺ͸߶
+		// 获取文本布局的宽度和高度
 		DWRITE_TEXT_METRICS metrics;
 		text_layout_->GetMetrics(&metrics);
-		// ı
+		// 重设文本宽高
 		this->SetSize(metrics.width, metrics.height);
 
-		// ´ layout
+		// 重新创建 layout
 		SafeRelease(text_layout_);
 		ThrowIfFailed(
 			writeFactory->CreateTextLayout(
@@ -456,7 +478,7 @@ void easy2d::Text::CreateLayout()
 		);
 	}
 
-	// »ߺɾ
+	// 添加下划线和删除线
 	DWRITE_TEXT_RANGE Range = { 0, length };
 	if (style_.underline)
 	{
@@ -0,0 +1,488 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "../e2dobject.h"
+
+
+namespace
+{
+	// 在 pos 处插入或删除元素，使其后的元素整体移动 delta
+	template <typename T>
+	void Shift(std::vector<T>& values, size_t pos, std::ptrdiff_t delta)
+	{
+		if (delta > 0)
+		{
+			values.insert(values.begin() + pos, static_cast<size_t>(delta), T());
+		}
+		else if (delta < 0)
+		{
+			values.erase(values.begin() + (pos + delta), values.begin() + pos);
+		}
+	}
+}
+
+easy2d::TransformStore::TransformStore()
+	: dirty_hierarchy_(false)
+	, dirty_root_(false)
+	, dirty_begin_(0)
+{
+}
+
+void easy2d::TransformStore::MarkHierarchyDirty(Node * node)
+{
+	if (!node)
+	{
+		dirty_hierarchy_ = true;
+		return;
+	}
+
+	// 重建整个缓存时不需要单独收集
+	if (dirty_hierarchy_ || node->dirty_children_)
+		return;
+
+	node->dirty_children_ = true;
+	dirty_parents_.push_back(node);
+}
+
+void easy2d::TransformStore::Forget(Node * node)
+{
+	if (node->dirty_children_)
+	{
+		node->dirty_children_ = false;
+		dirty_parents_.erase(
+			std::remove(dirty_parents_.begin(), dirty_parents_.end(), node),
+			dirty_parents_.end()
+		);
+	}
+}
+
+void easy2d::TransformStore::MarkDirty(Node * node)
+{
+	// 层级改变时将在重建缓存时处理
+	if (dirty_hierarchy_)
+		return;
+
+	// 还不在缓存中的节点会随着父节点的子树一起收集
+	if (node->transform_index_ >= 0 && static_cast<size_t>(node->transform_index_) < nodes_.size())
+	{
+		dirty_locals_.push_back(static_cast<size_t>(node->transform_index_));
+	}
+}
+
+void easy2d::TransformStore::MarkRootDirty()
+{
+	dirty_root_ = true;
+}
+
+bool easy2d::TransformStore::IsDirty() const
+{
+	return dirty_hierarchy_ || dirty_root_ || !dirty_locals_.empty() || !dirty_parents_.empty();
+}
+
+size_t easy2d::TransformStore::GetCount() const
+{
+	return nodes_.size();
+}
+
+void easy2d::TransformStore::Update(Node * root, const D2D1::Matrix3x2F& scene_transform)
+{
+	if (!IsDirty())
+		return;
+
+	const bool rebuilt = dirty_hierarchy_;
+	if (dirty_hierarchy_)
+	{
+		Rebuild(root);
+	}
+	else
+	{
+		dirty_begin_ = nodes_.size();
+		bounds_queue_.clear();
+		if (!dirty_parents_.empty())
+		{
+			Splice();
+		}
+	}
+
+	// 更新发生改变的局部矩阵
+	for (const auto& index : dirty_locals_)
+	{
+		UpdateLocal(index);
+		dirty_flags_[index] = 1;
+		dirty_begin_ = std::min(dirty_begin_, index);
+	}
+	dirty_locals_.clear();
+
+	const UINT8 root_flag = dirty_root_ ? 1 : 0;
+	if (dirty_root_)
+	{
+		dirty_root_ = false;
+		dirty_begin_ = 0;
+	}
+
+	const size_t count = nodes_.size();
+	if (dirty_begin_ >= count && bounds_queue_.empty() && !rebuilt)
+		return;
+
+	// 父节点总是在子节点之前，脏标记沿数组线性传递
+	const int * parents = parents_.data();
+	UINT8 * flags = dirty_flags_.data();
+	for (size_t i = dirty_begin_; i < count; ++i)
+	{
+		const int parent = parents[i];
+		flags[i] |= (parent >= 0) ? flags[parent] : root_flag;
+	}
+
+	// 计算世界矩阵
+	const D2D1::Matrix3x2F * local_initial = local_initial_.data();
+	const D2D1::Matrix3x2F * local_final = local_final_.data();
+	D2D1::Matrix3x2F * world_initial = world_initial_.data();
+	D2D1::Matrix3x2F * world_final = world_final_.data();
+	for (size_t i = dirty_begin_; i < count; ++i)
+	{
+		if (flags[i])
+		{
+			const int parent = parents[i];
+			const D2D1::Matrix3x2F& parent_matrix = (parent >= 0) ? world_initial[parent] : scene_transform;
+			world_initial[i].SetProduct(local_initial[i], parent_matrix);
+			world_final[i].SetProduct(local_final[i], parent_matrix);
+		}
+	}
+
+	// 将结果写回节点
+	for (size_t i = dirty_begin_; i < count; ++i)
+	{
+		if (flags[i])
+		{
+			Node * node = nodes_[i];
+			node->initial_matrix_ = world_initial[i];
+			node->final_matrix_ = world_final[i];
+			node->dirty_transform_ = false;
+			node->UpdateBorderVertices();
+
+			bounds_queue_.push_back(i);
+		}
+	}
+
+	UpdateBounds(rebuilt);
+	dirty_begin_ = count;
+}
+
+void easy2d::TransformStore::UpdateBounds(bool all)
+{
+	const int * parents = parents_.data();
+	UINT8 * flags = dirty_flags_.data();
+
+	// 重建后所有子树包围盒都需要重新计算
+	if (all)
+	{
+		for (size_t i = nodes_.size(); i > 0; --i)
+		{
+			flags[i - 1] = 0;
+			nodes_[i - 1]->UpdateSubtreeBounds();
+		}
+		bounds_queue_.clear();
+		return;
+	}
+
+	// 只更新脏节点和它们的祖先节点，序号大的先出队，子节点总是先于父节点完成
+	std::sort(bounds_queue_.begin(), bounds_queue_.end());
+	bounds_queue_.erase(std::unique(bounds_queue_.begin(), bounds_queue_.end()), bounds_queue_.end());
+	for (const auto& index : bounds_queue_)
+	{
+		flags[index] = 1;
+	}
+	std::make_heap(bounds_queue_.begin(), bounds_queue_.end());
+
+	while (!bounds_queue_.empty())
+	{
+		std::pop_heap(bounds_queue_.begin(), bounds_queue_.end());
+		const size_t index = bounds_queue_.back();
+		bounds_queue_.pop_back();
+
+		flags[index] = 0;
+		nodes_[index]->UpdateSubtreeBounds();
+
+		const int parent = parents[index];
+		if (parent >= 0 && !flags[parent])
+		{
+			flags[parent] = 1;
+			bounds_queue_.push_back(static_cast<size_t>(parent));
+			std::push_heap(bounds_queue_.begin(), bounds_queue_.end());
+		}
+	}
+}
+
+void easy2d::TransformStore::Rebuild(Node * root)
+{
+	dirty_hierarchy_ = false;
+	dirty_locals_.clear();
+	bounds_queue_.clear();
+
+	for (auto node : dirty_parents_)
+	{
+		node->dirty_children_ = false;
+	}
+	dirty_parents_.clear();
+
+	nodes_.clear();
+	parents_.clear();
+	sizes_.clear();
+
+	if (root)
+	{
+		Collect(root, -1);
+	}
+
+	const size_t count = nodes_.size();
+	dirty_begin_ = 0;
+	dirty_flags_.assign(count, 1);
+	local_initial_.resize(count);
+	local_final_.resize(count);
+	world_initial_.resize(count);
+	world_final_.resize(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		UpdateLocal(i);
+		nodes_[i]->transform_index_ = static_cast<int>(i);
+	}
+}
+
+void easy2d::TransformStore::Collect(Node * node, int parent)
+{
+	const int index = static_cast<int>(nodes_.size());
+	nodes_.push_back(node);
+	parents_.push_back(parent);
+	sizes_.push_back(1);
+
+	for (const auto& child : node->children_)
+	{
+		Collect(child, index);
+	}
+	sizes_[index] = static_cast<int>(nodes_.size()) - index;
+}
+
+void easy2d::TransformStore::Splice()
+{
+	// 新加入场景的节点会随着已在缓存中的祖先节点一起收集
+	splice_order_.clear();
+	for (auto node : dirty_parents_)
+	{
+		node->dirty_children_ = false;
+
+		const int index = node->transform_index_;
+		if (index >= 0 && static_cast<size_t>(index) < nodes_.size() && nodes_[index] == node)
+		{
+			splice_order_.push_back(index);
+		}
+	}
+
+	// 从后向前拼接，子孙节点先于祖先节点完成，也不会移动还没处理的区间
+	// 还没处理的祖先区间中可能有已被释放的节点，移动的序号在全部拼接完成后再写回节点
+	std::sort(splice_order_.begin(), splice_order_.end(), std::greater<int>());
+	size_t moved = nodes_.size();
+	for (const auto& index : splice_order_)
+	{
+		moved = std::min(moved, SpliceSubtree(static_cast<size_t>(index)));
+	}
+	for (size_t i = moved; i < nodes_.size(); ++i)
+	{
+		nodes_[i]->transform_index_ = static_cast<int>(i);
+	}
+
+	// 子节点改变后需要更新包围盒，拼接全部完成后序号才确定
+	for (auto node : dirty_parents_)
+	{
+		const int index = node->transform_index_;
+		if (index >= 0 && static_cast<size_t>(index) < nodes_.size() && nodes_[index] == node)
+		{
+			bounds_queue_.push_back(static_cast<size_t>(index));
+		}
+	}
+	dirty_parents_.clear();
+}
+
+size_t easy2d::TransformStore::SpliceSubtree(size_t index)
+{
+	const size_t old_size = static_cast<size_t>(sizes_[index]);
+	const size_t old_end = index + old_size;
+
+	splice_nodes_.clear();
+	splice_parents_.clear();
+	splice_sizes_.clear();
+	splice_sources_.clear();
+	CollectRange(nodes_[index], parents_[index], static_cast<int>(index), index);
+
+	// 保存原区间的矩阵和脏标记，区间移动后按来源复制
+	splice_flags_.assign(dirty_flags_.begin() + index, dirty_flags_.begin() + old_end);
+	splice_matrices_.resize(old_size * 4);
+	std::copy(local_initial_.begin() + index, local_initial_.begin() + old_end, splice_matrices_.begin());
+	std::copy(local_final_.begin() + index, local_final_.begin() + old_end, splice_matrices_.begin() + old_size);
+	std::copy(world_initial_.begin() + index, world_initial_.begin() + old_end, splice_matrices_.begin() + old_size * 2);
+	std::copy(world_final_.begin() + index, world_final_.begin() + old_end, splice_matrices_.begin() + old_size * 3);
+
+	const size_t new_size = splice_nodes_.size();
+	const std::ptrdiff_t delta = static_cast<std::ptrdiff_t>(new_size) - static_cast<std::ptrdiff_t>(old_size);
+	if (delta != 0)
+	{
+		Shift(nodes_, old_end, delta);
+		Shift(parents_, old_end, delta);
+		Shift(sizes_, old_end, delta);
+		Shift(dirty_flags_, old_end, delta);
+		Shift(local_initial_, old_end, delta);
+		Shift(local_final_, old_end, delta);
+		Shift(world_initial_, old_end, delta);
+		Shift(world_final_, old_end, delta);
+	}
+
+	for (size_t i = 0; i < new_size; ++i)
+	{
+		const size_t pos = index + i;
+		Node * node = splice_nodes_[i];
+		nodes_[pos] = node;
+		parents_[pos] = splice_parents_[i];
+		sizes_[pos] = splice_sizes_[i];
+		node->transform_index_ = static_cast<int>(pos);
+
+		// 位置和父节点都没有改变的节点直接复用矩阵
+		const int source = splice_sources_[i];
+		if (source >= 0 && !node->dirty_transform_)
+		{
+			const size_t offset = static_cast<size_t>(source) - index;
+			local_initial_[pos] = splice_matrices_[offset];
+			local_final_[pos] = splice_matrices_[old_size + offset];
+			world_initial_[pos] = splice_matrices_[old_size * 2 + offset];
+			world_final_[pos] = splice_matrices_[old_size * 3 + offset];
+			dirty_flags_[pos] = splice_flags_[offset];
+		}
+		else
+		{
+			UpdateLocal(pos);
+			dirty_flags_[pos] = 1;
+		}
+	}
+	dirty_begin_ = std::min(dirty_begin_, index);
+
+	// 区间内的节点已经按 dirty_transform_ 处理，之后的节点序号整体移动
+	const size_t new_end = index + new_size;
+	size_t kept = 0;
+	for (size_t i = 0; i < dirty_locals_.size(); ++i)
+	{
+		size_t local = dirty_locals_[i];
+		if (local >= index && local < old_end)
+			continue;
+		if (local >= old_end)
+			local = static_cast<size_t>(local + delta);
+		dirty_locals_[kept++] = local;
+	}
+	dirty_locals_.resize(kept);
+
+	if (delta == 0)
+		return nodes_.size();
+
+	const int shift = static_cast<int>(delta);
+	const int moved = static_cast<int>(old_end);
+	for (size_t i = new_end; i < nodes_.size(); ++i)
+	{
+		if (parents_[i] >= moved)
+		{
+			parents_[i] += shift;
+		}
+	}
+
+	for (int parent = parents_[index]; parent >= 0; parent = parents_[parent])
+	{
+		sizes_[parent] += shift;
+	}
+	return new_end;
+}
+
+void easy2d::TransformStore::CollectRange(Node * node, int parent, int source, size_t begin)
+{
+	const size_t offset = splice_nodes_.size();
+	const int index = static_cast<int>(begin + offset);
+	splice_nodes_.push_back(node);
+	splice_parents_.push_back(parent);
+	splice_sizes_.push_back(1);
+	splice_sources_.push_back(source);
+
+	// 离开过场景的节点序号为 -1，需要重新收集
+	// 其他节点中的序号可能还没有更新，找不到时在原区间的子节点中查找
+	const int source_end = source >= 0 ? source + sizes_[source] : source;
+	int cursor = source + 1;
+	for (const auto& child : node->children_)
+	{
+		int child_index = child->transform_index_;
+		if (source >= 0 && child_index >= 0 && !(child_index > source && child_index < source_end &&
+			nodes_[child_index] == child && parents_[child_index] == source))
+		{
+			child_index = -1;
+			for (int i = cursor; i < source_end; i += sizes_[i])
+			{
+				if (nodes_[i] == child)
+				{
+					child_index = i;
+					break;
+				}
+			}
+			for (int i = source + 1; child_index < 0 && i < cursor; i += sizes_[i])
+			{
+				if (nodes_[i] == child)
+				{
+					child_index = i;
+				}
+			}
+		}
+
+		if (source < 0 || child_index < 0)
+		{
+			CollectRange(child, index, -1, begin);
+			continue;
+		}
+		cursor = child_index + sizes_[child_index];
+
+		// 子树没有改变，父节点序号按新位置修正
+		const int child_size = sizes_[child_index];
+		const int moved = static_cast<int>(begin + splice_nodes_.size()) - child_index;
+		for (int i = child_index; i < child_index + child_size; ++i)
+		{
+			splice_nodes_.push_back(nodes_[i]);
+			splice_parents_.push_back(i == child_index ? index : parents_[i] + moved);
+			splice_sizes_.push_back(sizes_[i]);
+			splice_sources_.push_back(i);
+		}
+	}
+	splice_sizes_[offset] = static_cast<int>(splice_nodes_.size() - offset);
+}
+
+void easy2d::TransformStore::UpdateLocal(size_t index)
+{
+	const Transform& transform = nodes_[index]->transform_;
+
+	local_final_[index] = static_cast<D2D1::Matrix3x2F>(transform);
+
+	// 根据自身支点计算 Initial 矩阵，子节点将根据这个矩阵进行变换
+	local_initial_[index] = local_final_[index] * D2D1::Matrix3x2F::Translation(
+		transform.size.width * transform.pivot_x,
+		transform.size.height * transform.pivot_y
+	);
+}
@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dtool.h"
-#include "..\e2dmodule.h"
+#include "../e2dtool.h"
+#include "../e2dmodule.h"
 #include <shobjidl.h> 
 
 std::list<easy2d::String>	easy2d::File::search_paths_;
@@ -83,14 +83,14 @@ const easy2d::String& easy2d::File::GetPath() const
 easy2d::String easy2d::File::GetExtension() const
 {
 	String file_ext;
-	// ҵļеһ '.' λ
+	// 找到文件名中的最后一个 '.' 的位置
 	size_t pos = file_path_.operator std::wstring().find_last_of(L'.');
-	// ж pos ǷЧλ
+	// 判断 pos 是否是有效位置
 	if (pos != std::wstring::npos)
 	{
-		// ȡչ
+		// 截取扩展名
 		file_ext = file_path_.Subtract(static_cast<int>(pos));
-		// תΪСдĸ
+		// 转换为小写字母
 		file_ext = file_ext.ToLower();
 	}
 	return std::move(file_ext);
@@ -119,14 +119,14 @@ easy2d::File easy2d::File::Extract(const Resource& res, const String& dest_file_
 	if (file_handle == INVALID_HANDLE_VALUE)
 		return std::move(file);
 
-	// ԴļСԴڴ桢õԴС
+	// 查找资源文件中、加载资源到内存、得到资源大小
 	HRSRC res = ::FindResource(NULL, MAKEINTRESOURCE(res.id), static_cast<LPCWSTR>(res.type));
 	HGLOBAL res_data = ::LoadResource(NULL, res);
 	DWORD res_size = ::SizeofResource(NULL, res);
 
 	if (res && res_data && res_size)
 	{
-		// дļ
+		// 写入文件
 		DWORD written_bytes = 0;
 		::WriteFile(file_handle, res_data, res_size, &written_bytes, NULL);
 		::CloseHandle(file_handle);
@@ -189,7 +189,7 @@ easy2d::File easy2d::File::ShowOpenDialog(const String & title, const String & f
 			{
 				COMDLG_FILTERSPEC spec[] =
 				{
-					{ L"ļ", L"*.*" }
+					{ L"所有文件", L"*.*" }
 				};
 				file_open->SetFileTypes(1, spec);
 			}
@@ -259,7 +259,7 @@ easy2d::File easy2d::File::ShowSaveDialog(const String & title, const String& de
 			{
 				COMDLG_FILTERSPEC spec[] =
 				{
-					{ L"ļ", L"*.*" }
+					{ L"所有文件", L"*.*" }
 				};
 				file_save->SetFileTypes(1, spec);
 			}
@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dtool.h"
-#include "..\e2dmodule.h"
+#include "../e2dtool.h"
+#include "../e2dmodule.h"
 
 
 inline bool TraceError(wchar_t* prompt)
@@ -37,7 +37,7 @@ inline bool TraceError(wchar_t* prompt, HRESULT hr)
 
 namespace easy2d
 {
-	// Ƶ
+	// 音频解码器
 	class Transcoder
 	{
 		WAVEFORMATEX* wave_format_;
@@ -176,7 +176,7 @@ namespace easy2d
 				hr = partial_type->SetGUID(MF_MT_SUBTYPE, MFAudioFormat_PCM);
 			}
 
-			//  source reader ýͣʹúʵĽȥƵ
+			// 设置 source reader 的媒体类型，它将使用合适的解码器去解码这个音频
 			if (SUCCEEDED(hr))
 			{
 				hr = reader->SetCurrentMediaType(
@@ -186,7 +186,7 @@ namespace easy2d
 				);
 			}
 
-			//  IMFMediaType лȡ WAVEFORMAT ṹ
+			// 从 IMFMediaType 中获取 WAVEFORMAT 结构
 			if (SUCCEEDED(hr))
 			{
 				hr = reader->GetCurrentMediaType(
@@ -195,7 +195,7 @@ namespace easy2d
 				);
 			}
 
-			// ָƵ
+			// 指定音频流
 			if (SUCCEEDED(hr))
 			{
 				hr = reader->SetStreamSelection(
@@ -204,7 +204,7 @@ namespace easy2d
 				);
 			}
 
-			// ȡ WAVEFORMAT 
+			// 获取 WAVEFORMAT 数据
 			if (SUCCEEDED(hr))
 			{
 				UINT32 size = 0;
@@ -215,7 +215,7 @@ namespace easy2d
 				);
 			}
 
-			// ƵС
+			// 估算音频流大小
 			if (SUCCEEDED(hr))
 			{
 				PROPVARIANT prop;
@@ -234,7 +234,7 @@ namespace easy2d
 				PropVariantClear(&prop);
 			}
 
-			// ȡƵ
+			// 读取音频数据
 			if (SUCCEEDED(hr))
 			{
 				DWORD flags = 0;
@@ -363,8 +363,8 @@ bool easy2d::Music::Load(const easy2d::String & file_path)
 		return false;
 	}
 
-	// û·һ·Ϊûͨ File::AddSearchPath 
-	// Ĭ·Ҫͨ File::GetPath ȡ·
+	// 用户输入的路径不一定是完整路径，因为用户可能通过 File::AddSearchPath 添加
+	// 默认搜索路径，所以需要通过 File::GetPath 获取完整路径
 	String music_file_path = music_file.GetPath();
 
 	Transcoder transcoder;
@@ -446,7 +446,7 @@ bool easy2d::Music::Play(int loop_count)
 		loop_count = std::min(loop_count, XAUDIO2_LOOP_INFINITE - 1);
 	}
 
-	// ύ wave 
+	// 提交 wave 样本数据
 	XAUDIO2_BUFFER buffer = { 0 };
 	buffer.pAudioData = wave_data_;
 	buffer.Flags = XAUDIO2_END_OF_STREAM;
@@ -18,14 +18,14 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dtool.h"
-#include "..\e2dmodule.h"
+#include "../e2dtool.h"
+#include "../e2dmodule.h"
 #include <shlobj.h>
 
 
 namespace
 {
-	// ָļ
+	// 创建指定文件夹
 	bool CreateFolder(const easy2d::String & dir_path)
 	{
 		if (dir_path.IsEmpty() || dir_path.Length() >= MAX_PATH)
@@ -58,7 +58,7 @@ const easy2d::String& easy2d::Path::GetDataPath()
 	static String data_path;
 	if (data_path.IsEmpty())
 	{
-		// ݵı·
+		// 设置数据的保存路径
 		String local_app_data_path = Path::GetLocalAppDataPath();
 		String title = Game::GetInstance()->GetTitle();
 		String folder_name = String::Parse(title.GetHash());
@@ -83,7 +83,7 @@ const easy2d::String& easy2d::Path::GetTemporaryPath()
 	static String temp_path;
 	if (temp_path.IsEmpty())
 	{
-		// ʱļ·
+		// 设置临时文件保存路径
 		wchar_t path[_MAX_PATH];
 		String title = Game::GetInstance()->GetTitle();
 		String folder_name = String::Parse(title.GetHash());
@@ -107,7 +107,7 @@ const easy2d::String& easy2d::Path::GetLocalAppDataPath()
 	static String local_app_data_path;
 	if (local_app_data_path.IsEmpty())
 	{
-		// ȡ AppData/Local ļе·
+		// 获取 AppData/Local 文件夹的路径
 		wchar_t path[MAX_PATH] = { 0 };
 		::SHGetFolderPath(NULL, CSIDL_LOCAL_APPDATA, NULL, SHGFP_TYPE_CURRENT, path);
 		local_app_data_path = path;
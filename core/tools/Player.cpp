@@ -1,4 +1,4 @@
-#include "..\e2dtool.h"
+#include "../e2dtool.h"
 
 
 std::map<size_t, easy2d::Music*> easy2d::Player::musics_;
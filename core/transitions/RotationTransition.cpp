@@ -18,8 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dtransition.h"
-#include "..\e2dobject.h"
+#include "../e2dtransition.h"
+#include "../e2dobject.h"
 
 easy2d::RotationTransition::RotationTransition(float duration, float rotation)
 	: Transition(duration)
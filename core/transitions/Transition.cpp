@@ -18,9 +18,9 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dtransition.h"
-#include "..\e2dobject.h"
-#include "..\e2dmodule.h"
+#include "../e2dtransition.h"
+#include "../e2dobject.h"
+#include "../e2dmodule.h"
 
 easy2d::Transition::Transition(float duration)
 	: done_(false)
@@ -52,7 +52,7 @@ bool easy2d::Transition::IsDone()
 
 void easy2d::Transition::Init(Scene * prev, Scene * next, Game * game)
 {
-	started_ = Time::Now();
+	started_ = game->GetTime();
 	out_scene_ = prev;
 	in_scene_ = next;
 
@@ -102,7 +102,8 @@ void easy2d::Transition::Update()
 	}
 	else
 	{
-		process_ = (Time::Now() - started_).Seconds() / duration_;
+		// 场景动画跟随游戏时钟，受全局时间缩放影响
+		process_ = (Game::GetInstance()->GetTime() - started_).Seconds() / duration_;
 		process_ = std::min(process_, 1.f);
 	}
 
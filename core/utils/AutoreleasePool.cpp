@@ -0,0 +1,103 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "../e2dobject.h"
+
+namespace
+{
+	bool deferred_enabled = false;
+	std::mutex pool_mutex;
+	std::vector<easy2d::Ref*> autoreleased_refs;
+	std::vector<easy2d::Ref*> deferred_refs;
+}
+
+void easy2d::AutoreleasePool::Add(Ref * ref)
+{
+	if (ref)
+	{
+		ref->Retain();
+
+		// 并行更新时可能从工作线程中添加
+		std::lock_guard<std::mutex> lock(pool_mutex);
+		autoreleased_refs.push_back(ref);
+	}
+}
+
+void easy2d::AutoreleasePool::SetDeferred(bool deferred)
+{
+	deferred_enabled = deferred;
+}
+
+bool easy2d::AutoreleasePool::IsDeferred()
+{
+	return deferred_enabled;
+}
+
+size_t easy2d::AutoreleasePool::GetCount()
+{
+	std::lock_guard<std::mutex> lock(pool_mutex);
+	return autoreleased_refs.size() + deferred_refs.size();
+}
+
+void easy2d::AutoreleasePool::Defer(Ref * ref)
+{
+	std::lock_guard<std::mutex> lock(pool_mutex);
+	deferred_refs.push_back(ref);
+}
+
+void easy2d::AutoreleasePool::Drain()
+{
+	std::vector<Ref*> refs;
+	for (;;)
+	{
+		{
+			std::lock_guard<std::mutex> lock(pool_mutex);
+			if (autoreleased_refs.empty() && deferred_refs.empty())
+				break;
+
+			refs.swap(autoreleased_refs);
+		}
+
+		for (auto ref : refs)
+		{
+			ref->Release();
+		}
+		refs.clear();
+
+		// 对象归零后可能被重新引用并再次归零，需要去除重复项
+		{
+			std::lock_guard<std::mutex> lock(pool_mutex);
+			refs.swap(deferred_refs);
+		}
+		std::sort(refs.begin(), refs.end());
+		refs.erase(std::unique(refs.begin(), refs.end()), refs.end());
+
+		// 析构函数中释放的对象会进入下一轮
+		for (auto ref : refs)
+		{
+			if (ref->GetRefCount() <= 0)
+			{
+				delete ref;
+			}
+		}
+		refs.clear();
+	}
+}
@@ -18,82 +18,94 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dutil.h"
+#include "../e2dutil.h"
 
 using namespace std::chrono;
 
 easy2d::Duration::Duration()
-	: duration_ms_()
+	: duration_()
 {
 }
 
 easy2d::Duration::Duration(float seconds)
-	: duration_ms_(static_cast<long long>(seconds * 1000.f))
+	: duration_(static_cast<long long>(seconds * 1000000.0 + (seconds < 0 ? -0.5 : 0.5)))
 {
 }
 
+easy2d::Duration easy2d::Duration::FromMicroseconds(long long microseconds)
+{
+	Duration d;
+	d.duration_ = std::chrono::microseconds(microseconds);
+	return d;
+}
+
+long long easy2d::Duration::Microseconds() const
+{
+	return duration_.count();
+}
+
 int easy2d::Duration::Milliseconds() const
 {
-	return static_cast<int>(duration_ms_.count());
+	return static_cast<int>(duration_.count() / 1000);
 }
 
 float easy2d::Duration::Seconds() const
 {
-	return duration_ms_.count() / 1000.f;
+	return static_cast<float>(duration_.count() / 1000000.0);
 }
 
 bool easy2d::Duration::operator==(const Duration & other) const
 {
-	return duration_ms_ == other.duration_ms_;
+	return duration_ == other.duration_;
 }
 
 bool easy2d::Duration::operator!=(const Duration & other) const
 {
-	return duration_ms_ != other.duration_ms_;
+	return duration_ != other.duration_;
 }
 
 bool easy2d::Duration::operator>(const Duration & other) const
 {
-	return duration_ms_ > other.duration_ms_;
+	return duration_ > other.duration_;
 }
 
 bool easy2d::Duration::operator>=(const Duration & other) const
 {
-	return duration_ms_ >= other.duration_ms_;
+	return duration_ >= other.duration_;
 }
 
 bool easy2d::Duration::operator<(const Duration & other) const
 {
-	return duration_ms_ < other.duration_ms_;
+	return duration_ < other.duration_;
 }
 
 bool easy2d::Duration::operator<=(const Duration & other) const
 {
-	return duration_ms_ <= other.duration_ms_;
+	return duration_ <= other.duration_;
 }
 
 easy2d::Duration easy2d::Duration::operator+(Duration const & other) const
 {
 	Duration d;
-	d.duration_ms_ = duration_ms_ + other.duration_ms_;
+	d.duration_ = duration_ + other.duration_;
 	return std::move(d);
 }
 
 easy2d::Duration easy2d::Duration::operator-(Duration const & other) const
 {
 	Duration d;
-	d.duration_ms_ = duration_ms_ - other.duration_ms_;
+	d.duration_ = duration_ - other.duration_;
 	return std::move(d);
 }
 
 easy2d::Duration & easy2d::Duration::operator+=(Duration const &other)
 {
-	duration_ms_ += other.duration_ms_;
+	duration_ += other.duration_;
 	return (*this);
 }
 
 easy2d::Duration & easy2d::Duration::operator-=(Duration const &other)
 {
-	duration_ms_ -= other.duration_ms_;
+	duration_ -= other.duration_;
 	return (*this);
 }
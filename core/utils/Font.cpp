@@ -18,7 +18,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dutil.h"
+#include "../e2dutil.h"
 
 easy2d::Font::Font()
 	: family("")
@@ -0,0 +1,143 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "../e2dutil.h"
+
+easy2d::LruCache::LruCache(size_t budget)
+	: budget_(budget)
+	, stats_()
+	, order_()
+	, entries_()
+{
+}
+
+void easy2d::LruCache::SetBudget(size_t bytes)
+{
+	budget_ = bytes;
+}
+
+size_t easy2d::LruCache::GetBudget() const
+{
+	return budget_;
+}
+
+const easy2d::LruCache::Stats & easy2d::LruCache::GetStats() const
+{
+	return stats_;
+}
+
+bool easy2d::LruCache::Contains(size_t key) const
+{
+	return entries_.find(key) != entries_.end();
+}
+
+bool easy2d::LruCache::Lookup(size_t key)
+{
+	if (Contains(key))
+	{
+		++stats_.hits;
+		return true;
+	}
+	++stats_.misses;
+	return false;
+}
+
+void easy2d::LruCache::Add(size_t key, size_t bytes)
+{
+	if (Contains(key))
+		return;
+
+	Entry entry;
+	entry.bytes = bytes;
+	entry.refs = 0;
+	entry.order = order_.insert(order_.end(), key);
+	entries_.insert(std::make_pair(key, entry));
+
+	stats_.bytes += bytes;
+	++stats_.count;
+}
+
+bool easy2d::LruCache::Retain(size_t key)
+{
+	auto iter = entries_.find(key);
+	if (iter == entries_.end())
+		return false;
+
+	auto& entry = iter->second;
+	++entry.refs;
+	order_.splice(order_.end(), order_, entry.order);
+	return true;
+}
+
+int easy2d::LruCache::Release(size_t key)
+{
+	auto iter = entries_.find(key);
+	if (iter == entries_.end() || iter->second.refs == 0)
+		return 0;
+
+	// 最后一次被引用的时间作为使用时间
+	auto& entry = iter->second;
+	if (--entry.refs == 0)
+	{
+		order_.splice(order_.end(), order_, entry.order);
+	}
+	return entry.refs;
+}
+
+int easy2d::LruCache::GetRefCount(size_t key) const
+{
+	auto iter = entries_.find(key);
+	return iter == entries_.end() ? 0 : iter->second.refs;
+}
+
+void easy2d::LruCache::Trim(std::vector<size_t>& evicted)
+{
+	if (budget_ == 0)
+		return;
+
+	// 从最久没有使用的项开始淘汰，跳过仍被引用的项
+	auto iter = order_.begin();
+	while (stats_.bytes > budget_ && iter != order_.end())
+	{
+		auto entry = entries_.find(*iter);
+		if (entry->second.refs > 0)
+		{
+			++iter;
+			continue;
+		}
+
+		stats_.bytes -= entry->second.bytes;
+		--stats_.count;
+		++stats_.evictions;
+
+		evicted.push_back(*iter);
+		entries_.erase(entry);
+		iter = order_.erase(iter);
+	}
+}
+
+void easy2d::LruCache::Clear()
+{
+	entries_.clear();
+	order_.clear();
+	stats_.bytes = 0;
+	stats_.count = 0;
+}
@@ -0,0 +1,224 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "../e2dobject.h"
+#include <malloc.h>
+
+namespace
+{
+	// 按 16 字节分级，超过 512 字节的对象直接从系统分配
+	const size_t kAlignment = 16;
+	const size_t kMaxPooledSize = 512;
+	const size_t kClassCount = kMaxPooledSize / kAlignment;
+
+	// 内存块按自身大小对齐，可以通过地址直接找到所属的内存块
+	const size_t kChunkShift = 16;
+	const size_t kChunkSize = size_t(1) << kChunkShift;
+
+	struct FreeBlock
+	{
+		FreeBlock * next;
+	};
+
+	// 每个线程使用自己的空闲链表，分配和释放不需要加锁
+	// 在其他线程释放的内存会进入释放线程的链表
+	E2D_THREAD_LOCAL FreeBlock * free_lists[kClassCount] = { nullptr };
+
+	// 只有向系统申请内存块时需要加锁
+	std::mutex chunk_mutex;
+
+	// 两级页表，记录每个内存块的分级序号加一，为 0 表示不属于内存池
+	const size_t kPageBits = 16;
+	const size_t kPageCount = size_t(1) << kPageBits;
+	UINT8 * page_map[kPageCount] = { nullptr };
+
+	std::atomic<size_t> live_count(0);
+	std::atomic<size_t> peak_count(0);
+	std::atomic<size_t> live_bytes(0);
+	std::atomic<size_t> reserved_bytes(0);
+
+	// 直接从系统分配的大对象在头部记录大小
+	struct LargeHeader
+	{
+		size_t size;
+		size_t padding;
+	};
+
+	size_t GetClassIndex(size_t size)
+	{
+		return (size + kAlignment - 1) / kAlignment - 1;
+	}
+
+	size_t GetChunkNumber(const void * p)
+	{
+		return reinterpret_cast<uintptr_t>(p) >> kChunkShift;
+	}
+
+	// 查找地址所属内存块的分级，不在内存池中时返回 0
+	size_t LookupClass(const void * p)
+	{
+		const size_t number = GetChunkNumber(p);
+		const UINT8 * page = page_map[(number >> kPageBits) & (kPageCount - 1)];
+		return page ? page[number & (kPageCount - 1)] : 0;
+	}
+
+	// 申请新的内存块，并切分成相同大小的内存加入当前线程的空闲链表
+	void Refill(size_t index)
+	{
+		const size_t block_size = (index + 1) * kAlignment;
+		const size_t count = kChunkSize / block_size;
+
+		char * chunk = static_cast<char*>(::_aligned_malloc(kChunkSize, kChunkSize));
+		if (!chunk)
+			throw std::bad_alloc();
+
+		{
+			std::lock_guard<std::mutex> lock(chunk_mutex);
+
+			const size_t number = GetChunkNumber(chunk);
+			UINT8 *& page = page_map[(number >> kPageBits) & (kPageCount - 1)];
+			if (!page)
+			{
+				page = new UINT8[kPageCount]();
+			}
+			page[number & (kPageCount - 1)] = static_cast<UINT8>(index + 1);
+		}
+		reserved_bytes += kChunkSize;
+
+		FreeBlock *& list = free_lists[index];
+		for (size_t i = count; i > 0; --i)
+		{
+			auto block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * block_size);
+			block->next = list;
+			list = block;
+		}
+	}
+
+	void OnAllocated(size_t size)
+	{
+		const size_t count = ++live_count;
+		live_bytes += size;
+
+		size_t peak = peak_count.load(std::memory_order_relaxed);
+		while (count > peak && !peak_count.compare_exchange_weak(peak, count))
+		{
+		}
+	}
+
+	void OnFreed(size_t size)
+	{
+		--live_count;
+		live_bytes -= size;
+	}
+
+	void FreeLarge(void * p)
+	{
+		LargeHeader * header = static_cast<LargeHeader*>(p) - 1;
+		OnFreed(header->size);
+		::operator delete(header);
+	}
+
+	void FreePooled(void * p, size_t index)
+	{
+		auto block = static_cast<FreeBlock*>(p);
+		block->next = free_lists[index];
+		free_lists[index] = block;
+		OnFreed((index + 1) * kAlignment);
+	}
+}
+
+void * easy2d::MemoryPool::Allocate(size_t size)
+{
+	if (size == 0)
+	{
+		size = 1;
+	}
+
+	if (size > kMaxPooledSize)
+	{
+		LargeHeader * header = static_cast<LargeHeader*>(::operator new(sizeof(LargeHeader) + size));
+		header->size = size;
+		OnAllocated(size);
+		return header + 1;
+	}
+
+	const size_t index = GetClassIndex(size);
+	if (!free_lists[index])
+	{
+		Refill(index);
+	}
+
+	FreeBlock * block = free_lists[index];
+	free_lists[index] = block->next;
+	OnAllocated((index + 1) * kAlignment);
+	return block;
+}
+
+void easy2d::MemoryPool::Free(void * p, size_t size)
+{
+	if (!p)
+		return;
+
+	if (size > kMaxPooledSize)
+	{
+		FreeLarge(p);
+	}
+	else
+	{
+		FreePooled(p, GetClassIndex(size == 0 ? 1 : size));
+	}
+}
+
+void easy2d::MemoryPool::Free(void * p)
+{
+	if (!p)
+		return;
+
+	const size_t index = LookupClass(p);
+	if (index)
+	{
+		FreePooled(p, index - 1);
+	}
+	else
+	{
+		FreeLarge(p);
+	}
+}
+
+size_t easy2d::MemoryPool::GetLiveCount()
+{
+	return live_count;
+}
+
+size_t easy2d::MemoryPool::GetPeakCount()
+{
+	return peak_count;
+}
+
+size_t easy2d::MemoryPool::GetLiveBytes()
+{
+	return live_bytes;
+}
+
+size_t easy2d::MemoryPool::GetReservedBytes()
+{
+	return reserved_bytes;
+}
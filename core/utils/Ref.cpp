@@ -18,7 +18,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dobject.h"
+#include "../e2dobject.h"
 
 easy2d::Ref::Ref()
 	: ref_count_(0)
@@ -29,18 +29,61 @@ easy2d::Ref::~Ref()
 {
 }
 
+void * easy2d::Ref::operator new(size_t size)
+{
+	return MemoryPool::Allocate(size);
+}
+
+void * easy2d::Ref::operator new(size_t size, const std::nothrow_t&) E2D_NOEXCEPT
+{
+	try
+	{
+		return MemoryPool::Allocate(size);
+	}
+	catch (const std::bad_alloc&)
+	{
+		return nullptr;
+	}
+}
+
+void easy2d::Ref::operator delete(void * p, size_t size)
+{
+	MemoryPool::Free(p, size);
+}
+
+void easy2d::Ref::operator delete(void * p, const std::nothrow_t&) E2D_NOEXCEPT
+{
+	MemoryPool::Free(p);
+}
+
 LONG easy2d::Ref::Retain()
 {
+#if E2D_ATOMIC_REF_COUNT
 	return ::InterlockedIncrement(&ref_count_);
+#else
+	return ++ref_count_;
+#endif
 }
 
 LONG easy2d::Ref::Release()
 {
+#if E2D_ATOMIC_REF_COUNT
 	LONG new_count = ::InterlockedDecrement(&ref_count_);
+#else
+	LONG new_count = --ref_count_;
+#endif
 
 	if (new_count <= 0)
 	{
-		delete this;
+		// 游戏运行时不在遍历过程中删除对象
+		if (AutoreleasePool::IsDeferred())
+		{
+			AutoreleasePool::Defer(this);
+		}
+		else
+		{
+			delete this;
+		}
 		return 0;
 	}
 
@@ -51,3 +94,9 @@ LONG easy2d::Ref::GetRefCount() const
 {
 	return ref_count_;
 }
+
+easy2d::Ref * easy2d::Ref::Autorelease()
+{
+	AutoreleasePool::Add(this);
+	return this;
+}
@@ -18,11 +18,54 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dutil.h"
+#include "../e2dutil.h"
 #include <iomanip>
 #include <cwctype>
-#include <comutil.h>
-#pragma comment(lib, "comsuppw.lib")
+
+#if !E2D_HEADLESS
+#	include <comutil.h>
+#	pragma comment(lib, "comsuppw.lib")
+#endif
+
+namespace
+{
+#if !E2D_HEADLESS
+	std::wstring ToWide(const char * str)
+	{
+		return static_cast<wchar_t*>(_bstr_t(str));
+	}
+
+	std::string ToNarrow(const wchar_t * str)
+	{
+		return static_cast<const char *>(_bstr_t(str));
+	}
+#else
+	// 按当前区域设置转换
+	std::wstring ToWide(const char * str)
+	{
+		std::wstring result;
+		const size_t length = std::mbstowcs(nullptr, str, 0);
+		if (length != static_cast<size_t>(-1))
+		{
+			result.resize(length);
+			std::mbstowcs(&result[0], str, length);
+		}
+		return result;
+	}
+
+	std::string ToNarrow(const wchar_t * str)
+	{
+		std::string result;
+		const size_t length = std::wcstombs(nullptr, str, 0);
+		if (length != static_cast<size_t>(-1))
+		{
+			result.resize(length);
+			std::wcstombs(&result[0], str, length);
+		}
+		return result;
+	}
+#endif
+}
 
 
 easy2d::String::String()
@@ -36,7 +79,7 @@ easy2d::String::String(const wchar_t *str)
 }
 
 easy2d::String::String(const char *cstr)
-	: string_(static_cast<wchar_t*>(_bstr_t(cstr)))
+	: string_(ToWide(cstr))
 {
 }
 
@@ -63,7 +106,7 @@ easy2d::String &easy2d::String::operator=(const wchar_t *str)
 
 easy2d::String & easy2d::String::operator=(const char *cstr)
 {
-	string_ = static_cast<wchar_t*>(_bstr_t(cstr));
+	string_ = ToWide(cstr);
 	return (*this);
 }
 
@@ -220,7 +263,7 @@ easy2d::String easy2d::String::operator+(const wchar_t *str) const
 easy2d::String easy2d::String::operator+(const char *str) const
 {
 	String temp;
-	temp.string_ = string_ + static_cast<wchar_t*>(_bstr_t(str));
+	temp.string_ = string_ + ToWide(str);
 	return std::move(temp);
 }
 
@@ -241,7 +284,7 @@ easy2d::String easy2d::operator+(const wchar_t *str1, const easy2d::String &str2
 easy2d::String easy2d::operator+(const char *str1, const String &str2)
 {
 	String temp;
-	temp.string_ = static_cast<wchar_t*>(_bstr_t(str1)) + str2.string_;
+	temp.string_ = ToWide(str1) + str2.string_;
 	return std::move(temp);
 }
 
@@ -253,7 +296,7 @@ easy2d::String & easy2d::String::operator+=(const wchar_t *str)
 
 easy2d::String & easy2d::String::operator+=(const char *str)
 {
-	string_ += static_cast<wchar_t*>(_bstr_t(str));
+	string_ += ToWide(str);
 	return (*this);
 }
 
@@ -303,13 +346,13 @@ easy2d::String & easy2d::String::operator<<(wchar_t *str)
 
 easy2d::String & easy2d::String::operator<<(const char * cstr)
 {
-	string_ += static_cast<wchar_t*>(_bstr_t(cstr));
+	string_ += ToWide(cstr);
 	return (*this);
 }
 
 easy2d::String & easy2d::String::operator<<(char * cstr)
 {
-	string_ += static_cast<wchar_t*>(_bstr_t(cstr));
+	string_ += ToWide(cstr);
 	return (*this);
 }
 
@@ -354,7 +397,7 @@ easy2d::String::operator std::wstring() const
 
 easy2d::String::operator std::string() const
 {
-	std::string str = static_cast<const char *>(_bstr_t(string_.c_str()));
+	std::string str = ToNarrow(string_.c_str());
 	return std::move(str);
 }
 
@@ -506,7 +549,7 @@ std::wistream & easy2d::operator>>(std::wistream &cin, String &str)
 
 std::ostream & easy2d::operator<<(std::ostream &cout, const String &str)
 {
-	std::string cstr = static_cast<char*>(_bstr_t(str.string_.c_str()));
+	std::string cstr = ToNarrow(str.string_.c_str());
 	cout << cstr;
 	return cout;
 }
@@ -515,6 +558,6 @@ std::istream & easy2d::operator>>(std::istream &cin, String &str)
 {
 	std::string temp;
 	cin >> temp;
-	str.string_ = static_cast<wchar_t*>(_bstr_t(temp.c_str()));
+	str.string_ = ToWide(temp.c_str());
 	return cin;
 }
\ No newline at end of file
@@ -18,7 +18,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "..\e2dutil.h"
+#include "../e2dutil.h"
 
 using namespace std::chrono;
 
@@ -29,7 +29,7 @@ easy2d::Time::Time()
 
 time_t easy2d::Time::GetTimeStamp() const
 {
-	auto& duration = time_point_cast<milliseconds>(time_).time_since_epoch();
+	auto duration = time_point_cast<milliseconds>(time_).time_since_epoch();
 	return static_cast<time_t>(duration.count());
 }
 
@@ -41,33 +41,32 @@ bool easy2d::Time::IsZero() const
 easy2d::Time easy2d::Time::operator+(Duration const & other) const
 {
 	Time t;
-	t.time_ = time_ + milliseconds(other.Milliseconds());
+	t.time_ = time_ + other.duration_;
 	return std::move(t);
 }
 
 easy2d::Time easy2d::Time::operator-(Duration const & other) const
 {
 	Time t;
-	t.time_ = time_ - milliseconds(other.Milliseconds());
+	t.time_ = time_ - other.duration_;
 	return std::move(t);
 }
 
 easy2d::Time & easy2d::Time::operator+=(Duration const & other)
 {
-	time_ += milliseconds(other.Milliseconds());
+	time_ += other.duration_;
 	return (*this);
 }
 
 easy2d::Time & easy2d::Time::operator-=(Duration const &other)
 {
-	time_ -= milliseconds(other.Milliseconds());
+	time_ -= other.duration_;
 	return (*this);
 }
 
 easy2d::Duration easy2d::Time::operator-(Time const & other) const
 {
-	auto ms = duration_cast<milliseconds>(time_ - other.time_).count();
-	return std::move(Duration(static_cast<float>(ms) / 1000.f));
+	return Duration::FromMicroseconds(duration_cast<microseconds>(time_ - other.time_).count());
 }
 
 easy2d::Time easy2d::Time::Now()
@@ -0,0 +1,254 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "Test.h"
+
+using namespace easy2d;
+
+namespace
+{
+	// 重写了 Update 但没有重写 Clone 的移动动作
+	class CountingMove
+		: public MoveBy
+	{
+	public:
+		CountingMove() : MoveBy(1, Point(10, 0)), updates(0) {}
+
+		int updates;
+
+	protected:
+		virtual void Update() override
+		{
+			++updates;
+			MoveBy::Update();
+		}
+	};
+
+	// 可以手动推进时钟的节点
+	class ClockNode
+		: public Node
+	{
+	public:
+		using Node::AdvanceTime;
+	};
+
+	// 离开原点时释放另一个节点
+	class ReleasingNode
+		: public ClockNode
+	{
+	public:
+		ReleasingNode() : other(nullptr) {}
+
+		virtual void SetPosition(float x, float y) override
+		{
+			Node::SetPosition(x, y);
+			if (x > 0)
+			{
+				SafeRelease(other);
+			}
+		}
+
+		Node * other;
+	};
+
+	// 推进一帧并更新所有动作
+	void Step(ClockNode * node, float dt)
+	{
+		node->AdvanceTime(dt, Duration(dt));
+		ActionManager::GetInstance()->Update(nullptr);
+		TweenManager::GetInstance()->Update(nullptr);
+	}
+}
+
+E2D_TEST(CompileKeepsDerivedAction)
+{
+	auto move = new MoveBy(1, Point(10, 0));
+	move->Retain();
+	auto counting = new CountingMove();
+	counting->Retain();
+
+	// 内置动作编译为补间步骤，派生的动作只能按普通动作执行
+	E2D_CHECK(move->GetProgram()->GetStepCount() == 1);
+	E2D_CHECK(counting->GetProgram()->GetStepCount() == 1);
+
+	auto sequence = new Sequence({ move, counting });
+	sequence->Retain();
+	E2D_CHECK(sequence->GetProgram()->GetStepCount() == 3);
+
+	sequence->Release();
+	counting->Release();
+	move->Release();
+}
+
+E2D_TEST(RunActionCallsDerivedUpdate)
+{
+	Node * node = new Node();
+	node->Retain();
+
+	auto counting = new CountingMove();
+	counting->Retain();
+	node->RunAction(counting);
+	ActionManager::GetInstance()->Update(nullptr);
+	E2D_CHECK(counting->updates == 1);
+
+	// 组合动作中的派生动作同样执行重写的 Update
+	auto inner = new CountingMove();
+	auto sequence = new Sequence({ inner });
+	node->RunAction(sequence);
+	ActionManager::GetInstance()->Update(nullptr);
+	E2D_CHECK(counting->updates == 2);
+	E2D_CHECK(inner->updates == 1);
+
+	node->StopAllActions();
+	ActionManager::GetInstance()->Update(nullptr);
+	counting->Release();
+	node->Release();
+}
+
+E2D_TEST(RunActionForwardsControl)
+{
+	Node * node = new Node();
+	node->Retain();
+	Node * other = new Node();
+	other->Retain();
+
+	auto move = new MoveBy(1, Point(10, 0));
+	move->Retain();
+	RunProgram * run = node->RunAction(move);
+	RunProgram * other_run = other->RunAction(move);
+	E2D_CHECK(run && run->GetSource() == move);
+	E2D_CHECK(move->GetTarget() == other);
+	E2D_CHECK(!move->IsDone());
+
+	// 控制动作本身作用于所有执行
+	move->SetName(L"walk");
+	move->SetTag(3);
+	E2D_CHECK(run->GetName() == L"walk" && other_run->GetTag() == 3);
+	move->Pause();
+	E2D_CHECK(!run->IsRunning() && !other_run->IsRunning());
+	move->Resume();
+	E2D_CHECK(run->IsRunning() && other_run->IsRunning());
+
+	// 控制执行只作用于一个节点
+	run->Stop();
+	E2D_CHECK(!move->IsDone() && !other_run->IsDone());
+	move->Stop();
+	E2D_CHECK(other_run->IsDone() && move->IsDone());
+
+	ActionManager::GetInstance()->Update(nullptr);
+	E2D_CHECK(node->GetAllActions().empty() && other->GetAllActions().empty());
+	E2D_CHECK(move->GetTarget() == nullptr);
+
+	move->Release();
+	other->Release();
+	node->Release();
+}
+
+E2D_TEST(SequenceStepsUseTweenLanes)
+{
+	ClockNode * node = new ClockNode();
+	node->Retain();
+
+	auto sequence = new Sequence({ new MoveBy(1, Point(10, 0)), new MoveBy(1, Point(0, 10)) });
+	node->RunAction(sequence);
+
+	// 动作从第一次更新开始计时，补间步骤在第一帧之后转交给补间管理器
+	Step(node, 0);
+	Step(node, 0.25f);
+	E2D_CHECK(TweenManager::GetInstance()->GetCount() == 1);
+	E2D_CHECK(std::abs(node->GetPosition().x - 2.5f) < 1e-3f);
+
+	Step(node, 0.25f);
+	E2D_CHECK(std::abs(node->GetPosition().x - 5.f) < 1e-3f);
+
+	// 其他方式造成的位移会叠加到补间上
+	node->MoveBy(0, 1);
+	Step(node, 0.25f);
+	E2D_CHECK(std::abs(node->GetPosition().x - 7.5f) < 1e-3f);
+	E2D_CHECK(std::abs(node->GetPosition().y - 1.f) < 1e-3f);
+
+	// 第一步结束时写回最终位置，第二步从该位置开始
+	Step(node, 0.5f);
+	E2D_CHECK(TweenManager::GetInstance()->GetCount() == 1);
+	E2D_CHECK(std::abs(node->GetPosition().x - 10.f) < 1e-3f);
+	E2D_CHECK(std::abs(node->GetPosition().y - 3.5f) < 1e-3f);
+
+	Step(node, 1.f);
+	E2D_CHECK(TweenManager::GetInstance()->GetCount() == 0);
+	E2D_CHECK(node->GetAllActions().empty());
+	E2D_CHECK(std::abs(node->GetPosition().x - 10.f) < 1e-3f);
+	E2D_CHECK(std::abs(node->GetPosition().y - 11.f) < 1e-3f);
+
+	node->Release();
+}
+
+E2D_TEST(TweenRemovalDuringScatter)
+{
+	ReleasingNode * first = new ReleasingNode();
+	first->Retain();
+	ClockNode * second = new ClockNode();
+	second->Retain();
+	first->other = second;
+
+	first->RunAction(new MoveBy(1, Point(10, 0)));
+	second->RunAction(new MoveBy(1, Point(10, 0)));
+	Step(first, 0);
+	E2D_CHECK(TweenManager::GetInstance()->GetCount() == 2);
+
+	// 写回第一个补间时释放第二个节点，它的补间在更新结束后移除
+	Step(first, 0.25f);
+	E2D_CHECK(first->other == nullptr);
+	E2D_CHECK(TweenManager::GetInstance()->GetCount() == 1);
+
+	first->StopAllActions();
+	Step(first, 0.25f);
+	E2D_CHECK(TweenManager::GetInstance()->GetCount() == 0);
+	first->Release();
+}
+
+E2D_TEST(TweenRunsAsProgramStep)
+{
+	ClockNode * first = new ClockNode();
+	first->Retain();
+	ClockNode * second = new ClockNode();
+	second->Retain();
+
+	auto tween = CreateTween(1.f, 0.f, 1.f, OpacitySetter());
+	tween->Retain();
+	E2D_CHECK(tween->GetProgram()->GetStepCount() == 1);
+
+	// 两个节点共享补间的定义，各自按自己的时间设置属性
+	first->RunAction(tween);
+	Step(first, 0);
+	second->RunAction(tween);
+	Step(first, 0.5f);
+	Step(second, 0);
+	Step(second, 0.25f);
+	E2D_CHECK(std::abs(first->GetOpacity() - 0.5f) < 1e-3f);
+	E2D_CHECK(std::abs(second->GetOpacity() - 0.25f) < 1e-3f);
+
+	Step(first, 0.5f);
+	E2D_CHECK(std::abs(first->GetOpacity() - 1.f) < 1e-3f);
+	E2D_CHECK(first->GetAllActions().empty());
+
+	tween->Release();
+	second->Release();
+	first->Release();
+}
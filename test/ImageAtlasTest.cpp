@@ -0,0 +1,82 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "Test.h"
+
+using namespace easy2d;
+
+namespace
+{
+	// 纯色的预乘像素
+	std::vector<BYTE> SolidPixels(UINT width, UINT height)
+	{
+		return std::vector<BYTE>(static_cast<size_t>(width) * height * 4, 255);
+	}
+}
+
+E2D_TEST(AtlasPacksImagesIntoPages)
+{
+	ImageAtlas * atlas = new ImageAtlas(64, 64, 1, 1);
+	atlas->Retain();
+
+	// 每张图片加上边缘和间隔后占用 17x17，一页可以放下 9 张
+	bool added = true;
+	for (int i = 0; i < 12; ++i)
+	{
+		added = atlas->Add(String(L"image") + String::Parse(i), 14, 14, SolidPixels(14, 14)) && added;
+	}
+	E2D_CHECK(added);
+	E2D_CHECK(atlas->Build());
+	E2D_CHECK(atlas->GetPageCount() == 2);
+	E2D_CHECK(atlas->GetOccupancy() > 0.5f);
+
+	atlas->Release();
+}
+
+E2D_TEST(AtlasGivesOversizedImageItsOwnPage)
+{
+	ImageAtlas * atlas = new ImageAtlas(64, 64, 1, 1);
+	atlas->Retain();
+
+	E2D_CHECK(atlas->Add(L"small", 10, 10, SolidPixels(10, 10)));
+	E2D_CHECK(atlas->Add(L"wide", 100, 20, SolidPixels(100, 20)));
+
+	// 超出页面大小的图片不会被丢弃
+	E2D_CHECK(atlas->Build());
+	E2D_CHECK(atlas->GetPageCount() == 2);
+
+	const float image_area = 10.f * 10 + 100.f * 20;
+	const float page_area = 13.f * 13 + 103.f * 23;
+	E2D_CHECK(std::fabs(atlas->GetOccupancy() - image_area / page_area) < 1e-4f);
+
+	atlas->Release();
+}
+
+E2D_TEST(AtlasRejectsMismatchedPixels)
+{
+	ImageAtlas * atlas = new ImageAtlas(64, 64);
+	atlas->Retain();
+
+	E2D_CHECK(!atlas->Add(L"broken", 10, 10, SolidPixels(10, 9)));
+	E2D_CHECK(!atlas->Add(L"", 10, 10, SolidPixels(10, 10)));
+	E2D_CHECK(!atlas->Build());
+
+	atlas->Release();
+}
@@ -0,0 +1,250 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "Test.h"
+
+using namespace easy2d;
+
+namespace
+{
+	const size_t kBytes = 100;
+
+	int live_bitmaps = 0;
+
+	// 只有引用计数和像素大小的位图
+	class FakeBitmap
+		: public ID2D1Bitmap
+	{
+	public:
+		FakeBitmap(UINT width, UINT height) : refs_(1), width_(width), height_(height) { ++live_bitmaps; }
+
+		virtual ULONG STDMETHODCALLTYPE AddRef() override { return ++refs_; }
+
+		virtual ULONG STDMETHODCALLTYPE Release() override
+		{
+			ULONG refs = --refs_;
+			if (refs == 0)
+			{
+				--live_bitmaps;
+				delete this;
+			}
+			return refs;
+		}
+
+		virtual D2D1_SIZE_F STDMETHODCALLTYPE GetSize() const override
+		{
+			return D2D1::SizeF(static_cast<float>(width_), static_cast<float>(height_));
+		}
+
+		virtual D2D1_SIZE_U STDMETHODCALLTYPE GetPixelSize() const override
+		{
+			return D2D1::SizeU(width_, height_);
+		}
+
+	private:
+		ULONG refs_;
+		UINT width_;
+		UINT height_;
+	};
+
+	// 和 Image::Load 一样查找位图，未命中时创建位图，之后引用它
+	ID2D1Bitmap * LoadBitmap(BitmapCache& cache, size_t key)
+	{
+		if (!cache.Lookup(key))
+		{
+			cache.Add(key, new FakeBitmap(16, 16));
+		}
+		return cache.Acquire(key);
+	}
+
+	// 添加一组大小相同的缓存项，键从 1 开始
+	void AddEntries(LruCache& cache, size_t count)
+	{
+		for (size_t key = 1; key <= count; ++key)
+		{
+			cache.Add(key, kBytes);
+		}
+	}
+}
+
+E2D_TEST(CacheTrimEvictsLeastRecentlyUsed)
+{
+	LruCache cache(3 * kBytes);
+	AddEntries(cache, 5);
+
+	std::vector<size_t> evicted;
+	cache.Trim(evicted);
+
+	E2D_CHECK(evicted.size() == 2);
+	E2D_CHECK(evicted[0] == 1 && evicted[1] == 2);
+	E2D_CHECK(!cache.Contains(1) && !cache.Contains(2));
+	E2D_CHECK(cache.Contains(3) && cache.Contains(4) && cache.Contains(5));
+	E2D_CHECK(cache.GetStats().bytes == 3 * kBytes);
+	E2D_CHECK(cache.GetStats().count == 3);
+	E2D_CHECK(cache.GetStats().evictions == 2);
+}
+
+E2D_TEST(CacheReferencedEntriesSurvive)
+{
+	LruCache cache(2 * kBytes);
+	AddEntries(cache, 3);
+	cache.Retain(1);
+
+	std::vector<size_t> evicted;
+	cache.Trim(evicted);
+
+	// 最久没有使用的项仍被引用，淘汰下一个
+	E2D_CHECK(evicted.size() == 1 && evicted[0] == 2);
+	E2D_CHECK(cache.Contains(1));
+	E2D_CHECK(cache.GetRefCount(1) == 1);
+}
+
+E2D_TEST(CacheReleaseMarksRecentlyUsed)
+{
+	LruCache cache(2 * kBytes);
+	AddEntries(cache, 3);
+	cache.Retain(1);
+	E2D_CHECK(cache.Release(1) == 0);
+
+	std::vector<size_t> evicted;
+	cache.Trim(evicted);
+
+	// 取消引用的时间作为使用时间，1 比 2 更晚使用
+	E2D_CHECK(evicted.size() == 1 && evicted[0] == 2);
+	E2D_CHECK(cache.Contains(1) && cache.Contains(3));
+}
+
+E2D_TEST(CachePinnedBatchLargerThanBudget)
+{
+	// 预加载的图片比预算多时，整批完成前全部保持引用
+	const size_t count = 10;
+	LruCache cache(kBytes * 5 / 2);
+
+	std::vector<size_t> evicted;
+	for (size_t key = 1; key <= count; ++key)
+	{
+		cache.Add(key, kBytes);
+		cache.Retain(key);
+		cache.Trim(evicted);
+	}
+
+	E2D_CHECK(evicted.empty());
+	E2D_CHECK(cache.GetStats().count == count);
+	E2D_CHECK(cache.GetStats().bytes == count * kBytes);
+
+	for (size_t key = 1; key <= count; ++key)
+	{
+		cache.Release(key);
+	}
+	cache.Trim(evicted);
+
+	// 完成后按使用顺序淘汰到预算以内，只保留最后两项
+	E2D_CHECK(evicted.size() == count - 2);
+	E2D_CHECK(evicted.front() == 1 && evicted.back() == count - 2);
+	E2D_CHECK(cache.Contains(count - 1) && cache.Contains(count));
+	E2D_CHECK(cache.GetStats().bytes == 2 * kBytes);
+	E2D_CHECK(cache.GetStats().evictions == count - 2);
+}
+
+E2D_TEST(CacheLookupCountsHitsAndMisses)
+{
+	LruCache cache;
+	E2D_CHECK(!cache.Lookup(1));
+	cache.Add(1, kBytes);
+	E2D_CHECK(cache.Lookup(1));
+	E2D_CHECK(cache.Lookup(1));
+
+	E2D_CHECK(cache.GetStats().hits == 2);
+	E2D_CHECK(cache.GetStats().misses == 1);
+}
+
+E2D_TEST(CacheZeroBudgetIsUnlimited)
+{
+	LruCache cache;
+	AddEntries(cache, 100);
+
+	std::vector<size_t> evicted;
+	cache.Trim(evicted);
+
+	E2D_CHECK(evicted.empty());
+	E2D_CHECK(cache.GetStats().count == 100);
+}
+
+E2D_TEST(CacheClearKeepsCounters)
+{
+	LruCache cache(kBytes);
+	AddEntries(cache, 2);
+	cache.Lookup(1);
+
+	std::vector<size_t> evicted;
+	cache.Trim(evicted);
+	cache.Clear();
+
+	E2D_CHECK(!cache.Contains(2));
+	E2D_CHECK(cache.GetStats().bytes == 0);
+	E2D_CHECK(cache.GetStats().count == 0);
+	E2D_CHECK(cache.GetStats().hits == 1);
+	E2D_CHECK(cache.GetStats().evictions == 1);
+	E2D_CHECK(cache.Release(2) == 0);
+}
+
+E2D_TEST(BitmapCacheCyclesImagesOverBudget)
+{
+	const size_t image_bytes = 16 * 16 * 4;
+	const size_t image_count = 10;
+	BitmapCache cache(4 * image_bytes);
+
+	// 一张图片依次加载多张位图，位图数量始终不超过预算加上正在使用的一张
+	size_t current = 0;
+	bool within_budget = true;
+	for (int round = 0; round < 3; ++round)
+	{
+		for (size_t key = 1; key <= image_count; ++key)
+		{
+			E2D_CHECK(LoadBitmap(cache, key) != nullptr);
+			if (current)
+			{
+				cache.Release(current);
+			}
+			current = key;
+
+			within_budget = within_budget &&
+				cache.GetStats().bytes <= 4 * image_bytes &&
+				live_bitmaps <= 5;
+		}
+	}
+	E2D_CHECK(within_budget);
+
+	// 按顺序循环的图片多于预算时每次都未命中
+	E2D_CHECK(cache.GetStats().misses == 3 * image_count);
+	E2D_CHECK(cache.GetStats().hits == 0);
+	E2D_CHECK(cache.GetStats().evictions == 3 * image_count - 4);
+
+	// 最近使用的图片仍在缓存中
+	E2D_CHECK(LoadBitmap(cache, image_count - 1) != nullptr);
+	E2D_CHECK(cache.GetStats().hits == 1);
+	cache.Release(image_count - 1);
+	cache.Release(current);
+
+	cache.Clear();
+	E2D_CHECK(live_bitmaps == 0);
+	E2D_CHECK(cache.GetStats().count == 0);
+}
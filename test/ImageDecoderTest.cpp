@@ -0,0 +1,225 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "Test.h"
+
+using namespace easy2d;
+
+namespace
+{
+	// 16x16 RGBA，逐行轮换五种过滤方式，动态 Huffman 压缩
+	// 像素为 (x * 16, y * 16, (x + y) * 8)，左半透明度 255，右半 128
+	const BYTE kRgbaPng[] = {
+		0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D, 0x49, 0x48, 0x44, 0x52,
+		0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x08, 0x06, 0x00, 0x00, 0x00, 0x1F, 0xF3, 0xFF,
+		0x61, 0x00, 0x00, 0x00, 0xFA, 0x49, 0x44, 0x41, 0x54, 0x78, 0xDA, 0xC5, 0xD0, 0x1D, 0x9B, 0xC3,
+		0x40, 0x14, 0xC5, 0xF1, 0xBB, 0x2F, 0x10, 0x1C, 0x5C, 0x0C, 0x2C, 0x14, 0x07, 0x8B, 0xC1, 0xE2,
+		0xC5, 0xE0, 0x60, 0x71, 0x30, 0x78, 0xD6, 0x82, 0x83, 0xC1, 0x8B, 0xC5, 0xC1, 0x62, 0x6A, 0xC5,
+		0xE0, 0x62, 0x70, 0xF1, 0x7E, 0x83, 0xB3, 0xDD, 0xFD, 0x00, 0x91, 0x42, 0xE0, 0x4F, 0xE7, 0x79,
+		0x0E, 0xFC, 0x44, 0x44, 0x18, 0xA4, 0x61, 0x2B, 0x81, 0x51, 0x3E, 0xD8, 0x49, 0x4B, 0x95, 0x03,
+		0x93, 0x44, 0x66, 0x39, 0x12, 0xD2, 0xA1, 0xC8, 0x09, 0x26, 0x8A, 0x2A, 0x3D, 0x66, 0x49, 0x58,
+		0xE4, 0x8C, 0x55, 0x32, 0x5C, 0x06, 0xBC, 0x48, 0x68, 0xFE, 0x0E, 0x64, 0xA3, 0xAF, 0xAD, 0xFD,
+		0xF5, 0x71, 0x20, 0xCF, 0xF4, 0x26, 0x6D, 0x40, 0xD3, 0x34, 0xB2, 0xD1, 0x6D, 0x6B, 0x7F, 0xFF,
+		0x7F, 0x92, 0x67, 0xD2, 0x03, 0x83, 0x46, 0xB6, 0x7A, 0x64, 0xD4, 0x8E, 0x9D, 0x9E, 0xA8, 0xAA,
+		0x4C, 0xDA, 0x33, 0x6B, 0x22, 0xF4, 0x8C, 0xA2, 0x19, 0xA6, 0x03, 0xAA, 0x02, 0xB3, 0x8E, 0x58,
+		0xB4, 0x60, 0xD5, 0x09, 0xAE, 0xF6, 0x40, 0x4C, 0x71, 0x6F, 0xC4, 0xD3, 0xE7, 0xDE, 0x88, 0xA6,
+		0x0C, 0xD6, 0xB3, 0xB5, 0xC4, 0x68, 0x67, 0x76, 0x96, 0xA9, 0x36, 0x30, 0x19, 0x98, 0x6D, 0x24,
+		0xAC, 0xA0, 0xD8, 0x04, 0x33, 0x43, 0xB5, 0x0B, 0x66, 0xAB, 0x58, 0xEC, 0x8A, 0xD5, 0x66, 0xB8,
+		0xDD, 0x1F, 0x88, 0xB5, 0xDF, 0x1B, 0x31, 0x1F, 0xF7, 0x46, 0xF4, 0x81, 0xC1, 0xC1, 0xD6, 0x47,
+		0x46, 0x2F, 0xEC, 0x7C, 0xA2, 0xBA, 0x31, 0xF9, 0x85, 0xD9, 0x2B, 0xE1, 0x57, 0x14, 0x9F, 0x61,
+		0x7E, 0x47, 0xF5, 0x05, 0xB3, 0x7F, 0x63, 0xF1, 0x15, 0xAB, 0xFF, 0xC0, 0xDD, 0xF1, 0x0B, 0xDC,
+		0x2B, 0xA3, 0xD6, 0xA4, 0xD6, 0xEE, 0x69, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4E, 0x44, 0xAE,
+		0x42, 0x60, 0x82,
+	};
+
+	// 4x2 的 2 位调色板图片，带透明度表，未压缩
+	// 调色板为红、绿、蓝、白，透明度为 255、0、128、255，两行索引为 0 1 2 3 和 3 2 1 0
+	const BYTE kPalettePng[] = {
+		0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D, 0x49, 0x48, 0x44, 0x52,
+		0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x02, 0x02, 0x03, 0x00, 0x00, 0x00, 0x02, 0xC6, 0x95,
+		0xF0, 0x00, 0x00, 0x00, 0x0C, 0x50, 0x4C, 0x54, 0x45, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00,
+		0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFB, 0x00, 0x60, 0xF6, 0x00, 0x00, 0x00, 0x03, 0x74, 0x52, 0x4E,
+		0x53, 0xFF, 0x00, 0x80, 0xA9, 0x56, 0x73, 0x13, 0x00, 0x00, 0x00, 0x0F, 0x49, 0x44, 0x41, 0x54,
+		0x78, 0x01, 0x01, 0x04, 0x00, 0xFB, 0xFF, 0x00, 0x1B, 0x00, 0xE4, 0x01, 0x39, 0x01, 0x00, 0x27,
+		0xD7, 0x7A, 0x3A, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4E, 0x44, 0xAE, 0x42, 0x60, 0x82,
+	};
+
+	// 3x1 的 8 位灰度图片，固定 Huffman 压缩，像素为 0、128、255
+	const BYTE kGrayPng[] = {
+		0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D, 0x49, 0x48, 0x44, 0x52,
+		0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x01, 0x08, 0x00, 0x00, 0x00, 0x00, 0x3E, 0x8B, 0x4B,
+		0x68, 0x00, 0x00, 0x00, 0x0C, 0x49, 0x44, 0x41, 0x54, 0x78, 0x01, 0x63, 0x60, 0x68, 0xF8, 0x0F,
+		0x00, 0x02, 0x03, 0x01, 0x80, 0x36, 0xE2, 0x49, 0xC4, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4E,
+		0x44, 0xAE, 0x42, 0x60, 0x82,
+	};
+
+	// 生成 24 位 BMP 文件数据，像素按从上到下的顺序给出 RGB
+	std::vector<BYTE> MakeBmp(int width, int height, const BYTE * rgb)
+	{
+		const int stride = (width * 3 + 3) / 4 * 4;
+		std::vector<BYTE> data(54 + stride * height, 0);
+
+		auto put32 = [&](size_t pos, UINT value)
+		{
+			for (int i = 0; i < 4; ++i)
+			{
+				data[pos + i] = static_cast<BYTE>(value >> (i * 8));
+			}
+		};
+		data[0] = 'B';
+		data[1] = 'M';
+		put32(2, static_cast<UINT>(data.size()));
+		put32(10, 54);
+		put32(14, 40);
+		put32(18, width);
+		put32(22, height);
+		data[26] = 1;
+		data[28] = 24;
+
+		// 自下而上存放
+		for (int y = 0; y < height; ++y)
+		{
+			BYTE * row = &data[54 + stride * (height - 1 - y)];
+			for (int x = 0; x < width; ++x)
+			{
+				const BYTE * src = rgb + (y * width + x) * 3;
+				row[x * 3 + 0] = src[2];
+				row[x * 3 + 1] = src[1];
+				row[x * 3 + 2] = src[0];
+			}
+		}
+		return data;
+	}
+
+	bool PixelEquals(const std::vector<BYTE>& pixels, size_t index, int b, int g, int r, int a)
+	{
+		const BYTE * p = &pixels[index * 4];
+		return p[0] == b && p[1] == g && p[2] == r && p[3] == a;
+	}
+}
+
+E2D_TEST(DecodePngFilteredRgba)
+{
+	PortableImageDecoder decoder;
+	UINT width = 0, height = 0;
+	std::vector<BYTE> pixels;
+	E2D_CHECK(decoder.Decode(kRgbaPng, sizeof(kRgbaPng), &width, &height, pixels));
+	E2D_CHECK(width == 16 && height == 16);
+	E2D_CHECK(pixels.size() == 16 * 16 * 4);
+
+	bool matches = true;
+	for (int y = 0; y < 16 && pixels.size() == 16 * 16 * 4; ++y)
+	{
+		for (int x = 0; x < 16; ++x)
+		{
+			// 输出为预乘透明度的 BGRA
+			const int a = (x < 8) ? 255 : 128;
+			const int r = (x * 16 * a + 127) / 255;
+			const int g = (y * 16 * a + 127) / 255;
+			const int b = ((x + y) * 8 * a + 127) / 255;
+			matches = matches && PixelEquals(pixels, y * 16 + x, b, g, r, a);
+		}
+	}
+	E2D_CHECK(matches);
+}
+
+E2D_TEST(DecodePngPaletteAndGray)
+{
+	PortableImageDecoder decoder;
+	UINT width = 0, height = 0;
+	std::vector<BYTE> pixels;
+
+	E2D_CHECK(decoder.Decode(kPalettePng, sizeof(kPalettePng), &width, &height, pixels));
+	E2D_CHECK(width == 4 && height == 2);
+	if (pixels.size() == 4 * 2 * 4)
+	{
+		E2D_CHECK(PixelEquals(pixels, 0, 0, 0, 255, 255));
+		E2D_CHECK(PixelEquals(pixels, 1, 0, 0, 0, 0));
+		E2D_CHECK(PixelEquals(pixels, 2, 128, 0, 0, 128));
+		E2D_CHECK(PixelEquals(pixels, 3, 255, 255, 255, 255));
+		E2D_CHECK(PixelEquals(pixels, 4, 255, 255, 255, 255));
+		E2D_CHECK(PixelEquals(pixels, 7, 0, 0, 255, 255));
+	}
+
+	E2D_CHECK(decoder.Decode(kGrayPng, sizeof(kGrayPng), &width, &height, pixels));
+	E2D_CHECK(width == 3 && height == 1);
+	if (pixels.size() == 3 * 4)
+	{
+		E2D_CHECK(PixelEquals(pixels, 0, 0, 0, 0, 255));
+		E2D_CHECK(PixelEquals(pixels, 1, 128, 128, 128, 255));
+		E2D_CHECK(PixelEquals(pixels, 2, 255, 255, 255, 255));
+	}
+}
+
+E2D_TEST(DecodeBmpFromFile)
+{
+	const BYTE rgb[] = {
+		255, 0, 0,		0, 255, 0,		0, 0, 255,
+		10, 20, 30,		40, 50, 60,		70, 80, 90,
+	};
+	std::vector<BYTE> data = MakeBmp(3, 2, rgb);
+
+	const char * path = "image_decoder_test.bmp";
+	FILE * file = std::fopen(path, "wb");
+	E2D_CHECK(file != nullptr);
+	if (!file)
+		return;
+	std::fwrite(&data[0], 1, data.size(), file);
+	std::fclose(file);
+
+	PortableImageDecoder decoder;
+	UINT width = 0, height = 0;
+	std::vector<BYTE> pixels;
+	E2D_CHECK(decoder.DecodeFile(String(path), &width, &height, pixels));
+	std::remove(path);
+
+	E2D_CHECK(width == 3 && height == 2);
+	if (pixels.size() == 3 * 2 * 4)
+	{
+		E2D_CHECK(PixelEquals(pixels, 0, 0, 0, 255, 255));
+		E2D_CHECK(PixelEquals(pixels, 2, 255, 0, 0, 255));
+		E2D_CHECK(PixelEquals(pixels, 4, 60, 50, 40, 255));
+	}
+}
+
+E2D_TEST(DecodeRejectsCorruptData)
+{
+	PortableImageDecoder decoder;
+	UINT width = 0, height = 0;
+	std::vector<BYTE> pixels;
+
+	// 截断的压缩数据
+	std::vector<BYTE> truncated(kRgbaPng, kRgbaPng + sizeof(kRgbaPng));
+	truncated.resize(truncated.size() / 2);
+	E2D_CHECK(!decoder.Decode(&truncated[0], truncated.size(), &width, &height, pixels));
+
+	// 损坏的压缩数据
+	std::vector<BYTE> corrupt(kRgbaPng, kRgbaPng + sizeof(kRgbaPng));
+	for (size_t i = 60; i < 120; ++i)
+	{
+		corrupt[i] = static_cast<BYTE>(corrupt[i] * 7 + 13);
+	}
+	E2D_CHECK(!decoder.Decode(&corrupt[0], corrupt.size(), &width, &height, pixels));
+
+	const BYTE unknown[] = { 'G', 'I', 'F', '8', '9', 'a', 0, 0 };
+	E2D_CHECK(!decoder.Decode(unknown, sizeof(unknown), &width, &height, pixels));
+	E2D_CHECK(!decoder.DecodeFile(String("missing_image_file.png"), &width, &height, pixels));
+}
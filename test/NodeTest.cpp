@@ -0,0 +1,456 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "Test.h"
+
+using namespace easy2d;
+
+namespace
+{
+	// 创建一个以左上角为支点的节点
+	Node * CreateNode(float x, float y, float width, float height)
+	{
+		Node * node = new Node();
+		node->Retain();
+		node->SetPivot(0, 0);
+		node->SetPosition(x, y);
+		node->SetSize(width, height);
+		return node;
+	}
+
+	// 记录收到的鼠标消息数量
+	class ClickNode
+		: public Node
+		, public MouseEventHandler
+	{
+	public:
+		ClickNode() : count(0) {}
+
+		virtual void Handle(MouseEvent e) override
+		{
+			++count;
+		}
+
+		int count;
+	};
+
+	// 收到鼠标消息时移除另一个节点和自身
+	class RemovingNode
+		: public ClickNode
+	{
+	public:
+		RemovingNode() : victim(nullptr) {}
+
+		virtual void Handle(MouseEvent e) override
+		{
+			ClickNode::Handle(e);
+			victim->RemoveFromParent();
+			RemoveFromParent();
+		}
+
+		Node * victim;
+	};
+
+	// 可以读取变换缓存结果的节点
+	class CachedNode
+		: public Node
+	{
+	public:
+		// 按节点大小剔除，使包围盒参与检查
+		CachedNode() { SetCustomDraw(false); }
+
+		int GetIndex() const { return transform_index_; }
+
+		const D2D1::Matrix3x2F& GetFinalMatrix() const { return final_matrix_; }
+
+		bool IsSubtreeBounded() const { return subtree_bounded_; }
+
+		const Rect& GetSubtreeBounds() const { return subtree_bounds_; }
+
+		// 重新计算子树包围盒，子节点先于父节点
+		void RecomputeSubtreeBounds()
+		{
+			for (auto child : children_)
+			{
+				static_cast<CachedNode*>(child)->RecomputeSubtreeBounds();
+			}
+			UpdateSubtreeBounds();
+		}
+	};
+
+	bool NearlyEqual(float a, float b)
+	{
+		return std::fabs(a - b) <= 1e-3f * (1.f + std::fabs(a) + std::fabs(b));
+	}
+
+	// 按深度优先顺序检查缓存序号和世界矩阵，parent_initial 为父节点的 Initial 矩阵
+	bool CheckCached(CachedNode * node, const D2D1::Matrix3x2F& parent_initial, int& index)
+	{
+		bool passed = (node->GetIndex() == index++);
+
+		const Transform& transform = node->GetTransform();
+		const D2D1::Matrix3x2F local = static_cast<D2D1::Matrix3x2F>(transform);
+		const D2D1::Matrix3x2F expected = local * parent_initial;
+		const D2D1::Matrix3x2F& actual = node->GetFinalMatrix();
+		passed = passed &&
+			NearlyEqual(actual._11, expected._11) && NearlyEqual(actual._12, expected._12) &&
+			NearlyEqual(actual._21, expected._21) && NearlyEqual(actual._22, expected._22) &&
+			NearlyEqual(actual._31, expected._31) && NearlyEqual(actual._32, expected._32);
+
+		const D2D1::Matrix3x2F initial = local * D2D1::Matrix3x2F::Translation(
+			transform.size.width * transform.pivot_x,
+			transform.size.height * transform.pivot_y
+		) * parent_initial;
+		for (auto child : node->GetAllChildren())
+		{
+			passed = CheckCached(static_cast<CachedNode*>(child), initial, index) && passed;
+		}
+		return passed;
+	}
+
+	// 增量更新的子树包围盒与重新计算的结果一致
+	bool CheckSubtreeBounds(CachedNode * root)
+	{
+		std::vector<CachedNode*> nodes(1, root);
+		for (size_t i = 0; i < nodes.size(); ++i)
+		{
+			for (auto child : nodes[i]->GetAllChildren())
+			{
+				nodes.push_back(static_cast<CachedNode*>(child));
+			}
+		}
+
+		std::vector<std::pair<bool, Rect>> cached;
+		for (auto node : nodes)
+		{
+			cached.push_back(std::make_pair(node->IsSubtreeBounded(), node->GetSubtreeBounds()));
+		}
+
+		root->RecomputeSubtreeBounds();
+
+		bool passed = true;
+		for (size_t i = 0; i < nodes.size(); ++i)
+		{
+			const bool bounded = nodes[i]->IsSubtreeBounded();
+			const Rect& rect = nodes[i]->GetSubtreeBounds();
+			passed = passed && cached[i].first == bounded;
+			if (bounded)
+			{
+				passed = passed &&
+					NearlyEqual(cached[i].second.origin.x, rect.origin.x) &&
+					NearlyEqual(cached[i].second.origin.y, rect.origin.y) &&
+					NearlyEqual(cached[i].second.size.width, rect.size.width) &&
+					NearlyEqual(cached[i].second.size.height, rect.size.height);
+			}
+		}
+		return passed;
+	}
+
+	MouseEvent MouseMove(int x, int y)
+	{
+		return MouseEvent(
+			static_cast<UINT>(MouseEvent::Type::MoveBy),
+			0,
+			static_cast<LPARAM>((x & 0xffff) | ((y & 0xffff) << 16))
+		);
+	}
+}
+
+E2D_TEST(ContainsPointAxisAligned)
+{
+	Node * node = CreateNode(10, 20, 100, 50);
+
+	E2D_CHECK(node->ContainsPoint(Point(50, 40)));
+	E2D_CHECK(node->ContainsPoint(Point(10, 20)));
+	E2D_CHECK(!node->ContainsPoint(Point(5, 40)));
+	E2D_CHECK(!node->ContainsPoint(Point(120, 40)));
+	E2D_CHECK(!node->ContainsPoint(Point(50, 80)));
+
+	node->Release();
+}
+
+E2D_TEST(ContainsPointRotated)
+{
+	// 旋转 45 度后轮廓是菱形，包围盒的角落不在节点内
+	Node * node = CreateNode(0, 0, 100, 100);
+	node->SetPivot(0.5f, 0.5f);
+	node->SetRotation(45);
+
+	E2D_CHECK(node->ContainsPoint(Point(0, 0)));
+	E2D_CHECK(node->ContainsPoint(Point(60, 0)));
+	E2D_CHECK(!node->ContainsPoint(Point(60, 60)));
+	E2D_CHECK(!node->ContainsPoint(Point(-60, -60)));
+
+	node->Release();
+}
+
+E2D_TEST(ContainsPointZeroScale)
+{
+	Node * node = CreateNode(10, 20, 100, 50);
+
+	// 缩放为 0 时轮廓退化成一个点，不包含任何点
+	node->SetScale(0);
+	E2D_CHECK(!node->ContainsPoint(Point(10, 20)));
+	E2D_CHECK(!node->ContainsPoint(Point(50, 40)));
+	E2D_CHECK(!node->ContainsPoint(Point(-1000, 1000)));
+
+	// 只在一个方向上缩放为 0 时轮廓退化成线段
+	node->SetScale(1, 0);
+	E2D_CHECK(!node->ContainsPoint(Point(50, 20)));
+
+	node->SetScale(1);
+	E2D_CHECK(node->ContainsPoint(Point(50, 40)));
+
+	node->Release();
+}
+
+E2D_TEST(ContainsPointZeroSize)
+{
+	Node * node = CreateNode(10, 20, 0, 0);
+	E2D_CHECK(!node->ContainsPoint(Point(10, 20)));
+	node->Release();
+}
+
+E2D_TEST(IntersectsAxisAligned)
+{
+	Node * a = CreateNode(0, 0, 100, 100);
+	Node * b = CreateNode(50, 50, 100, 100);
+	Node * c = CreateNode(200, 0, 10, 10);
+
+	E2D_CHECK(a->Intersects(b));
+	E2D_CHECK(b->Intersects(a));
+	E2D_CHECK(!a->Intersects(c));
+	E2D_CHECK(!c->Intersects(a));
+
+	a->Release();
+	b->Release();
+	c->Release();
+}
+
+E2D_TEST(IntersectsRotated)
+{
+	// 菱形的包围盒与 b 相交，但轮廓本身不相交
+	Node * a = CreateNode(0, 0, 100, 100);
+	a->SetPivot(0.5f, 0.5f);
+	a->SetRotation(45);
+
+	Node * b = CreateNode(50, 50, 20, 20);
+	E2D_CHECK(!a->Intersects(b));
+	E2D_CHECK(!b->Intersects(a));
+
+	b->SetPosition(20, 20);
+	E2D_CHECK(a->Intersects(b));
+	E2D_CHECK(b->Intersects(a));
+
+	a->Release();
+	b->Release();
+}
+
+E2D_TEST(IntersectsZeroScale)
+{
+	Node * a = CreateNode(0, 0, 100, 100);
+	Node * b = CreateNode(50, 50, 100, 100);
+
+	b->SetScale(0);
+	E2D_CHECK(!a->Intersects(b));
+	E2D_CHECK(!b->Intersects(a));
+
+	a->Release();
+	b->Release();
+}
+
+E2D_TEST(DispatchHitsRotatedOutline)
+{
+	// 旋转 45 度后，包围盒角落里的点不会发给节点
+	ClickNode * node = new ClickNode();
+	node->SetPivot(0.5f, 0.5f);
+	node->SetPosition(100, 100);
+	node->SetSize(100, 100);
+	node->SetRotation(45);
+
+	Node * root = new Node();
+	root->AddChild(node);
+
+	Scene * scene = new Scene(root);
+	scene->Retain();
+	scene->SetSpatialIndexEnabled(true);
+
+	scene->Dispatch(MouseMove(100, 100));
+	E2D_CHECK(node->count == 1);
+
+	scene->Dispatch(MouseMove(160, 100));
+	E2D_CHECK(node->count == 2);
+
+	// 从节点上移开时还会收到一次消息，用于处理鼠标移出
+	scene->Dispatch(MouseMove(140, 140));
+	E2D_CHECK(node->count == 3);
+
+	scene->Dispatch(MouseMove(140, 140));
+	E2D_CHECK(node->count == 3);
+
+	scene->Release();
+}
+
+E2D_TEST(DispatchSurvivesListenerRemoval)
+{
+	Node * root = new Node();
+	ClickNode * first = new ClickNode();
+	ClickNode * victim = new ClickNode();
+	ClickNode * last = new ClickNode();
+	RemovingNode * remover = new RemovingNode();
+	remover->victim = victim;
+	remover->SetEventPriority(1);
+	root->AddChild(first);
+	root->AddChild(victim);
+	root->AddChild(last);
+	root->AddChild(remover);
+
+	Scene * scene = new Scene(root);
+	scene->Retain();
+
+	// 处理消息的节点释放了自身和还没收到消息的节点，其余节点仍然收到消息
+	scene->Dispatch(MouseMove(10, 10));
+	E2D_CHECK(first->count == 1);
+	E2D_CHECK(last->count == 1);
+	E2D_CHECK(root->GetChildrenCount() == 2);
+
+	// 分发结束后空位已删除，之后的移除和分发正常进行
+	first->Retain();
+	first->RemoveFromParent();
+	scene->Dispatch(MouseMove(10, 10));
+	E2D_CHECK(first->count == 1);
+	E2D_CHECK(last->count == 2);
+
+	first->Release();
+	scene->Release();
+}
+
+E2D_TEST(TransformStoreSplicesSubtrees)
+{
+	CachedNode * root = new CachedNode();
+	Scene * scene = new Scene(root);
+	scene->Retain();
+
+	std::vector<CachedNode*> nodes(1, root);
+	unsigned seed = 12345;
+	auto random = [&](size_t n) -> size_t
+	{
+		seed = seed * 1103515245u + 12345u;
+		return static_cast<size_t>((seed >> 8) % n);
+	};
+
+	auto create = [&]() -> CachedNode*
+	{
+		CachedNode * node = new CachedNode();
+		node->SetPosition(static_cast<float>(random(200)), static_cast<float>(random(200)));
+		node->SetSize(static_cast<float>(random(3)) * 10, 10);
+		node->SetRotation(static_cast<float>(random(4)) * 15);
+		return node;
+	};
+
+	// 被移除的节点及其子孙节点不再可用
+	auto forget = [&](Node * node)
+	{
+		std::vector<Node*> removed(1, node);
+		for (size_t i = 0; i < removed.size(); ++i)
+		{
+			for (auto child : removed[i]->GetAllChildren())
+				removed.push_back(child);
+		}
+		for (auto n : removed)
+		{
+			nodes.erase(std::remove(nodes.begin(), nodes.end(), n), nodes.end());
+		}
+	};
+
+	for (int i = 0; i < 30; ++i)
+	{
+		CachedNode * node = create();
+		nodes[random(nodes.size())]->AddChild(node);
+		nodes.push_back(node);
+	}
+	scene->UpdateTransform();
+
+	bool passed = true;
+	for (int round = 0; round < 300; ++round)
+	{
+		const size_t ops = 1 + random(4);
+		for (size_t op = 0; op < ops; ++op)
+		{
+			CachedNode * target = nodes[random(nodes.size())];
+			switch (random(6))
+			{
+			case 0:
+			case 5:
+			{
+				CachedNode * node = create();
+				target->AddChild(node, static_cast<int>(random(3)) - 1);
+				nodes.push_back(node);
+				break;
+			}
+			case 1:
+				// 多数时候只移除叶节点，避免树很快变空
+				if (target != root && (target->GetAllChildren().empty() || random(4) == 0))
+				{
+					forget(target);
+					target->RemoveFromParent();
+				}
+				break;
+			case 2:
+				if (target != root)
+				{
+					target->SetOrder(static_cast<int>(random(3)) - 1);
+				}
+				break;
+			case 3:
+				target->SetPosition(static_cast<float>(random(200)), static_cast<float>(random(200)));
+				break;
+			case 4:
+			{
+				// 移动到不在自身子树中的节点下
+				CachedNode * parent = nodes[random(nodes.size())];
+				bool inside = false;
+				for (Node * n = parent; n; n = n->GetParent())
+					inside = inside || (n == target);
+				if (target != root && !inside)
+				{
+					target->Retain();
+					target->RemoveFromParent();
+					parent->AddChild(target);
+					target->Release();
+				}
+				break;
+			}
+			}
+		}
+
+		scene->UpdateTransform();
+
+		int index = 0;
+		passed = passed && CheckCached(root, D2D1::Matrix3x2F::Identity(), index);
+		passed = passed && static_cast<size_t>(index) == nodes.size();
+		passed = passed && CheckSubtreeBounds(root);
+	}
+	E2D_CHECK(passed);
+	E2D_CHECK(nodes.size() > 1);
+
+	scene->Release();
+}
@@ -0,0 +1,425 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "Test.h"
+
+using namespace easy2d;
+
+namespace
+{
+	const D2D1_RECT_F kRect = D2D1::RectF(0, 0, 10, 10);
+
+	// 记录命令只保存资源指针，测试中不需要真实的位图和几何图形
+	void DrawBitmap(RenderCommandList& commands)
+	{
+		commands.DrawBitmap(nullptr, kRect, kRect, 1.f);
+	}
+
+	void DrawGeometry(RenderCommandList& commands, const D2D1_COLOR_F& color)
+	{
+		commands.DrawGeometry(nullptr, color, 1.f);
+	}
+
+	// 创建一个以左上角为支点的节点
+	template <typename T>
+	T * CreateNode(float x, float y, float width, float height)
+	{
+		T * node = new T();
+		node->SetPivot(0, 0);
+		node->SetPosition(x, y);
+		node->SetSize(width, height);
+		return node;
+	}
+
+	// 重写了 Draw 的节点
+	class DrawingNode
+		: public Node
+	{
+	public:
+		DrawingNode() : draw_count(0) {}
+
+		virtual void Draw() const override
+		{
+			++draw_count;
+		}
+
+		mutable int draw_count;
+	};
+
+	// 没有重写 Draw 的派生节点
+	class ContainerNode
+		: public Node
+	{
+	};
+
+	// 和图形设备一样在回放时调用节点的 Draw
+	class DrawingRecorder
+		: public RenderRecorder
+	{
+	protected:
+		virtual void Draw(const RenderCommand& command) override
+		{
+			RenderRecorder::Draw(command);
+			if (command.type == RenderCommand::Type::Custom)
+			{
+				command.node->Draw();
+			}
+		}
+	};
+
+	int CountCommands(const RenderCommandList& commands, RenderCommand::Type type)
+	{
+		int count = 0;
+		for (const auto& command : commands.GetCommands())
+		{
+			if (command.type == type)
+				++count;
+		}
+		return count;
+	}
+}
+
+E2D_TEST(RecorderSkipsRepeatedTransform)
+{
+	RenderCommandList commands;
+	commands.SetTransform(D2D1::Matrix3x2F::Identity());
+	DrawBitmap(commands);
+	commands.SetTransform(D2D1::Matrix3x2F::Identity());
+	DrawBitmap(commands);
+	commands.SetTransform(D2D1::Matrix3x2F::Translation(5, 0));
+	DrawBitmap(commands);
+
+	RenderRecorder recorder;
+	recorder.Replay(commands);
+
+	E2D_CHECK(recorder.GetDrawCallCount() == 3);
+	E2D_CHECK(recorder.GetStateChangeCount() == 2);
+	E2D_CHECK(recorder.GetSkippedCount() == 1);
+	E2D_CHECK(recorder.GetCommands().size() == 5);
+}
+
+E2D_TEST(RecorderSkipsRepeatedOpacity)
+{
+	RenderCommandList commands;
+	commands.SetOpacity(0.5f);
+	DrawBitmap(commands);
+	commands.SetOpacity(0.5f);
+	DrawBitmap(commands);
+	commands.SetOpacity(1.f);
+	DrawBitmap(commands);
+
+	RenderRecorder recorder;
+	recorder.Replay(commands);
+
+	E2D_CHECK(recorder.GetDrawCallCount() == 3);
+	E2D_CHECK(recorder.GetStateChangeCount() == 2);
+	E2D_CHECK(recorder.GetSkippedCount() == 1);
+}
+
+E2D_TEST(RecorderSkipsRepeatedColor)
+{
+	const D2D1_COLOR_F red = D2D1::ColorF(D2D1::ColorF::Red);
+	const D2D1_COLOR_F blue = D2D1::ColorF(D2D1::ColorF::Blue);
+
+	RenderCommandList commands;
+	DrawGeometry(commands, red);
+	DrawGeometry(commands, red);
+	DrawGeometry(commands, blue);
+
+	RenderRecorder recorder;
+	recorder.Replay(commands);
+
+	// 画刷颜色的切换只计数，不出现在记录的命令中
+	E2D_CHECK(recorder.GetDrawCallCount() == 3);
+	E2D_CHECK(recorder.GetStateChangeCount() == 2);
+	E2D_CHECK(recorder.GetSkippedCount() == 1);
+	E2D_CHECK(recorder.GetCommands().size() == 3);
+}
+
+E2D_TEST(RecorderTextInvalidatesColor)
+{
+	const D2D1_COLOR_F red = D2D1::ColorF(D2D1::ColorF::Red);
+
+	RenderCommandList commands;
+	DrawGeometry(commands, red);
+	commands.DrawTextLayout(nullptr, red, FALSE, red, 0.f, D2D1_LINE_JOIN_MITER);
+	DrawGeometry(commands, red);
+
+	RenderRecorder recorder;
+	recorder.Replay(commands);
+
+	// 文字渲染器会修改画刷颜色，之后的颜色必须重新设置
+	E2D_CHECK(recorder.GetDrawCallCount() == 3);
+	E2D_CHECK(recorder.GetStateChangeCount() == 2);
+	E2D_CHECK(recorder.GetSkippedCount() == 0);
+}
+
+E2D_TEST(RecorderCustomDrawResetsState)
+{
+	RenderCommandList commands;
+	commands.SetTransform(D2D1::Matrix3x2F::Identity());
+	commands.SetOpacity(0.5f);
+	commands.DrawNode(nullptr);
+	commands.SetTransform(D2D1::Matrix3x2F::Identity());
+	commands.SetOpacity(0.5f);
+	DrawBitmap(commands);
+
+	RenderRecorder recorder;
+	recorder.Replay(commands);
+
+	// 节点的 Draw 函数可以任意修改渲染目标，之后的状态不能跳过
+	E2D_CHECK(recorder.GetDrawCallCount() == 2);
+	E2D_CHECK(recorder.GetStateChangeCount() == 4);
+	E2D_CHECK(recorder.GetSkippedCount() == 0);
+}
+
+E2D_TEST(RecorderClipIsNotStateChange)
+{
+	RenderCommandList commands;
+	commands.SetTransform(D2D1::Matrix3x2F::Identity());
+	commands.PushClip(kRect);
+	DrawBitmap(commands);
+	commands.PopClip();
+
+	RenderRecorder recorder;
+	recorder.Replay(commands);
+
+	E2D_CHECK(recorder.GetDrawCallCount() == 1);
+	E2D_CHECK(recorder.GetStateChangeCount() == 1);
+	E2D_CHECK(recorder.GetCommands().size() == 4);
+	E2D_CHECK(recorder.GetCommands()[1].type == RenderCommand::Type::PushClip);
+	E2D_CHECK(recorder.GetCommands()[3].type == RenderCommand::Type::PopClip);
+}
+
+E2D_TEST(RecorderReplayResetsState)
+{
+	RenderCommandList commands;
+	commands.SetTransform(D2D1::Matrix3x2F::Identity());
+	DrawBitmap(commands);
+
+	// 两次回放之间渲染目标的状态可能被修改过，第二次回放不能跳过变换
+	RenderRecorder recorder;
+	recorder.Replay(commands);
+	recorder.Replay(commands);
+
+	E2D_CHECK(recorder.GetDrawCallCount() == 2);
+	E2D_CHECK(recorder.GetStateChangeCount() == 2);
+	E2D_CHECK(recorder.GetSkippedCount() == 0);
+
+	recorder.Clear();
+	E2D_CHECK(recorder.GetDrawCallCount() == 0);
+	E2D_CHECK(recorder.GetStateChangeCount() == 0);
+	E2D_CHECK(recorder.GetCommands().empty());
+}
+
+E2D_TEST(VisitSkipsPlainNodes)
+{
+	Node * root = CreateNode<Node>(0, 0, 100, 100);
+	root->AddChild(CreateNode<Node>(10, 10, 20, 20));
+	root->AddChild(CreateNode<Node>(40, 40, 20, 20));
+
+	Scene * scene = new Scene(root);
+	scene->Retain();
+
+	// 普通节点不生成任何命令，也不计入绘制数量
+	RenderCommandList commands;
+	scene->Draw(commands, Size(100, 100));
+
+	E2D_CHECK(commands.GetCount() == 0);
+	E2D_CHECK(scene->GetVisitedCount() == 3);
+	E2D_CHECK(scene->GetDrawnCount() == 0);
+	E2D_CHECK(scene->GetCulledCount() == 0);
+
+	scene->Release();
+}
+
+E2D_TEST(VisitStopsCallingDefaultDraw)
+{
+	Node * root = new Node();
+	auto drawing = CreateNode<DrawingNode>(0, 0, 10, 10);
+	auto container = CreateNode<ContainerNode>(20, 0, 10, 10);
+	root->AddChild(drawing);
+	root->AddChild(container);
+
+	Scene * scene = new Scene(root);
+	scene->Retain();
+
+	RenderCommandList commands;
+	DrawingRecorder recorder;
+	scene->Draw(commands, Size(100, 100));
+	recorder.Replay(commands);
+
+	// 第一帧无法确定派生节点是否重写了 Draw
+	E2D_CHECK(CountCommands(commands, RenderCommand::Type::Custom) == 2);
+	E2D_CHECK(scene->GetDrawnCount() == 2);
+	E2D_CHECK(drawing->draw_count == 1);
+
+	// 回放时调用了基类的 Draw，之后不再为该节点生成命令
+	commands.Clear();
+	recorder.Clear();
+	scene->Draw(commands, Size(100, 100));
+	recorder.Replay(commands);
+
+	E2D_CHECK(CountCommands(commands, RenderCommand::Type::Custom) == 1);
+	E2D_CHECK(CountCommands(commands, RenderCommand::Type::Transform) == 1);
+	E2D_CHECK(scene->GetDrawnCount() == 1);
+	E2D_CHECK(recorder.GetDrawCallCount() == 1);
+	E2D_CHECK(drawing->draw_count == 2);
+
+	scene->Release();
+}
+
+E2D_TEST(VisitCullsOutsideView)
+{
+	Node * root = new Node();
+	auto visible = CreateNode<DrawingNode>(10, 10, 10, 10);
+	auto hidden = CreateNode<DrawingNode>(200, 200, 10, 10);
+	visible->SetDrawBounds(Rect(0, 0, 10, 10));
+	hidden->SetDrawBounds(Rect(0, 0, 10, 10));
+	root->AddChild(visible);
+	root->AddChild(hidden);
+
+	Scene * scene = new Scene(root);
+	scene->Retain();
+
+	RenderCommandList commands;
+	scene->Draw(commands, Size(100, 100));
+
+	E2D_CHECK(scene->GetVisitedCount() == 3);
+	E2D_CHECK(scene->GetCulledCount() == 1);
+	E2D_CHECK(scene->GetDrawnCount() == 1);
+	E2D_CHECK(CountCommands(commands, RenderCommand::Type::Custom) == 1);
+
+	// 移入视口后重新绘制
+	hidden->SetPosition(50, 50);
+	commands.Clear();
+	scene->Draw(commands, Size(100, 100));
+
+	E2D_CHECK(scene->GetCulledCount() == 0);
+	E2D_CHECK(scene->GetDrawnCount() == 2);
+
+	scene->Release();
+}
+
+E2D_TEST(VisitCullsZeroSizeSubtree)
+{
+	Node * root = new Node();
+	auto visible = CreateNode<DrawingNode>(10, 10, 10, 10);
+	auto group = CreateNode<Node>(200, 200, 0, 0);
+	for (int i = 0; i < 3; ++i)
+	{
+		auto child = CreateNode<DrawingNode>(static_cast<float>(i) * 10, 0, 10, 10);
+		child->SetDrawBounds(Rect(0, 0, 10, 10));
+		group->AddChild(child);
+	}
+	visible->SetDrawBounds(Rect(0, 0, 10, 10));
+	root->AddChild(visible);
+	root->AddChild(group);
+
+	Scene * scene = new Scene(root);
+	scene->Retain();
+
+	// 大小为零的容器按子节点的范围整体剔除
+	RenderCommandList commands;
+	scene->Draw(commands, Size(100, 100));
+
+	E2D_CHECK(scene->GetVisitedCount() == 3);
+	E2D_CHECK(scene->GetCulledCount() == 1);
+	E2D_CHECK(scene->GetDrawnCount() == 1);
+
+	group->SetPosition(20, 20);
+	commands.Clear();
+	scene->Draw(commands, Size(100, 100));
+
+	E2D_CHECK(scene->GetVisitedCount() == 6);
+	E2D_CHECK(scene->GetCulledCount() == 0);
+	E2D_CHECK(scene->GetDrawnCount() == 4);
+
+	scene->Release();
+}
+
+E2D_TEST(VisitKeepsCustomDrawWithoutBounds)
+{
+	Node * root = new Node();
+	auto drawing = CreateNode<DrawingNode>(200, 200, 10, 10);
+	auto container = CreateNode<ContainerNode>(300, 300, 0, 0);
+	auto child = CreateNode<DrawingNode>(0, 0, 10, 10);
+	child->SetDrawBounds(Rect(0, 0, 10, 10));
+	container->AddChild(child);
+	root->AddChild(drawing);
+	root->AddChild(container);
+
+	Scene * scene = new Scene(root);
+	scene->Retain();
+
+	// 重写了 Draw 的节点可能在节点大小之外绘制，没有绘制范围时不剔除
+	RenderCommandList commands;
+	DrawingRecorder recorder;
+	scene->Draw(commands, Size(100, 100));
+	recorder.Replay(commands);
+
+	E2D_CHECK(scene->GetVisitedCount() == 4);
+	E2D_CHECK(scene->GetCulledCount() == 1);
+	E2D_CHECK(drawing->draw_count == 1);
+
+	// 回放后确定派生容器不绘制内容，之后整个子树被剔除
+	commands.Clear();
+	recorder.Clear();
+	scene->Draw(commands, Size(100, 100));
+	recorder.Replay(commands);
+
+	E2D_CHECK(scene->GetVisitedCount() == 3);
+	E2D_CHECK(scene->GetCulledCount() == 1);
+	E2D_CHECK(drawing->draw_count == 2);
+
+	scene->Release();
+}
+
+E2D_TEST(VisitRecordsClipAndTransform)
+{
+	Node * root = new Node();
+	auto clip = CreateNode<Node>(10, 20, 50, 50);
+	clip->SetClipEnabled(true);
+	clip->AddChild(CreateNode<DrawingNode>(5, 5, 10, 10));
+	root->AddChild(clip);
+
+	Scene * scene = new Scene(root);
+	scene->Retain();
+
+	RenderCommandList commands;
+	scene->Draw(commands, Size(100, 100));
+
+	// 裁剪节点自身不绘制，子节点的变换包含父节点的位移
+	const auto& list = commands.GetCommands();
+	E2D_CHECK(list.size() == 5);
+	if (list.size() == 5)
+	{
+		E2D_CHECK(list[0].type == RenderCommand::Type::Transform);
+		E2D_CHECK(list[1].type == RenderCommand::Type::PushClip);
+		E2D_CHECK(list[2].type == RenderCommand::Type::Transform);
+		E2D_CHECK_NEAR(list[2].transform._31, 15.f);
+		E2D_CHECK_NEAR(list[2].transform._32, 25.f);
+		E2D_CHECK(list[3].type == RenderCommand::Type::Custom);
+		E2D_CHECK(list[4].type == RenderCommand::Type::PopClip);
+	}
+
+	scene->Release();
+}
@@ -0,0 +1,83 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+#include "../core/easy2d.h"
+#include <cstdio>
+#include <cmath>
+
+namespace easy2d
+{
+	namespace test
+	{
+		typedef void(*TestFunc)();
+
+		struct TestCase
+		{
+			const char *	name;
+			TestFunc		func;
+		};
+
+		// 所有已注册的测试
+		inline std::vector<TestCase>& GetTests()
+		{
+			static std::vector<TestCase> tests;
+			return tests;
+		}
+
+		// 当前测试中失败的检查数量
+		inline int& GetFailures()
+		{
+			static int failures = 0;
+			return failures;
+		}
+
+		// 在静态初始化时注册测试
+		struct Registrar
+		{
+			Registrar(const char * name, TestFunc func)
+			{
+				TestCase test = { name, func };
+				GetTests().push_back(test);
+			}
+		};
+
+		inline void ReportFailure(const char * file, int line, const char * expr)
+		{
+			std::printf("  %s(%d): check failed: %s\n", file, line, expr);
+			++GetFailures();
+		}
+	}
+}
+
+// 定义一个测试
+#define E2D_TEST(NAME) \
+	static void NAME(); \
+	static ::easy2d::test::Registrar NAME##_registrar(#NAME, NAME); \
+	static void NAME()
+
+// 检查表达式是否为真，失败时继续执行当前测试
+#define E2D_CHECK(EXPR) \
+	do { if (!(EXPR)) ::easy2d::test::ReportFailure(__FILE__, __LINE__, #EXPR); } while (0)
+
+// 检查两个浮点数是否近似相等
+#define E2D_CHECK_NEAR(A, B) \
+	E2D_CHECK(std::fabs((A) - (B)) < 1e-4f)
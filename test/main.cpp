@@ -0,0 +1,47 @@
+// Copyright (c) 2016-2018 Easy2D - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "Test.h"
+
+int main()
+{
+	using namespace easy2d::test;
+
+	int failed = 0;
+	for (const auto& test : GetTests())
+	{
+		GetFailures() = 0;
+		test.func();
+
+		if (GetFailures() == 0)
+		{
+			std::printf("[ OK ] %s\n", test.name);
+		}
+		else
+		{
+			std::printf("[FAIL] %s\n", test.name);
+			++failed;
+		}
+	}
+
+	std::printf("%d/%d tests passed\n", static_cast<int>(GetTests().size()) - failed, static_cast<int>(GetTests().size()));
+	return failed == 0 ? 0 : 1;
+}